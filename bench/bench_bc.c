@@ -0,0 +1,209 @@
+/*
+ * RELIC is an Efficient LIbrary for Cryptography
+ * Copyright (C) 2007-2015 RELIC Authors
+ *
+ * This file is part of RELIC. RELIC is legal property of its developers,
+ * whose names are not listed here. Please refer to the COPYRIGHT file
+ * for contact information.
+ *
+ * RELIC is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * RELIC is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with RELIC. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ *
+ * Benchmarks for block ciphers.
+ *
+ * @version $Id$
+ * @ingroup bc
+ */
+
+#include <stdio.h>
+
+#include "relic.h"
+#include "relic_bench.h"
+
+/**
+ * Length in bytes of the messages encrypted in the benchmarks.
+ */
+#define MSG_LEN		4096
+
+/**
+ * Decrypts in CBC mode with a fresh output capacity on each call.
+ */
+static int cbc_dec(uint8_t *out, uint8_t *in, int in_len, uint8_t *key,
+		uint8_t *iv) {
+	int out_len = in_len;
+
+	return bc_aes_cbc_dec(out, &out_len, in, in_len, key, 128, iv);
+}
+
+/**
+ * Decrypts in GCM mode with a fresh output capacity on each call.
+ */
+static int gcm_dec(uint8_t *out, uint8_t *in, int in_len, uint8_t *key,
+		uint8_t *iv) {
+	int out_len = in_len;
+
+	return bc_aes_gcm_dec(out, &out_len, in, in_len, key, 128, iv, 12, NULL,
+			0);
+}
+
+/**
+ * Decrypts with ChaCha20-Poly1305 with a fresh output capacity on each call.
+ */
+static int chacha_dec(uint8_t *out, uint8_t *in, int in_len, uint8_t *key,
+		uint8_t *iv) {
+	int out_len = in_len;
+
+	return bc_chacha_dec(out, &out_len, in, in_len, key, 256, iv,
+			BC_CHACHA_IV, NULL, 0);
+}
+
+static void aes(void) {
+	uint8_t key[32], iv[BC_LEN], in[MSG_LEN], out[MSG_LEN + BC_LEN];
+	uint8_t dec[MSG_LEN + BC_LEN];
+	int out_len;
+	bc_aes_t k;
+
+	rand_bytes(key, sizeof(key));
+	rand_bytes(iv, sizeof(iv));
+	rand_bytes(in, sizeof(in));
+
+	BENCH_BEGIN("bc_aes_key (128 bits)") {
+		BENCH_ADD(bc_aes_key(&k, key, 128));
+	}
+	BENCH_END;
+
+	BENCH_BEGIN("bc_aes_key (256 bits)") {
+		BENCH_ADD(bc_aes_key(&k, key, 256));
+	}
+	BENCH_END;
+
+	bc_aes_key(&k, key, 128);
+
+	BENCH_BEGIN("bc_aes_ecb_enc (1 block)") {
+		BENCH_ADD(bc_aes_ecb_enc(out, in, BC_LEN, &k));
+	}
+	BENCH_END;
+
+	BENCH_BEGIN("bc_aes_ecb_enc (4096 bytes)") {
+		BENCH_ADD(bc_aes_ecb_enc(out, in, MSG_LEN, &k));
+	}
+	BENCH_END;
+
+	BENCH_BEGIN("bc_aes_ecb_dec (4096 bytes)") {
+		BENCH_ADD(bc_aes_ecb_dec(out, in, MSG_LEN, &k));
+	}
+	BENCH_END;
+
+	BENCH_BEGIN("bc_aes_cbc_enc (4096 bytes)") {
+		out_len = sizeof(out);
+		BENCH_ADD(bc_aes_cbc_enc(out, &out_len, in, MSG_LEN, key, 128, iv));
+	}
+	BENCH_END;
+
+	BENCH_BEGIN("bc_aes_cbc_dec (4096 bytes)") {
+		out_len = sizeof(out);
+		bc_aes_cbc_enc(out, &out_len, in, MSG_LEN, key, 128, iv);
+		BENCH_ADD(cbc_dec(dec, out, out_len, key, iv));
+	}
+	BENCH_END;
+
+	BENCH_BEGIN("bc_aes_ctr_enc (4096 bytes)") {
+		out_len = sizeof(out);
+		BENCH_ADD(bc_aes_ctr_enc(out, &out_len, in, MSG_LEN, key, 128, iv));
+	}
+	BENCH_END;
+
+	BENCH_BEGIN("bc_aes_gcm_enc (4096 bytes)") {
+		out_len = sizeof(out);
+		BENCH_ADD(bc_aes_gcm_enc(out, &out_len, in, MSG_LEN, key, 128, iv, 12,
+				NULL, 0));
+	}
+	BENCH_END;
+
+	BENCH_BEGIN("bc_aes_gcm_dec (4096 bytes)") {
+		out_len = sizeof(out);
+		bc_aes_gcm_enc(out, &out_len, in, MSG_LEN, key, 128, iv, 12, NULL, 0);
+		BENCH_ADD(gcm_dec(dec, out, out_len, key, iv));
+	}
+	BENCH_END;
+}
+
+static void chacha(void) {
+	uint8_t key[BC_CHACHA_KEY], iv[BC_CHACHA_IV], tag[BC_TAG_LEN];
+	uint8_t in[MSG_LEN], out[MSG_LEN + BC_TAG_LEN], dec[MSG_LEN + BC_TAG_LEN];
+	int out_len;
+
+	rand_bytes(key, sizeof(key));
+	rand_bytes(iv, sizeof(iv));
+	rand_bytes(in, sizeof(in));
+
+	BENCH_BEGIN("bc_chacha20 (64 bytes)") {
+		BENCH_ADD(bc_chacha20(out, in, 64, key, iv, 0));
+	}
+	BENCH_END;
+
+	BENCH_BEGIN("bc_chacha20 (4096 bytes)") {
+		BENCH_ADD(bc_chacha20(out, in, MSG_LEN, key, iv, 0));
+	}
+	BENCH_END;
+
+	BENCH_BEGIN("bc_poly1305 (64 bytes)") {
+		BENCH_ADD(bc_poly1305(tag, in, 64, key));
+	}
+	BENCH_END;
+
+	BENCH_BEGIN("bc_poly1305 (4096 bytes)") {
+		BENCH_ADD(bc_poly1305(tag, in, MSG_LEN, key));
+	}
+	BENCH_END;
+
+	BENCH_BEGIN("bc_chacha_enc (4096 bytes)") {
+		out_len = sizeof(out);
+		BENCH_ADD(bc_chacha_enc(out, &out_len, in, MSG_LEN, key, 256, iv,
+				BC_CHACHA_IV, NULL, 0));
+	}
+	BENCH_END;
+
+	BENCH_BEGIN("bc_chacha_dec (4096 bytes)") {
+		out_len = sizeof(out);
+		bc_chacha_enc(out, &out_len, in, MSG_LEN, key, 256, iv, BC_CHACHA_IV,
+				NULL, 0);
+		BENCH_ADD(chacha_dec(dec, out, out_len, key, iv));
+	}
+	BENCH_END;
+}
+
+int main(void) {
+	if (core_init() != STS_OK) {
+		core_clean();
+		return 1;
+	}
+
+	conf_print();
+	util_banner("Benchmarks for the BC module:", 0);
+
+	util_banner("Block ciphers:\n", 0);
+	aes();
+
+	util_banner("Stream ciphers:\n", 0);
+	chacha();
+
+	if (core_clean() != STS_OK) {
+		return 1;
+	}
+	return 0;
+}
@@ -29,6 +29,8 @@
  * @ingroup bench
  */
 
+#include <stdlib.h>
+
 #include "relic.h"
 #include "relic_bench.h"
 
@@ -220,6 +222,18 @@ static void util(void) {
 	}
 	BENCH_END;
 
+	BENCH_BEGIN("bn_write_str (radix 16)") {
+		bn_rand(a, BN_POS, BN_BITS);
+		BENCH_ADD(bn_write_str(str, sizeof(str), a, 16));
+	}
+	BENCH_END;
+
+	BENCH_BEGIN("bn_read_str (radix 16)") {
+		bn_rand(a, BN_POS, BN_BITS);
+		BENCH_ADD(bn_read_str(a, str, sizeof(str), 16));
+	}
+	BENCH_END;
+
 	BENCH_BEGIN("bn_size_bin") {
 		bn_rand(a, BN_POS, BN_BITS);
 		BENCH_ADD(bn_size_bin(a));
@@ -282,6 +296,7 @@ static void util(void) {
 
 static void arith(void) {
 	bn_t a, b, c, d, e;
+	bn_mod_ctx_t ctx;
 	dig_t f;
 	int len;
 
@@ -290,12 +305,14 @@ static void arith(void) {
 	bn_null(c);
 	bn_null(d);
 	bn_null(e);
+	bn_mod_ctx_null(ctx);
 
 	bn_new(a);
 	bn_new(b);
 	bn_new(c);
 	bn_new(d);
 	bn_new(e);
+	bn_mod_ctx_new(ctx);
 
 	BENCH_BEGIN("bn_add") {
 		bn_rand(a, BN_POS, BN_BITS);
@@ -369,6 +386,22 @@ static void arith(void) {
 	BENCH_END;
 #endif
 
+#if BN_MUL == TOOMC || !defined(STRIP)
+	BENCH_BEGIN("bn_mul_toom3") {
+		bn_rand(a, BN_POS, BN_BITS);
+		bn_rand(b, BN_POS, BN_BITS);
+		BENCH_ADD(bn_mul_toom3(c, a, b));
+	}
+	BENCH_END;
+
+	BENCH_BEGIN("bn_mul_toomc") {
+		bn_rand(a, BN_POS, BN_BITS);
+		bn_rand(b, BN_POS, BN_BITS);
+		BENCH_ADD(bn_mul_toomc(c, a, b));
+	}
+	BENCH_END;
+#endif
+
 	BENCH_BEGIN("bn_sqr") {
 		bn_rand(a, BN_POS, BN_BITS);
 		BENCH_ADD(bn_sqr(c, a));
@@ -399,6 +432,20 @@ static void arith(void) {
 	BENCH_END;
 #endif
 
+#if BN_SQR == TOOMC || !defined(STRIP)
+	BENCH_BEGIN("bn_sqr_toom3") {
+		bn_rand(a, BN_POS, BN_BITS);
+		BENCH_ADD(bn_sqr_toom3(c, a));
+	}
+	BENCH_END;
+
+	BENCH_BEGIN("bn_sqr_toomc") {
+		bn_rand(a, BN_POS, BN_BITS);
+		BENCH_ADD(bn_sqr_toomc(c, a));
+	}
+	BENCH_END;
+#endif
+
 	BENCH_BEGIN("bn_dbl") {
 		bn_rand(a, BN_POS, BN_BITS);
 		BENCH_ADD(bn_dbl(c, a));
@@ -645,7 +692,7 @@ static void arith(void) {
 	BENCH_END;
 #endif
 
-#if BN_MXP == CONST || !defined(STRIP)
+#if BN_MXP == MONTY || !defined(STRIP)
 	BENCH_BEGIN("bn_mxp_monty") {
 		bn_rand(a, BN_POS, 2 * BN_BITS - BN_DIGIT / 2);
 		bn_mod(a, a, b);
@@ -654,6 +701,38 @@ static void arith(void) {
 	BENCH_END;
 #endif
 
+	BENCH_BEGIN("bn_mxp_const") {
+		bn_rand(a, BN_POS, 2 * BN_BITS - BN_DIGIT / 2);
+		bn_mod(a, a, b);
+		BENCH_ADD(bn_mxp_const(c, a, b, b));
+	}
+	BENCH_END;
+
+	bn_mod_ctx_set(ctx, b);
+
+	BENCH_BEGIN("bn_mul_mod_ctx") {
+		bn_rand(a, BN_POS, 2 * BN_BITS - BN_DIGIT / 2);
+		bn_mod(a, a, b);
+		bn_rand(d, BN_POS, 2 * BN_BITS - BN_DIGIT / 2);
+		bn_mod(d, d, b);
+		BENCH_ADD(bn_mul_mod_ctx(c, a, d, ctx));
+	}
+	BENCH_END;
+
+	BENCH_BEGIN("bn_mxp_ctx") {
+		bn_rand(a, BN_POS, 2 * BN_BITS - BN_DIGIT / 2);
+		bn_mod(a, a, b);
+		BENCH_ADD(bn_mxp_ctx(c, a, b, ctx));
+	}
+	BENCH_END;
+
+	BENCH_BEGIN("bn_mxp_const_ctx") {
+		bn_rand(a, BN_POS, 2 * BN_BITS - BN_DIGIT / 2);
+		bn_mod(a, a, b);
+		BENCH_ADD(bn_mxp_const_ctx(c, a, b, ctx));
+	}
+	BENCH_END;
+
 	BENCH_BEGIN("bn_mxp_dig") {
 		bn_rand(a, BN_POS, BN_BITS);
 		bn_rand(d, BN_POS, BN_DIGIT);
@@ -915,8 +994,106 @@ static void arith(void) {
 	bn_free(c);
 	bn_free(d);
 	bn_free(e);
+	bn_mod_ctx_free(ctx);
+}
+
+#if BN_MUL == TOOMC || BN_SQR == TOOMC || !defined(STRIP)
+
+/**
+ * Measures the mean time of a multiplication function.
+ */
+static ull_t tune_mul(void (*f)(bn_t, const bn_t, const bn_t), bn_t c,
+		const bn_t a, const bn_t b) {
+	bench_reset(NULL);
+	f(c, a, b);
+	bench_before();
+	for (int i = 0; i < BENCH * BENCH; i++) {
+		f(c, a, b);
+	}
+	bench_after();
+	bench_compute(BENCH * BENCH);
+	return bench_total();
 }
 
+/**
+ * Measures the mean time of a squaring function.
+ */
+static ull_t tune_sqr(void (*f)(bn_t, const bn_t), bn_t c, const bn_t a) {
+	bench_reset(NULL);
+	f(c, a);
+	bench_before();
+	for (int i = 0; i < BENCH * BENCH; i++) {
+		f(c, a);
+	}
+	bench_after();
+	bench_compute(BENCH * BENCH);
+	return bench_total();
+}
+
+/**
+ * Compares Comba, Karatsuba and Toom-3 on growing operands and prints the
+ * thresholds used when the method is chosen by size. This takes much longer
+ * than the benchmarks, so it only runs if RELIC_BENCH_TUNE is set.
+ */
+static void tune(void) {
+	bn_t a, b, c;
+	ull_t t0, t1, t2;
+	int step = MAX(1, BN_DIGS / 32);
+	int mul_k = BN_DIGS + step, mul_t = BN_DIGS + step;
+	int sqr_k = BN_DIGS + step, sqr_t = BN_DIGS + step;
+
+	bn_null(a);
+	bn_null(b);
+	bn_null(c);
+
+	bn_new(a);
+	bn_new(b);
+	bn_new(c);
+
+	/* Each threshold is the smallest size from which the method always wins. */
+	for (int n = BN_DIGS; n > 0; n -= step) {
+		bn_rand(a, BN_POS, n * BN_DIGIT);
+		bn_rand(b, BN_POS, n * BN_DIGIT);
+#if BN_MUL == TOOMC || !defined(STRIP)
+		t0 = tune_mul(bn_mul_comba, c, a, b);
+		t1 = tune_mul(bn_mul_karat, c, a, b);
+		t2 = tune_mul(bn_mul_toom3, c, a, b);
+		util_print("TUNE: bn_mul %4d digits: comba = %llu, karat = %llu, "
+				"toom3 = %llu\n", n, t0, t1, t2);
+		if (t1 < t0 && mul_k == n + step) {
+			mul_k = n;
+		}
+		if (t2 < MIN(t0, t1) && mul_t == n + step) {
+			mul_t = n;
+		}
+#endif
+#if BN_SQR == TOOMC || !defined(STRIP)
+		t0 = tune_sqr(bn_sqr_comba, c, a);
+		t1 = tune_sqr(bn_sqr_karat, c, a);
+		t2 = tune_sqr(bn_sqr_toom3, c, a);
+		util_print("TUNE: bn_sqr %4d digits: comba = %llu, karat = %llu, "
+				"toom3 = %llu\n", n, t0, t1, t2);
+		if (t1 < t0 && sqr_k == n + step) {
+			sqr_k = n;
+		}
+		if (t2 < MIN(t0, t1) && sqr_t == n + step) {
+			sqr_t = n;
+		}
+#endif
+	}
+
+	util_print("#define BN_MUL_KARAT\t%d\n", mul_k);
+	util_print("#define BN_MUL_TOOM3\t%d\n", mul_t);
+	util_print("#define BN_SQR_KARAT\t%d\n", sqr_k);
+	util_print("#define BN_SQR_TOOM3\t%d\n", sqr_t);
+
+	bn_free(a);
+	bn_free(b);
+	bn_free(c);
+}
+
+#endif
+
 int main(void) {
 	if (core_init() != STS_OK) {
 		core_clean();
@@ -930,7 +1107,15 @@ int main(void) {
 	util();
 	util_banner("Arithmetic:", 1);
 	arith();
+#if BN_MUL == TOOMC || BN_SQR == TOOMC || !defined(STRIP)
+	if (getenv("RELIC_BENCH_TUNE") != NULL) {
+		util_banner("Tuning:", 1);
+		tune();
+	}
+#endif
 
-	core_clean();
+	if (core_clean() != STS_OK) {
+		return 1;
+	}
 	return 0;
 }
@@ -37,17 +37,26 @@
 #if defined(WITH_BN)
 
 static void rsa(void) {
-	rsa_t pub, prv;
+	rsa_t pub, prv, pubs[4], prvs[4];
 	uint8_t in[10], new[10], h[MD_LEN], out[BN_BITS / 8 + 1];
-	int out_len, new_len;
+	uint8_t ins[4][10], outs[4][BN_BITS / 8 + 1], *ip[4], *op[4];
+	int out_len, new_len, ils[4], ols[4];
 
 	rsa_null(pub);
 	rsa_null(prv);
 
 	rsa_new(pub);
 	rsa_new(prv);
+	for (int j = 0; j < 4; j++) {
+		rsa_null(pubs[j]);
+		rsa_null(prvs[j]);
+		rsa_new(pubs[j]);
+		rsa_new(prvs[j]);
+		ip[j] = ins[j];
+		op[j] = outs[j];
+	}
 
-	BENCH_ONCE("cp_rsa_gen", cp_rsa_gen(pub, prv, BN_BITS));
+	BENCH_SMALL("cp_rsa_gen", cp_rsa_gen(pub, prv, BN_BITS));
 
 	BENCH_BEGIN("cp_rsa_enc") {
 		out_len = BN_BITS / 8 + 1;
@@ -87,6 +96,18 @@ static void rsa(void) {
 		cp_rsa_enc(out, &out_len, in, sizeof(in), pub);
 		BENCH_ADD(cp_rsa_dec_quick(new, &new_len, out, out_len, prv));
 	} BENCH_END;
+
+#if MULTI != NONE
+	multi_set_cores(1);
+	BENCH_BEGIN("cp_rsa_dec_quick (1 core)") {
+		out_len = BN_BITS / 8 + 1;
+		new_len =out_len;
+		rand_bytes(in, sizeof(in));
+		cp_rsa_enc(out, &out_len, in, sizeof(in), pub);
+		BENCH_ADD(cp_rsa_dec_quick(new, &new_len, out, out_len, prv));
+	} BENCH_END;
+	multi_set_cores(CORES);
+#endif
 #endif
 
 	BENCH_ONCE("cp_rsa_gen", cp_rsa_gen(pub, prv, BN_BITS));
@@ -123,6 +144,17 @@ static void rsa(void) {
 		BENCH_ADD(cp_rsa_ver(out, out_len, h, MD_LEN, 1, pub));
 	} BENCH_END;
 
+	for (int j = 0; j < 4; j++) {
+		rand_bytes(ins[j], sizeof(ins[j]));
+		ils[j] = sizeof(ins[j]);
+		ols[j] = BN_BITS / 8 + 1;
+		cp_rsa_sig(outs[j], &ols[j], ins[j], ils[j], 0, prv);
+	}
+
+	BENCH_BEGIN("cp_rsa_ver_batch (n = 4)") {
+		BENCH_ADD(cp_rsa_ver_batch(NULL, op, ols, ip, ils, 0, pub, 4));
+	} BENCH_END;
+
 #if CP_RSA == BASIC || !defined(STRIP)
 	BENCH_ONCE("cp_rsa_gen_basic", cp_rsa_gen_basic(pub, prv, BN_BITS));
 
@@ -159,10 +191,34 @@ static void rsa(void) {
 		md_map(h, in, sizeof(in));
 		BENCH_ADD(cp_rsa_sig_quick(out, &out_len, in, sizeof(in), 1, prv));
 	} BENCH_END;
+
+	BENCH_ONCE("cp_rsa_gen_batch (n = 4)", cp_rsa_gen_batch(pubs, prvs, 4,
+			BN_BITS));
+
+	for (int j = 0; j < 4; j++) {
+		rand_bytes(ins[j], sizeof(ins[j]));
+		ils[j] = sizeof(ins[j]);
+		ols[j] = BN_BITS / 8 + 1;
+	}
+
+	BENCH_BEGIN("cp_rsa_sig_batch (n = 4)") {
+		BENCH_ADD(cp_rsa_sig_batch(op, ols, ip, ils, 0, prvs, 4));
+	} BENCH_END;
+
+	/* Time of one signature on one core, the inverse of the throughput. */
+	multi_set_cores(1);
+	BENCH_BEGIN("cp_rsa_sig_batch (per sig)") {
+		BENCH_ADD(cp_rsa_sig_batch(op, ols, ip, ils, 0, prvs, 4));
+	} BENCH_DIV(4);
+	multi_set_cores(CORES);
 #endif
 
 	rsa_free(pub);
 	rsa_free(prv);
+	for (int j = 0; j < 4; j++) {
+		rsa_free(pubs[j]);
+		rsa_free(prvs[j]);
+	}
 }
 
 static void rabin(void) {
@@ -201,6 +257,7 @@ static void rabin(void) {
 
 static void benaloh(void) {
 	bdpe_t pub, prv;
+	dlog_t d;
 	dig_t in, new;
 	uint8_t out[BN_BITS / 8 + 1];
 	int out_len;
@@ -210,6 +267,8 @@ static void benaloh(void) {
 
 	bdpe_new(pub);
 	bdpe_new(prv);
+	dlog_null(d);
+	dlog_new(d);
 
 	BENCH_ONCE("cp_bdpe_gen", cp_bdpe_gen(pub, prv, bn_get_prime(47), BN_BITS));
 
@@ -229,43 +288,105 @@ static void benaloh(void) {
 		BENCH_ADD(cp_bdpe_dec(&new, out, out_len, prv));
 	} BENCH_END;
 
+	BENCH_ONCE("cp_bdpe_pre", cp_bdpe_pre(d, prv));
+
+	BENCH_BEGIN("cp_bdpe_dec_fix") {
+		out_len = BN_BITS / 8 + 1;
+		rand_bytes(out, 1);
+		in = out[0] % bn_get_prime(47);
+		cp_bdpe_enc(out, &out_len, in, pub);
+		BENCH_ADD(cp_bdpe_dec_fix(&new, out, out_len, d, prv));
+	} BENCH_END;
+
 	bdpe_free(pub);
 	bdpe_free(prv);
+	dlog_free(d);
 }
 
 static void paillier(void) {
-	bn_t n, l;
+	bn_t c, t[BN_XP_TABLE];
+	phpe_t pub, prv;
 	uint8_t in[1000], new[1000], out[BN_BITS / 8 + 1];
-	int in_len, out_len;
+	uint8_t ins[4][BN_BITS / 8 + 1], outs[4][BN_BITS / 8 + 1], *ip[4], *op[4];
+	int in_len, out_len, ils[4], ols[4];
+
+	bn_null(c);
+	phpe_null(pub);
+	phpe_null(prv);
+
+	bn_new(c);
+	phpe_new(pub);
+	phpe_new(prv);
+	for (int j = 0; j < BN_XP_TABLE; j++) {
+		bn_null(t[j]);
+		bn_new(t[j]);
+	}
 
-	bn_null(n);
-	bn_null(l);
+	BENCH_SMALL("cp_phpe_gen", cp_phpe_gen(pub, prv, BN_BITS / 2));
 
-	bn_new(n);
-	bn_new(l);
+	BENCH_BEGIN("cp_phpe_enc") {
+		in_len = bn_size_bin(pub->n);
+		out_len = BN_BITS / 8 + 1;
+		memset(in, 0, sizeof(in));
+		rand_bytes(in + 1, in_len - 1);
+		BENCH_ADD(cp_phpe_enc(out, &out_len, in, in_len, pub));
+		cp_phpe_dec(new, in_len, out, out_len, prv);
+	} BENCH_END;
 
-	BENCH_ONCE("cp_phpe_gen", cp_phpe_gen(n, l, BN_BITS / 2));
+	BENCH_ONCE("cp_phpe_pre", cp_phpe_pre(t, pub));
 
-	BENCH_BEGIN("cp_phpe_enc") {
-		in_len = bn_size_bin(n);
+	BENCH_BEGIN("cp_phpe_enc_fix") {
+		in_len = bn_size_bin(pub->n);
 		out_len = BN_BITS / 8 + 1;
 		memset(in, 0, sizeof(in));
 		rand_bytes(in + 1, in_len - 1);
-		BENCH_ADD(cp_phpe_enc(out, &out_len, in, in_len, n));
-		cp_phpe_dec(new, in_len, out, out_len, n, l);
+		BENCH_ADD(cp_phpe_enc_fix(out, &out_len, in, in_len, (const bn_t *)t,
+						pub));
 	} BENCH_END;
 
-	BENCH_BEGIN("cp_bdpe_dec") {
-		in_len = bn_size_bin(n);
+	for (int j = 0; j < 4; j++) {
+		ip[j] = ins[j];
+		op[j] = outs[j];
+		ils[j] = bn_size_bin(pub->n);
+		memset(ins[j], 0, sizeof(ins[j]));
+		rand_bytes(ins[j] + 1, ils[j] - 1);
+	}
+
+	BENCH_BEGIN("cp_phpe_enc_batch (per enc)") {
+		for (int j = 0; j < 4; j++) {
+			ols[j] = BN_BITS / 8 + 1;
+		}
+		BENCH_ADD(cp_phpe_enc_batch(op, ols, ip, ils, (const bn_t *)t, pub,
+						4));
+	} BENCH_DIV(4);
+
+	BENCH_BEGIN("cp_phpe_add") {
+		out_len = BN_BITS / 8 + 1;
+		BENCH_ADD(cp_phpe_add(out, &out_len, outs[0], ols[0], outs[1], ols[1],
+						pub));
+	} BENCH_END;
+
+	BENCH_BEGIN("cp_phpe_mul") {
+		out_len = BN_BITS / 8 + 1;
+		bn_rand(c, BN_POS, 32);
+		BENCH_ADD(cp_phpe_mul(out, &out_len, outs[0], ols[0], c, pub));
+	} BENCH_END;
+
+	BENCH_BEGIN("cp_phpe_dec") {
+		in_len = bn_size_bin(pub->n);
 		out_len = BN_BITS / 8 + 1;
 		memset(in, 0, sizeof(in));
 		rand_bytes(in + 1, in_len - 1);
-		cp_phpe_enc(out, &out_len, in, in_len, n);
-		BENCH_ADD(cp_phpe_dec(new, in_len, out, out_len, n, l));
+		cp_phpe_enc(out, &out_len, in, in_len, pub);
+		BENCH_ADD(cp_phpe_dec(new, in_len, out, out_len, prv));
 	} BENCH_END;
 
-	bn_free(n);
-	bn_free(l);
+	bn_free(c);
+	phpe_free(pub);
+	phpe_free(prv);
+	for (int j = 0; j < BN_XP_TABLE; j++) {
+		bn_free(t[j]);
+	}
 }
 
 #endif
@@ -367,15 +488,50 @@ static void ecies(void) {
 	}
 	BENCH_END;
 
+	BENCH_BEGIN("cp_ecies_gcm_enc") {
+		in_len = sizeof(in);
+		out_len = sizeof(out);
+		rand_bytes(in, sizeof(in));
+		BENCH_ADD(cp_ecies_gcm_enc(r, out, &out_len, in, in_len, q));
+	}
+	BENCH_END;
+
+	BENCH_BEGIN("cp_ecies_gcm_dec") {
+		in_len = sizeof(in);
+		out_len = sizeof(out);
+		rand_bytes(in, sizeof(in));
+		cp_ecies_gcm_enc(r, out, &out_len, in, in_len, q);
+		BENCH_ADD(cp_ecies_gcm_dec(in, &in_len, r, out, out_len, d));
+	}
+	BENCH_END;
+
+	BENCH_BEGIN("cp_ecies_chacha_enc") {
+		in_len = sizeof(in);
+		out_len = sizeof(out);
+		rand_bytes(in, sizeof(in));
+		BENCH_ADD(cp_ecies_chacha_enc(r, out, &out_len, in, in_len, q));
+	}
+	BENCH_END;
+
+	BENCH_BEGIN("cp_ecies_chacha_dec") {
+		in_len = sizeof(in);
+		out_len = sizeof(out);
+		rand_bytes(in, sizeof(in));
+		cp_ecies_chacha_enc(r, out, &out_len, in, in_len, q);
+		BENCH_ADD(cp_ecies_chacha_dec(in, &in_len, r, out, out_len, d));
+	}
+	BENCH_END;
+
 	ec_free(q);
 	ec_free(r);
 	bn_free(d);
 }
 
 static void ecdsa(void) {
-	uint8_t msg[5] = { 0, 1, 2, 3, 4 }, h[MD_LEN];
-	bn_t r, s, d;
-	ec_t p;
+	uint8_t msg[5] = { 0, 1, 2, 3, 4 }, h[MD_LEN], *ms[4];
+	int l[4];
+	bn_t r, s, d, rs[4], ss[4];
+	ec_t p, ps[4];
 
 	bn_null(r);
 	bn_null(s);
@@ -386,6 +542,14 @@ static void ecdsa(void) {
 	bn_new(s);
 	bn_new(d);
 	ec_new(p);
+	for (int i = 0; i < 4; i++) {
+		bn_null(rs[i]);
+		bn_null(ss[i]);
+		ec_null(ps[i]);
+		bn_new(rs[i]);
+		bn_new(ss[i]);
+		ec_new(ps[i]);
+	}
 
 	BENCH_BEGIN("cp_ecdsa_gen") {
 		BENCH_ADD(cp_ecdsa_gen(d, p));
@@ -414,10 +578,27 @@ static void ecdsa(void) {
 	}
 	BENCH_END;
 
+	for (int i = 0; i < 4; i++) {
+		cp_ecdsa_sig(rs[i], ss[i], msg, 5, 0, d);
+		ec_copy(ps[i], p);
+		ms[i] = msg;
+		l[i] = 5;
+	}
+
+	BENCH_BEGIN("cp_ecdsa_ver_batch (n = 4)") {
+		BENCH_ADD(cp_ecdsa_ver_batch(NULL, rs, ss, ms, l, 0, ps, 4));
+	}
+	BENCH_END;
+
 	bn_free(r);
 	bn_free(s);
 	bn_free(d);
 	ec_free(p);
+	for (int i = 0; i < 4; i++) {
+		bn_free(rs[i]);
+		bn_free(ss[i]);
+		ec_free(ps[i]);
+	}
 }
 
 static void ecss(void) {
@@ -622,6 +803,7 @@ static void bgn(void) {
 	g2_t d[2];
 	gt_t e[4];
 	bgn_t pub, prv;
+	dlog_t d1, d2, dt;
 	dig_t in;
 
 	g1_null(c[0]);
@@ -637,6 +819,12 @@ static void bgn(void) {
 	g2_new(d[1]);
 	bgn_new(pub);
 	bgn_new(prv);
+	dlog_null(d1);
+	dlog_null(d2);
+	dlog_null(dt);
+	dlog_new(d1);
+	dlog_new(d2);
+	dlog_new(dt);
 	for (int i = 0; i < 4; i++) {
 		gt_null(e[i]);
 		gt_new(e[i]);
@@ -668,6 +856,30 @@ static void bgn(void) {
 		BENCH_ADD(cp_bgn_dec2(&in, d, prv));
 	} BENCH_END;
 
+	BENCH_ONCE("cp_bgn_pre1 (2^16)", cp_bgn_pre1(d1, 1 << 16, prv));
+
+	BENCH_BEGIN("cp_bgn_dec1_fix (10)") {
+		cp_bgn_enc1(c, in, pub);
+		BENCH_ADD(cp_bgn_dec1_fix(&in, c, d1, prv));
+	} BENCH_END;
+
+	BENCH_BEGIN("cp_bgn_dec1_fix (40000)") {
+		cp_bgn_enc1(c, 40000, pub);
+		BENCH_ADD(cp_bgn_dec1_fix(&in, c, d1, prv));
+	} BENCH_END;
+
+	BENCH_ONCE("cp_bgn_pre2 (2^16)", cp_bgn_pre2(d2, 1 << 16, prv));
+
+	BENCH_BEGIN("cp_bgn_dec2_fix (10)") {
+		in = 10;
+		cp_bgn_enc2(d, in, pub);
+		BENCH_ADD(cp_bgn_dec2_fix(&in, d, d2, prv));
+	} BENCH_END;
+
+	in = 10;
+	cp_bgn_enc1(c, in, pub);
+	cp_bgn_enc2(d, in, pub);
+
 	BENCH_BEGIN("cp_bgn_mul") {
 		BENCH_ADD(cp_bgn_mul(e, c, d));
 	} BENCH_END;
@@ -676,6 +888,12 @@ static void bgn(void) {
 		BENCH_ADD(cp_bgn_dec(&in, e, prv));
 	} BENCH_END;
 
+	BENCH_ONCE("cp_bgn_pre (2^16)", cp_bgn_pre(dt, 1 << 16, prv));
+
+	BENCH_BEGIN("cp_bgn_dec_fix (100)") {
+		BENCH_ADD(cp_bgn_dec_fix(&in, e, dt, prv));
+	} BENCH_END;
+
 	BENCH_BEGIN("cp_bgn_add") {
 		BENCH_ADD(cp_bgn_add(e, e, e));
 	} BENCH_END;
@@ -686,15 +904,19 @@ static void bgn(void) {
 	g2_free(d[1]);
 	bgn_free(pub);
 	bgn_free(prv);
+	dlog_free(d1);
+	dlog_free(d2);
+	dlog_free(dt);
 	for (int i = 0; i < 4; i++) {
 		gt_free(e[i]);
 	}
 }
 
 static void bls(void) {
-	uint8_t msg[5] = { 0, 1, 2, 3, 4 };
-	g1_t s;
-	g2_t p;
+	uint8_t msg[5] = { 0, 1, 2, 3, 4 }, *ms[4];
+	int l[4];
+	g1_t s, ss[4];
+	g2_t p, ps[4];
 	bn_t d;
 
 	g1_null(s);
@@ -704,6 +926,12 @@ static void bls(void) {
 	g1_new(s);
 	g2_new(p);
 	bn_new(d);
+	for (int i = 0; i < 4; i++) {
+		g1_null(ss[i]);
+		g2_null(ps[i]);
+		g1_new(ss[i]);
+		g2_new(ps[i]);
+	}
 
 	BENCH_BEGIN("cp_bls_gen") {
 		BENCH_ADD(cp_bls_gen(d, p));
@@ -720,9 +948,25 @@ static void bls(void) {
 	}
 	BENCH_END;
 
+	for (int i = 0; i < 4; i++) {
+		g1_copy(ss[i], s);
+		g2_copy(ps[i], p);
+		ms[i] = msg;
+		l[i] = 5;
+	}
+
+	BENCH_BEGIN("cp_bls_ver_batch (n = 4)") {
+		BENCH_ADD(cp_bls_ver_batch(NULL, ss, ms, l, ps, 4));
+	}
+	BENCH_END;
+
 	g1_free(s);
 	bn_free(d);
 	g2_free(p);
+	for (int i = 0; i < 4; i++) {
+		g1_free(ss[i]);
+		g2_free(ps[i]);
+	}
 }
 
 static void bbs(void) {
@@ -820,6 +1064,8 @@ int main(void) {
 	}
 #endif
 
-	core_clean();
+	if (core_clean() != STS_OK) {
+		return 1;
+	}
 	return 0;
 }
@@ -100,6 +100,8 @@ int main(void) {
 	util_banner("Utilities:\n", 0);
 	memory();
 	copy();
-	core_clean();
+	if (core_clean() != STS_OK) {
+		return 1;
+	}
 	return 0;
 }
@@ -688,6 +688,8 @@ int main(void) {
 		}
 	}
 
-	core_clean();
+	if (core_clean() != STS_OK) {
+		return 1;
+	}
 	return 0;
 }
@@ -560,6 +560,29 @@ static void arith(void) {
 		BENCH_ADD(ep_mul_sim_gen(r, k, q, l));
 	} BENCH_END;
 
+	{
+		ep_t t[8];
+		bn_t u[8];
+
+		for (int i = 0; i < 8; i++) {
+			ep_null(t[i]);
+			bn_null(u[i]);
+			ep_new(t[i]);
+			bn_new(u[i]);
+			ep_rand(t[i]);
+			bn_rand_mod(u[i], n);
+		}
+
+		BENCH_BEGIN("ep_mul_sim_lot (n = 8)") {
+			BENCH_ADD(ep_mul_sim_lot(r, t, u, 8));
+		} BENCH_END;
+
+		for (int i = 0; i < 8; i++) {
+			ep_free(t[i]);
+			bn_free(u[i]);
+		}
+	}
+
 	BENCH_BEGIN("ep_map") {
 		uint8_t msg[5];
 		rand_bytes(msg, 5);
@@ -631,6 +654,8 @@ int main(void) {
 		}
 	}
 
-	core_clean();
+	if (core_clean() != STS_OK) {
+		return 1;
+	}
 	return 0;
 }
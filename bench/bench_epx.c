@@ -607,6 +607,8 @@ int main(void) {
 	util_banner("Arithmetic:", 1);
 	arith();
 
-	core_clean();
+	if (core_clean() != STS_OK) {
+		return 1;
+	}
 	return 0;
 }
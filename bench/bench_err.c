@@ -69,6 +69,8 @@ int main(void) {
 	conf_print();
 	util_banner("Benchmarks for the ERR module:\n", 0);
 	error();
-	core_clean();
+	if (core_clean() != STS_OK) {
+		return 1;
+	}
 	return 0;
 }
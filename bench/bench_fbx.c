@@ -172,6 +172,8 @@ int main(void) {
 	util_banner("Arithmetic:", 1);
 	arith2();
 
-	core_clean();
+	if (core_clean() != STS_OK) {
+		return 1;
+	}
 	return 0;
 }
@@ -605,6 +605,8 @@ int main(void) {
 	util_banner("Arithmetic:\n", 0);
 	arith();
 
-	core_clean();
+	if (core_clean() != STS_OK) {
+		return 1;
+	}
 	return 0;
 }
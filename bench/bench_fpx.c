@@ -1739,6 +1739,8 @@ int main(void) {
 		arith18();
 	}
 
-	core_clean();
+	if (core_clean() != STS_OK) {
+		return 1;
+	}
 	return 0;
 }
@@ -0,0 +1,224 @@
+/*
+ * RELIC is an Efficient LIbrary for Cryptography
+ * Copyright (C) 2007-2015 RELIC Authors
+ *
+ * This file is part of RELIC. RELIC is legal property of its developers,
+ * whose names are not listed here. Please refer to the COPYRIGHT file
+ * for contact information.
+ *
+ * RELIC is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * RELIC is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with RELIC. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ *
+ * Benchmarks for hash functions.
+ *
+ * @version $Id$
+ * @ingroup md
+ */
+
+#include <stdio.h>
+
+#include "relic.h"
+#include "relic_bench.h"
+
+/**
+ * Length in bytes of the messages hashed in the benchmarks.
+ */
+#define MSG_LEN		1024
+
+/**
+ * Number of messages hashed in the multi-buffer benchmarks.
+ */
+#define MSG_LOT		8
+
+static void hash(void) {
+	uint8_t msg[MSG_LEN], digest[MD_LEN_SH512];
+
+	rand_bytes(msg, sizeof(msg));
+
+#if MD_MAP == SHONE || !defined(STRIP)
+	BENCH_BEGIN("md_map_shone (1024 bytes)") {
+		BENCH_ADD(md_map_shone(digest, msg, sizeof(msg)));
+	}
+	BENCH_END;
+#endif
+
+#if MD_MAP == SH224 || !defined(STRIP)
+	BENCH_BEGIN("md_map_sh224 (1024 bytes)") {
+		BENCH_ADD(md_map_sh224(digest, msg, sizeof(msg)));
+	}
+	BENCH_END;
+#endif
+
+#if MD_MAP == SH256 || !defined(STRIP)
+	BENCH_BEGIN("md_map_sh256 (1024 bytes)") {
+		BENCH_ADD(md_map_sh256(digest, msg, sizeof(msg)));
+	}
+	BENCH_END;
+#endif
+
+#if MD_MAP == SH384 || !defined(STRIP)
+	BENCH_BEGIN("md_map_sh384 (1024 bytes)") {
+		BENCH_ADD(md_map_sh384(digest, msg, sizeof(msg)));
+	}
+	BENCH_END;
+#endif
+
+#if MD_MAP == SH512 || !defined(STRIP)
+	BENCH_BEGIN("md_map_sh512 (1024 bytes)") {
+		BENCH_ADD(md_map_sh512(digest, msg, sizeof(msg)));
+	}
+	BENCH_END;
+#endif
+
+#if MD_MAP == SH3_256 || !defined(STRIP)
+	BENCH_BEGIN("md_map_sh3_256 (1024 bytes)") {
+		BENCH_ADD(md_map_sh3_256(digest, msg, sizeof(msg)));
+	}
+	BENCH_END;
+#endif
+
+#if MD_MAP == SH3_512 || !defined(STRIP)
+	BENCH_BEGIN("md_map_sh3_512 (1024 bytes)") {
+		BENCH_ADD(md_map_sh3_512(digest, msg, sizeof(msg)));
+	}
+	BENCH_END;
+#endif
+
+#if MD_MAP == B2S_256 || !defined(STRIP)
+	BENCH_BEGIN("md_map_b2s_256 (1024 bytes)") {
+		BENCH_ADD(md_map_b2s_256(digest, msg, sizeof(msg)));
+	}
+	BENCH_END;
+#endif
+
+#if MD_MAP == B2B_512 || !defined(STRIP)
+	BENCH_BEGIN("md_map_b2b_512 (1024 bytes)") {
+		BENCH_ADD(md_map_b2b_512(digest, msg, sizeof(msg)));
+	}
+	BENCH_END;
+#endif
+
+	BENCH_BEGIN("md_xof_shk128 (1024 bytes)") {
+		BENCH_ADD(md_xof_shk128(digest, 32, msg, sizeof(msg)));
+	}
+	BENCH_END;
+
+	BENCH_BEGIN("md_xof_shk256 (1024 bytes)") {
+		BENCH_ADD(md_xof_shk256(digest, 64, msg, sizeof(msg)));
+	}
+	BENCH_END;
+}
+
+static void lot(void) {
+	uint8_t buf[MSG_LOT][64], out[MSG_LOT][MD_LEN_SH512];
+	uint8_t *m[MSG_LOT], *h[MSG_LOT];
+	int l[MSG_LOT];
+
+	for (int i = 0; i < MSG_LOT; i++) {
+		m[i] = buf[i];
+		h[i] = out[i];
+		l[i] = sizeof(buf[i]);
+		rand_bytes(buf[i], sizeof(buf[i]));
+	}
+
+#if MD_MAP == SH256 || !defined(STRIP)
+	BENCH_BEGIN("md_map_sh256_x8 (8 messages of 64 bytes)") {
+		BENCH_ADD(md_map_sh256_x8(h, m, l, MSG_LOT));
+	}
+	BENCH_END;
+#endif
+
+#if MD_MAP == SH512 || !defined(STRIP)
+	BENCH_BEGIN("md_map_sh512_x4 (8 messages of 64 bytes)") {
+		BENCH_ADD(md_map_sh512_x4(h, m, l, MSG_LOT));
+	}
+	BENCH_END;
+#endif
+
+	BENCH_BEGIN("md_map_lot (8 messages of 64 bytes)") {
+		BENCH_ADD(md_map_lot(h, m, l, MSG_LOT));
+	}
+	BENCH_END;
+}
+
+static void derive(void) {
+	uint8_t key[MD_LEN], msg[MSG_LEN], mac[MD_LEN], out[64];
+	md_hmac_t ctx;
+
+	rand_bytes(key, sizeof(key));
+	rand_bytes(msg, sizeof(msg));
+
+	BENCH_BEGIN("md_hmac (1024 bytes)") {
+		BENCH_ADD(md_hmac(mac, msg, sizeof(msg), key, sizeof(key)));
+	}
+	BENCH_END;
+
+	BENCH_BEGIN("md_hmac_init") {
+		BENCH_ADD(md_hmac_init(&ctx, key, sizeof(key)));
+	}
+	BENCH_END;
+
+	BENCH_BEGIN("md_hmac_update + md_hmac_final (1024 bytes)") {
+		BENCH_ADD({ md_hmac_update(&ctx, msg, sizeof(msg));
+			md_hmac_final(&ctx, mac); });
+	}
+	BENCH_END;
+
+	BENCH_BEGIN("md_hkdf (64 bytes)") {
+		BENCH_ADD(md_hkdf(out, sizeof(out), key, sizeof(key), msg, 16, msg, 16));
+	}
+	BENCH_END;
+
+	BENCH_BEGIN("md_kdf1 (64 bytes)") {
+		BENCH_ADD(md_kdf1(out, sizeof(out), key, sizeof(key)));
+	}
+	BENCH_END;
+
+	BENCH_BEGIN("md_kdf2 (64 bytes)") {
+		BENCH_ADD(md_kdf2(out, sizeof(out), key, sizeof(key)));
+	}
+	BENCH_END;
+
+	BENCH_BEGIN("md_mgf1 (64 bytes)") {
+		BENCH_ADD(md_mgf1(out, sizeof(out), key, sizeof(key)));
+	}
+	BENCH_END;
+}
+
+int main(void) {
+	if (core_init() != STS_OK) {
+		core_clean();
+		return 1;
+	}
+
+	conf_print();
+	util_banner("Benchmarks for the MD module:", 0);
+
+	util_banner("Hash functions:\n", 0);
+	hash();
+
+	util_banner("Multi-buffer hashing:\n", 0);
+	lot();
+
+	util_banner("Derived functions:\n", 0);
+	derive();
+
+	if (core_clean() != STS_OK) {
+		return 1;
+	}
+	return 0;
+}
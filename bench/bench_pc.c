@@ -665,6 +665,48 @@ static void pairing(void) {
 	gt_free(r);	
 }
 
+#if FP_PRIME < 1536
+
+static void product(void) {
+	g1_t p[16];
+	g2_t q[16];
+	gt_t r;
+	int cores = multi_get_cores();
+
+	gt_new(r);
+	for (int i = 0; i < 16; i++) {
+		g1_null(p[i]);
+		g2_null(q[i]);
+		g1_new(p[i]);
+		g2_new(q[i]);
+		g1_rand(p[i]);
+		g2_rand(q[i]);
+	}
+
+	BENCH_BEGIN("pc_map (n = 16)") {
+		BENCH_ADD(for (int k = 0; k < 16; k++) { pc_map(r, p[k], q[k]); });
+	}
+	BENCH_END;
+
+	for (int c = 1; c <= CORES; c++) {
+		multi_set_cores(c);
+		util_print("      *** %d thread(s) ***\n", multi_get_cores());
+		BENCH_BEGIN("pc_map_sim (n = 16)") {
+			BENCH_ADD(pc_map_sim(r, p, q, 16));
+		}
+		BENCH_END;
+	}
+	multi_set_cores(cores);
+
+	gt_free(r);
+	for (int i = 0; i < 16; i++) {
+		g1_free(p[i]);
+		g2_free(q[i]);
+	}
+}
+
+#endif
+
 int main(void) {
 	if (core_init() != STS_OK) {
 		core_clean();
@@ -709,7 +751,13 @@ int main(void) {
 	util_banner("Pairing:", 0);	
 	util_banner("Arithmetic:", 1);
 	pairing();
+#if FP_PRIME < 1536
+	util_banner("Products of pairings:", 1);
+	product();
+#endif
 
-	core_clean();
+	if (core_clean() != STS_OK) {
+		return 1;
+	}
 	return 0;
 }
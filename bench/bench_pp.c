@@ -377,6 +377,8 @@ int main(void) {
 		pairing12();
 	}
 
-	core_clean();
+	if (core_clean() != STS_OK) {
+		return 1;
+	}
 	return 0;
 }
@@ -78,6 +78,7 @@ static void rng(void) {
 #else
 
 static void rng(void) {
+	static uint8_t large[1 << 16];
 	uint8_t buffer[256];
 
 	BENCH_BEGIN("rand_seed (20)") {
@@ -90,6 +91,16 @@ static void rng(void) {
 			BENCH_ADD(rand_bytes(buffer, k));
 		} BENCH_END;
 	}
+
+	for (int k = 1; k <= sizeof(buffer); k *= 2) {
+		BENCH_BEGIN("rand_bytes_small (from 1 to 256)") {
+			BENCH_ADD(rand_bytes_small(buffer, k));
+		} BENCH_END;
+	}
+
+	BENCH_BEGIN("rand_bytes (65536)") {
+		BENCH_ADD(rand_bytes(large, sizeof(large)));
+	} BENCH_END;
 }
 
 #endif
@@ -104,6 +115,8 @@ int main(void) {
 	util_banner("Benchmarks for the RAND module:", 0);
 	util_banner("Utilities:\n", 0);
 	rng();
-	core_clean();
+	if (core_clean() != STS_OK) {
+		return 1;
+	}
 	return 0;
 }
@@ -12,11 +12,13 @@ message("   ** Available multiple precision arithmetic methods (default = COMBA;
 
 message("      Integer multiplication:")
 message("      BN_METHD=BASIC    Schoolbook multiplication.")
-message("      BN_METHD=COMBA    Comba multiplication.\n")
+message("      BN_METHD=COMBA    Comba multiplication.")
+message("      BN_METHD=TOOMC    Comba, Karatsuba or Toom-3 multiplication by size.\n")
 
 message("      Integer squaring:")
 message("      BN_METHD=BASIC    Schoolbook squaring.")
 message("      BN_METHD=COMBA    Comba squaring.")
+message("      BN_METHD=TOOMC    Comba, Karatsuba or Toom-3 squaring by size.")
 message("      BN_METHD=MULTP    Reuse multiplication for squaring.\n")
 
 message("      Modular reduction:")
@@ -28,7 +30,8 @@ message("      BN_METHD=RADIX    Diminished radix modular reduction.\n")
 message("      Modular exponentiation:")
 message("      BN_METHD=BASIC    Binary modular exponentiation.")
 message("      BN_METHD=MONTY    Montgomery powering ladder.")
-message("      BN_METHD=SLIDE    Sliding window modular exponentiation.\n")
+message("      BN_METHD=SLIDE    Sliding window modular exponentiation.")
+message("      BN_METHD=CONST    Constant-time fixed window modular exponentiation.\n")
 
 message("      Greatest Common Divisor:")
 message("      BN_METHD=BASIC    Euclid's standard GCD algorithm.")
@@ -5,7 +5,11 @@ message("      MD_METHD=SHONE    SHA-1 hash function.")
 message("      MD_METHD=SH224    SHA-224 hash function.")
 message("      MD_METHD=SH256    SHA-256 hash function.")
 message("      MD_METHD=SH384    SHA-384 hash function.")
-message("      MD_METHD=SH512    SHA-512 hash function.\n")
+message("      MD_METHD=SH512    SHA-512 hash function.")
+message("      MD_METHD=SH3_256  SHA3-256 hash function.")
+message("      MD_METHD=SH3_512  SHA3-512 hash function.")
+message("      MD_METHD=B2S_256  BLAKE2s-256 hash function.")
+message("      MD_METHD=B2B_512  BLAKE2b-512 hash function.\n")
 
 # Choose the arithmetic methods.
 if (NOT MD_METHD)
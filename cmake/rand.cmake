@@ -2,8 +2,10 @@ message(STATUS "Available pseudo-random number generators (default = HASH):\n")
 
 message("   RAND=HASH      Use the HASH-DRBG generator. (recommended)")
 message("   RAND=HMAC      Use the HMAC-DRBG generator. (recommended)")
+message("   RAND=CTR       Use the AES-256 CTR-DRBG generator. (recommended)")
 message("   RAND=UDEV      Use the operating system underlying generator.")
 message("   RAND=FIPS      Use the FIPS 186-2 (CN1) SHA1-based generator.")
+message("   RAND=CHACHA    Use the ChaCha20 generator with fast key erasure.")
 message("   RAND=CALL      Override the generator with a callback.\n")
 
 message(STATUS "Available random number generator seeders (default = UDEV):\n")
@@ -14,8 +16,18 @@ message("   SEED=UDEV      Use non-blocking /dev/urandom. (recommended)")
 message("   SEED=LIBC      Use the libc rand()/random() functions. (insecure!)")
 message("   SEED=ZERO      Use a zero seed. (insecure!)\n")
 
+message(STATUS "Random number generator buffering (default = 1024):\n")
+
+message("   RAND_BUF=n     Serve small requests from a buffer of n bytes. (0 disables)\n")
+
 # Choose the pseudo-random number generator.
 set(RAND "HASH" CACHE STRING "Pseudo-random number generator")
 
 # Choose the pseudo-random number generator.
 set(SEED "UDEV" CACHE STRING "Random number generator seeder")
+
+# Choose the size of the buffer for small requests.
+if (NOT DEFINED RAND_BUF)
+	set(RAND_BUF 1024)
+endif(NOT DEFINED RAND_BUF)
+set(RAND_BUF ${RAND_BUF} CACHE INTEGER "Size in bytes of the buffer for small requests")
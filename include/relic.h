@@ -97,5 +97,6 @@
 #include "relic_err.h"
 #include "relic_rand.h"
 #include "relic_util.h"
+#include "relic_multi.h"
 
 #endif /* !RELIC_H */
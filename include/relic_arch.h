@@ -70,6 +70,45 @@
 #define FETCH(STR, ID, L)	strncpy(STR, ID, L);
 #endif
 
+#if ARCH == X64
+
+/**
+ * Processor supports the SSSE3 and SSE4.1 instruction set extensions.
+ */
+#define ARCH_SSE41			0x01
+
+/**
+ * Processor and operating system support the AVX2 extensions.
+ */
+#define ARCH_AVX2			0x02
+
+/**
+ * Processor supports the BMI2 bit manipulation instructions.
+ */
+#define ARCH_BMI2			0x04
+
+/**
+ * Processor supports the SHA extensions.
+ */
+#define ARCH_SHANI			0x08
+
+/**
+ * Processor supports the AES-NI instructions.
+ */
+#define ARCH_AESNI			0x10
+
+/**
+ * Processor supports the carry-less multiplication instruction.
+ */
+#define ARCH_CLMUL			0x20
+
+/**
+ * All instruction set extensions used by the library.
+ */
+#define ARCH_ALL			(~0)
+
+#endif
+
 /*============================================================================*/
 /* Function prototypes                                                        */
 /*============================================================================*/
@@ -102,4 +141,26 @@ void arch_copy_rom(char *dest, const char *src, int len);
 
 #endif
 
+#if ARCH == X64
+
+/**
+ * Returns the instruction set extensions detected by arch_init() as a
+ * combination of the ARCH_* flags. Returns zero before the library is
+ * initialized, so callers fall back to portable code.
+ */
+int arch_features(void);
+
+/**
+ * Restricts the instruction set extensions reported by arch_features() to
+ * the ones in the given mask, so that the portable fallbacks can be tested
+ * on any processor. ARCH_ALL restores the detected extensions. The setting
+ * is global and must not change while other threads use the library, and
+ * key schedules computed under one setting must not be used under another.
+ *
+ * @param[in] mask		- the allowed extensions as ARCH_* flags.
+ */
+void arch_limit(int mask);
+
+#endif
+
 #endif /* !RELIC_ARCH_H */
@@ -48,10 +48,141 @@
  */
 #define BC_LEN					16
 
+/**
+ * Maximum number of rounds of AES.
+ */
+#define BC_AES_NR				14
+
+/**
+ * Length in bytes of the authentication tag of GCM.
+ */
+#define BC_TAG_LEN				16
+
+/**
+ * Length in bytes of a ChaCha20 key.
+ */
+#define BC_CHACHA_KEY			32
+
+/**
+ * Length in bytes of a ChaCha20 nonce.
+ */
+#define BC_CHACHA_IV			12
+
+/*============================================================================*/
+/* Type definitions                                                           */
+/*============================================================================*/
+
+/**
+ * Represents an expanded AES key.
+ */
+typedef struct {
+	/** Round keys for encryption. */
+	uint8_t ek[BC_LEN * (BC_AES_NR + 1)];
+	/** Round keys for the inverse cipher with AES-NI, or bitsliced keys. */
+	uint8_t dk[BC_LEN * (BC_AES_NR + 1)];
+	/** Number of rounds. */
+	int nr;
+} bc_aes_t;
+
+/**
+ * Represents the state of an authenticated encryption in GCM mode.
+ */
+typedef struct {
+	/** The expanded key. */
+	bc_aes_t key;
+	/** The hash key and its powers H, H^2, H^3 and H^4. */
+	uint8_t h[4 * BC_LEN];
+	/** The initial counter block, used to mask the tag. */
+	uint8_t j0[BC_LEN];
+	/** The current counter block. */
+	uint8_t ctr[BC_LEN];
+	/** The GHASH accumulator. */
+	uint8_t x[BC_LEN];
+	/** The key stream of the current partial block. */
+	uint8_t ks[BC_LEN];
+	/** The bytes of the current partial block to authenticate. */
+	uint8_t buf[BC_LEN];
+	/** The number of bytes in the current partial block. */
+	int used;
+	/** The number of bytes of additional data. */
+	uint64_t aad_len;
+	/** The number of bytes of encrypted data. */
+	uint64_t msg_len;
+} bc_gcm_t;
+
+/**
+ * Represents the state of a Poly1305 authenticator.
+ */
+typedef struct {
+	/** The key r and its powers up to r^4, in 26-bit limbs. */
+	uint32_t r[4][5];
+	/** The accumulator, in 26-bit limbs. */
+	uint32_t h[5];
+	/** The key s added to the final accumulator. */
+	uint8_t s[16];
+	/** The bytes of the current partial block. */
+	uint8_t buf[16];
+	/** The number of bytes in the current partial block. */
+	int used;
+} bc_poly1305_t;
+
+/**
+ * Represents the state of an authenticated encryption with
+ * ChaCha20-Poly1305.
+ */
+typedef struct {
+	/** The input words of the ChaCha20 block function. */
+	uint32_t x[16];
+	/** The key stream of the current partial block. */
+	uint8_t ks[64];
+	/** The number of bytes of key stream already used. */
+	int used;
+	/** The authenticator. */
+	bc_poly1305_t mac;
+	/** The number of bytes of additional data. */
+	uint64_t aad_len;
+	/** The number of bytes of encrypted data. */
+	uint64_t msg_len;
+} bc_chacha_t;
+
 /*============================================================================*/
 /* Function prototypes                                                        */
 /*============================================================================*/
 
+/**
+ * Expands an AES key. The AES-NI instructions are used by the functions
+ * taking the expanded key when the processor supports them, otherwise a
+ * constant-time bitsliced implementation is used.
+ *
+ * @param[out] key			- the expanded key.
+ * @param[in] k				- the key.
+ * @param[in] key_len		- the key size in bits.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+int bc_aes_key(bc_aes_t *key, const uint8_t *k, int key_len);
+
+/**
+ * Encrypts a sequence of blocks with AES in ECB mode.
+ *
+ * @param[out] out			- the resulting ciphertext.
+ * @param[in] in			- the bytes to be encrypted.
+ * @param[in] len			- the number of bytes, a multiple of BC_LEN.
+ * @param[in] key			- the expanded key.
+ */
+void bc_aes_ecb_enc(uint8_t *out, const uint8_t *in, int len,
+		const bc_aes_t *key);
+
+/**
+ * Decrypts a sequence of blocks with AES in ECB mode.
+ *
+ * @param[out] out			- the resulting plaintext.
+ * @param[in] in			- the bytes to be decrypted.
+ * @param[in] len			- the number of bytes, a multiple of BC_LEN.
+ * @param[in] key			- the expanded key.
+ */
+void bc_aes_ecb_dec(uint8_t *out, const uint8_t *in, int len,
+		const bc_aes_t *key);
+
 /**
  * Encrypts with AES in CBC mode.
  * 
@@ -60,7 +191,8 @@
  * @param[in] in			- the bytes to be encrypted.
  * @param[in] in_len		- the number of bytes to encrypt.
  * @param[in] key			- the key.
- * @param[in] key_len		- the key size in bytes.
+ * @param[in] key_len		- the key size in bits.
+ * @param[in] iv			- the initialization vector.
  * @return STS_OK if no errors occurred, STS_ERR otherwise.
  */
 int bc_aes_cbc_enc(uint8_t *out, int *out_len, uint8_t *in,
@@ -74,10 +206,306 @@ int bc_aes_cbc_enc(uint8_t *out, int *out_len, uint8_t *in,
  * @param[in] in			- the bytes to be decrypted.
  * @param[in] in_len		- the number of bytes to decrypt.
  * @param[in] key			- the key.
- * @param[in] key_len		- the key size in bytes.
+ * @param[in] key_len		- the key size in bits.
+ * @param[in] iv			- the initialization vector.
  * @return STS_OK if no errors occurred, STS_ERR otherwise.
  */
 int bc_aes_cbc_dec(uint8_t *out, int *out_len, uint8_t *in,
 		int in_len, uint8_t *key, int key_len, uint8_t *iv);
 
+/**
+ * Encrypts with AES in CTR mode. The initialization vector is the first
+ * counter block, incremented as a 128-bit big-endian integer.
+ *
+ * @param[out] out			- the resulting ciphertext.
+ * @param[in,out] out_len	- the buffer capacity and number of bytes written.
+ * @param[in] in			- the bytes to be encrypted.
+ * @param[in] in_len		- the number of bytes to encrypt.
+ * @param[in] key			- the key.
+ * @param[in] key_len		- the key size in bits.
+ * @param[in] iv			- the initialization vector.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+int bc_aes_ctr_enc(uint8_t *out, int *out_len, uint8_t *in,
+		int in_len, uint8_t *key, int key_len, uint8_t *iv);
+
+/**
+ * Decrypts with AES in CTR mode.
+ *
+ * @param[out] out			- the resulting plaintext.
+ * @param[in,out] out_len	- the buffer capacity and number of bytes written.
+ * @param[in] in			- the bytes to be decrypted.
+ * @param[in] in_len		- the number of bytes to decrypt.
+ * @param[in] key			- the key.
+ * @param[in] key_len		- the key size in bits.
+ * @param[in] iv			- the initialization vector.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+int bc_aes_ctr_dec(uint8_t *out, int *out_len, uint8_t *in,
+		int in_len, uint8_t *key, int key_len, uint8_t *iv);
+
+/**
+ * Starts an authenticated encryption or decryption with AES in GCM mode.
+ * GHASH uses PCLMULQDQ when the processor supports it, otherwise a
+ * constant-time portable multiplier.
+ *
+ * @param[out] ctx			- the GCM context.
+ * @param[in] key			- the key.
+ * @param[in] key_len		- the key size in bits.
+ * @param[in] iv			- the initialization vector, preferably 12 bytes.
+ * @param[in] iv_len		- the number of bytes in the initialization vector.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+int bc_aes_gcm_init(bc_gcm_t *ctx, uint8_t *key, int key_len, uint8_t *iv,
+		int iv_len);
+
+/**
+ * Authenticates additional data in GCM mode. Must be called before any data
+ * is encrypted or decrypted, and may be called several times.
+ *
+ * @param[in,out] ctx		- the GCM context.
+ * @param[in] aad			- the additional data.
+ * @param[in] aad_len		- the number of bytes of additional data.
+ */
+void bc_aes_gcm_aad(bc_gcm_t *ctx, uint8_t *aad, int aad_len);
+
+/**
+ * Encrypts the next part of a message in GCM mode. The output may overlap
+ * the input.
+ *
+ * @param[in,out] ctx		- the GCM context.
+ * @param[out] out			- the resulting ciphertext.
+ * @param[in] in			- the bytes to be encrypted.
+ * @param[in] len			- the number of bytes to encrypt.
+ */
+void bc_aes_gcm_enc_update(bc_gcm_t *ctx, uint8_t *out, uint8_t *in,
+		int len);
+
+/**
+ * Decrypts the next part of a message in GCM mode. The plaintext must not be
+ * used before the tag is verified. The output may overlap the input.
+ *
+ * @param[in,out] ctx		- the GCM context.
+ * @param[out] out			- the resulting plaintext.
+ * @param[in] in			- the bytes to be decrypted.
+ * @param[in] len			- the number of bytes to decrypt.
+ */
+void bc_aes_gcm_dec_update(bc_gcm_t *ctx, uint8_t *out, uint8_t *in,
+		int len);
+
+/**
+ * Finishes an encryption in GCM mode. The context is erased afterwards.
+ *
+ * @param[in,out] ctx		- the GCM context.
+ * @param[out] tag			- the authentication tag of BC_TAG_LEN bytes.
+ */
+void bc_aes_gcm_enc_final(bc_gcm_t *ctx, uint8_t *tag);
+
+/**
+ * Finishes a decryption in GCM mode, verifying the authentication tag in
+ * constant time. The context is erased afterwards.
+ *
+ * @param[in,out] ctx		- the GCM context.
+ * @param[in] tag			- the authentication tag of BC_TAG_LEN bytes.
+ * @return STS_OK if the tag is valid, STS_ERR otherwise.
+ */
+int bc_aes_gcm_dec_final(bc_gcm_t *ctx, uint8_t *tag);
+
+/**
+ * Encrypts with AES in GCM mode, appending the authentication tag to the
+ * ciphertext.
+ *
+ * @param[out] out			- the resulting ciphertext and tag.
+ * @param[in,out] out_len	- the buffer capacity and number of bytes written.
+ * @param[in] in			- the bytes to be encrypted.
+ * @param[in] in_len		- the number of bytes to encrypt.
+ * @param[in] key			- the key.
+ * @param[in] key_len		- the key size in bits.
+ * @param[in] iv			- the initialization vector.
+ * @param[in] iv_len		- the number of bytes in the initialization vector.
+ * @param[in] aad			- the additional data to authenticate.
+ * @param[in] aad_len		- the number of bytes of additional data.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+int bc_aes_gcm_enc(uint8_t *out, int *out_len, uint8_t *in, int in_len,
+		uint8_t *key, int key_len, uint8_t *iv, int iv_len, uint8_t *aad,
+		int aad_len);
+
+/**
+ * Decrypts with AES in GCM mode and verifies the authentication tag at the
+ * end of the ciphertext. The output is cleared if the tag is invalid.
+ *
+ * @param[out] out			- the resulting plaintext.
+ * @param[in,out] out_len	- the buffer capacity and number of bytes written.
+ * @param[in] in			- the ciphertext and tag.
+ * @param[in] in_len		- the number of bytes of ciphertext and tag.
+ * @param[in] key			- the key.
+ * @param[in] key_len		- the key size in bits.
+ * @param[in] iv			- the initialization vector.
+ * @param[in] iv_len		- the number of bytes in the initialization vector.
+ * @param[in] aad			- the additional data to authenticate.
+ * @param[in] aad_len		- the number of bytes of additional data.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+int bc_aes_gcm_dec(uint8_t *out, int *out_len, uint8_t *in, int in_len,
+		uint8_t *key, int key_len, uint8_t *iv, int iv_len, uint8_t *aad,
+		int aad_len);
+
+/**
+ * Encrypts or decrypts with the ChaCha20 stream cipher of RFC 8439. Several
+ * blocks are computed in parallel with SSE2 or AVX2 when available.
+ *
+ * @param[out] out			- the resulting bytes.
+ * @param[in] in			- the bytes to be encrypted or decrypted.
+ * @param[in] len			- the number of bytes.
+ * @param[in] key			- the key of BC_CHACHA_KEY bytes.
+ * @param[in] iv			- the nonce of BC_CHACHA_IV bytes.
+ * @param[in] ctr			- the initial block counter.
+ */
+void bc_chacha20(uint8_t *out, uint8_t *in, int len, uint8_t *key,
+		uint8_t *iv, uint32_t ctr);
+
+/**
+ * Starts a Poly1305 authentication. The key must be used for a single
+ * message.
+ *
+ * @param[out] ctx			- the Poly1305 context.
+ * @param[in] key			- the one-time key of 32 bytes.
+ */
+void bc_poly1305_init(bc_poly1305_t *ctx, uint8_t *key);
+
+/**
+ * Authenticates the next part of a message with Poly1305.
+ *
+ * @param[in,out] ctx		- the Poly1305 context.
+ * @param[in] in			- the bytes to authenticate.
+ * @param[in] len			- the number of bytes.
+ */
+void bc_poly1305_update(bc_poly1305_t *ctx, uint8_t *in, int len);
+
+/**
+ * Finishes a Poly1305 authentication.
+ *
+ * @param[in,out] ctx		- the Poly1305 context.
+ * @param[out] tag			- the authentication tag of BC_TAG_LEN bytes.
+ */
+void bc_poly1305_final(bc_poly1305_t *ctx, uint8_t *tag);
+
+/**
+ * Computes the Poly1305 authenticator of a message.
+ *
+ * @param[out] tag			- the authentication tag of BC_TAG_LEN bytes.
+ * @param[in] in			- the message.
+ * @param[in] len			- the number of bytes in the message.
+ * @param[in] key			- the one-time key of 32 bytes.
+ */
+void bc_poly1305(uint8_t *tag, uint8_t *in, int len, uint8_t *key);
+
+/**
+ * Starts an authenticated encryption or decryption with ChaCha20-Poly1305.
+ *
+ * @param[out] ctx			- the ChaCha20-Poly1305 context.
+ * @param[in] key			- the key.
+ * @param[in] key_len		- the key size in bits, which must be 256.
+ * @param[in] iv			- the nonce.
+ * @param[in] iv_len		- the number of bytes in the nonce, which must be
+ * 							BC_CHACHA_IV.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+int bc_chacha_init(bc_chacha_t *ctx, uint8_t *key, int key_len, uint8_t *iv,
+		int iv_len);
+
+/**
+ * Authenticates additional data with ChaCha20-Poly1305. Must be called before
+ * any data is encrypted or decrypted, and may be called several times.
+ *
+ * @param[in,out] ctx		- the ChaCha20-Poly1305 context.
+ * @param[in] aad			- the additional data.
+ * @param[in] aad_len		- the number of bytes of additional data.
+ */
+void bc_chacha_aad(bc_chacha_t *ctx, uint8_t *aad, int aad_len);
+
+/**
+ * Encrypts the next part of a message with ChaCha20-Poly1305. The output may
+ * overlap the input.
+ *
+ * @param[in,out] ctx		- the ChaCha20-Poly1305 context.
+ * @param[out] out			- the resulting ciphertext.
+ * @param[in] in			- the bytes to be encrypted.
+ * @param[in] len			- the number of bytes to encrypt.
+ */
+void bc_chacha_enc_update(bc_chacha_t *ctx, uint8_t *out, uint8_t *in,
+		int len);
+
+/**
+ * Decrypts the next part of a message with ChaCha20-Poly1305. The plaintext
+ * must not be used before the tag is verified. The output may overlap the
+ * input.
+ *
+ * @param[in,out] ctx		- the ChaCha20-Poly1305 context.
+ * @param[out] out			- the resulting plaintext.
+ * @param[in] in			- the bytes to be decrypted.
+ * @param[in] len			- the number of bytes to decrypt.
+ */
+void bc_chacha_dec_update(bc_chacha_t *ctx, uint8_t *out, uint8_t *in,
+		int len);
+
+/**
+ * Finishes an encryption with ChaCha20-Poly1305.
+ *
+ * @param[in,out] ctx		- the ChaCha20-Poly1305 context.
+ * @param[out] tag			- the authentication tag of BC_TAG_LEN bytes.
+ */
+void bc_chacha_enc_final(bc_chacha_t *ctx, uint8_t *tag);
+
+/**
+ * Finishes a decryption with ChaCha20-Poly1305, verifying the authentication
+ * tag in constant time.
+ *
+ * @param[in,out] ctx		- the ChaCha20-Poly1305 context.
+ * @param[in] tag			- the authentication tag of BC_TAG_LEN bytes.
+ * @return STS_OK if the tag is valid, STS_ERR otherwise.
+ */
+int bc_chacha_dec_final(bc_chacha_t *ctx, uint8_t *tag);
+
+/**
+ * Encrypts with ChaCha20-Poly1305, appending the authentication tag to the
+ * ciphertext.
+ *
+ * @param[out] out			- the resulting ciphertext and tag.
+ * @param[in,out] out_len	- the buffer capacity and number of bytes written.
+ * @param[in] in			- the bytes to be encrypted.
+ * @param[in] in_len		- the number of bytes to encrypt.
+ * @param[in] key			- the key.
+ * @param[in] key_len		- the key size in bits, which must be 256.
+ * @param[in] iv			- the nonce.
+ * @param[in] iv_len		- the number of bytes in the nonce.
+ * @param[in] aad			- the additional data to authenticate.
+ * @param[in] aad_len		- the number of bytes of additional data.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+int bc_chacha_enc(uint8_t *out, int *out_len, uint8_t *in, int in_len,
+		uint8_t *key, int key_len, uint8_t *iv, int iv_len, uint8_t *aad,
+		int aad_len);
+
+/**
+ * Decrypts with ChaCha20-Poly1305 and verifies the authentication tag at the
+ * end of the ciphertext. The output is cleared if the tag is invalid.
+ *
+ * @param[out] out			- the resulting plaintext.
+ * @param[in,out] out_len	- the buffer capacity and number of bytes written.
+ * @param[in] in			- the ciphertext and tag.
+ * @param[in] in_len		- the number of bytes of ciphertext and tag.
+ * @param[in] key			- the key.
+ * @param[in] key_len		- the key size in bits, which must be 256.
+ * @param[in] iv			- the nonce.
+ * @param[in] iv_len		- the number of bytes in the nonce.
+ * @param[in] aad			- the additional data to authenticate.
+ * @param[in] aad_len		- the number of bytes of additional data.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+int bc_chacha_dec(uint8_t *out, int *out_len, uint8_t *in, int in_len,
+		uint8_t *key, int key_len, uint8_t *iv, int iv_len, uint8_t *aad,
+		int aad_len);
+
 #endif /* !RELIC_BC_H */
@@ -29,6 +29,25 @@
  *
  * Interface of useful routines for benchmarking.
  *
+ * Besides the human-readable output, results can be written to a file and
+ * compared against a previous run. This is controlled by environment
+ * variables read by the first benchmark:
+ *
+ * - RELIC_BENCH_OUTPUT: file where results are written, one record per
+ *   benchmark with the mean, minimum, median, 99th percentile and standard
+ *   deviation of the samples;
+ * - RELIC_BENCH_FORMAT: "json" or "csv", chosen from the file extension of
+ *   RELIC_BENCH_OUTPUT by default;
+ * - RELIC_BENCH_BASELINE: results file from a previous run, in either format,
+ *   whose medians are compared against the current ones;
+ * - RELIC_BENCH_THRESHOLD: percentage a median may increase over the baseline
+ *   before it is flagged as a regression, 10 by default;
+ * - RELIC_BENCH_WARMUP: number of executions discarded before the first
+ *   sample of each benchmark, BENCH by default.
+ *
+ * If any regression is flagged, core_clean() returns STS_ERR and the benchmark
+ * programs exit with a failure status.
+ *
  * @ingroup bench
  */
 
@@ -65,7 +84,7 @@
  * @param[in] FUNCTION		- the function to benchmark.
  */
 #define BENCH_ONCE(LABEL, FUNCTION)											\
-	bench_reset();															\
+	bench_reset(LABEL);														\
 	util_print("BENCH: " LABEL "%*c = ", (int)(32 - strlen(LABEL)), ' ');	\
 	bench_before();															\
 	FUNCTION;																\
@@ -80,7 +99,7 @@
  * @param[in] FUNCTION		- the function to benchmark.
  */
 #define BENCH_SMALL(LABEL, FUNCTION)										\
-	bench_reset();															\
+	bench_reset(LABEL);														\
 	util_print("BENCH: " LABEL "%*c = ", (int)(32 - strlen(LABEL)), ' ');	\
 	bench_before();															\
 	for (int i = 0; i < BENCH; i++)	{										\
@@ -96,7 +115,7 @@
  * @param[in] LABEL			- the label for this benchmark.
  */
 #define BENCH_BEGIN(LABEL)													\
-	bench_reset();															\
+	bench_reset(LABEL);														\
 	util_print("BENCH: " LABEL "%*c = ", (int)(32 - strlen(LABEL)), ' ');	\
 	for (int i = 0; i < BENCH; i++)	{										\
 
@@ -109,11 +128,25 @@
 	bench_print()															\
 
 /**
- * Measures the time of one execution and adds it to the benchmark total.
+ * Prints the mean timing of each of the N operations done by every execution.
+ *
+ * @param[in] N				- the number of operations per execution.
+ */
+#define BENCH_DIV(N)														\
+	}																		\
+	bench_compute(BENCH * BENCH * (N));										\
+	bench_print()															\
+
+/**
+ * Measures the time of one sample and adds it to the benchmark total. The
+ * first sample of a benchmark is preceded by the warm-up executions.
  *
  * @param[in] FUNCTION		- the function executed.
  */
 #define BENCH_ADD(FUNCTION)													\
+	for (int _w = bench_warmup(); _w > 0; _w--) {							\
+		FUNCTION;															\
+	}																		\
 	FUNCTION;																\
 	bench_before();															\
 	for (int j = 0; j < BENCH; j++) {										\
@@ -172,7 +205,15 @@ void bench_overhead(void);
  *
  * @param[in] label			- the benchmark label.
  */
-void bench_reset(void);
+void bench_reset(const char *label);
+
+/**
+ * Returns the number of warm-up executions pending for the current benchmark
+ * and clears it.
+ *
+ * @return the number of warm-up executions.
+ */
+int bench_warmup(void);
 
 /**
  * Measures the time before a benchmark is executed.
@@ -192,10 +233,19 @@ void bench_after(void);
 void bench_compute(int benches);
 
 /**
- * Prints the last benchmark.
+ * Prints the last benchmark and records its statistics in the results file,
+ * comparing them against the baseline if one was given.
  */
 void bench_print(void);
 
+/**
+ * Finishes the results file and reports the regressions found.
+ *
+ * @return STS_ERR if some benchmark regressed over the baseline, STS_OK
+ * otherwise.
+ */
+int bench_clean(void);
+
 /**
  * Returns the result of the last benchmark.
  *
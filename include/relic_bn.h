@@ -84,6 +84,43 @@
 #define BN_SIZE		((int)BN_DIGS)
 #endif
 
+/**
+ * Size in digits from which multiplication switches from Comba to Karatsuba
+ * when the multiplication method is chosen by size. This and the following
+ * thresholds were measured with 64-bit digits and can be regenerated by
+ * running bench_bn with the RELIC_BENCH_TUNE environment variable set.
+ */
+#define BN_MUL_KARAT	48
+
+/**
+ * Size in digits from which multiplication switches from Karatsuba to Toom-3
+ * when the multiplication method is chosen by size.
+ */
+#define BN_MUL_TOOM3	96
+
+/**
+ * Size in digits from which squaring switches from Comba to Karatsuba when the
+ * squaring method is chosen by size.
+ */
+#define BN_SQR_KARAT	64
+
+/**
+ * Size in digits from which squaring switches from Karatsuba to Toom-3 when the
+ * squaring method is chosen by size.
+ */
+#define BN_SQR_TOOM3	112
+
+/**
+ * Width in bits of the windows used in fixed-base modular exponentiation.
+ */
+#define BN_XP_WIDTH		4
+
+/**
+ * Number of entries in a precomputation table for fixed-base modular
+ * exponentiation, enough for exponents of up to BN_BITS bits.
+ */
+#define BN_XP_TABLE		(BN_BITS / BN_XP_WIDTH + 1)
+
 /**
  * Positive sign of a multiple precision integer.
  */
@@ -130,6 +167,28 @@ typedef bn_st bn_t[1];
 typedef bn_st *bn_t;
 #endif
 
+/**
+ * Represents a modulus together with the values precomputed for repeated
+ * modular arithmetic with it.
+ */
+typedef struct {
+	/** The modulus. */
+	bn_t m;
+	/** The auxiliar value derived from the modulus for modular reduction. */
+	bn_t u;
+	/** The square of the Montgomery radix modulo m, if Montgomery is used. */
+	bn_t r2;
+} bn_mod_ctx_st;
+
+/**
+ * Pointer to a precomputed modulus.
+ */
+#if ALLOC == AUTO
+typedef bn_mod_ctx_st bn_mod_ctx_t[1];
+#else
+typedef bn_mod_ctx_st *bn_mod_ctx_t;
+#endif
+
 /*============================================================================*/
 /* Macro definitions                                                          */
 /*============================================================================*/
@@ -244,6 +303,100 @@ typedef bn_st *bn_t;
 
 #endif
 
+/**
+ * Initializes a precomputed modulus with a null value.
+ *
+ * @param[out] A			- the precomputed modulus to initialize.
+ */
+#if ALLOC == AUTO
+#define bn_mod_ctx_null(A)		/* empty */
+#else
+#define bn_mod_ctx_null(A)		A = NULL;
+#endif
+
+/**
+ * Calls a function to allocate and initialize a precomputed modulus.
+ *
+ * @param[out] A			- the new precomputed modulus.
+ * @throw ERR_NO_MEMORY		- if there is no available memory.
+ */
+#if ALLOC == DYNAMIC
+#define bn_mod_ctx_new(A)													\
+	A = (bn_mod_ctx_t)calloc(1, sizeof(bn_mod_ctx_st));						\
+	if (A == NULL) {														\
+		THROW(ERR_NO_MEMORY);												\
+	}																		\
+	bn_null((A)->m);														\
+	bn_null((A)->u);														\
+	bn_null((A)->r2);														\
+	bn_new((A)->m);															\
+	bn_new((A)->u);															\
+	bn_new((A)->r2);														\
+
+#elif ALLOC == STATIC
+#define bn_mod_ctx_new(A)													\
+	A = (bn_mod_ctx_t)alloca(sizeof(bn_mod_ctx_st));						\
+	if (A == NULL) {														\
+		THROW(ERR_NO_MEMORY);												\
+	}																		\
+	bn_null((A)->m);														\
+	bn_null((A)->u);														\
+	bn_null((A)->r2);														\
+	bn_new((A)->m);															\
+	bn_new((A)->u);															\
+	bn_new((A)->r2);														\
+
+#elif ALLOC == AUTO
+#define bn_mod_ctx_new(A)													\
+	bn_new((A)->m);															\
+	bn_new((A)->u);															\
+	bn_new((A)->r2);														\
+
+#elif ALLOC == STACK
+#define bn_mod_ctx_new(A)													\
+	A = (bn_mod_ctx_t)alloca(sizeof(bn_mod_ctx_st));						\
+	bn_new((A)->m);															\
+	bn_new((A)->u);															\
+	bn_new((A)->r2);														\
+
+#endif
+
+/**
+ * Calls a function to clean and free a precomputed modulus.
+ *
+ * @param[out] A			- the precomputed modulus to clean and free.
+ */
+#if ALLOC == DYNAMIC
+#define bn_mod_ctx_free(A)													\
+	if (A != NULL) {														\
+		bn_free((A)->m);													\
+		bn_free((A)->u);													\
+		bn_free((A)->r2);													\
+		free(A);															\
+		A = NULL;															\
+	}
+
+#elif ALLOC == STATIC
+#define bn_mod_ctx_free(A)													\
+	if (A != NULL) {														\
+		bn_free((A)->m);													\
+		bn_free((A)->u);													\
+		bn_free((A)->r2);													\
+		A = NULL;															\
+	}																		\
+
+#elif ALLOC == AUTO
+#define bn_mod_ctx_free(A)		/* empty */
+
+#elif ALLOC == STACK
+#define bn_mod_ctx_free(A)													\
+	bn_free((A)->m);														\
+	bn_free((A)->u);														\
+	bn_free((A)->r2);														\
+	A = NULL;																\
+
+#endif
+
 /**
  * Multiples two multiple precision integers. Computes c = a * b.
  *
@@ -257,6 +410,8 @@ typedef bn_st *bn_t;
 #define bn_mul(C, A, B)		bn_mul_basic(C, A, B)
 #elif BN_MUL == COMBA
 #define bn_mul(C, A, B)		bn_mul_comba(C, A, B)
+#elif BN_MUL == TOOMC
+#define bn_mul(C, A, B)		bn_mul_toomc(C, A, B)
 #endif
 
 /**
@@ -271,6 +426,8 @@ typedef bn_st *bn_t;
 #define bn_sqr(C, A)		bn_sqr_basic(C, A)
 #elif BN_SQR == COMBA
 #define bn_sqr(C, A)		bn_sqr_comba(C, A)
+#elif BN_SQR == TOOMC
+#define bn_sqr(C, A)		bn_sqr_toomc(C, A)
 #elif BN_SQR == MULTP
 #define bn_sqr(C, A)		bn_mul(C, A, A)
 #endif
@@ -336,7 +493,7 @@ typedef bn_st *bn_t;
  */
 #if BN_MUL == BASIC
 #define bn_mod_monty(C, A, M, U)	bn_mod_monty_basic(C, A, M, U)
-#elif BN_MUL == COMBA
+#elif BN_MUL == COMBA || BN_MUL == TOOMC
 #define bn_mod_monty(C, A, M, U)	bn_mod_monty_comba(C, A, M, U)
 #endif
 
@@ -356,6 +513,8 @@ typedef bn_st *bn_t;
 #define bn_mxp(C, A, B, M)	bn_mxp_slide(C, A, B, M)
 #elif BN_MXP == MONTY
 #define bn_mxp(C, A, B, M)	bn_mxp_monty(C, A, B, M)
+#elif BN_MXP == CONST
+#define bn_mxp(C, A, B, M)	bn_mxp_const(C, A, B, M)
 #endif
 
 /**
@@ -784,6 +943,26 @@ void bn_mul_comba(bn_t c, const bn_t a, const bn_t b);
  */
 void bn_mul_karat(bn_t c, const bn_t a, const bn_t b);
 
+/**
+ * Multiplies two multiple precision integers using one step of Toom-3
+ * multiplication.
+ *
+ * @param[out] c			- the result.
+ * @param[in] a				- the first multiple precision integer to multiply.
+ * @param[in] b				- the second multiple precision integer to multiply.
+ */
+void bn_mul_toom3(bn_t c, const bn_t a, const bn_t b);
+
+/**
+ * Multiplies two multiple precision integers choosing Comba, Karatsuba or
+ * Toom-3 multiplication by the size of the operands.
+ *
+ * @param[out] c			- the result.
+ * @param[in] a				- the first multiple precision integer to multiply.
+ * @param[in] b				- the second multiple precision integer to multiply.
+ */
+void bn_mul_toomc(bn_t c, const bn_t a, const bn_t b);
+
 /**
  * Computes the square of a multiple precision integer using Schoolbook
  * squaring.
@@ -809,6 +988,24 @@ void bn_sqr_comba(bn_t c, const bn_t a);
  */
 void bn_sqr_karat(bn_t c, const bn_t a);
 
+/**
+ * Computes the square of a multiple precision integer using one step of Toom-3
+ * squaring.
+ *
+ * @param[out] c			- the result.
+ * @param[in] a				- the multiple precision integer to square.
+ */
+void bn_sqr_toom3(bn_t c, const bn_t a);
+
+/**
+ * Computes the square of a multiple precision integer choosing Comba,
+ * Karatsuba or Toom-3 squaring by the size of the operand.
+ *
+ * @param[out] c			- the result.
+ * @param[in] a				- the multiple precision integer to square.
+ */
+void bn_sqr_toomc(bn_t c, const bn_t a);
+
 /**
  * Doubles a multiple precision. Computes c = a + a.
  *
@@ -1010,6 +1207,74 @@ void bn_mod_pre_pmers(bn_t u, const bn_t m);
  */
 void bn_mod_pmers(bn_t c, const bn_t a, const bn_t m, const bn_t u);
 
+/**
+ * Precomputes the values used for repeated modular arithmetic with a modulus.
+ *
+ * @param[out] ctx			- the precomputed modulus.
+ * @param[in] m				- the modulus.
+ * @throw ERR_NO_VALID		- if Montgomery reduction is used and m is even.
+ */
+void bn_mod_ctx_set(bn_mod_ctx_t ctx, const bn_t m);
+
+/**
+ * Compares the modulus held by a precomputed modulus with a multiple precision
+ * integer.
+ *
+ * @param[in] ctx			- the precomputed modulus.
+ * @param[in] m				- the multiple precision integer.
+ * @return CMP_LT if the modulus is less than m, CMP_EQ if they are equal and
+ * CMP_GT otherwise.
+ */
+int bn_mod_ctx_cmp(const bn_mod_ctx_t ctx, const bn_t m);
+
+/**
+ * Converts a multiple precision integer to the internal representation used
+ * for modular arithmetic with a precomputed modulus, reducing it first if
+ * needed. With Montgomery reduction this is the Montgomery form.
+ *
+ * @param[out] c			- the result.
+ * @param[in] a				- the multiple precision integer to convert.
+ * @param[in] ctx			- the precomputed modulus.
+ */
+void bn_mod_ctx_conv(bn_t c, const bn_t a, const bn_mod_ctx_t ctx);
+
+/**
+ * Converts a multiple precision integer back from the internal representation
+ * used for modular arithmetic with a precomputed modulus.
+ *
+ * @param[out] c			- the result.
+ * @param[in] a				- the multiple precision integer to convert.
+ * @param[in] ctx			- the precomputed modulus.
+ */
+void bn_mod_ctx_back(bn_t c, const bn_t a, const bn_mod_ctx_t ctx);
+
+/**
+ * Multiplies two multiple precision integers given in the internal
+ * representation of a precomputed modulus, producing a result in the same
+ * representation. With Montgomery reduction this costs one multiplication and
+ * one reduction, so chains of products should convert their inputs once with
+ * bn_mod_ctx_conv() and the result back with bn_mod_ctx_back().
+ *
+ * @param[out] c			- the result.
+ * @param[in] a				- the first multiple precision integer to multiply.
+ * @param[in] b				- the second multiple precision integer to multiply.
+ * @param[in] ctx			- the precomputed modulus.
+ */
+void bn_mod_ctx_mul(bn_t c, const bn_t a, const bn_t b, const bn_mod_ctx_t ctx);
+
+/**
+ * Multiplies two multiple precision integers modulo a precomputed modulus.
+ * Computes c = a * b mod m. The inputs must be reduced modulo m and must not
+ * be in Montgomery form, which costs a second multiplication and reduction
+ * with Montgomery reduction.
+ *
+ * @param[out] c			- the result.
+ * @param[in] a				- the first multiple precision integer to multiply.
+ * @param[in] b				- the second multiple precision integer to multiply.
+ * @param[in] ctx			- the precomputed modulus.
+ */
+void bn_mul_mod_ctx(bn_t c, const bn_t a, const bn_t b, const bn_mod_ctx_t ctx);
+
 /**
  * Exponentiates a multiple precision integer modulo a modulus using the binary
  * method.
@@ -1043,6 +1308,31 @@ void bn_mxp_slide(bn_t c, const bn_t a, const bn_t b, const bn_t m);
  */
 void bn_mxp_monty(bn_t c, const bn_t a, const bn_t b, const bn_t m);
 
+/**
+ * Exponentiates a multiple precision integer modulo a modulus in constant time
+ * using a fixed window. The precomputed table is interleaved and every entry
+ * is read when looking up a window, so that the memory access pattern does not
+ * depend on the exponent.
+ *
+ * @param[out] c			- the result.
+ * @param[in] a				- the basis.
+ * @param[in] b				- the exponent.
+ * @param[in] m				- the modulus.
+ */
+void bn_mxp_const(bn_t c, const bn_t a, const bn_t b, const bn_t m);
+
+/**
+ * Exponentiates a multiple precision integer modulo a precomputed modulus in
+ * constant time using a fixed window.
+ *
+ * @param[out] c			- the result.
+ * @param[in] a				- the basis.
+ * @param[in] b				- the exponent.
+ * @param[in] ctx			- the precomputed modulus.
+ */
+void bn_mxp_const_ctx(bn_t c, const bn_t a, const bn_t b,
+		const bn_mod_ctx_t ctx);
+
 /**
  * Exponentiates a multiple precision integer by a small power modulo a modulus
  * using the binary method.
@@ -1054,6 +1344,54 @@ void bn_mxp_monty(bn_t c, const bn_t a, const bn_t b, const bn_t m);
  */
 void bn_mxp_dig(bn_t c, const bn_t a, dig_t b, const bn_t m);
 
+/**
+ * Exponentiates a multiple precision integer modulo a precomputed modulus with
+ * the configured exponentiation method. Computes c = a^b mod m. The basis must
+ * not be in Montgomery form.
+ *
+ * @param[out] c			- the result.
+ * @param[in] a				- the basis.
+ * @param[in] b				- the exponent.
+ * @param[in] ctx			- the precomputed modulus.
+ */
+void bn_mxp_ctx(bn_t c, const bn_t a, const bn_t b, const bn_mod_ctx_t ctx);
+
+/**
+ * Exponentiates a multiple precision integer by a small power modulo a
+ * precomputed modulus using the binary method. This is faster than the
+ * configured method for short public exponents such as 3 or 65537.
+ *
+ * @param[out] c			- the result.
+ * @param[in] a				- the basis.
+ * @param[in] b				- the exponent.
+ * @param[in] ctx			- the precomputed modulus.
+ */
+void bn_mxp_dig_ctx(bn_t c, const bn_t a, dig_t b, const bn_mod_ctx_t ctx);
+
+/**
+ * Builds a precomputation table for fixed-base modular exponentiation. The
+ * i-th entry is a^(2^(BN_XP_WIDTH * i)) mod m, stored in the representation
+ * used internally by the precomputed modulus.
+ *
+ * @param[out] t			- the precomputation table with BN_XP_TABLE entries.
+ * @param[in] a				- the basis.
+ * @param[in] ctx			- the precomputed modulus.
+ */
+void bn_mxp_pre(bn_t *t, const bn_t a, const bn_mod_ctx_t ctx);
+
+/**
+ * Exponentiates a fixed basis modulo a precomputed modulus using Yao's
+ * windowing method and a precomputation table. Computes c = a^b mod m. The
+ * running time depends on the exponent, as in the configured method.
+ *
+ * @param[out] c			- the result.
+ * @param[in] t				- the precomputation table of the basis.
+ * @param[in] b				- the exponent.
+ * @param[in] ctx			- the precomputed modulus.
+ * @throw ERR_NO_VALID		- if the exponent is negative or too large.
+ */
+void bn_mxp_fix(bn_t c, const bn_t *t, const bn_t b, const bn_mod_ctx_t ctx);
+
 /**
  * Extracts an approximate integer square-root of a multiple precision integer.
  *
@@ -49,6 +49,7 @@
 #include "relic_bench.h"
 #include "relic_rand.h"
 #include "relic_pool.h"
+#include "relic_multi.h"
 #include "relic_label.h"
 
 #if MULTI != NONE
@@ -150,7 +151,7 @@ typedef struct _ctx_t {
 	sts_t *last;
 	/** Error state to be used outside try-catch blocks. */
 	sts_t error;
-	/** Error number to be used outside try-catch blocks. */
+	/** Error number to be used outside try-catch blocks, or error flag. */
 	err_t number;
 	/** The error message respective to the last error. */
 	char *reason[ERR_MAX];
@@ -163,13 +164,6 @@ typedef struct _ctx_t {
 	int trace;
 #endif /* CHECK && TRACE */
 
-#if ALLOC == STATIC
-	/** The static pool of digit vectors. */
-	pool_t pool[POOL_SIZE];
-	/** The index of the next free digit vector in the pool. */
-	int next;
-#endif /* ALLOC == STATIC */
-
 #ifdef WITH_FB
 	/** Identifier of the currently configured binary field. */
 	int fb_id;
@@ -377,6 +371,14 @@ typedef struct _ctx_t {
 	bench_t after;
 	/** Stores the sum of timings for the current benchmark. */
 	long long total;
+	/** Stores the timings of each sample of the current benchmark. */
+	long long samples[BENCH];
+	/** Number of samples collected for the current benchmark. */
+	int sampled;
+	/** Number of warm-up executions still pending for the current benchmark. */
+	int warmup;
+	/** The label of the current benchmark. */
+	const char *label;
 #ifdef OVERH
 	/** Benchmarking overhead to be measured and subtracted from benchmarks. */
 	long long over;
@@ -394,6 +396,14 @@ typedef struct _ctx_t {
 	int seeded;
 	/** Counter to keep track of number of calls since last seeding. */
 	int counter;
+#if RAND != CALL && RAND_BUF > 0
+	/** Buffered output of the PRNG used to serve small requests. */
+	uint8_t rand_buf[RAND_BUF];
+	/** Number of unused bytes at the end of the output buffer. */
+	int rand_len;
+#endif
+	/** Number of threads used to process batches of operations. */
+	int cores;
 } ctx_t;
 
 #ifdef TRACE
@@ -426,7 +436,8 @@ int core_init(void);
 /**
  * Finalizes the library.
  *
- * @return STS_OK if no error occurs, STS_ERR otherwise.
+ * @return STS_OK if no error occurs, STS_ERR otherwise or if a benchmark
+ * regressed over the baseline.
  */
 int core_clean(void);
 
@@ -75,7 +75,9 @@
 /*============================================================================*/
 
 /**
- * Represents an RSA key pair.
+ * Represents an RSA key pair. The precomputed moduli are filled by the key
+ * generation functions, or by cp_rsa_prepare() for a key whose fields were set
+ * directly.
  */
 typedef struct _rsa_t {
 	/** The modulus n = pq. */
@@ -94,6 +96,12 @@ typedef struct _rsa_t {
 	bn_t dq;
 	/** The inverse of q modulo p. */
 	bn_t qi;
+	/** The precomputed modulus n. */
+	bn_mod_ctx_t mn;
+	/** The precomputed modulus p. */
+	bn_mod_ctx_t mp;
+	/** The precomputed modulus q. */
+	bn_mod_ctx_t mq;
 } rsa_st;
 
 /**
@@ -131,7 +139,9 @@ typedef rabin_st *rabin_t;
 #endif
 
 /**
- * Represents a Benaloh's Dense Probabilistic Encryption key pair.
+ * Represents a Benaloh's Dense Probabilistic Encryption key pair. The
+ * precomputed modulus is filled by cp_bdpe_gen(), or by cp_bdpe_prepare() for
+ * a key whose fields were set directly.
  */
 typedef struct _bdpe_t {
 	/** The modulus n = pq. */
@@ -144,6 +154,8 @@ typedef struct _bdpe_t {
 	bn_t y;
 	/** The divisor of (p-1) such that gcd(t, (p-1)/t) = gcd(t, q-1) = 1. */
 	dig_t t;
+	/** The precomputed modulus n. */
+	bn_mod_ctx_t mn;
 } bdpe_st;
 
 /**
@@ -155,6 +167,71 @@ typedef bdpe_st bdpe_t[1];
 typedef bdpe_st *bdpe_t;
 #endif
 
+/**
+ * Represents a Paillier's Homomorphic Probabilistic Encryption key pair.
+ */
+typedef struct _phpe_t {
+	/** The modulus n = pq. */
+	bn_t n;
+	/** The first prime p. */
+	bn_t p;
+	/** The second prime q. */
+	bn_t q;
+	/** The inverse of q modulo p. */
+	bn_t qi;
+	/** The inverse of -q modulo p, used to recover the plaintext mod p. */
+	bn_t hp;
+	/** The inverse of -p modulo q, used to recover the plaintext mod q. */
+	bn_t hq;
+	/** The precomputed modulus n^2. */
+	bn_mod_ctx_t mn;
+	/** The precomputed modulus p^2. */
+	bn_mod_ctx_t mp;
+	/** The precomputed modulus q^2. */
+	bn_mod_ctx_t mq;
+} phpe_st;
+
+/**
+ * Pointer to a Paillier's Homomorphic Probabilistic Encryption key pair.
+ */
+#if ALLOC == AUTO
+typedef phpe_st phpe_t[1];
+#else
+typedef phpe_st *phpe_t;
+#endif
+
+/**
+ * Represents a baby-step giant-step table for discrete logarithms of group
+ * elements with exponents in a range [0, max). The baby steps are indexed by
+ * a fingerprint of their serialization. The storage of the table is always
+ * taken from the heap.
+ */
+typedef struct _dlog_t {
+	/** The size of the range of exponents. */
+	int max;
+	/** The number of baby steps. */
+	int m;
+	/** The number of slots in the hash table, a power of two. */
+	int cap;
+	/** The fingerprints of the baby steps. */
+	uint64_t *key;
+	/** The exponents of the baby steps, or -1 if the slot is empty. */
+	int *val;
+	/** The serialized giant step. */
+	uint8_t *step;
+	/** The length of the serialized giant step in bytes. */
+	int len;
+} dlog_st;
+
+/**
+ * Pointer to a baby-step giant-step table.
+ */
+#if ALLOC == AUTO
+typedef dlog_st dlog_t[1];
+#else
+typedef dlog_st *dlog_t;
+#endif
+
 /**
  * Represents a SOKAKA key pair.
  */
@@ -277,6 +354,9 @@ typedef vbnn_ibs_user_st *vbnn_ibs_user_t;
 	bn_null((A)->p);														\
 	bn_null((A)->q);														\
 	bn_null((A)->qi);														\
+	bn_mod_ctx_null((A)->mn);												\
+	bn_mod_ctx_null((A)->mp);												\
+	bn_mod_ctx_null((A)->mq);												\
 	bn_new((A)->e);															\
 	bn_new((A)->n);															\
 	bn_new((A)->d);															\
@@ -285,6 +365,9 @@ typedef vbnn_ibs_user_st *vbnn_ibs_user_t;
 	bn_new((A)->p);															\
 	bn_new((A)->q);															\
 	bn_new((A)->qi);														\
+	bn_mod_ctx_new((A)->mn);												\
+	bn_mod_ctx_new((A)->mp);												\
+	bn_mod_ctx_new((A)->mq);												\
 
 #elif ALLOC == STATIC
 #define rsa_new(A)															\
@@ -300,6 +383,9 @@ typedef vbnn_ibs_user_st *vbnn_ibs_user_t;
 	bn_null((A)->p);														\
 	bn_null((A)->q);														\
 	bn_null((A)->qi);														\
+	bn_mod_ctx_null((A)->mn);												\
+	bn_mod_ctx_null((A)->mp);												\
+	bn_mod_ctx_null((A)->mq);												\
 	bn_new((A)->e);															\
 	bn_new((A)->n);															\
 	bn_new((A)->d);															\
@@ -308,6 +394,9 @@ typedef vbnn_ibs_user_st *vbnn_ibs_user_t;
 	bn_new((A)->p);															\
 	bn_new((A)->q);															\
 	bn_new((A)->qi);														\
+	bn_mod_ctx_new((A)->mn);												\
+	bn_mod_ctx_new((A)->mp);												\
+	bn_mod_ctx_new((A)->mq);												\
 
 #elif ALLOC == AUTO
 #define rsa_new(A)															\
@@ -319,6 +408,9 @@ typedef vbnn_ibs_user_st *vbnn_ibs_user_t;
 	bn_new((A)->p);															\
 	bn_new((A)->q);															\
 	bn_new((A)->qi);														\
+	bn_mod_ctx_new((A)->mn);												\
+	bn_mod_ctx_new((A)->mp);												\
+	bn_mod_ctx_new((A)->mq);												\
 
 #elif ALLOC == STACK
 #define rsa_new(A)															\
@@ -331,6 +423,9 @@ typedef vbnn_ibs_user_st *vbnn_ibs_user_t;
 	bn_new((A)->p);															\
 	bn_new((A)->q);															\
 	bn_new((A)->qi);														\
+	bn_mod_ctx_new((A)->mn);												\
+	bn_mod_ctx_new((A)->mp);												\
+	bn_mod_ctx_new((A)->mq);												\
 
 #endif
 
@@ -350,6 +445,9 @@ typedef vbnn_ibs_user_st *vbnn_ibs_user_t;
 		bn_free((A)->p);													\
 		bn_free((A)->q);													\
 		bn_free((A)->qi);													\
+		bn_mod_ctx_free((A)->mn);											\
+		bn_mod_ctx_free((A)->mp);											\
+		bn_mod_ctx_free((A)->mq);											\
 		free(A);															\
 		A = NULL;															\
 	}
@@ -365,6 +463,9 @@ typedef vbnn_ibs_user_st *vbnn_ibs_user_t;
 		bn_free((A)->p);													\
 		bn_free((A)->q);													\
 		bn_free((A)->qi);													\
+		bn_mod_ctx_free((A)->mn);											\
+		bn_mod_ctx_free((A)->mp);											\
+		bn_mod_ctx_free((A)->mq);											\
 		A = NULL;															\
 	}																		\
 
@@ -381,6 +482,9 @@ typedef vbnn_ibs_user_st *vbnn_ibs_user_t;
 	bn_free((A)->p);														\
 	bn_free((A)->q);														\
 	bn_free((A)->qi);														\
+	bn_mod_ctx_free((A)->mn);												\
+	bn_mod_ctx_free((A)->mp);												\
+	bn_mod_ctx_free((A)->mq);												\
 	A = NULL;																\
 
 #endif
@@ -512,6 +616,7 @@ typedef vbnn_ibs_user_st *vbnn_ibs_user_t;
 	bn_new((A)->y);															\
 	bn_new((A)->p);															\
 	bn_new((A)->q);															\
+	bn_mod_ctx_new((A)->mn);												\
 	(A)->t = 0;																\
 
 #elif ALLOC == STATIC
@@ -524,6 +629,7 @@ typedef vbnn_ibs_user_st *vbnn_ibs_user_t;
 	bn_new((A)->y);															\
 	bn_new((A)->p);															\
 	bn_new((A)->q);															\
+	bn_mod_ctx_new((A)->mn);												\
 	(A)->t = 0;																\
 
 #elif ALLOC == AUTO
@@ -532,6 +638,7 @@ typedef vbnn_ibs_user_st *vbnn_ibs_user_t;
 	bn_new((A)->y);															\
 	bn_new((A)->p);															\
 	bn_new((A)->q);															\
+	bn_mod_ctx_new((A)->mn);												\
 	(A)->t = 0;																\
 
 #elif ALLOC == STACK
@@ -541,6 +648,7 @@ typedef vbnn_ibs_user_st *vbnn_ibs_user_t;
 	bn_new((A)->y);															\
 	bn_new((A)->p);															\
 	bn_new((A)->q);															\
+	bn_mod_ctx_new((A)->mn);												\
 
 #endif
 
@@ -556,6 +664,7 @@ typedef vbnn_ibs_user_st *vbnn_ibs_user_t;
 		bn_free((A)->y);													\
 		bn_free((A)->p);													\
 		bn_free((A)->q);													\
+		bn_mod_ctx_free((A)->mn);											\
 		(A)->t = 0;															\
 		free(A);															\
 		A = NULL;															\
@@ -568,6 +677,7 @@ typedef vbnn_ibs_user_st *vbnn_ibs_user_t;
 		bn_free((A)->y);													\
 		bn_free((A)->p);													\
 		bn_free((A)->q);													\
+		bn_mod_ctx_free((A)->mn);											\
 		(A)->t = 0;															\
 		A = NULL;															\
 	}																		\
@@ -581,11 +691,225 @@ typedef vbnn_ibs_user_st *vbnn_ibs_user_t;
 	bn_free((A)->y);														\
 	bn_free((A)->p);														\
 	bn_free((A)->q);														\
+	bn_mod_ctx_free((A)->mn);												\
 	(A)->t = 0;																\
 	A = NULL;																\
 
 #endif
 
+/**
+ * Initializes a Paillier's key pair with a null value.
+ *
+ * @param[out] A			- the key pair to initialize.
+ */
+#if ALLOC == AUTO
+#define phpe_null(A)			/* empty */
+#else
+#define phpe_null(A)			A = NULL;
+#endif
+
+/**
+ * Calls a function to allocate and initialize a Paillier's key pair.
+ *
+ * @param[out] A			- the new key pair.
+ */
+#if ALLOC == DYNAMIC
+#define phpe_new(A)															\
+	A = (phpe_t)calloc(1, sizeof(phpe_st));									\
+	if (A == NULL) {														\
+		THROW(ERR_NO_MEMORY);												\
+	}																		\
+	bn_new((A)->n);															\
+	bn_new((A)->p);															\
+	bn_new((A)->q);															\
+	bn_new((A)->qi);														\
+	bn_new((A)->hp);														\
+	bn_new((A)->hq);														\
+	bn_mod_ctx_new((A)->mn);												\
+	bn_mod_ctx_new((A)->mp);												\
+	bn_mod_ctx_new((A)->mq);												\
+
+#elif ALLOC == STATIC
+#define phpe_new(A)															\
+	A = (phpe_t)alloca(sizeof(phpe_st));									\
+	if (A == NULL) {														\
+		THROW(ERR_NO_MEMORY);												\
+	}																		\
+	bn_new((A)->n);															\
+	bn_new((A)->p);															\
+	bn_new((A)->q);															\
+	bn_new((A)->qi);														\
+	bn_new((A)->hp);														\
+	bn_new((A)->hq);														\
+	bn_mod_ctx_new((A)->mn);												\
+	bn_mod_ctx_new((A)->mp);												\
+	bn_mod_ctx_new((A)->mq);												\
+
+#elif ALLOC == AUTO
+#define phpe_new(A)															\
+	bn_new((A)->n);															\
+	bn_new((A)->p);															\
+	bn_new((A)->q);															\
+	bn_new((A)->qi);														\
+	bn_new((A)->hp);														\
+	bn_new((A)->hq);														\
+	bn_mod_ctx_new((A)->mn);												\
+	bn_mod_ctx_new((A)->mp);												\
+	bn_mod_ctx_new((A)->mq);												\
+
+#elif ALLOC == STACK
+#define phpe_new(A)															\
+	A = (phpe_t)alloca(sizeof(phpe_st));									\
+	bn_new((A)->n);															\
+	bn_new((A)->p);															\
+	bn_new((A)->q);															\
+	bn_new((A)->qi);														\
+	bn_new((A)->hp);														\
+	bn_new((A)->hq);														\
+	bn_mod_ctx_new((A)->mn);												\
+	bn_mod_ctx_new((A)->mp);												\
+	bn_mod_ctx_new((A)->mq);												\
+
+#endif
+
+/**
+ * Calls a function to clean and free a Paillier's key pair.
+ *
+ * @param[out] A			- the key pair to clean and free.
+ */
+#if ALLOC == DYNAMIC
+#define phpe_free(A)														\
+	if (A != NULL) {														\
+		bn_free((A)->n);													\
+		bn_free((A)->p);													\
+		bn_free((A)->q);													\
+		bn_free((A)->qi);													\
+		bn_free((A)->hp);													\
+		bn_free((A)->hq);													\
+		bn_mod_ctx_free((A)->mn);											\
+		bn_mod_ctx_free((A)->mp);											\
+		bn_mod_ctx_free((A)->mq);											\
+		free(A);															\
+		A = NULL;															\
+	}
+
+#elif ALLOC == STATIC
+#define phpe_free(A)														\
+	if (A != NULL) {														\
+		bn_free((A)->n);													\
+		bn_free((A)->p);													\
+		bn_free((A)->q);													\
+		bn_free((A)->qi);													\
+		bn_free((A)->hp);													\
+		bn_free((A)->hq);													\
+		bn_mod_ctx_free((A)->mn);											\
+		bn_mod_ctx_free((A)->mp);											\
+		bn_mod_ctx_free((A)->mq);											\
+		A = NULL;															\
+	}																		\
+
+#elif ALLOC == AUTO
+#define phpe_free(A)			/* empty */
+
+#elif ALLOC == STACK
+#define phpe_free(A)														\
+	bn_free((A)->n);														\
+	bn_free((A)->p);														\
+	bn_free((A)->q);														\
+	bn_free((A)->qi);														\
+	bn_free((A)->hp);														\
+	bn_free((A)->hq);														\
+	bn_mod_ctx_free((A)->mn);												\
+	bn_mod_ctx_free((A)->mp);												\
+	bn_mod_ctx_free((A)->mq);												\
+	A = NULL;																\
+
+#endif
+
+/**
+ * Initializes a baby-step giant-step table with a null value.
+ *
+ * @param[out] A			- the table to initialize.
+ */
+#if ALLOC == AUTO
+#define dlog_null(A)			/* empty */
+#else
+#define dlog_null(A)			A = NULL;
+#endif
+
+/**
+ * Calls a function to allocate and initialize an empty baby-step giant-step
+ * table.
+ *
+ * @param[out] A			- the new table.
+ */
+#if ALLOC == DYNAMIC
+#define dlog_new(A)															\
+	A = (dlog_t)calloc(1, sizeof(dlog_st));									\
+	if (A == NULL) {														\
+		THROW(ERR_NO_MEMORY);												\
+	}																		\
+	(A)->max = (A)->m = (A)->cap = (A)->len = 0;							\
+	(A)->key = NULL;														\
+	(A)->val = NULL;														\
+	(A)->step = NULL;														\
+
+#elif ALLOC == STATIC || ALLOC == STACK
+#define dlog_new(A)															\
+	A = (dlog_t)alloca(sizeof(dlog_st));									\
+	if (A == NULL) {														\
+		THROW(ERR_NO_MEMORY);												\
+	}																		\
+	(A)->max = (A)->m = (A)->cap = (A)->len = 0;							\
+	(A)->key = NULL;														\
+	(A)->val = NULL;														\
+	(A)->step = NULL;														\
+
+#elif ALLOC == AUTO
+#define dlog_new(A)															\
+	(A)->max = (A)->m = (A)->cap = (A)->len = 0;							\
+	(A)->key = NULL;														\
+	(A)->val = NULL;														\
+	(A)->step = NULL;														\
+
+#endif
+
+/**
+ * Calls a function to clean and free a baby-step giant-step table and its
+ * storage.
+ *
+ * @param[out] A			- the table to clean and free.
+ */
+#if ALLOC == DYNAMIC
+#define dlog_free(A)														\
+	if (A != NULL) {														\
+		free((A)->key);														\
+		free((A)->val);														\
+		free((A)->step);													\
+		free(A);															\
+		A = NULL;															\
+	}
+
+#elif ALLOC == STATIC || ALLOC == STACK
+#define dlog_free(A)														\
+	if (A != NULL) {														\
+		free((A)->key);														\
+		free((A)->val);														\
+		free((A)->step);													\
+		A = NULL;															\
+	}
+
+#elif ALLOC == AUTO
+#define dlog_free(A)														\
+	free((A)->key);															\
+	free((A)->val);															\
+	free((A)->step);														\
+	(A)->key = NULL;														\
+	(A)->val = NULL;														\
+	(A)->step = NULL;														\
+
+#endif
+
 /**
  * Initializes a SOKAKA key pair with a null value.
  *
@@ -1005,6 +1329,18 @@ typedef vbnn_ibs_user_st *vbnn_ibs_user_t;
 /* Function prototypes                                                        */
 /*============================================================================*/
 
+/**
+ * Precomputes the moduli of an RSA key whose fields were set directly, for
+ * instance when importing a key from storage. Keys produced by the key
+ * generation functions are already prepared. The operations only read the key
+ * and reject one that was not prepared, so a prepared key can be shared by
+ * several threads.
+ *
+ * @param[in,out] key		- the public or private key.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+int cp_rsa_prepare(rsa_t key);
+
 /**
  * Generates a key pair for the basic RSA algorithm.
  *
@@ -1016,7 +1352,9 @@ typedef vbnn_ibs_user_st *vbnn_ibs_user_t;
 int cp_rsa_gen_basic(rsa_t pub, rsa_t prv, int bits);
 
 /**
- * Generates a key pair for fast RSA operations with the CRT optimization.
+ * Generates a key pair for fast RSA operations with the CRT optimization. The
+ * primes p and q are searched on two threads when the thread pool has more
+ * than one core.
  *
  * @param[out] pub			- the public key.
  * @param[out] prv			- the private key.
@@ -1025,6 +1363,24 @@ int cp_rsa_gen_basic(rsa_t pub, rsa_t prv, int bits);
  */
 int cp_rsa_gen_quick(rsa_t pub, rsa_t prv, int bits);
 
+/**
+ * Generates a batch of key pairs for Fiat's batch RSA. The key pairs share the
+ * same modulus and have distinct small prime public exponents, so that private
+ * operations under different keys of the batch can share one exponentiation.
+ * The public exponents are the smallest odd primes coprime to phi(n), that is,
+ * typically e = 3, 5, 7, ... in order. Such small exponents are only safe
+ * with a padding scheme and a strict verifier. Since the modulus is shared,
+ * any single private key of the batch factors it, so all key pairs of the
+ * batch must belong to the same owner.
+ *
+ * @param[out] pub			- the public keys.
+ * @param[out] prv			- the private keys.
+ * @param[in] n				- the number of key pairs.
+ * @param[in] bits			- the key length in bits.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+int cp_rsa_gen_batch(rsa_t *pub, rsa_t *prv, int n, int bits);
+
 /**
  * Encrypts using the RSA cryptosystem.
  *
@@ -1051,7 +1407,9 @@ int cp_rsa_dec_basic(uint8_t *out, int *out_len, uint8_t *in, int in_len,
 		rsa_t prv);
 
 /**
- * Decrypts using the fast RSA decryption with CRT optimization.
+ * Decrypts using the fast RSA decryption with CRT optimization. The
+ * exponentiations modulo p and q run on two threads when the thread pool has
+ * more than one core.
  *
  * @param[out] out			- the output buffer.
  * @param[in, out] out_len	- the buffer capacity and number of bytes written.
@@ -1063,6 +1421,26 @@ int cp_rsa_dec_basic(uint8_t *out, int *out_len, uint8_t *in, int in_len,
 int cp_rsa_dec_quick(uint8_t *out, int *out_len, uint8_t *in, int in_len,
 		rsa_t prv);
 
+/**
+ * Decrypts a batch of ciphertexts, the i-th one under the i-th private key. If
+ * the keys were generated by cp_rsa_gen_batch(), a single full exponentiation
+ * serves the whole batch. Otherwise, the ciphertexts are decrypted
+ * independently on the thread pool. A malformed ciphertext, or one that is not
+ * invertible modulo its key, is rejected alone and does not prevent the others
+ * from being decrypted.
+ *
+ * @param[out] v			- the result of each decryption, or NULL.
+ * @param[out] out			- the output buffers.
+ * @param[in, out] out_len	- the buffer capacities and numbers of bytes written.
+ * @param[in] in			- the input buffers.
+ * @param[in] in_len		- the numbers of bytes to decrypt.
+ * @param[in] prv			- the private keys.
+ * @param[in] n				- the number of ciphertexts.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+int cp_rsa_dec_batch(int *v, uint8_t **out, int *out_len, uint8_t **in,
+		int *in_len, rsa_t *prv, int n);
+
 /**
  * Signs using the basic RSA signature algorithm. The flag must be non-zero if
  * the message being signed is already a hash value.
@@ -1080,7 +1458,9 @@ int cp_rsa_sig_basic(uint8_t *sig, int *sig_len, uint8_t *msg, int msg_len,
 
 /**
  * Signs using the fast RSA signature algorithm with CRT optimization. The flag
- * must be non-zero if the message being signed is already a hash value.
+ * must be non-zero if the message being signed is already a hash value. The
+ * exponentiations modulo p and q run on two threads when the thread pool has
+ * more than one core.
  *
  * @param[out] sig			- the signature
  * @param[out] sig_len		- the number of bytes written in the signature.
@@ -1093,6 +1473,25 @@ int cp_rsa_sig_basic(uint8_t *sig, int *sig_len, uint8_t *msg, int msg_len,
 int cp_rsa_sig_quick(uint8_t *sig, int *sig_len, uint8_t *msg, int msg_len,
 		int hash, rsa_t prv);
 
+/**
+ * Signs a batch of messages, the i-th one under the i-th private key. If the
+ * keys were generated by cp_rsa_gen_batch(), a single full exponentiation
+ * serves the whole batch. Otherwise, the messages are signed independently on
+ * the thread pool. The flag must be non-zero if the messages are already hash
+ * values.
+ *
+ * @param[out] sig			- the signatures.
+ * @param[in, out] sig_len	- the buffer capacities and numbers of bytes written.
+ * @param[in] msg			- the messages to sign.
+ * @param[in] msg_len		- the numbers of bytes to sign.
+ * @param[in] hash			- the flag to indicate the message format.
+ * @param[in] prv			- the private keys.
+ * @param[in] n				- the number of messages.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+int cp_rsa_sig_batch(uint8_t **sig, int *sig_len, uint8_t **msg, int *msg_len,
+		int hash, rsa_t *prv, int n);
+
 /**
  * Verifies an RSA signature. The flag must be non-zero if the message being
  * signed is already a hash value.
@@ -1108,6 +1507,24 @@ int cp_rsa_sig_quick(uint8_t *sig, int *sig_len, uint8_t *msg, int msg_len,
 int cp_rsa_ver(uint8_t *sig, int sig_len, uint8_t *msg, int msg_len, int hash,
 		rsa_t pub);
 
+/**
+ * Verifies a batch of RSA signatures under the same public key, distributing
+ * the verifications among the available cores. The flag must be non-zero if
+ * the messages are already hash values.
+ *
+ * @param[out] v			- the result of each verification, or NULL.
+ * @param[in] sig			- the signatures to verify.
+ * @param[in] sig_len		- the signature lengths in bytes.
+ * @param[in] msg			- the signed messages.
+ * @param[in] msg_len		- the message lengths in bytes.
+ * @param[in] hash			- the flag to indicate the message format.
+ * @param[in] pub			- the public key.
+ * @param[in] n				- the number of signatures.
+ * @return a boolean value indicating if all signatures are valid.
+ */
+int cp_rsa_ver_batch(int *v, uint8_t **sig, int *sig_len, uint8_t **msg,
+		int *msg_len, int hash, rsa_t pub, int n);
+
 /**
  * Generates a key pair for the Rabin cryptosystem.
  *
@@ -1144,6 +1561,84 @@ int cp_rabin_enc(uint8_t *out, int *out_len, uint8_t *in, int in_len,
 int cp_rabin_dec(uint8_t *out, int *out_len, uint8_t *in, int in_len,
 		rabin_t prv);
 
+/**
+ * Prepares an empty baby-step giant-step table for exponents in [0, max).
+ *
+ * @param[out] d			- the table.
+ * @param[in] max			- the size of the range of exponents.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+int cp_dlog_init(dlog_t d, int max);
+
+/**
+ * Inserts a baby step into a baby-step giant-step table.
+ *
+ * @param[in,out] d			- the table.
+ * @param[in] bin			- the serialized group element g^j.
+ * @param[in] len			- the length of the serialization in bytes.
+ * @param[in] j				- the exponent, smaller than the number of baby steps.
+ */
+void cp_dlog_add(dlog_t d, uint8_t *bin, int len, int j);
+
+/**
+ * Looks up a group element among the baby steps of a table.
+ *
+ * @param[in] d				- the table.
+ * @param[in] bin			- the serialized group element.
+ * @param[in] len			- the length of the serialization in bytes.
+ * @return the exponent j of the baby step g^j, or -1 if there is none.
+ */
+int cp_dlog_get(dlog_t d, uint8_t *bin, int len);
+
+/**
+ * Stores the giant step g^(-m) of a table, where m is the number of baby
+ * steps.
+ *
+ * @param[in,out] d			- the table.
+ * @param[in] bin			- the serialized giant step.
+ * @param[in] len			- the length of the serialization in bytes.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+int cp_dlog_step(dlog_t d, uint8_t *bin, int len);
+
+/**
+ * Returns the number of bytes necessary to store a baby-step giant-step table.
+ *
+ * @param[in] d				- the table.
+ * @return the number of bytes.
+ */
+int cp_dlog_size_bin(dlog_t d);
+
+/**
+ * Writes a baby-step giant-step table to a byte vector, so that it can be
+ * persisted and loaded again without recomputing the baby steps.
+ *
+ * @param[out] bin			- the byte vector.
+ * @param[in] len			- the buffer capacity.
+ * @param[in] d				- the table.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+int cp_dlog_write_bin(uint8_t *bin, int len, dlog_t d);
+
+/**
+ * Reads a baby-step giant-step table from a byte vector.
+ *
+ * @param[out] d			- the table.
+ * @param[in] bin			- the byte vector.
+ * @param[in] len			- the buffer capacity.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+int cp_dlog_read_bin(dlog_t d, uint8_t *bin, int len);
+
+/**
+ * Precomputes the modulus of a Benaloh's key whose fields were set directly.
+ * Keys produced by cp_bdpe_gen() are already prepared.
+ *
+ * @param[in,out] key		- the public or private key.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+int cp_bdpe_prepare(bdpe_t key);
+
 /**
  * Generates a key pair for Benaloh's Dense Probabilistic Encryption.
  *
@@ -1178,14 +1673,40 @@ int cp_bdpe_enc(uint8_t *out, int *out_len, dig_t in, bdpe_t pub);
 int cp_bdpe_dec(dig_t *out, uint8_t *in, int in_len, bdpe_t prv);
 
 /**
- * Generates a key pair for Paillier's Homomorphic Probabilistic Encryption.
+ * Builds the baby-step giant-step table used to decrypt with a Benaloh's
+ * private key. The table covers the whole block [0, t) and needs O(sqrt(t))
+ * storage.
+ *
+ * @param[out] d			- the table.
+ * @param[in] prv			- the private key.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+int cp_bdpe_pre(dlog_t d, bdpe_t prv);
+
+/**
+ * Decrypts using Benaloh's cryptosystem and a baby-step giant-step table, in
+ * O(sqrt(t)) multiplications.
+ *
+ * @param[out] out			- the decrypted small integer.
+ * @param[in] in			- the input buffer.
+ * @param[in] in_len		- the number of bytes to decrypt.
+ * @param[in] d				- the table built by cp_bdpe_pre().
+ * @param[in] prv			- the private key.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+int cp_bdpe_dec_fix(dig_t *out, uint8_t *in, int in_len, dlog_t d,
+		bdpe_t prv);
+
+/**
+ * Generates a key pair for Paillier's Homomorphic Probabilistic Encryption
+ * with generator g = n + 1.
  *
- * @param[out] n			- the public key.
- * @param[out] l			- the private key.
+ * @param[out] pub			- the public key.
+ * @param[out] prv			- the private key.
  * @param[in] bits			- the key length in bits.
  * @return STS_OK if no errors occurred, STS_ERR otherwise.
  */
-int cp_phpe_gen(bn_t n, bn_t l, int bits);
+int cp_phpe_gen(phpe_t pub, phpe_t prv, int bits);
 
 /**
  * Encrypts using the Paillier cryptosystem.
@@ -1194,25 +1715,101 @@ int cp_phpe_gen(bn_t n, bn_t l, int bits);
  * @param[in, out] out_len	- the buffer capacity and number of bytes written.
  * @param[in] in			- the input buffer.
  * @param[in] in_len		- the number of bytes to encrypt.
- * @param[in] n				- the public key.
+ * @param[in] pub			- the public key.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+int cp_phpe_enc(uint8_t *out, int *out_len, uint8_t *in, int in_len,
+		phpe_t pub);
+
+/**
+ * Builds a precomputation table for fast Paillier encryption. The table fixes
+ * a random h = r^n mod n^2 and must be kept with the public key that built it.
+ *
+ * @param[out] t			- the precomputation table with BN_XP_TABLE entries.
+ * @param[in] pub			- the public key.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+int cp_phpe_pre(bn_t *t, phpe_t pub);
+
+/**
+ * Encrypts using the Paillier cryptosystem and a precomputation table. The
+ * noise is computed as h^a mod n^2 for a random exponent a as long as n, which
+ * replaces the exponentiation r^n by a fixed-base exponentiation.
+ *
+ * @param[out] out			- the output buffer.
+ * @param[in, out] out_len	- the buffer capacity and number of bytes written.
+ * @param[in] in			- the input buffer.
+ * @param[in] in_len		- the number of bytes to encrypt.
+ * @param[in] t				- the precomputation table built by cp_phpe_pre().
+ * @param[in] pub			- the public key.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+int cp_phpe_enc_fix(uint8_t *out, int *out_len, uint8_t *in, int in_len,
+		const bn_t *t, phpe_t pub);
+
+/**
+ * Encrypts a batch of plaintexts under the same public key, distributing the
+ * exponentiations among the available cores. The random values are drawn in
+ * the calling thread.
+ *
+ * @param[out] out			- the output buffers.
+ * @param[in, out] out_len	- the buffer capacities and numbers of bytes written.
+ * @param[in] in			- the input buffers.
+ * @param[in] in_len		- the numbers of bytes to encrypt.
+ * @param[in] t				- the precomputation table, or NULL.
+ * @param[in] pub			- the public key.
+ * @param[in] n				- the number of plaintexts.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+int cp_phpe_enc_batch(uint8_t **out, int *out_len, uint8_t **in, int *in_len,
+		const bn_t *t, phpe_t pub, int n);
+
+/**
+ * Adds two plaintexts under the Paillier cryptosystem by multiplying their
+ * ciphertexts modulo n^2.
+ *
+ * @param[out] out			- the output buffer.
+ * @param[in, out] out_len	- the buffer capacity and number of bytes written.
+ * @param[in] a				- the first ciphertext.
+ * @param[in] a_len			- the length of the first ciphertext in bytes.
+ * @param[in] b				- the second ciphertext.
+ * @param[in] b_len			- the length of the second ciphertext in bytes.
+ * @param[in] pub			- the public key.
  * @return STS_OK if no errors occurred, STS_ERR otherwise.
  */
-int cp_phpe_enc(uint8_t *out, int *out_len, uint8_t *in, int in_len, bn_t n);
+int cp_phpe_add(uint8_t *out, int *out_len, uint8_t *a, int a_len, uint8_t *b,
+		int b_len, phpe_t pub);
+
+/**
+ * Multiplies a plaintext by a scalar under the Paillier cryptosystem by
+ * exponentiating its ciphertext modulo n^2.
+ *
+ * @param[out] out			- the output buffer.
+ * @param[in, out] out_len	- the buffer capacity and number of bytes written.
+ * @param[in] in			- the ciphertext.
+ * @param[in] in_len		- the length of the ciphertext in bytes.
+ * @param[in] k				- the non-negative scalar.
+ * @param[in] pub			- the public key.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+int cp_phpe_mul(uint8_t *out, int *out_len, uint8_t *in, int in_len, bn_t k,
+		phpe_t pub);
 
 /**
  * Decrypts using the Paillier cryptosystem. Since this system is homomorphic,
  * no padding can be applied and the user is responsible for specifying the
- * resulting plaintext size.
+ * resulting plaintext size. The decryption is computed modulo p^2 and q^2 and
+ * the halves are combined with the Chinese Remainder Theorem.
  *
  * @param[out] out			- the output buffer.
  * @param[out] out_len		- the number of bytes to write in the output buffer.
+ * @param[in] in			- the input buffer.
  * @param[in] in_len		- the number of bytes to decrypt.
- * @param[in] n				- the public key.
- * @param[in] l				- the private key. 
+ * @param[in] prv			- the private key.
  * @return STS_OK if no errors occurred, STS_ERR otherwise.
  */
-int cp_phpe_dec(uint8_t *out, int out_len, uint8_t *in, int in_len, bn_t n,
-		bn_t l);
+int cp_phpe_dec(uint8_t *out, int out_len, uint8_t *in, int in_len,
+		phpe_t prv);
 
 /**
  * Generates an ECDH key pair.
@@ -1296,6 +1893,68 @@ int cp_ecies_enc(ec_t r, uint8_t *out, int *out_len, uint8_t *in, int in_len,
 int cp_ecies_dec(uint8_t *out, int *out_len, ec_t r, uint8_t *in, int in_len,
 		bn_t d);
 
+/**
+ * Encrypts using the ECIES cryptosystem with AES-GCM as the authenticated
+ * cipher, which replaces the separate MAC computation over the ciphertext.
+ * The key and the nonce are both derived from the shared point, which is
+ * different for every message since a fresh ephemeral key is drawn.
+ *
+ * @param[out] r 			- the resulting elliptic curve point.
+ * @param[out] out			- the output buffer.
+ * @param[in, out] out_len	- the buffer capacity and number of bytes written.
+ * @param[in] in			- the input buffer.
+ * @param[in] in_len		- the number of bytes to encrypt.
+ * @param[in] q				- the public key.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+int cp_ecies_gcm_enc(ec_t r, uint8_t *out, int *out_len, uint8_t *in,
+		int in_len, ec_t q);
+
+/**
+ * Decrypts using the ECIES cryptosystem with AES-GCM as the authenticated
+ * cipher.
+ *
+ * @param[out] out			- the output buffer.
+ * @param[in, out] out_len	- the buffer capacity and number of bytes written.
+ * @param[in] r 			- the elliptic curve point.
+ * @param[in] in			- the input buffer.
+ * @param[in] in_len		- the number of bytes to decrypt.
+ * @param[in] d				- the private key.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+int cp_ecies_gcm_dec(uint8_t *out, int *out_len, ec_t r, uint8_t *in,
+		int in_len, bn_t d);
+
+/**
+ * Encrypts using the ECIES cryptosystem with ChaCha20-Poly1305 as the
+ * authenticated cipher.
+ *
+ * @param[out] r 			- the resulting elliptic curve point.
+ * @param[out] out			- the output buffer.
+ * @param[in, out] out_len	- the buffer capacity and number of bytes written.
+ * @param[in] in			- the input buffer.
+ * @param[in] in_len		- the number of bytes to encrypt.
+ * @param[in] q				- the public key.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+int cp_ecies_chacha_enc(ec_t r, uint8_t *out, int *out_len, uint8_t *in,
+		int in_len, ec_t q);
+
+/**
+ * Decrypts using the ECIES cryptosystem with ChaCha20-Poly1305 as the
+ * authenticated cipher.
+ *
+ * @param[out] out			- the output buffer.
+ * @param[in, out] out_len	- the buffer capacity and number of bytes written.
+ * @param[in] r 			- the elliptic curve point.
+ * @param[in] in			- the input buffer.
+ * @param[in] in_len		- the number of bytes to decrypt.
+ * @param[in] d				- the private key.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+int cp_ecies_chacha_dec(uint8_t *out, int *out_len, ec_t r, uint8_t *in,
+		int in_len, bn_t d);
+
 /**
  * Generates an ECDSA key pair.
  *
@@ -1331,6 +1990,24 @@ int cp_ecdsa_sig(bn_t r, bn_t s, uint8_t *msg, int len, int hash, bn_t d);
  */
 int cp_ecdsa_ver(bn_t r, bn_t s, uint8_t *msg, int len, int hash, ec_t q);
 
+/**
+ * Verifies a batch of messages signed with ECDSA, distributing the
+ * verifications among the thread pool.
+ * An empty batch is rejected.
+ *
+ * @param[out] v				- the individual results, can be NULL.
+ * @param[in] r					- the first components of the signatures.
+ * @param[in] s					- the second components of the signatures.
+ * @param[in] msg				- the signed messages.
+ * @param[in] len				- the message lengths in bytes.
+ * @param[in] hash				- the flag to indicate the message format.
+ * @param[in] q					- the public keys.
+ * @param[in] n					- the number of signatures.
+ * @return a boolean value indicating if all signatures are valid.
+ */
+int cp_ecdsa_ver_batch(int *v, bn_t *r, bn_t *s, uint8_t **msg, int *len,
+		int hash, ec_t *q, int n);
+
 /**
  * Generates an Elliptic Curve Schnorr Signature key pair.
  *
@@ -1488,6 +2165,75 @@ int cp_bgn_mul(gt_t e[4], g1_t c[2], g2_t d[2]);
  */
 int cp_bgn_dec(dig_t *out, gt_t in[4], bgn_t prv);
 
+/**
+ * Builds a baby-step giant-step table to decrypt ciphertexts in G_1 with
+ * plaintexts in [0, max).
+ *
+ * @param[out] d			- the table.
+ * @param[in] max			- the size of the range of plaintexts.
+ * @param[in] prv			- the private key.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+int cp_bgn_pre1(dlog_t d, int max, bgn_t prv);
+
+/**
+ * Decrypts in G_1 using the BGN cryptosystem and a baby-step giant-step
+ * table.
+ *
+ * @param[out] out			- the decrypted integer.
+ * @param[in] in			- the ciphertext.
+ * @param[in] d				- the table built by cp_bgn_pre1().
+ * @param[in] prv			- the private key.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+int cp_bgn_dec1_fix(dig_t *out, g1_t in[2], dlog_t d, bgn_t prv);
+
+/**
+ * Builds a baby-step giant-step table to decrypt ciphertexts in G_2 with
+ * plaintexts in [0, max).
+ *
+ * @param[out] d			- the table.
+ * @param[in] max			- the size of the range of plaintexts.
+ * @param[in] prv			- the private key.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+int cp_bgn_pre2(dlog_t d, int max, bgn_t prv);
+
+/**
+ * Decrypts in G_2 using the BGN cryptosystem and a baby-step giant-step
+ * table.
+ *
+ * @param[out] out			- the decrypted integer.
+ * @param[in] in			- the ciphertext.
+ * @param[in] d				- the table built by cp_bgn_pre2().
+ * @param[in] prv			- the private key.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+int cp_bgn_dec2_fix(dig_t *out, g2_t in[2], dlog_t d, bgn_t prv);
+
+/**
+ * Builds a baby-step giant-step table to decrypt ciphertexts in G_T with
+ * plaintexts in [0, max).
+ *
+ * @param[out] d			- the table.
+ * @param[in] max			- the size of the range of plaintexts.
+ * @param[in] prv			- the private key.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+int cp_bgn_pre(dlog_t d, int max, bgn_t prv);
+
+/**
+ * Decrypts in G_T using the BGN cryptosystem and a baby-step giant-step
+ * table.
+ *
+ * @param[out] out			- the decrypted integer.
+ * @param[in] in			- the ciphertext.
+ * @param[in] d				- the table built by cp_bgn_pre().
+ * @param[in] prv			- the private key.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+int cp_bgn_dec_fix(dig_t *out, gt_t in[4], dlog_t d, bgn_t prv);
+
 /**
  * Generates a private key for a user in the BF-IBE protocol.
  *
@@ -1553,6 +2299,22 @@ int cp_bls_sig(g1_t s, uint8_t *msg, int len, bn_t d);
  */
 int cp_bls_ver(g1_t s, uint8_t *msg, int len, g2_t q);
 
+/**
+ * Verifies a batch of messages signed with BLS, distributing the
+ * verifications among the thread pool.
+ * An empty batch is rejected.
+ *
+ * @param[out] v				- the individual results, can be NULL.
+ * @param[in] s					- the signatures.
+ * @param[in] msg				- the signed messages.
+ * @param[in] len				- the message lengths in bytes.
+ * @param[in] q					- the public keys.
+ * @param[in] n					- the number of signatures.
+ * @return a boolean value indicating if all signatures are valid.
+ */
+int cp_bls_ver_batch(int *v, g1_t *s, uint8_t **msg, int *len, g2_t *q,
+		int n);
+
 /**
  * Generates a Boneh-Boyen key pair.
  *
@@ -1058,6 +1058,17 @@ void ep_mul_sim_joint(ep_t r, const ep_t p, const bn_t k, const ep_t q,
  */
 void ep_mul_sim_gen(ep_t r, const bn_t k, const ep_t q, const bn_t m);
 
+/**
+ * Multiplies and adds multiple prime elliptic curve points. Computes
+ * R = \sum k_iP_i, splitting the points in pairs processed by the thread pool.
+ *
+ * @param[out] r			- the result.
+ * @param[in] p				- the points to multiply.
+ * @param[in] k				- the integers.
+ * @param[in] n				- the number of points.
+ */
+void ep_mul_sim_lot(ep_t r, const ep_t *p, const bn_t *k, int n);
+
 /**
  * Converts a point to affine coordinates.
  *
@@ -1084,6 +1095,17 @@ void ep_norm_sim(ep_t *r, const ep_t *t, int n);
  */
 void ep_map(ep_t p, const uint8_t *msg, int len);
 
+/**
+ * Maps several byte arrays to points in a prime elliptic curve, hashing
+ * them together and mapping the digests in parallel.
+ *
+ * @param[out] p			- the resulting points.
+ * @param[in] msg			- the byte arrays to map.
+ * @param[in] len			- the array lengths in bytes.
+ * @param[in] n				- the number of byte arrays.
+ */
+void ep_map_lot(ep_t *p, uint8_t **msg, int *len, int n);
+
 /**
  * Compresses a point.
  *
@@ -134,6 +134,8 @@ typedef struct _sts_t {
 /* Macro definitions                                                          */
 /*============================================================================*/
 
+#ifndef NOJMP
+
 /**
  * Implements the TRY clause of the error-handling routines.
  *
@@ -224,6 +226,69 @@ typedef struct _sts_t {
 		}																\
 	}																	\
 
+#else
+
+/**
+ * Implements the TRY clause of the error-handling routines using status flags.
+ *
+ * This macro saves the error flag of the current library context and clears
+ * it, so that errors thrown inside the program block can be distinguished
+ * from errors thrown before. No program location is stored, hence errors
+ * thrown inside the block do not interrupt its execution.
+ */
+#define ERR_TRY															\
+	{																	\
+		ctx_t *_ctx = core_get();										\
+		err_t _last = _ctx->number;										\
+		_ctx->number = ERR_CAUGHT;										\
+		if (1)															\
+
+/**
+ * Implements the CATCH clause of the error-handling routines using status
+ * flags.
+ *
+ * The error flag is inspected after the program block is executed. If an error
+ * was thrown inside the block, it is stored in the caught flag and the address
+ * of the error being caught. The previous error flag is then restored and the
+ * execution resumes inside the CATCH block.
+ *
+ * @param[in] ADDR	- the address of the exception being caught
+ */
+#define ERR_CATCH(ADDR)													\
+		else { }														\
+		_ctx->caught = _ctx->number;									\
+		_ctx->number = _last;											\
+		if (_ctx->caught != ERR_CAUGHT) {								\
+			err_t *_addr = ADDR;										\
+			if (_addr != NULL) {										\
+				*_addr = _ctx->caught;									\
+			}															\
+		}																\
+	}																	\
+	for (int _z = 0; _z < 2; _z++)										\
+		if (_z == 1 && core_get()->caught)								\
+
+/**
+ * Implements the THROW clause of the error-handling routines using status
+ * flags.
+ *
+ * The error is recorded in the error flag of the current library context and
+ * the execution continues, so functions return right after throwing on
+ * invalid input. Rethrowing ERR_CAUGHT inside a CATCH block propagates the
+ * error that was just caught.
+ *
+ * @param[in] E		- the exception being caught.
+ */
+#define ERR_THROW(E)													\
+	{																	\
+		ctx_t *_ctx = core_get();										\
+		_ctx->code = STS_ERR;											\
+		_ctx->number = (E != ERR_CAUGHT ? E : _ctx->caught);			\
+		ERR_PRINT(E);													\
+	}																	\
+
+#endif /* NOJMP */
+
 #ifdef CHECK
 /**
  * Implements a TRY clause.
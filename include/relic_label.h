@@ -60,27 +60,35 @@
 #undef arch_clean
 #undef arch_cycles
 #undef arch_copy_rom
+#undef arch_features
+#undef arch_limit
 
 #define arch_init 	PREFIX(arch_init)
 #define arch_clean 	PREFIX(arch_clean)
 #define arch_cycles 	PREFIX(arch_cycles)
 #define arch_copy_rom 	PREFIX(arch_copy_rom)
+#define arch_features 	PREFIX(arch_features)
+#define arch_limit 	PREFIX(arch_limit)
 
 #undef bench_overhead
 #undef bench_reset
+#undef bench_warmup
 #undef bench_before
 #undef bench_after
 #undef bench_compute
 #undef bench_print
 #undef bench_total
+#undef bench_clean
 
 #define bench_overhead 	PREFIX(bench_overhead)
 #define bench_reset 	PREFIX(bench_reset)
+#define bench_warmup 	PREFIX(bench_warmup)
 #define bench_before 	PREFIX(bench_before)
 #define bench_after 	PREFIX(bench_after)
 #define bench_compute 	PREFIX(bench_compute)
 #define bench_print 	PREFIX(bench_print)
 #define bench_total 	PREFIX(bench_total)
+#define bench_clean 	PREFIX(bench_clean)
 
 #undef err_simple_msg
 #undef err_full_msg
@@ -106,9 +114,19 @@
 
 #undef pool_get
 #undef pool_put
+#undef pool_init
+#undef pool_clean
+#undef multi_get_cores
+#undef multi_set_cores
+#undef multi_run
 
 #define pool_get 	PREFIX(pool_get)
 #define pool_put 	PREFIX(pool_put)
+#define pool_init 	PREFIX(pool_init)
+#define pool_clean 	PREFIX(pool_clean)
+#define multi_get_cores 	PREFIX(multi_get_cores)
+#define multi_set_cores 	PREFIX(multi_set_cores)
+#define multi_run 	PREFIX(multi_run)
 
 #undef test_fail
 #undef test_pass
@@ -128,6 +146,7 @@
 #undef util_conv_char
 #undef util_bits_dig
 #undef util_cmp_const
+#undef util_wipe
 #undef util_printf
 #undef util_print_dig
 
@@ -137,6 +156,7 @@
 #define util_conv_char 	PREFIX(util_conv_char)
 #define util_bits_dig 	PREFIX(util_bits_dig)
 #define util_cmp_const 	PREFIX(util_cmp_const)
+#define util_wipe 	PREFIX(util_wipe)
 #define util_printf 	PREFIX(util_printf)
 #define util_print_dig 	PREFIX(util_print_dig)
 
@@ -216,9 +236,13 @@
 #undef bn_mul_basic
 #undef bn_mul_comba
 #undef bn_mul_karat
+#undef bn_mul_toom3
+#undef bn_mul_toomc
 #undef bn_sqr_basic
 #undef bn_sqr_comba
 #undef bn_sqr_karat
+#undef bn_sqr_toom3
+#undef bn_sqr_toomc
 #undef bn_dbl
 #undef bn_hlv
 #undef bn_lsh
@@ -239,10 +263,22 @@
 #undef bn_mod_monty_comba
 #undef bn_mod_pre_pmers
 #undef bn_mod_pmers
+#undef bn_mod_ctx_set
+#undef bn_mod_ctx_cmp
+#undef bn_mod_ctx_conv
+#undef bn_mod_ctx_back
+#undef bn_mod_ctx_mul
+#undef bn_mul_mod_ctx
 #undef bn_mxp_basic
 #undef bn_mxp_slide
 #undef bn_mxp_monty
+#undef bn_mxp_const
+#undef bn_mxp_const_ctx
 #undef bn_mxp_dig
+#undef bn_mxp_ctx
+#undef bn_mxp_dig_ctx
+#undef bn_mxp_pre
+#undef bn_mxp_fix
 #undef bn_gcd_basic
 #undef bn_gcd_lehme
 #undef bn_gcd_stein
@@ -317,9 +353,13 @@
 #define bn_mul_basic 	PREFIX(bn_mul_basic)
 #define bn_mul_comba 	PREFIX(bn_mul_comba)
 #define bn_mul_karat 	PREFIX(bn_mul_karat)
+#define bn_mul_toom3 	PREFIX(bn_mul_toom3)
+#define bn_mul_toomc 	PREFIX(bn_mul_toomc)
 #define bn_sqr_basic 	PREFIX(bn_sqr_basic)
 #define bn_sqr_comba 	PREFIX(bn_sqr_comba)
 #define bn_sqr_karat 	PREFIX(bn_sqr_karat)
+#define bn_sqr_toom3 	PREFIX(bn_sqr_toom3)
+#define bn_sqr_toomc 	PREFIX(bn_sqr_toomc)
 #define bn_dbl 	PREFIX(bn_dbl)
 #define bn_hlv 	PREFIX(bn_hlv)
 #define bn_lsh 	PREFIX(bn_lsh)
@@ -340,10 +380,22 @@
 #define bn_mod_monty_comba 	PREFIX(bn_mod_monty_comba)
 #define bn_mod_pre_pmers 	PREFIX(bn_mod_pre_pmers)
 #define bn_mod_pmers 	PREFIX(bn_mod_pmers)
+#define bn_mod_ctx_set 	PREFIX(bn_mod_ctx_set)
+#define bn_mod_ctx_cmp 	PREFIX(bn_mod_ctx_cmp)
+#define bn_mod_ctx_conv 	PREFIX(bn_mod_ctx_conv)
+#define bn_mod_ctx_back 	PREFIX(bn_mod_ctx_back)
+#define bn_mod_ctx_mul 	PREFIX(bn_mod_ctx_mul)
+#define bn_mul_mod_ctx 	PREFIX(bn_mul_mod_ctx)
 #define bn_mxp_basic 	PREFIX(bn_mxp_basic)
 #define bn_mxp_slide 	PREFIX(bn_mxp_slide)
 #define bn_mxp_monty 	PREFIX(bn_mxp_monty)
+#define bn_mxp_const 	PREFIX(bn_mxp_const)
+#define bn_mxp_const_ctx 	PREFIX(bn_mxp_const_ctx)
 #define bn_mxp_dig 	PREFIX(bn_mxp_dig)
+#define bn_mxp_ctx 	PREFIX(bn_mxp_ctx)
+#define bn_mxp_dig_ctx 	PREFIX(bn_mxp_dig_ctx)
+#define bn_mxp_pre 	PREFIX(bn_mxp_pre)
+#define bn_mxp_fix 	PREFIX(bn_mxp_fix)
 #define bn_gcd_basic 	PREFIX(bn_gcd_basic)
 #define bn_gcd_lehme 	PREFIX(bn_gcd_lehme)
 #define bn_gcd_stein 	PREFIX(bn_gcd_stein)
@@ -944,9 +996,11 @@
 #undef ep_mul_sim_inter
 #undef ep_mul_sim_joint
 #undef ep_mul_sim_gen
+#undef ep_mul_sim_lot
 #undef ep_norm
 #undef ep_norm_sim
 #undef ep_map
+#undef ep_map_lot
 #undef ep_pck
 #undef ep_upk
 
@@ -1024,9 +1078,11 @@
 #define ep_mul_sim_inter 	PREFIX(ep_mul_sim_inter)
 #define ep_mul_sim_joint 	PREFIX(ep_mul_sim_joint)
 #define ep_mul_sim_gen 	PREFIX(ep_mul_sim_gen)
+#define ep_mul_sim_lot 	PREFIX(ep_mul_sim_lot)
 #define ep_norm 	PREFIX(ep_norm)
 #define ep_norm_sim 	PREFIX(ep_norm_sim)
 #define ep_map 	PREFIX(ep_map)
+#define ep_map_lot 	PREFIX(ep_map_lot)
 #define ep_pck 	PREFIX(ep_pck)
 #define ep_upk 	PREFIX(ep_upk)
 
@@ -1773,6 +1829,9 @@
 #undef pp_map_tatep_k12
 #undef pp_map_weilp_k12
 #undef pp_map_oatep_k12
+#undef pp_map_sim_oatep_k12
+#undef pp_map_sim_tatep_k12
+#undef pp_map_sim_weilp_k12
 
 #define pp_map_init 	PREFIX(pp_map_init)
 #define pp_map_clean 	PREFIX(pp_map_clean)
@@ -1799,6 +1858,9 @@
 #define pp_map_tatep_k12 	PREFIX(pp_map_tatep_k12)
 #define pp_map_weilp_k12 	PREFIX(pp_map_weilp_k12)
 #define pp_map_oatep_k12 	PREFIX(pp_map_oatep_k12)
+#define pp_map_sim_oatep_k12 	PREFIX(pp_map_sim_oatep_k12)
+#define pp_map_sim_tatep_k12 	PREFIX(pp_map_sim_tatep_k12)
+#define pp_map_sim_weilp_k12 	PREFIX(pp_map_sim_weilp_k12)
 
 #undef rsa_t
 #undef rabin_t
@@ -1811,20 +1873,40 @@
 
 #undef cp_rsa_gen_basic
 #undef cp_rsa_gen_quick
+#undef cp_rsa_gen_batch
+#undef cp_rsa_prepare
 #undef cp_rsa_enc
 #undef cp_rsa_dec_basic
 #undef cp_rsa_dec_quick
+#undef cp_rsa_dec_batch
 #undef cp_rsa_sig_basic
 #undef cp_rsa_sig_quick
+#undef cp_rsa_sig_batch
 #undef cp_rsa_ver
+#undef cp_rsa_ver_batch
 #undef cp_rabin_gen
 #undef cp_rabin_enc
 #undef cp_rabin_dec
+#undef cp_dlog_init
+#undef cp_dlog_add
+#undef cp_dlog_get
+#undef cp_dlog_step
+#undef cp_dlog_size_bin
+#undef cp_dlog_write_bin
+#undef cp_dlog_read_bin
 #undef cp_bdpe_gen
+#undef cp_bdpe_prepare
 #undef cp_bdpe_enc
 #undef cp_bdpe_dec
+#undef cp_bdpe_pre
+#undef cp_bdpe_dec_fix
 #undef cp_phpe_gen
 #undef cp_phpe_enc
+#undef cp_phpe_pre
+#undef cp_phpe_enc_fix
+#undef cp_phpe_enc_batch
+#undef cp_phpe_add
+#undef cp_phpe_mul
 #undef cp_phpe_dec
 #undef cp_ecdh_gen
 #undef cp_ecdh_key
@@ -1833,9 +1915,14 @@
 #undef cp_ecies_gen
 #undef cp_ecies_enc
 #undef cp_ecies_dec
+#undef cp_ecies_gcm_enc
+#undef cp_ecies_gcm_dec
+#undef cp_ecies_chacha_enc
+#undef cp_ecies_chacha_dec
 #undef cp_ecdsa_gen
 #undef cp_ecdsa_sig
 #undef cp_ecdsa_ver
+#undef cp_ecdsa_ver_batch
 #undef cp_ecss_gen
 #undef cp_ecss_sig
 #undef cp_ecss_ver
@@ -1851,32 +1938,59 @@
 #undef cp_bgn_add
 #undef cp_bgn_mul
 #undef cp_bgn_dec
+#undef cp_bgn_pre1
+#undef cp_bgn_dec1_fix
+#undef cp_bgn_pre2
+#undef cp_bgn_dec2_fix
+#undef cp_bgn_pre
+#undef cp_bgn_dec_fix
 #undef cp_ibe_gen_prv
 #undef cp_ibe_enc
 #undef cp_ibe_dec
 #undef cp_bls_gen
 #undef cp_bls_sig
 #undef cp_bls_ver
+#undef cp_bls_ver_batch
 #undef cp_bbs_gen
 #undef cp_bbs_sig
 #undef cp_bbs_ver
 
 #define cp_rsa_gen_basic 	PREFIX(cp_rsa_gen_basic)
 #define cp_rsa_gen_quick 	PREFIX(cp_rsa_gen_quick)
+#define cp_rsa_gen_batch 	PREFIX(cp_rsa_gen_batch)
+#define cp_rsa_prepare 	PREFIX(cp_rsa_prepare)
 #define cp_rsa_enc 	PREFIX(cp_rsa_enc)
 #define cp_rsa_dec_basic 	PREFIX(cp_rsa_dec_basic)
 #define cp_rsa_dec_quick 	PREFIX(cp_rsa_dec_quick)
+#define cp_rsa_dec_batch 	PREFIX(cp_rsa_dec_batch)
 #define cp_rsa_sig_basic 	PREFIX(cp_rsa_sig_basic)
 #define cp_rsa_sig_quick 	PREFIX(cp_rsa_sig_quick)
+#define cp_rsa_sig_batch 	PREFIX(cp_rsa_sig_batch)
 #define cp_rsa_ver 	PREFIX(cp_rsa_ver)
+#define cp_rsa_ver_batch 	PREFIX(cp_rsa_ver_batch)
 #define cp_rabin_gen 	PREFIX(cp_rabin_gen)
 #define cp_rabin_enc 	PREFIX(cp_rabin_enc)
 #define cp_rabin_dec 	PREFIX(cp_rabin_dec)
+#define cp_dlog_init 	PREFIX(cp_dlog_init)
+#define cp_dlog_add 	PREFIX(cp_dlog_add)
+#define cp_dlog_get 	PREFIX(cp_dlog_get)
+#define cp_dlog_step 	PREFIX(cp_dlog_step)
+#define cp_dlog_size_bin 	PREFIX(cp_dlog_size_bin)
+#define cp_dlog_write_bin 	PREFIX(cp_dlog_write_bin)
+#define cp_dlog_read_bin 	PREFIX(cp_dlog_read_bin)
 #define cp_bdpe_gen 	PREFIX(cp_bdpe_gen)
+#define cp_bdpe_prepare 	PREFIX(cp_bdpe_prepare)
 #define cp_bdpe_enc 	PREFIX(cp_bdpe_enc)
 #define cp_bdpe_dec 	PREFIX(cp_bdpe_dec)
+#define cp_bdpe_pre 	PREFIX(cp_bdpe_pre)
+#define cp_bdpe_dec_fix 	PREFIX(cp_bdpe_dec_fix)
 #define cp_phpe_gen 	PREFIX(cp_phpe_gen)
 #define cp_phpe_enc 	PREFIX(cp_phpe_enc)
+#define cp_phpe_pre 	PREFIX(cp_phpe_pre)
+#define cp_phpe_enc_fix 	PREFIX(cp_phpe_enc_fix)
+#define cp_phpe_enc_batch 	PREFIX(cp_phpe_enc_batch)
+#define cp_phpe_add 	PREFIX(cp_phpe_add)
+#define cp_phpe_mul 	PREFIX(cp_phpe_mul)
 #define cp_phpe_dec 	PREFIX(cp_phpe_dec)
 #define cp_ecdh_gen 	PREFIX(cp_ecdh_gen)
 #define cp_ecdh_key 	PREFIX(cp_ecdh_key)
@@ -1885,9 +1999,14 @@
 #define cp_ecies_gen 	PREFIX(cp_ecies_gen)
 #define cp_ecies_enc 	PREFIX(cp_ecies_enc)
 #define cp_ecies_dec 	PREFIX(cp_ecies_dec)
+#define cp_ecies_gcm_enc 	PREFIX(cp_ecies_gcm_enc)
+#define cp_ecies_gcm_dec 	PREFIX(cp_ecies_gcm_dec)
+#define cp_ecies_chacha_enc 	PREFIX(cp_ecies_chacha_enc)
+#define cp_ecies_chacha_dec 	PREFIX(cp_ecies_chacha_dec)
 #define cp_ecdsa_gen 	PREFIX(cp_ecdsa_gen)
 #define cp_ecdsa_sig 	PREFIX(cp_ecdsa_sig)
 #define cp_ecdsa_ver 	PREFIX(cp_ecdsa_ver)
+#define cp_ecdsa_ver_batch 	PREFIX(cp_ecdsa_ver_batch)
 #define cp_ecss_gen 	PREFIX(cp_ecss_gen)
 #define cp_ecss_sig 	PREFIX(cp_ecss_sig)
 #define cp_ecss_ver 	PREFIX(cp_ecss_ver)
@@ -1903,12 +2022,19 @@
 #define cp_bgn_add 	PREFIX(cp_bgn_add)
 #define cp_bgn_mul 	PREFIX(cp_bgn_mul)
 #define cp_bgn_dec 	PREFIX(cp_bgn_dec)
+#define cp_bgn_pre1 	PREFIX(cp_bgn_pre1)
+#define cp_bgn_dec1_fix 	PREFIX(cp_bgn_dec1_fix)
+#define cp_bgn_pre2 	PREFIX(cp_bgn_pre2)
+#define cp_bgn_dec2_fix 	PREFIX(cp_bgn_dec2_fix)
+#define cp_bgn_pre 	PREFIX(cp_bgn_pre)
+#define cp_bgn_dec_fix 	PREFIX(cp_bgn_dec_fix)
 #define cp_ibe_gen_prv 	PREFIX(cp_ibe_gen_prv)
 #define cp_ibe_enc 	PREFIX(cp_ibe_enc)
 #define cp_ibe_dec 	PREFIX(cp_ibe_dec)
 #define cp_bls_gen 	PREFIX(cp_bls_gen)
 #define cp_bls_sig 	PREFIX(cp_bls_sig)
 #define cp_bls_ver 	PREFIX(cp_bls_ver)
+#define cp_bls_ver_batch 	PREFIX(cp_bls_ver_batch)
 #define cp_bbs_gen 	PREFIX(cp_bbs_gen)
 #define cp_bbs_sig 	PREFIX(cp_bbs_sig)
 #define cp_bbs_ver 	PREFIX(cp_bbs_ver)
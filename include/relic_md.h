@@ -53,7 +53,15 @@ enum {
 	/** Hash kength for SHA-384 function. */
 	MD_LEN_SH384 = 48,
 	/** Hash kength for SHA-512 function. */
-	MD_LEN_SH512 = 64
+	MD_LEN_SH512 = 64,
+	/** Hash length for SHA3-256 function. */
+	MD_LEN_SH3_256 = 32,
+	/** Hash length for SHA3-512 function. */
+	MD_LEN_SH3_512 = 64,
+	/** Hash length for BLAKE2s-256 function. */
+	MD_LEN_B2S_256 = 32,
+	/** Hash length for BLAKE2b-512 function. */
+	MD_LEN_B2B_512 = 64
 };
 
 /**
@@ -69,8 +77,152 @@ enum {
 #define MD_LEN					MD_LEN_SH384
 #elif MD_MAP == SH512
 #define MD_LEN					MD_LEN_SH512
+#elif MD_MAP == SH3_256
+#define MD_LEN					MD_LEN_SH3_256
+#elif MD_MAP == SH3_512
+#define MD_LEN					MD_LEN_SH3_512
+#elif MD_MAP == B2S_256
+#define MD_LEN					MD_LEN_B2S_256
+#elif MD_MAP == B2B_512
+#define MD_LEN					MD_LEN_B2B_512
 #endif
 
+/**
+ * Length in bytes of the input block of the default hash function.
+ */
+#if MD_MAP == SHONE || MD_MAP == SH224 || MD_MAP == SH256 || MD_MAP == B2S_256
+#define MD_BLOCK				64
+#elif MD_MAP == SH384 || MD_MAP == SH512 || MD_MAP == B2B_512
+#define MD_BLOCK				128
+#elif MD_MAP == SH3_256
+#define MD_BLOCK				136
+#elif MD_MAP == SH3_512
+#define MD_BLOCK				72
+#endif
+
+/*============================================================================*/
+/* Type definitions                                                           */
+/*============================================================================*/
+
+/**
+ * Context for the incremental computation of SHA-1.
+ */
+typedef struct {
+	/** Internal state of the hash function. */
+	uint64_t state[16];
+} md_shone_t;
+
+/**
+ * Context for the incremental computation of SHA-256.
+ */
+typedef struct {
+	/** Internal state of the hash function. */
+	uint64_t state[16];
+} md_sh256_t;
+
+/**
+ * Context for the incremental computation of SHA-224.
+ */
+typedef md_sh256_t md_sh224_t;
+
+/**
+ * Context for the incremental computation of SHA-512.
+ */
+typedef struct {
+	/** Internal state of the hash function. */
+	uint64_t state[32];
+} md_sh512_t;
+
+/**
+ * Context for the incremental computation of SHA-384.
+ */
+typedef md_sh512_t md_sh384_t;
+
+/**
+ * Context for the incremental computation of a Keccak sponge.
+ */
+typedef struct {
+	/** Internal state of the permutation. */
+	uint64_t s[25];
+	/** Number of bytes absorbed into the current block. */
+	int pos;
+	/** Rate of the sponge in bytes. */
+	int rate;
+} md_sh3_t;
+
+/**
+ * Context for the incremental computation of SHA3-256.
+ */
+typedef md_sh3_t md_sh3_256_t;
+
+/**
+ * Context for the incremental computation of SHA3-512.
+ */
+typedef md_sh3_t md_sh3_512_t;
+
+/**
+ * Context for the incremental computation of BLAKE2s-256.
+ */
+typedef struct {
+	/** Chaining value. */
+	uint32_t h[8];
+	/** Byte counter. */
+	uint32_t t[2];
+	/** Pending input block. */
+	uint8_t buf[64];
+	/** Number of bytes in the pending block. */
+	int len;
+} md_b2s_256_t;
+
+/**
+ * Context for the incremental computation of BLAKE2b-512.
+ */
+typedef struct {
+	/** Chaining value. */
+	uint64_t h[8];
+	/** Byte counter. */
+	uint64_t t[2];
+	/** Pending input block. */
+	uint8_t buf[128];
+	/** Number of bytes in the pending block. */
+	int len;
+} md_b2b_512_t;
+
+/**
+ * Context for the incremental computation of the chosen hash function.
+ */
+#if MD_MAP == SHONE
+typedef md_shone_t md_ctx_t;
+#elif MD_MAP == SH224
+typedef md_sh224_t md_ctx_t;
+#elif MD_MAP == SH256
+typedef md_sh256_t md_ctx_t;
+#elif MD_MAP == SH384
+typedef md_sh384_t md_ctx_t;
+#elif MD_MAP == SH512
+typedef md_sh512_t md_ctx_t;
+#elif MD_MAP == SH3_256
+typedef md_sh3_256_t md_ctx_t;
+#elif MD_MAP == SH3_512
+typedef md_sh3_512_t md_ctx_t;
+#elif MD_MAP == B2S_256
+typedef md_b2s_256_t md_ctx_t;
+#elif MD_MAP == B2B_512
+typedef md_b2b_512_t md_ctx_t;
+#endif
+
+/**
+ * Context for the computation of HMAC under a fixed key.
+ */
+typedef struct {
+	/** State of the hash function after absorbing the inner padded key. */
+	md_ctx_t inner;
+	/** State of the hash function after absorbing the outer padded key. */
+	md_ctx_t outer;
+	/** State of the message being authenticated. */
+	md_ctx_t ctx;
+} md_hmac_t;
+
 /*============================================================================*/
 /* Macro definitions                                                          */
 /*============================================================================*/
@@ -93,6 +245,111 @@ enum {
 #define md_map(H, M, L)			md_map_sh384(H, M, L)
 #elif MD_MAP == SH512
 #define md_map(H, M, L)			md_map_sh512(H, M, L)
+#elif MD_MAP == SH3_256
+#define md_map(H, M, L)			md_map_sh3_256(H, M, L)
+#elif MD_MAP == SH3_512
+#define md_map(H, M, L)			md_map_sh3_512(H, M, L)
+#elif MD_MAP == B2S_256
+#define md_map(H, M, L)			md_map_b2s_256(H, M, L)
+#elif MD_MAP == B2B_512
+#define md_map(H, M, L)			md_map_b2b_512(H, M, L)
+#endif
+
+/**
+ * Initializes the incremental computation of the chosen hash function.
+ *
+ * @param[out] C				- the context.
+ */
+#if MD_MAP == SHONE
+#define md_init(C)				md_shone_init(C)
+#elif MD_MAP == SH224
+#define md_init(C)				md_sh224_init(C)
+#elif MD_MAP == SH256
+#define md_init(C)				md_sh256_init(C)
+#elif MD_MAP == SH384
+#define md_init(C)				md_sh384_init(C)
+#elif MD_MAP == SH512
+#define md_init(C)				md_sh512_init(C)
+#elif MD_MAP == SH3_256
+#define md_init(C)				md_sh3_256_init(C)
+#elif MD_MAP == SH3_512
+#define md_init(C)				md_sh3_512_init(C)
+#elif MD_MAP == B2S_256
+#define md_init(C)				md_b2s_256_init(C)
+#elif MD_MAP == B2B_512
+#define md_init(C)				md_b2b_512_init(C)
+#endif
+
+/**
+ * Adds a byte vector to the incremental computation of the chosen hash
+ * function.
+ *
+ * @param[in,out] C				- the context.
+ * @param[in] M					- the bytes to hash.
+ * @param[in] L					- the number of bytes.
+ */
+#if MD_MAP == SHONE
+#define md_update(C, M, L)		md_shone_update(C, M, L)
+#elif MD_MAP == SH224
+#define md_update(C, M, L)		md_sh224_update(C, M, L)
+#elif MD_MAP == SH256
+#define md_update(C, M, L)		md_sh256_update(C, M, L)
+#elif MD_MAP == SH384
+#define md_update(C, M, L)		md_sh384_update(C, M, L)
+#elif MD_MAP == SH512
+#define md_update(C, M, L)		md_sh512_update(C, M, L)
+#elif MD_MAP == SH3_256
+#define md_update(C, M, L)		md_sh3_256_update(C, M, L)
+#elif MD_MAP == SH3_512
+#define md_update(C, M, L)		md_sh3_512_update(C, M, L)
+#elif MD_MAP == B2S_256
+#define md_update(C, M, L)		md_b2s_256_update(C, M, L)
+#elif MD_MAP == B2B_512
+#define md_update(C, M, L)		md_b2b_512_update(C, M, L)
+#endif
+
+/**
+ * Finishes the incremental computation of the chosen hash function.
+ *
+ * @param[in,out] C				- the context.
+ * @param[out] H				- the digest.
+ */
+#if MD_MAP == SHONE
+#define md_final(C, H)			md_shone_final(C, H)
+#elif MD_MAP == SH224
+#define md_final(C, H)			md_sh224_final(C, H)
+#elif MD_MAP == SH256
+#define md_final(C, H)			md_sh256_final(C, H)
+#elif MD_MAP == SH384
+#define md_final(C, H)			md_sh384_final(C, H)
+#elif MD_MAP == SH512
+#define md_final(C, H)			md_sh512_final(C, H)
+#elif MD_MAP == SH3_256
+#define md_final(C, H)			md_sh3_256_final(C, H)
+#elif MD_MAP == SH3_512
+#define md_final(C, H)			md_sh3_512_final(C, H)
+#elif MD_MAP == B2S_256
+#define md_final(C, H)			md_b2s_256_final(C, H)
+#elif MD_MAP == B2B_512
+#define md_final(C, H)			md_b2b_512_final(C, H)
+#endif
+
+/**
+ * Computes the chosen hash function over several independent messages,
+ * using parallel SIMD lanes when the hash function supports them.
+ *
+ * @param[out] H				- the digests.
+ * @param[in] M					- the messages to hash.
+ * @param[in] L					- the message lengths in bytes.
+ * @param[in] N					- the number of messages.
+ */
+#if MD_MAP == SH256
+#define md_map_lot(H, M, L, N)	md_map_sh256_x8(H, M, L, N)
+#elif MD_MAP == SH512
+#define md_map_lot(H, M, L, N)	md_map_sh512_x4(H, M, L, N)
+#else
+#define md_map_lot(H, M, L, N)												\
+	for (int _i = 0; _i < (N); _i++) md_map((H)[_i], (M)[_i], (L)[_i])
 #endif
 
 /*============================================================================*/
@@ -108,6 +365,32 @@ enum {
  */
 void md_map_shone(uint8_t *hash, const uint8_t *msg, int len);
 
+/**
+ * Initializes the incremental computation of the SHA-1 hash function.
+ *
+ * @param[out] ctx				- the context.
+ */
+void md_shone_init(md_shone_t *ctx);
+
+/**
+ * Adds a byte vector to the incremental computation of the SHA-1 hash
+ * function.
+ *
+ * @param[in,out] ctx			- the context.
+ * @param[in] msg				- the bytes to hash.
+ * @param[in] len				- the number of bytes.
+ */
+void md_shone_update(md_shone_t *ctx, const uint8_t *msg, int len);
+
+/**
+ * Finishes the incremental computation of the SHA-1 hash function. The
+ * context must be initialized again before being reused.
+ *
+ * @param[in,out] ctx			- the context.
+ * @param[out] hash				- the digest.
+ */
+void md_shone_final(md_shone_t *ctx, uint8_t *hash);
+
 /**
  * Returns the internal state of the hash function.
  *
@@ -125,6 +408,32 @@ void md_map_shone_mid(uint8_t *state, uint8_t *msg, int len);
  */
 void md_map_sh224(uint8_t *hash, const uint8_t *msg, int len);
 
+/**
+ * Initializes the incremental computation of the SHA-224 hash function.
+ *
+ * @param[out] ctx				- the context.
+ */
+void md_sh224_init(md_sh224_t *ctx);
+
+/**
+ * Adds a byte vector to the incremental computation of the SHA-224 hash
+ * function.
+ *
+ * @param[in,out] ctx			- the context.
+ * @param[in] msg				- the bytes to hash.
+ * @param[in] len				- the number of bytes.
+ */
+void md_sh224_update(md_sh224_t *ctx, const uint8_t *msg, int len);
+
+/**
+ * Finishes the incremental computation of the SHA-224 hash function. The
+ * context must be initialized again before being reused.
+ *
+ * @param[in,out] ctx			- the context.
+ * @param[out] hash				- the digest.
+ */
+void md_sh224_final(md_sh224_t *ctx, uint8_t *hash);
+
 /**
  * Computes the SHA-256 hash function.
  *
@@ -134,6 +443,43 @@ void md_map_sh224(uint8_t *hash, const uint8_t *msg, int len);
  */
 void md_map_sh256(uint8_t *hash, const uint8_t *msg, int len);
 
+/**
+ * Initializes the incremental computation of the SHA-256 hash function.
+ *
+ * @param[out] ctx				- the context.
+ */
+void md_sh256_init(md_sh256_t *ctx);
+
+/**
+ * Adds a byte vector to the incremental computation of the SHA-256 hash
+ * function.
+ *
+ * @param[in,out] ctx			- the context.
+ * @param[in] msg				- the bytes to hash.
+ * @param[in] len				- the number of bytes.
+ */
+void md_sh256_update(md_sh256_t *ctx, const uint8_t *msg, int len);
+
+/**
+ * Finishes the incremental computation of the SHA-256 hash function. The
+ * context must be initialized again before being reused.
+ *
+ * @param[in,out] ctx			- the context.
+ * @param[out] hash				- the digest.
+ */
+void md_sh256_final(md_sh256_t *ctx, uint8_t *hash);
+
+/**
+ * Computes the SHA-256 hash function over several independent messages,
+ * eight at a time in parallel SIMD lanes when the processor supports AVX2.
+ *
+ * @param[out] hash				- the digests.
+ * @param[in] msg				- the messages to hash.
+ * @param[in] len				- the message lengths in bytes.
+ * @param[in] n					- the number of messages.
+ */
+void md_map_sh256_x8(uint8_t **hash, uint8_t **msg, int *len, int n);
+
 /**
  * Computes the SHA-384 hash function.
  *
@@ -143,6 +489,32 @@ void md_map_sh256(uint8_t *hash, const uint8_t *msg, int len);
  */
 void md_map_sh384(uint8_t *hash, const uint8_t *msg, int len);
 
+/**
+ * Initializes the incremental computation of the SHA-384 hash function.
+ *
+ * @param[out] ctx				- the context.
+ */
+void md_sh384_init(md_sh384_t *ctx);
+
+/**
+ * Adds a byte vector to the incremental computation of the SHA-384 hash
+ * function.
+ *
+ * @param[in,out] ctx			- the context.
+ * @param[in] msg				- the bytes to hash.
+ * @param[in] len				- the number of bytes.
+ */
+void md_sh384_update(md_sh384_t *ctx, const uint8_t *msg, int len);
+
+/**
+ * Finishes the incremental computation of the SHA-384 hash function. The
+ * context must be initialized again before being reused.
+ *
+ * @param[in,out] ctx			- the context.
+ * @param[out] hash				- the digest.
+ */
+void md_sh384_final(md_sh384_t *ctx, uint8_t *hash);
+
 /**
  * Computes the SHA-512 hash function.
  *
@@ -152,6 +524,203 @@ void md_map_sh384(uint8_t *hash, const uint8_t *msg, int len);
  */
 void md_map_sh512(uint8_t *hash, const uint8_t *msg, int len);
 
+/**
+ * Initializes the incremental computation of the SHA-512 hash function.
+ *
+ * @param[out] ctx				- the context.
+ */
+void md_sh512_init(md_sh512_t *ctx);
+
+/**
+ * Adds a byte vector to the incremental computation of the SHA-512 hash
+ * function.
+ *
+ * @param[in,out] ctx			- the context.
+ * @param[in] msg				- the bytes to hash.
+ * @param[in] len				- the number of bytes.
+ */
+void md_sh512_update(md_sh512_t *ctx, const uint8_t *msg, int len);
+
+/**
+ * Finishes the incremental computation of the SHA-512 hash function. The
+ * context must be initialized again before being reused.
+ *
+ * @param[in,out] ctx			- the context.
+ * @param[out] hash				- the digest.
+ */
+void md_sh512_final(md_sh512_t *ctx, uint8_t *hash);
+
+/**
+ * Computes the SHA-512 hash function over several independent messages,
+ * four at a time in parallel SIMD lanes when the processor supports AVX2.
+ *
+ * @param[out] hash				- the digests.
+ * @param[in] msg				- the messages to hash.
+ * @param[in] len				- the message lengths in bytes.
+ * @param[in] n					- the number of messages.
+ */
+void md_map_sh512_x4(uint8_t **hash, uint8_t **msg, int *len, int n);
+
+/**
+ * Computes the SHA3-256 hash function.
+ *
+ * @param[out] hash				- the digest.
+ * @param[in] msg				- the message to hash.
+ * @param[in] len				- the message length in bytes.
+ */
+void md_map_sh3_256(uint8_t *hash, const uint8_t *msg, int len);
+
+/**
+ * Initializes the incremental computation of the SHA3-256 hash function.
+ *
+ * @param[out] ctx				- the context.
+ */
+void md_sh3_256_init(md_sh3_256_t *ctx);
+
+/**
+ * Adds a byte vector to the incremental computation of the SHA3-256 hash
+ * function.
+ *
+ * @param[in,out] ctx			- the context.
+ * @param[in] msg				- the bytes to hash.
+ * @param[in] len				- the number of bytes.
+ */
+void md_sh3_256_update(md_sh3_256_t *ctx, const uint8_t *msg, int len);
+
+/**
+ * Finishes the incremental computation of the SHA3-256 hash function. The
+ * context must be initialized again before being reused.
+ *
+ * @param[in,out] ctx			- the context.
+ * @param[out] hash				- the digest.
+ */
+void md_sh3_256_final(md_sh3_256_t *ctx, uint8_t *hash);
+
+/**
+ * Computes the SHA3-512 hash function.
+ *
+ * @param[out] hash				- the digest.
+ * @param[in] msg				- the message to hash.
+ * @param[in] len				- the message length in bytes.
+ */
+void md_map_sh3_512(uint8_t *hash, const uint8_t *msg, int len);
+
+/**
+ * Initializes the incremental computation of the SHA3-512 hash function.
+ *
+ * @param[out] ctx				- the context.
+ */
+void md_sh3_512_init(md_sh3_512_t *ctx);
+
+/**
+ * Adds a byte vector to the incremental computation of the SHA3-512 hash
+ * function.
+ *
+ * @param[in,out] ctx			- the context.
+ * @param[in] msg				- the bytes to hash.
+ * @param[in] len				- the number of bytes.
+ */
+void md_sh3_512_update(md_sh3_512_t *ctx, const uint8_t *msg, int len);
+
+/**
+ * Finishes the incremental computation of the SHA3-512 hash function. The
+ * context must be initialized again before being reused.
+ *
+ * @param[in,out] ctx			- the context.
+ * @param[out] hash				- the digest.
+ */
+void md_sh3_512_final(md_sh3_512_t *ctx, uint8_t *hash);
+
+/**
+ * Computes the BLAKE2s-256 hash function.
+ *
+ * @param[out] hash				- the digest.
+ * @param[in] msg				- the message to hash.
+ * @param[in] len				- the message length in bytes.
+ */
+void md_map_b2s_256(uint8_t *hash, const uint8_t *msg, int len);
+
+/**
+ * Initializes the incremental computation of the BLAKE2s-256 hash function.
+ *
+ * @param[out] ctx				- the context.
+ */
+void md_b2s_256_init(md_b2s_256_t *ctx);
+
+/**
+ * Adds a byte vector to the incremental computation of the BLAKE2s-256 hash
+ * function.
+ *
+ * @param[in,out] ctx			- the context.
+ * @param[in] msg				- the bytes to hash.
+ * @param[in] len				- the number of bytes.
+ */
+void md_b2s_256_update(md_b2s_256_t *ctx, const uint8_t *msg, int len);
+
+/**
+ * Finishes the incremental computation of the BLAKE2s-256 hash function. The
+ * context must be initialized again before being reused.
+ *
+ * @param[in,out] ctx			- the context.
+ * @param[out] hash				- the digest.
+ */
+void md_b2s_256_final(md_b2s_256_t *ctx, uint8_t *hash);
+
+/**
+ * Computes the BLAKE2b-512 hash function.
+ *
+ * @param[out] hash				- the digest.
+ * @param[in] msg				- the message to hash.
+ * @param[in] len				- the message length in bytes.
+ */
+void md_map_b2b_512(uint8_t *hash, const uint8_t *msg, int len);
+
+/**
+ * Initializes the incremental computation of the BLAKE2b-512 hash function.
+ *
+ * @param[out] ctx				- the context.
+ */
+void md_b2b_512_init(md_b2b_512_t *ctx);
+
+/**
+ * Adds a byte vector to the incremental computation of the BLAKE2b-512 hash
+ * function.
+ *
+ * @param[in,out] ctx			- the context.
+ * @param[in] msg				- the bytes to hash.
+ * @param[in] len				- the number of bytes.
+ */
+void md_b2b_512_update(md_b2b_512_t *ctx, const uint8_t *msg, int len);
+
+/**
+ * Finishes the incremental computation of the BLAKE2b-512 hash function. The
+ * context must be initialized again before being reused.
+ *
+ * @param[in,out] ctx			- the context.
+ * @param[out] hash				- the digest.
+ */
+void md_b2b_512_final(md_b2b_512_t *ctx, uint8_t *hash);
+
+/**
+ * Computes the SHAKE128 extendable-output function.
+ *
+ * @param[out] out				- the output.
+ * @param[in] out_len			- the number of bytes to output.
+ * @param[in] msg				- the message to hash.
+ * @param[in] len				- the message length in bytes.
+ */
+void md_xof_shk128(uint8_t *out, int out_len, const uint8_t *msg, int len);
+
+/**
+ * Computes the SHAKE256 extendable-output function.
+ *
+ * @param[out] out				- the output.
+ * @param[in] out_len			- the number of bytes to output.
+ * @param[in] msg				- the message to hash.
+ * @param[in] len				- the message length in bytes.
+ */
+void md_xof_shk256(uint8_t *out, int out_len, const uint8_t *msg, int len);
+
 /**
  * Derives a key from shared secret material through the standardized KDF1
  * function.
@@ -197,4 +766,77 @@ void md_mgf1(uint8_t *mask, int mask_len, const uint8_t *in, int in_len);
 void md_hmac(uint8_t *mac, const uint8_t *in, int in_len, const uint8_t *key,
 		int key_len);
 
+/**
+ * Initializes the computation of HMAC, hashing the padded key only once so
+ * that the context can authenticate several messages under the same key.
+ *
+ * @param[out] ctx				- the context.
+ * @param[in] key				- the cryptographic key.
+ * @param[in] key_len			- the size of the key in bytes.
+ */
+void md_hmac_init(md_hmac_t *ctx, const uint8_t *key, int key_len);
+
+/**
+ * Adds a byte vector to the message being authenticated.
+ *
+ * @param[in,out] ctx			- the context.
+ * @param[in] in				- the data to authenticate.
+ * @param[in] in_len			- the number of bytes to authenticate.
+ */
+void md_hmac_update(md_hmac_t *ctx, const uint8_t *in, int in_len);
+
+/**
+ * Finishes the computation of HMAC over the current message. The context is
+ * left ready to authenticate a new message under the same key.
+ *
+ * @param[in,out] ctx			- the context.
+ * @param[out] mac				- the authentication.
+ */
+void md_hmac_final(md_hmac_t *ctx, uint8_t *mac);
+
+/**
+ * Extracts a pseudorandom key from input keying material through the HKDF
+ * function (RFC 5869).
+ *
+ * @param[out] prk				- the pseudorandom key with MD_LEN bytes.
+ * @param[in] salt				- the optional salt.
+ * @param[in] salt_len			- the length of the salt in bytes.
+ * @param[in] in				- the input keying material.
+ * @param[in] in_len			- the length of the keying material in bytes.
+ */
+void md_hkdf_ext(uint8_t *prk, const uint8_t *salt, int salt_len,
+		const uint8_t *in, int in_len);
+
+/**
+ * Expands a pseudorandom key into output keying material through the HKDF
+ * function (RFC 5869).
+ *
+ * @param[out] key				- the output keying material.
+ * @param[in] key_len			- the intended key length in bytes.
+ * @param[in] prk				- the pseudorandom key.
+ * @param[in] prk_len			- the length of the pseudorandom key in bytes.
+ * @param[in] info				- the optional context information.
+ * @param[in] info_len			- the length of the information in bytes.
+ * @throw ERR_NO_VALID			- if the key length exceeds 255 * MD_LEN.
+ */
+void md_hkdf_exp(uint8_t *key, int key_len, const uint8_t *prk, int prk_len,
+		const uint8_t *info, int info_len);
+
+/**
+ * Derives a key from shared secret material through the HKDF function
+ * (RFC 5869), extracting and then expanding.
+ *
+ * @param[out] key				- the resulting key.
+ * @param[in] key_len			- the intended key length in bytes.
+ * @param[in] in				- the shared secret.
+ * @param[in] in_len			- the length of the shared secret in bytes.
+ * @param[in] salt				- the optional salt.
+ * @param[in] salt_len			- the length of the salt in bytes.
+ * @param[in] info				- the optional context information.
+ * @param[in] info_len			- the length of the information in bytes.
+ * @throw ERR_NO_VALID			- if the key length exceeds 255 * MD_LEN.
+ */
+void md_hkdf(uint8_t *key, int key_len, const uint8_t *in, int in_len,
+		const uint8_t *salt, int salt_len, const uint8_t *info, int info_len);
+
 #endif /* !RELIC_MD_H */
@@ -0,0 +1,76 @@
+/*
+ * RELIC is an Efficient LIbrary for Cryptography
+ * Copyright (C) 2007-2015 RELIC Authors
+ *
+ * This file is part of RELIC. RELIC is legal property of its developers,
+ * whose names are not listed here. Please refer to the COPYRIGHT file
+ * for contact information.
+ *
+ * RELIC is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * RELIC is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with RELIC. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ *
+ * Interface of the thread pool used to split batches of independent operations
+ * among the available processor cores.
+ *
+ * @ingroup relic
+ */
+
+#ifndef RELIC_MULTI_H
+#define RELIC_MULTI_H
+
+#include "relic_conf.h"
+#include "relic_types.h"
+#include "relic_label.h"
+
+/*============================================================================*/
+/* Function prototypes                                                        */
+/*============================================================================*/
+
+/**
+ * Returns the number of threads used to process batches of operations.
+ *
+ * @return the number of threads.
+ */
+int multi_get_cores(void);
+
+/**
+ * Sets the number of threads used to process batches of operations. The value
+ * is clamped to the interval [1, CORES].
+ *
+ * @param[in] cores			- the number of threads.
+ */
+void multi_set_cores(int cores);
+
+/**
+ * Runs a batch of independent tasks on the thread pool and waits for all of
+ * them to finish. Each worker thread owns a library context which is
+ * configured with the same parameters as the context of the caller, and its
+ * pseudo-random number generator is reseeded from the generator of the caller,
+ * or uses the same callback when RAND is CALL. Tasks are distributed in
+ * contiguous ranges and idle threads steal half of the remaining range of a
+ * busy thread.
+ *
+ * Errors raised by the tasks are thrown again in the caller after all tasks
+ * finish.
+ *
+ * @param[in] task			- the function that processes one task.
+ * @param[in] args			- the arguments shared by all tasks.
+ * @param[in] n				- the number of tasks.
+ */
+void multi_run(void (*task)(void *, int), void *args, int n);
+
+#endif /* !RELIC_MULTI_H */
@@ -764,6 +764,16 @@ typedef CAT(GT_LOWER, t) gt_t;
  */
 #define g1_map(P, M, L);	CAT(G1_LOWER, map)(P, M, L)
 
+/**
+ * Maps several byte arrays to elements in G_1.
+ *
+ * @param[out] P			- the results.
+ * @param[in] M				- the byte arrays to map.
+ * @param[in] L				- the array lengths in bytes.
+ * @param[in] N				- the number of byte arrays.
+ */
+#define g1_map_lot(P, M, L, N)	CAT(G1_LOWER, map_lot)(P, M, L, N)
+
 /**
  * Maps a byte array to an element in G_2.
  *
@@ -787,6 +797,19 @@ typedef CAT(GT_LOWER, t) gt_t;
 #define pc_map(R, P, Q);	CAT(PC_LOWER, map_k2)(R, P, Q)
 #endif
 
+/**
+ * Computes a product of bilinear pairings of G_1 and G_2 elements. Computes
+ * R = \prod e(P_i, Q_i).
+ *
+ * @param[out] R			- the result.
+ * @param[in] P				- the first elements.
+ * @param[in] Q				- the second elements.
+ * @param[in] M				- the number of pairings to evaluate.
+ */
+#if FP_PRIME < 1536
+#define pc_map_sim(R, P, Q, M);	CAT(PC_LOWER, map_sim_k12)(R, P, Q, M)
+#endif
+
 /**
  * Computes the final exponentiation of the pairing.
  *
@@ -47,20 +47,35 @@
 #if ALLOC == STATIC
 
 /**
- * The size of the static pool of digit vectors.
+ * The number of elements in each slab of the static pool. The first slab of
+ * each size class is reserved statically, further slabs are allocated on
+ * demand when the pool runs out of free elements.
  */
 #ifndef POOL_SIZE
-#define POOL_SIZE	(MAX(TESTS, MAX(BENCH * BENCH, 10000)))
+#define POOL_SIZE	(1024)
 #endif
 
-/** Indicates that the pool element is already used. */
-#define POOL_USED	(1)
+/**
+ * The maximum number of slabs in each size class of the pool.
+ */
+#ifndef POOL_SLABS
+#define POOL_SLABS	(256)
+#endif
+
+/** Size class for prime and binary field elements. */
+#define POOL_FP		(0)
+
+/** Size class for multiple precision integers. */
+#define POOL_BN		(1)
+
+/** Size class for temporary double-precision digit vectors. */
+#define POOL_DV		(2)
 
-/** Indicates that the pool element is free. */
-#define POOL_FREE	(0)
+/** Number of size classes in the pool. */
+#define POOL_CLASSES	(3)
 
-/** Indicates that the pool is empty. */
-#define POOL_EMPTY (-1)
+/** Indicates that a list of pool elements is empty. */
+#define POOL_EMPTY	(0)
 
 #endif
 
@@ -68,16 +83,38 @@
 /* Type definitions                                                           */
 /*============================================================================*/
 
+#if ALLOC == STATIC
+
 /**
- * Type that represents a element of a pool of digit vectors.
+ * Type that represents the header stored right before each pool element.
  */
 typedef struct {
-	/** Indicates if this pool element is being used. */
-	int state;
-	/** The pool element. The extra digit stores the pool position. */
-	align dig_t elem[DV_DIGS + 1];
+	/** The position of the next free element when this element is free. */
+	uint32_t next;
+	/** The position of this element inside its size class, plus one. */
+	uint32_t self;
+	/** The size class of this element. */
+	int kind;
+} pool_hdr_t;
+
+/**
+ * Type that represents a size class of the pool of digit vectors.
+ *
+ * Free elements are kept in a lock-free stack. The head of the stack stores
+ * the position of the top element in the lower 32 bits and a modification
+ * counter in the upper 32 bits to avoid the ABA problem.
+ */
+typedef struct {
+	/** The head of the list of free elements. */
+	uint64_t head;
+	/** The number of elements ever handed out from the slabs. */
+	uint32_t fresh;
+	/** The slabs of memory backing this size class. */
+	dig_t *slab[POOL_SLABS];
 } pool_t;
 
+#endif
+
 /*============================================================================*/
 /* Function prototypes                                                        */
 /*============================================================================*/
@@ -87,9 +124,11 @@ typedef struct {
 /**
  * Gets a new element from the static pool.
  *
- * @returns the address of a free element in the static pool.
+ * @param[in] digits		- the required precision in digits.
+ * @returns the address of a free element in the static pool or NULL if no
+ * memory is available.
  */
-dig_t *pool_get(void);
+dig_t *pool_get(int digits);
 
 /**
  * Restores an element to the static pool.
@@ -98,6 +137,17 @@ dig_t *pool_get(void);
  */
 void pool_put(dig_t *a);
 
+/**
+ * Registers a library context that may use the static pool.
+ */
+void pool_init(void);
+
+/**
+ * Unregisters a library context. When the last context is finalized and every
+ * element was restored to the pool, the slabs allocated on demand are released.
+ */
+void pool_clean(void);
+
 #endif
 
 #endif /* !RELIC_POOL_H */
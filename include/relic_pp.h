@@ -200,6 +200,24 @@
 #define pp_map_k12(R, P, Q)				pp_map_oatep_k12(R, P, Q)
 #endif
 
+/**
+ * Computes a product of pairings of pairs of prime elliptic curve points
+ * defined on an elliptic curve of embedding degree 12. Computes
+ * \prod e(P_i, Q_i).
+ *
+ * @param[out] R			- the result.
+ * @param[in] P				- the first elliptic curve points.
+ * @param[in] Q				- the second elliptic curve points.
+ * @param[in] M				- the number of pairings to evaluate.
+ */
+#if PP_MAP == TATEP
+#define pp_map_sim_k12(R, P, Q, M)		pp_map_sim_tatep_k12(R, P, Q, M)
+#elif PP_MAP == WEILP
+#define pp_map_sim_k12(R, P, Q, M)		pp_map_sim_weilp_k12(R, P, Q, M)
+#elif PP_MAP == OATEP
+#define pp_map_sim_k12(R, P, Q, M)		pp_map_sim_oatep_k12(R, P, Q, M)
+#endif
+
 /*============================================================================*/
 /* Function prototypes                                                        */
 /*============================================================================*/
@@ -466,4 +484,41 @@ void pp_map_weilp_k12(fp12_t r, ep_t p, ep2_t q);
  */
 void pp_map_oatep_k12(fp12_t r, ep_t p, ep2_t q);
 
+/**
+ * Computes a product of Tate pairings of pairs of points in a parameterized
+ * elliptic curve with embedding degree 12. The Miller loops are distributed
+ * among the thread pool and a single final exponentiation is computed.
+ *
+ * @param[out] r			- the result.
+ * @param[in] p				- the first elliptic curve points.
+ * @param[in] q				- the second elliptic curve points.
+ * @param[in] m				- the number of pairings to evaluate.
+ */
+void pp_map_sim_tatep_k12(fp12_t r, ep_t *p, ep2_t *q, int m);
+
+/**
+ * Computes a product of Weil pairings of pairs of points in a parameterized
+ * elliptic curve with embedding degree 12. The pairings are distributed among
+ * the thread pool.
+ *
+ * @param[out] r			- the result.
+ * @param[in] p				- the first elliptic curve points.
+ * @param[in] q				- the second elliptic curve points.
+ * @param[in] m				- the number of pairings to evaluate.
+ */
+void pp_map_sim_weilp_k12(fp12_t r, ep_t *p, ep2_t *q, int m);
+
+/**
+ * Computes a product of optimal ate pairings of pairs of points in a
+ * parameterized elliptic curve with embedding degree 12. The Miller loops are
+ * distributed among the thread pool and a single final exponentiation is
+ * computed.
+ *
+ * @param[out] r			- the result.
+ * @param[in] p				- the first elliptic curve points.
+ * @param[in] q				- the second elliptic curve points.
+ * @param[in] m				- the number of pairings to evaluate.
+ */
+void pp_map_sim_oatep_k12(fp12_t r, ep_t *p, ep2_t *q, int m);
+
 #endif /* !RELIC_PP_H */
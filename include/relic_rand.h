@@ -35,7 +35,7 @@
 #ifndef RELIC_RAND_H
 #define RELIC_RAND_H
 
-#include "relic_rand.h"
+#include "relic_md.h"
 
 /*============================================================================*/
 /* Constant definitions                                                       */
@@ -46,12 +46,18 @@
  */
 #if RAND == HASH
 
-#if MD_MAP == SHONE || MD_MAP == SH224 || MD_MAP == SH256
+#if MD_MAP == SHONE || MD_MAP == SH224 || MD_MAP == SH256 || \
+	MD_MAP == SH3_256 || MD_MAP == B2S_256
 #define RAND_SIZE		(1 + 2*440/8)
-#elif MD_MAP == SH384 || MD_MAP == SH512
+#elif MD_MAP == SH384 || MD_MAP == SH512 || MD_MAP == SH3_512 || \
+	MD_MAP == B2B_512
 #define RAND_SIZE		(1 + 2*888/8)
 #endif
 
+#elif RAND == HMAC
+#define RAND_SIZE		(2 * MD_LEN)
+#elif RAND == CTR
+#define RAND_SIZE		(32 + 16)
 #elif RAND == UDEV
 #define RAND_SIZE		(sizeof(int))
 #elif RAND == FIPS
@@ -60,6 +66,8 @@
 #define RAND_SIZE		(sizeof(void (*)(uint8_t *, int)))
 #elif RAND == RDRND
 #define RAND_SIZE      0
+#elif RAND == CHACHA
+#define RAND_SIZE		32
 #endif
 
 /**
@@ -67,6 +75,11 @@
  */
 #define SEED_SIZE	    64
 
+/**
+ * Largest request served from the output buffer, bigger ones bypass it.
+ */
+#define RAND_SMALL		(RAND_BUF / 4)
+
 /*============================================================================*/
 /* Function prototypes                                                        */
 /*============================================================================*/
@@ -96,7 +109,8 @@ void rand_seed(uint8_t *buf, int size);
 
 /**
  * Sets the initial state of the pseudo-random number generator as a function
- * pointer.
+ * pointer. Worker threads of multi_run() call the same function, so it must
+ * be thread-safe when MULTI is not NONE.
  * 
  * @param[in] callback		- the callback to call.
  * @param[in] arg			- the argument for the callback.
@@ -116,4 +130,25 @@ void rand_seed(void (*callback)(uint8_t *, int, void *), void *arg);
  */
 void rand_bytes(uint8_t *buf, int size);
 
+/**
+ * Gathers a small number of pseudo-random bytes. The bytes are taken from an
+ * output buffer in the library context which is refilled with a single call
+ * to rand_bytes() when exhausted. Consumed bytes are erased from the buffer.
+ * Requests larger than RAND_SMALL are forwarded to rand_bytes().
+ *
+ * @param[out] buf			- the buffer to write.
+ * @param[in] size			- the number of bytes to gather.
+ * @throw ERR_NO_VALID		- if the required length is too large.
+ * @throw ERR_NO_READ		- it the pseudo-random number generator cannot
+ * 							generate the specified number of bytes.
+ */
+void rand_bytes_small(uint8_t *buf, int size);
+
+/**
+ * Erases the buffered output of the pseudo-random number generator. Called
+ * whenever the generator is seeded, so that no bytes produced from a previous
+ * state are returned afterwards.
+ */
+void rand_flush(void);
+
 #endif /* !RELIC_RAND_H */
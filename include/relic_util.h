@@ -214,6 +214,15 @@ int util_bits_dig(dig_t a);
  */
 int util_cmp_const(const void *a, const void *b, int n);
 
+/**
+ * Overwrites a buffer with zeros in a way the compiler cannot remove, to
+ * erase sensitive data before the buffer goes out of scope.
+ *
+ * @param[out] a			- the buffer.
+ * @param[in] n				- the length in bytes of the buffer.
+ */
+void util_wipe(void *a, int n);
+
 /**
  * Formats and prints data following a printf-like syntax.
  *
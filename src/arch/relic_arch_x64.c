@@ -29,6 +29,8 @@
  * @ingroup arch
  */
 
+#include <cpuid.h>
+
 #include "relic_types.h"
 #include "relic_arch.h"
 
@@ -37,16 +39,81 @@
  */
 #define asm					__asm__ volatile
 
+/*============================================================================*/
+/* Private definitions                                                        */
+/*============================================================================*/
+
+/**
+ * Instruction set extensions supported by the processor.
+ */
+static int features = 0;
+
+/**
+ * Instruction set extensions the library is allowed to use.
+ */
+static int allowed = ARCH_ALL;
+
+/**
+ * Queries the processor for the instruction set extensions used by the
+ * library.
+ *
+ * @return the detected extensions as a combination of ARCH_* flags.
+ */
+static int arch_detect(void) {
+	unsigned int a, b, c, d, xlo, xhi;
+	int result = 0;
+
+	if (__get_cpuid(1, &a, &b, &c, &d) == 0) {
+		return 0;
+	}
+	if ((c & bit_SSSE3) && (c & bit_SSE4_1)) {
+		result |= ARCH_SSE41;
+	}
+	if (c & bit_AES) {
+		result |= ARCH_AESNI;
+	}
+	if (c & bit_PCLMUL) {
+		result |= ARCH_CLMUL;
+	}
+	/* AVX2 also needs the operating system to save the YMM registers. */
+	xlo = 0;
+	if (c & bit_OSXSAVE) {
+		asm ("xgetbv" : "=a" (xlo), "=d" (xhi) : "c" (0));
+	}
+	if (__get_cpuid_max(0, 0) >= 7) {
+		__cpuid_count(7, 0, a, b, c, d);
+		if ((b & bit_AVX2) && (xlo & 0x6) == 0x6) {
+			result |= ARCH_AVX2;
+		}
+		if (b & bit_BMI2) {
+			result |= ARCH_BMI2;
+		}
+		if ((b & bit_SHA) && (result & ARCH_SSE41)) {
+			result |= ARCH_SHANI;
+		}
+	}
+	return result;
+}
+
 /*============================================================================*/
 /* Public definitions                                                         */
 /*============================================================================*/
 
 void arch_init(void) {
+	features = arch_detect();
 }
 
 void arch_clean(void) {
 }
 
+int arch_features(void) {
+	return features & allowed;
+}
+
+void arch_limit(int mask) {
+	allowed = mask;
+}
+
 ull_t arch_cycles(void) {
 	unsigned int hi, lo;
 	asm (
@@ -34,54 +34,814 @@
 #include "relic_core.h"
 #include "relic_err.h"
 #include "relic_bc.h"
-#include "rijndael-api-fst.h"
+#include "relic_arch.h"
+
+#if ARCH == X64 && defined(__GNUC__)
+#include <immintrin.h>
+#endif
+
+/*============================================================================*/
+/* Private definitions                                                        */
+/*============================================================================*/
+
+/**
+ * Number of blocks processed together by the pipelined AES-NI code.
+ */
+#define PIPE		8
+
+/**
+ * Number of blocks processed together by the bitsliced code.
+ */
+#define SLICE		4
+
+/**
+ * Per-lane masks used to rotate the 16-byte lanes of a bitsliced state.
+ */
+#define LANE_4		0x0FFF0FFF0FFF0FFFULL
+#define LANE_8		0x00FF00FF00FF00FFULL
+#define LANE_12		0x000F000F000F000FULL
+
+/**
+ * Masks selecting the rows of the AES state in a bitsliced lane.
+ */
+#define ROW_0		0x1111111111111111ULL
+#define ROW_1		0x2222222222222222ULL
+#define ROW_2		0x4444444444444444ULL
+#define ROW_3		0x8888888888888888ULL
+
+/**
+ * Round constants of the key schedule.
+ */
+static const uint8_t aes_rcon[10] = {
+	0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1B, 0x36
+};
+
+/**
+ * Applies the AES S-box to 64 bytes in bitsliced representation, using the
+ * circuit of Boyar and Peralta. Bit plane q[i] holds bit i of every byte.
+ *
+ * @param[in,out] q			- the bit planes.
+ */
+static void aes_sbox(uint64_t *q) {
+	uint64_t x0, x1, x2, x3, x4, x5, x6, x7;
+	uint64_t y1, y2, y3, y4, y5, y6, y7, y8, y9, y10, y11, y12;
+	uint64_t y13, y14, y15, y16, y17, y18, y19, y20, y21;
+	uint64_t z0, z1, z2, z3, z4, z5, z6, z7, z8, z9, z10, z11;
+	uint64_t z12, z13, z14, z15, z16, z17;
+	uint64_t t0, t1, t2, t3, t4, t5, t6, t7, t8, t9, t10, t11, t12;
+	uint64_t t13, t14, t15, t16, t17, t18, t19, t20, t21, t22, t23, t24;
+	uint64_t t25, t26, t27, t28, t29, t30, t31, t32, t33, t34, t35, t36;
+	uint64_t t37, t38, t39, t40, t41, t42, t43, t44, t45, t46, t47, t48;
+	uint64_t t49, t50, t51, t52, t53, t54, t55, t56, t57, t58, t59, t60;
+	uint64_t t61, t62, t63, t64, t65, t66, t67;
+	uint64_t s0, s1, s2, s3, s4, s5, s6, s7;
+
+	x0 = q[7]; x1 = q[6]; x2 = q[5]; x3 = q[4];
+	x4 = q[3]; x5 = q[2]; x6 = q[1]; x7 = q[0];
+
+	/* Top linear transformation. */
+	y14 = x3 ^ x5; y13 = x0 ^ x6; y9 = x0 ^ x3; y8 = x0 ^ x5;
+	t0 = x1 ^ x2; y1 = t0 ^ x7; y4 = y1 ^ x3; y12 = y13 ^ y14;
+	y2 = y1 ^ x0; y5 = y1 ^ x6; y3 = y5 ^ y8; t1 = x4 ^ y12;
+	y15 = t1 ^ x5; y20 = t1 ^ x1; y6 = y15 ^ x7; y10 = y15 ^ t0;
+	y11 = y20 ^ y9; y7 = x7 ^ y11; y17 = y10 ^ y11; y19 = y10 ^ y8;
+	y16 = t0 ^ y11; y21 = y13 ^ y16; y18 = x0 ^ y16;
+
+	/* Non-linear section. */
+	t2 = y12 & y15; t3 = y3 & y6; t4 = t3 ^ t2; t5 = y4 & x7;
+	t6 = t5 ^ t2; t7 = y13 & y16; t8 = y5 & y1; t9 = t8 ^ t7;
+	t10 = y2 & y7; t11 = t10 ^ t7; t12 = y9 & y11; t13 = y14 & y17;
+	t14 = t13 ^ t12; t15 = y8 & y10; t16 = t15 ^ t12; t17 = t4 ^ t14;
+	t18 = t6 ^ t16; t19 = t9 ^ t14; t20 = t11 ^ t16; t21 = t17 ^ y20;
+	t22 = t18 ^ y19; t23 = t19 ^ y21; t24 = t20 ^ y18;
+
+	t25 = t21 ^ t22; t26 = t21 & t23; t27 = t24 ^ t26; t28 = t25 & t27;
+	t29 = t28 ^ t22; t30 = t23 ^ t24; t31 = t22 ^ t26; t32 = t31 & t30;
+	t33 = t32 ^ t24; t34 = t23 ^ t33; t35 = t27 ^ t33; t36 = t24 & t35;
+	t37 = t36 ^ t34; t38 = t27 ^ t36; t39 = t29 & t38; t40 = t25 ^ t39;
+
+	t41 = t40 ^ t37; t42 = t29 ^ t33; t43 = t29 ^ t40; t44 = t33 ^ t37;
+	t45 = t42 ^ t41;
+	z0 = t44 & y15; z1 = t37 & y6; z2 = t33 & x7; z3 = t43 & y16;
+	z4 = t40 & y1; z5 = t29 & y7; z6 = t42 & y11; z7 = t45 & y17;
+	z8 = t41 & y10; z9 = t44 & y12; z10 = t37 & y3; z11 = t33 & y4;
+	z12 = t43 & y13; z13 = t40 & y5; z14 = t29 & y2; z15 = t42 & y9;
+	z16 = t45 & y14; z17 = t41 & y8;
+
+	/* Bottom linear transformation. */
+	t46 = z15 ^ z16; t47 = z10 ^ z11; t48 = z5 ^ z13; t49 = z9 ^ z10;
+	t50 = z2 ^ z12; t51 = z2 ^ z5; t52 = z7 ^ z8; t53 = z0 ^ z3;
+	t54 = z6 ^ z7; t55 = z16 ^ z17; t56 = z12 ^ t48; t57 = t50 ^ t53;
+	t58 = z4 ^ t46; t59 = z3 ^ t54; t60 = t46 ^ t57; t61 = z14 ^ t57;
+	t62 = t52 ^ t58; t63 = t49 ^ t58; t64 = z4 ^ t59; t65 = t61 ^ t62;
+	t66 = z1 ^ t63; s0 = t59 ^ t63; s6 = t56 ^ ~t62; s7 = t48 ^ ~t60;
+	t67 = t64 ^ t65; s3 = t53 ^ t66; s4 = t51 ^ t66; s5 = t47 ^ t65;
+	s1 = t64 ^ ~s3; s2 = t55 ^ ~t67;
+
+	q[7] = s0; q[6] = s1; q[5] = s2; q[4] = s3;
+	q[3] = s4; q[2] = s5; q[1] = s6; q[0] = s7;
+}
+
+/**
+ * Applies the inverse of the affine transformation of the S-box to a
+ * bitsliced state.
+ *
+ * @param[in,out] q			- the bit planes.
+ */
+static void aes_affine_inv(uint64_t *q) {
+	uint64_t t[8];
+	int i;
+
+	for (i = 0; i < 8; i++) {
+		t[i] = q[(i + 7) & 7] ^ q[(i + 5) & 7] ^ q[(i + 2) & 7];
+	}
+	/* Add the constant 0x05. */
+	t[0] = ~t[0];
+	t[2] = ~t[2];
+	memcpy(q, t, sizeof(t));
+}
+
+/**
+ * Applies the inverse AES S-box to a bitsliced state. Since the S-box is an
+ * affine map A composed with inversion, its inverse is A^{-1} S A^{-1}.
+ *
+ * @param[in,out] q			- the bit planes.
+ */
+static void aes_sbox_inv(uint64_t *q) {
+	aes_affine_inv(q);
+	aes_sbox(q);
+	aes_affine_inv(q);
+}
+
+/**
+ * Rotates each 16-bit lane of a bit plane to the right.
+ *
+ * @param[in] x				- the bit plane.
+ * @param[in] k				- the rotation amount, a multiple of four.
+ * @param[in] m				- the lane mask for that rotation amount.
+ * @return the rotated plane.
+ */
+static inline uint64_t rot_lane(uint64_t x, int k, uint64_t m) {
+	return ((x >> k) & m) | ((x << (16 - k)) & ~m);
+}
+
+/**
+ * Rotates each 4-bit column of a bit plane by a number of rows.
+ *
+ * @param[in] x				- the bit plane.
+ * @param[in] k				- the number of rows.
+ * @return the rotated plane.
+ */
+static inline uint64_t rot_col(uint64_t x, int k) {
+	static const uint64_t m[4] = {
+		~0ULL, 0x7777777777777777ULL, 0x3333333333333333ULL, ROW_0
+	};
+	return ((x >> k) & m[k]) | ((x << (4 - k)) & ~m[k]);
+}
+
+/**
+ * Applies the ShiftRows step to a bitsliced state.
+ *
+ * @param[in,out] q			- the bit planes.
+ */
+static void aes_shift(uint64_t *q) {
+	for (int i = 0; i < 8; i++) {
+		uint64_t x = q[i];
+		q[i] = (x & ROW_0) | (rot_lane(x, 4, LANE_4) & ROW_1) |
+				(rot_lane(x, 8, LANE_8) & ROW_2) |
+				(rot_lane(x, 12, LANE_12) & ROW_3);
+	}
+}
+
+/**
+ * Applies the inverse ShiftRows step to a bitsliced state.
+ *
+ * @param[in,out] q			- the bit planes.
+ */
+static void aes_shift_inv(uint64_t *q) {
+	for (int i = 0; i < 8; i++) {
+		uint64_t x = q[i];
+		q[i] = (x & ROW_0) | (rot_lane(x, 12, LANE_12) & ROW_1) |
+				(rot_lane(x, 8, LANE_8) & ROW_2) |
+				(rot_lane(x, 4, LANE_4) & ROW_3);
+	}
+}
+
+/**
+ * Multiplies every byte of a bitsliced state by x in GF(2^8).
+ *
+ * @param[out] t			- the result.
+ * @param[in] a				- the bit planes.
+ */
+static void aes_xtime(uint64_t *t, const uint64_t *a) {
+	uint64_t h = a[7];
+
+	t[7] = a[6];
+	t[6] = a[5];
+	t[5] = a[4];
+	t[4] = a[3] ^ h;
+	t[3] = a[2] ^ h;
+	t[2] = a[1];
+	t[1] = a[0] ^ h;
+	t[0] = h;
+}
+
+/**
+ * Applies the MixColumns step to a bitsliced state.
+ *
+ * @param[in,out] q			- the bit planes.
+ */
+static void aes_mix(uint64_t *q) {
+	uint64_t s[8], t[8];
+	int i;
+
+	/* With s = a + rot(a, 1), b = 2 * s + s + a + rot(s, 2). */
+	for (i = 0; i < 8; i++) {
+		s[i] = q[i] ^ rot_col(q[i], 1);
+	}
+	aes_xtime(t, s);
+	for (i = 0; i < 8; i++) {
+		q[i] ^= t[i] ^ s[i] ^ rot_col(s[i], 2);
+	}
+}
+
+/**
+ * Applies the inverse MixColumns step to a bitsliced state, as MixColumns
+ * preceded by a multiplication by 4x^2 + 5.
+ *
+ * @param[in,out] q			- the bit planes.
+ */
+static void aes_mix_inv(uint64_t *q) {
+	uint64_t s[8], t[8];
+	int i;
+
+	for (i = 0; i < 8; i++) {
+		s[i] = q[i] ^ rot_col(q[i], 2);
+	}
+	aes_xtime(t, s);
+	aes_xtime(s, t);
+	for (i = 0; i < 8; i++) {
+		q[i] ^= s[i];
+	}
+	aes_mix(q);
+}
+
+/**
+ * Converts up to four blocks to bitsliced representation.
+ *
+ * @param[out] q			- the bit planes.
+ * @param[in] in			- the blocks.
+ * @param[in] n				- the number of blocks.
+ */
+static void aes_pack(uint64_t *q, const uint8_t *in, int n) {
+	uint64_t x;
+	int i, j;
+
+	memset(q, 0, 8 * sizeof(uint64_t));
+	for (i = 0; i < 2 * n; i++) {
+		x = 0;
+		for (j = 7; j >= 0; j--) {
+			x = (x << 8) | in[8 * i + j];
+		}
+		/* Gather bit j of the eight bytes into a single byte. */
+		for (j = 0; j < 8; j++) {
+			q[j] |= ((((x >> j) & 0x0101010101010101ULL) *
+					0x0102040810204080ULL) >> 56) << (8 * i);
+		}
+	}
+}
+
+/**
+ * Converts up to four blocks from bitsliced representation.
+ *
+ * @param[out] out			- the blocks.
+ * @param[in] q				- the bit planes.
+ * @param[in] n				- the number of blocks.
+ */
+static void aes_unpack(uint8_t *out, const uint64_t *q, int n) {
+	uint64_t x, b;
+	int i, j;
+
+	for (i = 0; i < 2 * n; i++) {
+		x = 0;
+		/* Spread each byte of a plane over bit j of eight bytes. */
+		for (j = 0; j < 8; j++) {
+			b = ((q[j] >> (8 * i)) & 0xFF) * 0x0101010101010101ULL;
+			b = ((b & 0x8040201008040201ULL) + 0x7F7F7F7F7F7F7F7FULL) >> 7;
+			x |= (b & 0x0101010101010101ULL) << j;
+		}
+		for (j = 0; j < 8; j++) {
+			out[8 * i + j] = (uint8_t)(x >> (8 * j));
+		}
+	}
+}
+
+/**
+ * Applies the S-box to the four bytes of a key schedule word.
+ *
+ * @param[in,out] w			- the word.
+ */
+static void aes_sub_word(uint8_t *w) {
+	uint64_t q[8];
+	int i, j;
+
+	memset(q, 0, sizeof(q));
+	for (i = 0; i < 4; i++) {
+		for (j = 0; j < 8; j++) {
+			q[j] |= (uint64_t)((w[i] >> j) & 1) << i;
+		}
+	}
+	aes_sbox(q);
+	for (i = 0; i < 4; i++) {
+		w[i] = 0;
+		for (j = 0; j < 8; j++) {
+			w[i] |= ((q[j] >> i) & 1) << j;
+		}
+	}
+}
+
+/**
+ * Stores the round keys in bitsliced representation, one 16-bit plane per
+ * bit of each round key.
+ *
+ * @param[in,out] key		- the key schedule.
+ */
+static void aes_slice_keys(bc_aes_t *key) {
+	uint64_t q[8];
+	uint16_t w;
+
+	for (int r = 0; r <= key->nr; r++) {
+		aes_pack(q, key->ek + BC_LEN * r, 1);
+		for (int j = 0; j < 8; j++) {
+			w = (uint16_t)q[j];
+			memcpy(key->dk + 2 * (8 * r + j), &w, sizeof(w));
+		}
+	}
+}
+
+/**
+ * Loads the bitsliced round keys, replicating each one over the four lanes.
+ *
+ * @param[out] rk			- the bitsliced round keys.
+ * @param[in] key			- the key schedule.
+ */
+static void aes_load_keys(uint64_t rk[][8], const bc_aes_t *key) {
+	uint16_t w;
+
+	for (int r = 0; r <= key->nr; r++) {
+		for (int j = 0; j < 8; j++) {
+			memcpy(&w, key->dk + 2 * (8 * r + j), sizeof(w));
+			rk[r][j] = w * 0x0001000100010001ULL;
+		}
+	}
+}
+
+/**
+ * Encrypts blocks with the constant-time bitsliced implementation.
+ *
+ * @param[out] out			- the ciphertext blocks.
+ * @param[in] in			- the plaintext blocks.
+ * @param[in] n				- the number of blocks.
+ * @param[in] key			- the key schedule.
+ */
+static void aes_enc_ct(uint8_t *out, const uint8_t *in, int n,
+		const bc_aes_t *key) {
+	uint64_t q[8], rk[BC_AES_NR + 1][8];
+	int i, j, r, l;
+
+	aes_load_keys(rk, key);
+	for (i = 0; i < n; i += SLICE) {
+		l = MIN(SLICE, n - i);
+		aes_pack(q, in + BC_LEN * i, l);
+		for (j = 0; j < 8; j++) {
+			q[j] ^= rk[0][j];
+		}
+		for (r = 1; r <= key->nr; r++) {
+			aes_sbox(q);
+			aes_shift(q);
+			if (r != key->nr) {
+				aes_mix(q);
+			}
+			for (j = 0; j < 8; j++) {
+				q[j] ^= rk[r][j];
+			}
+		}
+		aes_unpack(out + BC_LEN * i, q, l);
+	}
+	util_wipe(q, sizeof(q));
+	util_wipe(rk, sizeof(rk));
+}
+
+/**
+ * Decrypts blocks with the constant-time bitsliced implementation.
+ *
+ * @param[out] out			- the plaintext blocks.
+ * @param[in] in			- the ciphertext blocks.
+ * @param[in] n				- the number of blocks.
+ * @param[in] key			- the key schedule.
+ */
+static void aes_dec_ct(uint8_t *out, const uint8_t *in, int n,
+		const bc_aes_t *key) {
+	uint64_t q[8], rk[BC_AES_NR + 1][8];
+	int i, j, r, l;
+
+	aes_load_keys(rk, key);
+	for (i = 0; i < n; i += SLICE) {
+		l = MIN(SLICE, n - i);
+		aes_pack(q, in + BC_LEN * i, l);
+		for (j = 0; j < 8; j++) {
+			q[j] ^= rk[key->nr][j];
+		}
+		for (r = key->nr - 1; r >= 0; r--) {
+			aes_shift_inv(q);
+			aes_sbox_inv(q);
+			for (j = 0; j < 8; j++) {
+				q[j] ^= rk[r][j];
+			}
+			if (r != 0) {
+				aes_mix_inv(q);
+			}
+		}
+		aes_unpack(out + BC_LEN * i, q, l);
+	}
+	util_wipe(q, sizeof(q));
+	util_wipe(rk, sizeof(rk));
+}
+
+#if ARCH == X64 && defined(__GNUC__)
+
+/**
+ * Applies the S-box to the four bytes of a key schedule word with
+ * AESENCLAST. The word is broadcast to all columns, so ShiftRows has no
+ * effect.
+ *
+ * @param[in] w				- the word.
+ * @return the substituted word.
+ */
+__attribute__((target("aes,sse2")))
+static uint32_t aesni_sub_word(uint32_t w) {
+	__m128i a = _mm_set1_epi32((int)w);
+
+	a = _mm_aesenclast_si128(a, _mm_setzero_si128());
+	return (uint32_t)_mm_cvtsi128_si32(a);
+}
+
+/**
+ * Finishes a step of the key expansion with AESKEYGENASSIST, XORing the
+ * selected word into the prefix XOR of the previous four words.
+ *
+ * @param[in] k				- the previous four words.
+ * @param[in] t				- the output of AESKEYGENASSIST.
+ * @return the next four words.
+ */
+__attribute__((target("aes,sse2")))
+static __m128i aesni_key_step(__m128i k, __m128i t) {
+	k = _mm_xor_si128(k, _mm_slli_si128(k, 4));
+	k = _mm_xor_si128(k, _mm_slli_si128(k, 4));
+	k = _mm_xor_si128(k, _mm_slli_si128(k, 4));
+	return _mm_xor_si128(k, t);
+}
+
+/**
+ * Expands 128-bit and 256-bit keys with AESKEYGENASSIST.
+ *
+ * @param[out] key			- the key schedule.
+ * @param[in] k				- the key.
+ * @param[in] nk			- the number of 32-bit words in the key.
+ */
+__attribute__((target("aes,sse2")))
+static void aesni_key(bc_aes_t *key, const uint8_t *k, int nk) {
+	__m128i a, b, *rk = (__m128i *)key->ek;
+
+	/* The round constant must be an immediate, so unroll the rounds. */
+#define STEP(R)																\
+	a = aesni_key_step(a, _mm_shuffle_epi32(								\
+			_mm_aeskeygenassist_si128(b, R), 0xFF));						\
+	_mm_storeu_si128(rk++, a);												\
+	if (nk == 8 && R != 0x40) {												\
+		b = aesni_key_step(b, _mm_shuffle_epi32(							\
+				_mm_aeskeygenassist_si128(a, 0), 0xAA));					\
+		_mm_storeu_si128(rk++, b);											\
+	} else if (nk == 4) {													\
+		b = a;																\
+	}
+
+	a = _mm_loadu_si128((const __m128i *)k);
+	_mm_storeu_si128(rk++, a);
+	b = a;
+	if (nk == 8) {
+		b = _mm_loadu_si128((const __m128i *)(k + BC_LEN));
+		_mm_storeu_si128(rk++, b);
+	}
+	STEP(0x01);
+	STEP(0x02);
+	STEP(0x04);
+	STEP(0x08);
+	STEP(0x10);
+	STEP(0x20);
+	STEP(0x40);
+	if (nk == 4) {
+		STEP(0x80);
+		STEP(0x1B);
+		STEP(0x36);
+	}
+#undef STEP
+}
+
+/**
+ * Computes the round keys of the equivalent inverse cipher used by AESDEC.
+ *
+ * @param[in,out] key		- the key schedule.
+ */
+__attribute__((target("aes,sse2")))
+static void aesni_dec_keys(bc_aes_t *key) {
+	__m128i k;
+
+	memcpy(key->dk, key->ek + BC_LEN * key->nr, BC_LEN);
+	for (int r = 1; r < key->nr; r++) {
+		k = _mm_loadu_si128((const __m128i *)(key->ek + BC_LEN * (key->nr - r)));
+		_mm_storeu_si128((__m128i *)(key->dk + BC_LEN * r), _mm_aesimc_si128(k));
+	}
+	memcpy(key->dk + BC_LEN * key->nr, key->ek, BC_LEN);
+}
+
+/**
+ * Encrypts blocks with AES-NI, interleaving eight independent blocks to hide
+ * the latency of the round instructions.
+ *
+ * @param[out] out			- the ciphertext blocks.
+ * @param[in] in			- the plaintext blocks.
+ * @param[in] n				- the number of blocks.
+ * @param[in] key			- the key schedule.
+ */
+__attribute__((target("aes,sse2")))
+static void aesni_enc(uint8_t *out, const uint8_t *in, int n,
+		const bc_aes_t *key) {
+	__m128i rk[BC_AES_NR + 1], b[PIPE];
+	int i, j, r;
+
+	for (r = 0; r <= key->nr; r++) {
+		rk[r] = _mm_loadu_si128((const __m128i *)(key->ek + BC_LEN * r));
+	}
+	for (i = 0; i + PIPE <= n; i += PIPE) {
+		for (j = 0; j < PIPE; j++) {
+			b[j] = _mm_loadu_si128((const __m128i *)(in + BC_LEN * (i + j)));
+			b[j] = _mm_xor_si128(b[j], rk[0]);
+		}
+		for (r = 1; r < key->nr; r++) {
+			for (j = 0; j < PIPE; j++) {
+				b[j] = _mm_aesenc_si128(b[j], rk[r]);
+			}
+		}
+		for (j = 0; j < PIPE; j++) {
+			b[j] = _mm_aesenclast_si128(b[j], rk[key->nr]);
+			_mm_storeu_si128((__m128i *)(out + BC_LEN * (i + j)), b[j]);
+		}
+	}
+	for (; i < n; i++) {
+		b[0] = _mm_loadu_si128((const __m128i *)(in + BC_LEN * i));
+		b[0] = _mm_xor_si128(b[0], rk[0]);
+		for (r = 1; r < key->nr; r++) {
+			b[0] = _mm_aesenc_si128(b[0], rk[r]);
+		}
+		b[0] = _mm_aesenclast_si128(b[0], rk[key->nr]);
+		_mm_storeu_si128((__m128i *)(out + BC_LEN * i), b[0]);
+	}
+}
+
+/**
+ * Decrypts blocks with AES-NI, interleaving eight independent blocks.
+ *
+ * @param[out] out			- the plaintext blocks.
+ * @param[in] in			- the ciphertext blocks.
+ * @param[in] n				- the number of blocks.
+ * @param[in] key			- the key schedule.
+ */
+__attribute__((target("aes,sse2")))
+static void aesni_dec(uint8_t *out, const uint8_t *in, int n,
+		const bc_aes_t *key) {
+	__m128i rk[BC_AES_NR + 1], b[PIPE];
+	int i, j, r;
+
+	for (r = 0; r <= key->nr; r++) {
+		rk[r] = _mm_loadu_si128((const __m128i *)(key->dk + BC_LEN * r));
+	}
+	for (i = 0; i + PIPE <= n; i += PIPE) {
+		for (j = 0; j < PIPE; j++) {
+			b[j] = _mm_loadu_si128((const __m128i *)(in + BC_LEN * (i + j)));
+			b[j] = _mm_xor_si128(b[j], rk[0]);
+		}
+		for (r = 1; r < key->nr; r++) {
+			for (j = 0; j < PIPE; j++) {
+				b[j] = _mm_aesdec_si128(b[j], rk[r]);
+			}
+		}
+		for (j = 0; j < PIPE; j++) {
+			b[j] = _mm_aesdeclast_si128(b[j], rk[key->nr]);
+			_mm_storeu_si128((__m128i *)(out + BC_LEN * (i + j)), b[j]);
+		}
+	}
+	for (; i < n; i++) {
+		b[0] = _mm_loadu_si128((const __m128i *)(in + BC_LEN * i));
+		b[0] = _mm_xor_si128(b[0], rk[0]);
+		for (r = 1; r < key->nr; r++) {
+			b[0] = _mm_aesdec_si128(b[0], rk[r]);
+		}
+		b[0] = _mm_aesdeclast_si128(b[0], rk[key->nr]);
+		_mm_storeu_si128((__m128i *)(out + BC_LEN * i), b[0]);
+	}
+}
+
+#endif
+
+/**
+ * Tests if the processor supports the AES-NI instructions.
+ *
+ * @return 1 if AES-NI is available, 0 otherwise.
+ */
+static int aes_ni(void) {
+#if ARCH == X64 && defined(__GNUC__)
+	return (arch_features() & ARCH_AESNI) != 0;
+#else
+	return 0;
+#endif
+}
+
+/**
+ * Applies the S-box to a key schedule word, with AES-NI when available.
+ *
+ * @param[in] w				- the word, with the first byte in the lowest bits.
+ * @return the substituted word.
+ */
+static uint32_t aes_key_word(uint32_t w) {
+	uint8_t b[4];
+
+#if ARCH == X64 && defined(__GNUC__)
+	if (aes_ni()) {
+		return aesni_sub_word(w);
+	}
+#endif
+	for (int i = 0; i < 4; i++) {
+		b[i] = (uint8_t)(w >> (8 * i));
+	}
+	aes_sub_word(b);
+	return b[0] | (b[1] << 8) | (b[2] << 16) | ((uint32_t)b[3] << 24);
+}
 
 /*============================================================================*/
 /* Public definitions                                                         */
 /*============================================================================*/
 
+int bc_aes_key(bc_aes_t *key, const uint8_t *k, int key_len) {
+	uint32_t t, w[4 * (BC_AES_NR + 1)];
+	int i, j, r, nk, words;
+
+	if (key_len != 128 && key_len != 192 && key_len != 256) {
+		return STS_ERR;
+	}
+
+	nk = key_len / 32;
+	key->nr = nk + 6;
+	words = 4 * (key->nr + 1);
+#if ARCH == X64 && defined(__GNUC__)
+	if (aes_ni() && nk != 6) {
+		aesni_key(key, k, nk);
+		aesni_dec_keys(key);
+		return STS_OK;
+	}
+#endif
+	/* Words hold their first byte in the lowest bits. */
+	for (i = 0; i < nk; i++) {
+		w[i] = k[4 * i] | (k[4 * i + 1] << 8) | (k[4 * i + 2] << 16) |
+				((uint32_t)k[4 * i + 3] << 24);
+	}
+	for (i = nk, j = 0, r = 0; i < words; i++, j++) {
+		/* Track i mod nk and i / nk without divisions. */
+		if (j == nk) {
+			j = 0;
+		}
+		t = w[i - 1];
+		if (j == 0) {
+			/* t = SubWord(RotWord(t)) + Rcon. */
+			t = aes_key_word((t >> 8) | (t << 24)) ^ aes_rcon[r++];
+		} else if (nk > 6 && j == 4) {
+			t = aes_key_word(t);
+		}
+		w[i] = w[i - nk] ^ t;
+	}
+	for (i = 0; i < words; i++) {
+		for (j = 0; j < 4; j++) {
+			key->ek[4 * i + j] = (uint8_t)(w[i] >> (8 * j));
+		}
+	}
+	util_wipe(w, sizeof(w));
+#if ARCH == X64 && defined(__GNUC__)
+	if (aes_ni()) {
+		aesni_dec_keys(key);
+		return STS_OK;
+	}
+#endif
+	aes_slice_keys(key);
+	return STS_OK;
+}
+
+void bc_aes_ecb_enc(uint8_t *out, const uint8_t *in, int len,
+		const bc_aes_t *key) {
+#if ARCH == X64 && defined(__GNUC__)
+	if (aes_ni()) {
+		aesni_enc(out, in, len / BC_LEN, key);
+		return;
+	}
+#endif
+	aes_enc_ct(out, in, len / BC_LEN, key);
+}
+
+void bc_aes_ecb_dec(uint8_t *out, const uint8_t *in, int len,
+		const bc_aes_t *key) {
+#if ARCH == X64 && defined(__GNUC__)
+	if (aes_ni()) {
+		aesni_dec(out, in, len / BC_LEN, key);
+		return;
+	}
+#endif
+	aes_dec_ct(out, in, len / BC_LEN, key);
+}
+
 int bc_aes_cbc_enc(uint8_t *out, int *out_len, uint8_t *in,
 		int in_len, uint8_t *key, int key_len, uint8_t *iv) {
-	keyInstance key_inst;
-	cipherInstance cipher_inst;
-	
-	int pad_len = 16 - (in_len - 16 * (in_len/16));
+	bc_aes_t k;
+	uint8_t b[BC_LEN];
+	int i, j, pad_len = BC_LEN - (in_len % BC_LEN);
+
 	if (*out_len < in_len + pad_len) {
 		return STS_ERR;
 	}
-	if (makeKey2(&key_inst, DIR_ENCRYPT, key_len, (char *)key) != TRUE) {
+	if (bc_aes_key(&k, key, key_len) != STS_OK) {
 		return STS_ERR;
 	}
-	if (cipherInit(&cipher_inst, MODE_CBC, NULL) != TRUE) {
-		return STS_ERR;
+
+	memcpy(b, iv, BC_LEN);
+	for (i = 0; i + BC_LEN <= in_len; i += BC_LEN) {
+		for (j = 0; j < BC_LEN; j++) {
+			b[j] ^= in[i + j];
+		}
+		bc_aes_ecb_enc(out + i, b, BC_LEN, &k);
+		memcpy(b, out + i, BC_LEN);
 	}
-	memcpy(cipher_inst.IV, iv, BC_LEN);
-	*out_len = padEncrypt(&cipher_inst, &key_inst, in, in_len, out);
-	if (*out_len <= 0) {
-		return STS_ERR;
+	/* Apply the PKCS#7 padding to the last block. */
+	for (j = 0; j < BC_LEN - pad_len; j++) {
+		b[j] ^= in[i + j];
+	}
+	for (; j < BC_LEN; j++) {
+		b[j] ^= pad_len;
 	}
+	bc_aes_ecb_enc(out + i, b, BC_LEN, &k);
+	util_wipe(&k, sizeof(k));
+	*out_len = in_len + pad_len;
 	return STS_OK;
 }
 
 int bc_aes_cbc_dec(uint8_t *out, int *out_len, uint8_t *in,
 		int in_len, uint8_t *key, int key_len, uint8_t *iv) {
-	keyInstance key_inst;
-	cipherInstance cipher_inst;
-	
-	if (*out_len < in_len) {
+	bc_aes_t k;
+	uint8_t c[PIPE * BC_LEN], p[PIPE * BC_LEN], v[BC_LEN], pad, diff;
+	int i, j, l;
+
+	if (*out_len < in_len || in_len <= 0 || in_len % BC_LEN != 0) {
 		return STS_ERR;
 	}
-	
-	if (makeKey2(&key_inst, DIR_DECRYPT, key_len, (char *)key) != TRUE) {
+	if (bc_aes_key(&k, key, key_len) != STS_OK) {
 		return STS_ERR;
 	}
-	if (cipherInit(&cipher_inst, MODE_CBC, NULL) != TRUE) {
-		return STS_ERR;
+
+	/* Decryption is parallel, so blocks are deciphered in batches. The
+	 * ciphertext is copied first since the output may overlap the input. */
+	memcpy(v, iv, BC_LEN);
+	for (i = 0; i < in_len; i += l) {
+		l = MIN(PIPE * BC_LEN, in_len - i);
+		memcpy(c, in + i, l);
+		bc_aes_ecb_dec(p, c, l, &k);
+		for (j = 0; j < BC_LEN; j++) {
+			out[i + j] = p[j] ^ v[j];
+		}
+		for (; j < l; j++) {
+			out[i + j] = p[j] ^ c[j - BC_LEN];
+		}
+		memcpy(v, c + l - BC_LEN, BC_LEN);
+	}
+	util_wipe(&k, sizeof(k));
+	util_wipe(p, sizeof(p));
+
+	/* Check the padding without branching on the padding bytes. */
+	pad = out[in_len - 1];
+	diff = (pad == 0) | (pad > BC_LEN);
+	for (j = 1; j <= BC_LEN; j++) {
+		uint8_t in_pad = (uint8_t)-(j <= pad);
+		diff |= in_pad & (out[in_len - j] ^ pad);
 	}
-	memcpy(cipher_inst.IV, iv, BC_LEN);
-	*out_len = padDecrypt(&cipher_inst, &key_inst, in, in_len, out);
-	if (*out_len <= 0) {
+	if (diff != 0) {
 		return STS_ERR;
 	}
+	*out_len = in_len - pad;
 	return STS_OK;
 }
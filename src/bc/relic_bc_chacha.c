@@ -0,0 +1,459 @@
+/*
+ * RELIC is an Efficient LIbrary for Cryptography
+ * Copyright (C) 2007-2015 RELIC Authors
+ *
+ * This file is part of RELIC. RELIC is legal property of its developers,
+ * whose names are not listed here. Please refer to the COPYRIGHT file
+ * for contact information.
+ *
+ * RELIC is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * RELIC is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with RELIC. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ *
+ * Implementation of the ChaCha20 stream cipher and of the ChaCha20-Poly1305
+ * authenticated encryption scheme.
+ *
+ * @version $Id$
+ * @ingroup bc
+ */
+
+#include <string.h>
+
+#include "relic_core.h"
+#include "relic_util.h"
+#include "relic_bc.h"
+#include "relic_arch.h"
+
+#if ARCH == X64 && defined(__GNUC__)
+#include <immintrin.h>
+#endif
+
+/*============================================================================*/
+/* Private definitions                                                        */
+/*============================================================================*/
+
+/**
+ * Length in bytes of a ChaCha20 block.
+ */
+#define BLOCK		64
+
+/**
+ * Rotates a 32-bit integer to the left.
+ */
+#define ROTL(A, B)	(((A) << (B)) | ((A) >> (32 - (B))))
+
+/**
+ * Applies the quarter round to four words of a state, where ADD, XOR and ROT
+ * select the instructions for the words.
+ */
+#define QR(X, A, B, C, D)													\
+	X[A] = ADD(X[A], X[B]); X[D] = XOR(X[D], X[A]); X[D] = ROT(X[D], 16);	\
+	X[C] = ADD(X[C], X[D]); X[B] = XOR(X[B], X[C]); X[B] = ROT(X[B], 12);	\
+	X[A] = ADD(X[A], X[B]); X[D] = XOR(X[D], X[A]); X[D] = ROT(X[D], 8);	\
+	X[C] = ADD(X[C], X[D]); X[B] = XOR(X[B], X[C]); X[B] = ROT(X[B], 7);	\
+
+/**
+ * Applies the twenty rounds of ChaCha20 as ten double rounds.
+ */
+#define ROUNDS(X)															\
+	for (int r = 0; r < 10; r++) {											\
+		QR(X, 0, 4, 8, 12);													\
+		QR(X, 1, 5, 9, 13);													\
+		QR(X, 2, 6, 10, 14);												\
+		QR(X, 3, 7, 11, 15);												\
+		QR(X, 0, 5, 10, 15);												\
+		QR(X, 1, 6, 11, 12);												\
+		QR(X, 2, 7, 8, 13);													\
+		QR(X, 3, 4, 9, 14);													\
+	}																		\
+
+/**
+ * Reads a 32-bit integer in little-endian order.
+ *
+ * @param[in] b				- the bytes.
+ * @return the integer.
+ */
+static uint32_t load32(const uint8_t *b) {
+	return b[0] | (b[1] << 8) | (b[2] << 16) | ((uint32_t)b[3] << 24);
+}
+
+/**
+ * Computes one block of key stream and advances the block counter.
+ *
+ * @param[out] ks			- the key stream.
+ * @param[in,out] x			- the input words.
+ */
+static void chacha_block(uint8_t *ks, uint32_t *x) {
+	uint32_t v[16];
+	int i;
+
+	memcpy(v, x, sizeof(v));
+#define ADD(A, B)	((A) + (B))
+#define XOR(A, B)	((A) ^ (B))
+#define ROT(A, B)	ROTL(A, B)
+	ROUNDS(v);
+#undef ADD
+#undef XOR
+#undef ROT
+	for (i = 0; i < 16; i++) {
+		v[i] += x[i];
+		ks[4 * i] = (uint8_t)v[i];
+		ks[4 * i + 1] = (uint8_t)(v[i] >> 8);
+		ks[4 * i + 2] = (uint8_t)(v[i] >> 16);
+		ks[4 * i + 3] = (uint8_t)(v[i] >> 24);
+	}
+	x[12]++;
+}
+
+#if ARCH == X64 && defined(__GNUC__)
+
+/**
+ * Encrypts four blocks with SSE2, keeping the same word of the four states
+ * in each register.
+ *
+ * @param[out] out			- the resulting blocks.
+ * @param[in] in			- the input blocks.
+ * @param[in,out] x			- the input words.
+ */
+__attribute__((target("sse2")))
+static void chacha_sse2(uint8_t *out, const uint8_t *in, uint32_t *x) {
+	__m128i v[16], t[4], u[4];
+	int i, j;
+
+	for (i = 0; i < 16; i++) {
+		v[i] = _mm_set1_epi32((int)x[i]);
+	}
+	v[12] = _mm_add_epi32(v[12], _mm_set_epi32(3, 2, 1, 0));
+	memcpy(u, v + 12, sizeof(__m128i));
+#define ADD(A, B)	_mm_add_epi32(A, B)
+#define XOR(A, B)	_mm_xor_si128(A, B)
+#define ROT(A, B)	_mm_or_si128(_mm_slli_epi32(A, B), _mm_srli_epi32(A, 32 - (B)))
+	ROUNDS(v);
+#undef ADD
+#undef XOR
+#undef ROT
+	for (i = 0; i < 16; i++) {
+		v[i] = _mm_add_epi32(v[i], (i == 12 ? u[0] :
+				_mm_set1_epi32((int)x[i])));
+	}
+	/* Transpose each group of four words into the four blocks. */
+	for (i = 0; i < 16; i += 4) {
+		t[0] = _mm_unpacklo_epi32(v[i], v[i + 1]);
+		t[1] = _mm_unpacklo_epi32(v[i + 2], v[i + 3]);
+		t[2] = _mm_unpackhi_epi32(v[i], v[i + 1]);
+		t[3] = _mm_unpackhi_epi32(v[i + 2], v[i + 3]);
+		u[0] = _mm_unpacklo_epi64(t[0], t[1]);
+		u[1] = _mm_unpackhi_epi64(t[0], t[1]);
+		u[2] = _mm_unpacklo_epi64(t[2], t[3]);
+		u[3] = _mm_unpackhi_epi64(t[2], t[3]);
+		for (j = 0; j < 4; j++) {
+			const uint8_t *p = in + BLOCK * j + 4 * i;
+			u[j] = _mm_xor_si128(u[j], _mm_loadu_si128((const __m128i *)p));
+			_mm_storeu_si128((__m128i *)(out + BLOCK * j + 4 * i), u[j]);
+		}
+	}
+	x[12] += 4;
+}
+
+/**
+ * Encrypts eight blocks with AVX2, keeping the same word of the eight states
+ * in each register.
+ *
+ * @param[out] out			- the resulting blocks.
+ * @param[in] in			- the input blocks.
+ * @param[in,out] x			- the input words.
+ */
+__attribute__((target("avx2")))
+static void chacha_avx2(uint8_t *out, const uint8_t *in, uint32_t *x) {
+	const __m256i r16 = _mm256_set_epi8(13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7,
+			6, 1, 0, 3, 2, 13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2);
+	const __m256i r8 = _mm256_set_epi8(14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4,
+			7, 2, 1, 0, 3, 14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3);
+	__m256i v[16], t[4], u[4], c;
+	int i, j;
+
+	for (i = 0; i < 16; i++) {
+		v[i] = _mm256_set1_epi32((int)x[i]);
+	}
+	v[12] = _mm256_add_epi32(v[12], _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+	c = v[12];
+#define ADD(A, B)	_mm256_add_epi32(A, B)
+#define XOR(A, B)	_mm256_xor_si256(A, B)
+#define ROT(A, B)	((B) == 16 ? _mm256_shuffle_epi8(A, r16) :				\
+		(B) == 8 ? _mm256_shuffle_epi8(A, r8) :								\
+		_mm256_or_si256(_mm256_slli_epi32(A, B), _mm256_srli_epi32(A, 32 - (B))))
+	ROUNDS(v);
+#undef ADD
+#undef XOR
+#undef ROT
+	for (i = 0; i < 16; i++) {
+		v[i] = _mm256_add_epi32(v[i], (i == 12 ? c :
+				_mm256_set1_epi32((int)x[i])));
+	}
+	/* Transpose in each half, which holds blocks 0-3 and 4-7 respectively. */
+	for (i = 0; i < 16; i += 4) {
+		t[0] = _mm256_unpacklo_epi32(v[i], v[i + 1]);
+		t[1] = _mm256_unpacklo_epi32(v[i + 2], v[i + 3]);
+		t[2] = _mm256_unpackhi_epi32(v[i], v[i + 1]);
+		t[3] = _mm256_unpackhi_epi32(v[i + 2], v[i + 3]);
+		u[0] = _mm256_unpacklo_epi64(t[0], t[1]);
+		u[1] = _mm256_unpackhi_epi64(t[0], t[1]);
+		u[2] = _mm256_unpacklo_epi64(t[2], t[3]);
+		u[3] = _mm256_unpackhi_epi64(t[2], t[3]);
+		for (j = 0; j < 4; j++) {
+			const uint8_t *p = in + BLOCK * j + 4 * i;
+			const uint8_t *q = p + 4 * BLOCK;
+			__m128i a = _mm256_castsi256_si128(u[j]);
+			__m128i b = _mm256_extracti128_si256(u[j], 1);
+
+			a = _mm_xor_si128(a, _mm_loadu_si128((const __m128i *)p));
+			b = _mm_xor_si128(b, _mm_loadu_si128((const __m128i *)q));
+			_mm_storeu_si128((__m128i *)(out + BLOCK * j + 4 * i), a);
+			_mm_storeu_si128((__m128i *)(out + BLOCK * (j + 4) + 4 * i), b);
+		}
+	}
+	x[12] += 8;
+}
+
+#endif
+
+/**
+ * Encrypts full blocks, using the widest available vector instructions.
+ *
+ * @param[out] out			- the resulting blocks.
+ * @param[in] in			- the input blocks.
+ * @param[in] n				- the number of blocks.
+ * @param[in,out] x			- the input words.
+ */
+static void chacha_blocks(uint8_t *out, const uint8_t *in, int n,
+		uint32_t *x) {
+	uint8_t ks[BLOCK];
+	int i = 0, j;
+
+#if ARCH == X64 && defined(__GNUC__)
+	if (arch_features() & ARCH_AVX2) {
+		for (; i + 8 <= n; i += 8) {
+			chacha_avx2(out + BLOCK * i, in + BLOCK * i, x);
+		}
+	}
+	for (; i + 4 <= n; i += 4) {
+		chacha_sse2(out + BLOCK * i, in + BLOCK * i, x);
+	}
+#endif
+	for (; i < n; i++) {
+		chacha_block(ks, x);
+		for (j = 0; j < BLOCK; j++) {
+			out[BLOCK * i + j] = in[BLOCK * i + j] ^ ks[j];
+		}
+	}
+}
+
+/**
+ * Sets up the input words of ChaCha20.
+ *
+ * @param[out] x			- the input words.
+ * @param[in] key			- the key.
+ * @param[in] iv			- the nonce.
+ * @param[in] ctr			- the block counter.
+ */
+static void chacha_setup(uint32_t *x, const uint8_t *key, const uint8_t *iv,
+		uint32_t ctr) {
+	/* The constant "expand 32-byte k". */
+	x[0] = 0x61707865;
+	x[1] = 0x3320646E;
+	x[2] = 0x79622D32;
+	x[3] = 0x6B206574;
+	for (int i = 0; i < 8; i++) {
+		x[4 + i] = load32(key + 4 * i);
+	}
+	x[12] = ctr;
+	x[13] = load32(iv);
+	x[14] = load32(iv + 4);
+	x[15] = load32(iv + 8);
+}
+
+/**
+ * Encrypts or decrypts data with ChaCha20-Poly1305.
+ *
+ * @param[in,out] ctx		- the ChaCha20-Poly1305 context.
+ * @param[out] out			- the output bytes.
+ * @param[in] in			- the input bytes.
+ * @param[in] len			- the number of bytes.
+ * @param[in] dec			- the flag to indicate that the input is the
+ * 							ciphertext.
+ */
+static void chacha_update(bc_chacha_t *ctx, uint8_t *out, uint8_t *in,
+		int len, int dec) {
+	uint8_t z[16] = { 0 };
+	int i, l;
+
+	if (ctx->msg_len == 0 && ctx->mac.used > 0) {
+		/* Pad the additional data to a full block. */
+		bc_poly1305_update(&ctx->mac, z, 16 - ctx->mac.used);
+	}
+	ctx->msg_len += len;
+	if (dec) {
+		bc_poly1305_update(&ctx->mac, in, len);
+	}
+
+	/* Use the rest of the key stream left by the previous call. */
+	for (i = 0; i < len && ctx->used < BLOCK; i++) {
+		out[i] = in[i] ^ ctx->ks[ctx->used++];
+	}
+	l = (len - i) - (len - i) % BLOCK;
+	chacha_blocks(out + i, in + i, l / BLOCK, ctx->x);
+	i += l;
+	if (i < len) {
+		chacha_block(ctx->ks, ctx->x);
+		ctx->used = 0;
+		for (; i < len; i++) {
+			out[i] = in[i] ^ ctx->ks[ctx->used++];
+		}
+	}
+
+	if (!dec) {
+		bc_poly1305_update(&ctx->mac, out, len);
+	}
+}
+
+/**
+ * Computes the authentication tag of ChaCha20-Poly1305.
+ *
+ * @param[in,out] ctx		- the ChaCha20-Poly1305 context.
+ * @param[out] tag			- the tag.
+ */
+static void chacha_tag(bc_chacha_t *ctx, uint8_t *tag) {
+	uint8_t b[16] = { 0 };
+	uint64_t l[2] = { ctx->aad_len, ctx->msg_len };
+
+	/* Pad the additional data or the ciphertext to a full block. */
+	if (ctx->mac.used > 0) {
+		bc_poly1305_update(&ctx->mac, b, 16 - ctx->mac.used);
+	}
+	for (int i = 0; i < 2; i++) {
+		for (int j = 0; j < 8; j++) {
+			b[8 * i + j] = (uint8_t)(l[i] >> (8 * j));
+		}
+	}
+	bc_poly1305_update(&ctx->mac, b, 16);
+	bc_poly1305_final(&ctx->mac, tag);
+}
+
+/*============================================================================*/
+/* Public definitions                                                         */
+/*============================================================================*/
+
+void bc_chacha20(uint8_t *out, uint8_t *in, int len, uint8_t *key,
+		uint8_t *iv, uint32_t ctr) {
+	uint32_t x[16];
+	uint8_t ks[BLOCK];
+	int l = len - len % BLOCK;
+
+	chacha_setup(x, key, iv, ctr);
+	chacha_blocks(out, in, l / BLOCK, x);
+	if (l < len) {
+		chacha_block(ks, x);
+		for (int i = l; i < len; i++) {
+			out[i] = in[i] ^ ks[i - l];
+		}
+	}
+}
+
+int bc_chacha_init(bc_chacha_t *ctx, uint8_t *key, int key_len, uint8_t *iv,
+		int iv_len) {
+	uint8_t k[BLOCK];
+
+	if (key_len != 8 * BC_CHACHA_KEY || iv_len != BC_CHACHA_IV) {
+		return STS_ERR;
+	}
+	/* The first block of key stream gives the one-time Poly1305 key. */
+	chacha_setup(ctx->x, key, iv, 0);
+	chacha_block(k, ctx->x);
+	bc_poly1305_init(&ctx->mac, k);
+	ctx->used = BLOCK;
+	ctx->aad_len = ctx->msg_len = 0;
+	return STS_OK;
+}
+
+void bc_chacha_aad(bc_chacha_t *ctx, uint8_t *aad, int aad_len) {
+	bc_poly1305_update(&ctx->mac, aad, aad_len);
+	ctx->aad_len += aad_len;
+}
+
+void bc_chacha_enc_update(bc_chacha_t *ctx, uint8_t *out, uint8_t *in,
+		int len) {
+	chacha_update(ctx, out, in, len, 0);
+}
+
+void bc_chacha_dec_update(bc_chacha_t *ctx, uint8_t *out, uint8_t *in,
+		int len) {
+	chacha_update(ctx, out, in, len, 1);
+}
+
+void bc_chacha_enc_final(bc_chacha_t *ctx, uint8_t *tag) {
+	chacha_tag(ctx, tag);
+}
+
+int bc_chacha_dec_final(bc_chacha_t *ctx, uint8_t *tag) {
+	uint8_t t[BC_TAG_LEN];
+
+	chacha_tag(ctx, t);
+	if (util_cmp_const(t, tag, BC_TAG_LEN) != CMP_EQ) {
+		return STS_ERR;
+	}
+	return STS_OK;
+}
+
+int bc_chacha_enc(uint8_t *out, int *out_len, uint8_t *in, int in_len,
+		uint8_t *key, int key_len, uint8_t *iv, int iv_len, uint8_t *aad,
+		int aad_len) {
+	bc_chacha_t ctx;
+
+	if (*out_len < in_len + BC_TAG_LEN || in_len < 0) {
+		return STS_ERR;
+	}
+	if (bc_chacha_init(&ctx, key, key_len, iv, iv_len) != STS_OK) {
+		return STS_ERR;
+	}
+	bc_chacha_aad(&ctx, aad, aad_len);
+	bc_chacha_enc_update(&ctx, out, in, in_len);
+	bc_chacha_enc_final(&ctx, out + in_len);
+	*out_len = in_len + BC_TAG_LEN;
+	return STS_OK;
+}
+
+int bc_chacha_dec(uint8_t *out, int *out_len, uint8_t *in, int in_len,
+		uint8_t *key, int key_len, uint8_t *iv, int iv_len, uint8_t *aad,
+		int aad_len) {
+	bc_chacha_t ctx;
+	int len = in_len - BC_TAG_LEN;
+
+	if (len < 0 || *out_len < len) {
+		return STS_ERR;
+	}
+	if (bc_chacha_init(&ctx, key, key_len, iv, iv_len) != STS_OK) {
+		return STS_ERR;
+	}
+	bc_chacha_aad(&ctx, aad, aad_len);
+	bc_chacha_dec_update(&ctx, out, in, len);
+	if (bc_chacha_dec_final(&ctx, in + len) != STS_OK) {
+		/* Do not release unauthenticated plaintext. */
+		memset(out, 0, len);
+		return STS_ERR;
+	}
+	*out_len = len;
+	return STS_OK;
+}
@@ -0,0 +1,727 @@
+/*
+ * RELIC is an Efficient LIbrary for Cryptography
+ * Copyright (C) 2007-2015 RELIC Authors
+ *
+ * This file is part of RELIC. RELIC is legal property of its developers,
+ * whose names are not listed here. Please refer to the COPYRIGHT file
+ * for contact information.
+ *
+ * RELIC is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * RELIC is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with RELIC. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ *
+ * Implementation of the CTR and GCM modes of operation of the AES block
+ * cipher.
+ *
+ * @version $Id$
+ * @ingroup bc
+ */
+
+#include <string.h>
+
+#include "relic_core.h"
+#include "relic_util.h"
+#include "relic_bc.h"
+#include "relic_arch.h"
+
+#if ARCH == X64 && defined(__GNUC__)
+#include <immintrin.h>
+#endif
+
+/*============================================================================*/
+/* Private definitions                                                        */
+/*============================================================================*/
+
+/**
+ * Number of blocks of key stream generated together.
+ */
+#define PIPE		8
+
+/**
+ * Number of blocks sharing a single reduction in the CLMUL GHASH.
+ */
+#define AGGR		4
+
+/**
+ * Number of blocks encrypted before they are authenticated in GCM, small
+ * enough to keep them in the first-level cache between the two passes.
+ */
+#define CHUNK		64
+
+/**
+ * Reads a 64-bit integer in big-endian order.
+ *
+ * @param[in] b				- the bytes.
+ * @return the integer.
+ */
+static uint64_t load64(const uint8_t *b) {
+	uint64_t r = 0;
+
+	for (int i = 0; i < 8; i++) {
+		r = (r << 8) | b[i];
+	}
+	return r;
+}
+
+/**
+ * Writes a 64-bit integer in big-endian order.
+ *
+ * @param[out] b			- the bytes.
+ * @param[in] a				- the integer.
+ */
+static void store64(uint8_t *b, uint64_t a) {
+	for (int i = 7; i >= 0; i--) {
+		b[i] = (uint8_t)a;
+		a >>= 8;
+	}
+}
+
+/**
+ * Reverses the order of the bits in a 64-bit integer.
+ *
+ * @param[in] a				- the integer.
+ * @return the reversed integer.
+ */
+static uint64_t rev64(uint64_t a) {
+	a = ((a >> 1) & 0x5555555555555555ULL) | ((a & 0x5555555555555555ULL) << 1);
+	a = ((a >> 2) & 0x3333333333333333ULL) | ((a & 0x3333333333333333ULL) << 2);
+	a = ((a >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((a & 0x0F0F0F0F0F0F0F0FULL) << 4);
+	a = ((a >> 8) & 0x00FF00FF00FF00FFULL) | ((a & 0x00FF00FF00FF00FFULL) << 8);
+	a = ((a >> 16) & 0x0000FFFF0000FFFFULL) | ((a & 0x0000FFFF0000FFFFULL) << 16);
+	return (a >> 32) | (a << 32);
+}
+
+/**
+ * Computes the lower half of a carry-less product with integer multiplications.
+ * The operands are split in four interleaved parts with holes of three bits,
+ * so that carries never reach a bit of another part.
+ *
+ * @param[in] a				- the first operand.
+ * @param[in] b				- the second operand.
+ * @return the lower 64 bits of the carry-less product.
+ */
+static uint64_t bmul64(uint64_t a, uint64_t b) {
+	uint64_t a0, a1, a2, a3, b0, b1, b2, b3, c0, c1, c2, c3;
+
+	a0 = a & 0x1111111111111111ULL;
+	a1 = a & 0x2222222222222222ULL;
+	a2 = a & 0x4444444444444444ULL;
+	a3 = a & 0x8888888888888888ULL;
+	b0 = b & 0x1111111111111111ULL;
+	b1 = b & 0x2222222222222222ULL;
+	b2 = b & 0x4444444444444444ULL;
+	b3 = b & 0x8888888888888888ULL;
+	c0 = (a0 * b0) ^ (a1 * b3) ^ (a2 * b2) ^ (a3 * b1);
+	c1 = (a0 * b1) ^ (a1 * b0) ^ (a2 * b3) ^ (a3 * b2);
+	c2 = (a0 * b2) ^ (a1 * b1) ^ (a2 * b0) ^ (a3 * b3);
+	c3 = (a0 * b3) ^ (a1 * b2) ^ (a2 * b1) ^ (a3 * b0);
+	c0 &= 0x1111111111111111ULL;
+	c1 &= 0x2222222222222222ULL;
+	c2 &= 0x4444444444444444ULL;
+	c3 &= 0x8888888888888888ULL;
+	return c0 | c1 | c2 | c3;
+}
+
+/**
+ * Absorbs blocks into a GHASH accumulator with the constant-time portable
+ * multiplier. The upper halves of the products are computed from the
+ * bit-reversed operands, and Karatsuba saves one multiplication.
+ *
+ * @param[in,out] x			- the accumulator.
+ * @param[in] h				- the hash key.
+ * @param[in] in			- the blocks.
+ * @param[in] n				- the number of blocks.
+ */
+static void ghash_ct(uint8_t *x, const uint8_t *h, const uint8_t *in, int n) {
+	uint64_t y0, y1, y2, y0r, y1r, y2r, h0, h1, h2, h0r, h1r, h2r;
+	uint64_t z0, z1, z2, z0h, z1h, z2h, v0, v1, v2, v3;
+
+	y1 = load64(x);
+	y0 = load64(x + 8);
+	h1 = load64(h);
+	h0 = load64(h + 8);
+	h0r = rev64(h0);
+	h1r = rev64(h1);
+	h2 = h0 ^ h1;
+	h2r = h0r ^ h1r;
+	for (int i = 0; i < n; i++, in += BC_LEN) {
+		y1 ^= load64(in);
+		y0 ^= load64(in + 8);
+		y0r = rev64(y0);
+		y1r = rev64(y1);
+		y2 = y0 ^ y1;
+		y2r = y0r ^ y1r;
+
+		z0 = bmul64(y0, h0);
+		z1 = bmul64(y1, h1);
+		z2 = bmul64(y2, h2);
+		z0h = bmul64(y0r, h0r);
+		z1h = bmul64(y1r, h1r);
+		z2h = bmul64(y2r, h2r);
+		z2 ^= z0 ^ z1;
+		z2h ^= z0h ^ z1h;
+		z0h = rev64(z0h) >> 1;
+		z1h = rev64(z1h) >> 1;
+		z2h = rev64(z2h) >> 1;
+
+		v0 = z0;
+		v1 = z0h ^ z2;
+		v2 = z1 ^ z2h;
+		v3 = z1h;
+
+		/* Fix the bit order and reduce modulo x^128 + x^7 + x^2 + x + 1. */
+		v3 = (v3 << 1) | (v2 >> 63);
+		v2 = (v2 << 1) | (v1 >> 63);
+		v1 = (v1 << 1) | (v0 >> 63);
+		v0 = (v0 << 1);
+		v2 ^= v0 ^ (v0 >> 1) ^ (v0 >> 2) ^ (v0 >> 7);
+		v1 ^= (v0 << 63) ^ (v0 << 62) ^ (v0 << 57);
+		v3 ^= v1 ^ (v1 >> 1) ^ (v1 >> 2) ^ (v1 >> 7);
+		v2 ^= (v1 << 63) ^ (v1 << 62) ^ (v1 << 57);
+		y0 = v2;
+		y1 = v3;
+	}
+	store64(x, y1);
+	store64(x + 8, y0);
+}
+
+#if ARCH == X64 && defined(__GNUC__)
+
+/**
+ * Multiplies two field elements with PCLMULQDQ, without reducing. The
+ * products of several blocks can be accumulated before a single reduction.
+ *
+ * @param[in,out] lo		- the lower half of the accumulated product.
+ * @param[in,out] hi		- the upper half of the accumulated product.
+ * @param[in] a				- the first operand.
+ * @param[in] b				- the second operand.
+ */
+__attribute__((target("pclmul,sse2")))
+static inline void clmul_acc(__m128i *lo, __m128i *hi, __m128i a, __m128i b) {
+	__m128i t0, t1, t2;
+
+	t0 = _mm_clmulepi64_si128(a, b, 0x00);
+	t2 = _mm_clmulepi64_si128(a, b, 0x11);
+	t1 = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10),
+			_mm_clmulepi64_si128(a, b, 0x01));
+	*lo = _mm_xor_si128(*lo, _mm_xor_si128(t0, _mm_slli_si128(t1, 8)));
+	*hi = _mm_xor_si128(*hi, _mm_xor_si128(t2, _mm_srli_si128(t1, 8)));
+}
+
+/**
+ * Reduces a 256-bit carry-less product of byte-reflected operands modulo
+ * the GHASH polynomial, following the Intel white paper on GCM.
+ *
+ * @param[in] lo			- the lower half of the product.
+ * @param[in] hi			- the upper half of the product.
+ * @return the reduced field element.
+ */
+__attribute__((target("pclmul,sse2")))
+static inline __m128i clmul_red(__m128i lo, __m128i hi) {
+	__m128i t7, t8, t9, t2, t4, t5;
+
+	/* Shift the product left by one bit to undo the bit reflection. */
+	t7 = _mm_srli_epi32(lo, 31);
+	t8 = _mm_srli_epi32(hi, 31);
+	lo = _mm_slli_epi32(lo, 1);
+	hi = _mm_slli_epi32(hi, 1);
+	t9 = _mm_srli_si128(t7, 12);
+	t8 = _mm_slli_si128(t8, 4);
+	t7 = _mm_slli_si128(t7, 4);
+	lo = _mm_or_si128(lo, t7);
+	hi = _mm_or_si128(hi, t8);
+	hi = _mm_or_si128(hi, t9);
+
+	t7 = _mm_slli_epi32(lo, 31);
+	t8 = _mm_slli_epi32(lo, 30);
+	t9 = _mm_slli_epi32(lo, 25);
+	t7 = _mm_xor_si128(t7, t8);
+	t7 = _mm_xor_si128(t7, t9);
+	t8 = _mm_srli_si128(t7, 4);
+	t7 = _mm_slli_si128(t7, 12);
+	lo = _mm_xor_si128(lo, t7);
+	t2 = _mm_srli_epi32(lo, 1);
+	t4 = _mm_srli_epi32(lo, 2);
+	t5 = _mm_srli_epi32(lo, 7);
+	t2 = _mm_xor_si128(t2, t4);
+	t2 = _mm_xor_si128(t2, t5);
+	t2 = _mm_xor_si128(t2, t8);
+	lo = _mm_xor_si128(lo, t2);
+	return _mm_xor_si128(hi, lo);
+}
+
+/**
+ * Absorbs blocks into a GHASH accumulator with PCLMULQDQ. Groups of AGGR
+ * blocks are multiplied by decreasing powers of the hash key and share a
+ * single reduction.
+ *
+ * @param[in,out] x			- the accumulator.
+ * @param[in] h				- the powers of the hash key.
+ * @param[in] in			- the blocks.
+ * @param[in] n				- the number of blocks.
+ */
+__attribute__((target("pclmul,ssse3,sse2")))
+static void ghash_clmul(uint8_t *x, const uint8_t *h, const uint8_t *in,
+		int n) {
+	const __m128i bswap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11,
+			12, 13, 14, 15);
+	__m128i y, lo, hi, a, hp[AGGR];
+	int i, j;
+
+	for (i = 0; i < AGGR; i++) {
+		hp[i] = _mm_loadu_si128((const __m128i *)(h + BC_LEN * i));
+		hp[i] = _mm_shuffle_epi8(hp[i], bswap);
+	}
+	y = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)x), bswap);
+	for (i = 0; i + AGGR <= n; i += AGGR, in += AGGR * BC_LEN) {
+		lo = hi = _mm_setzero_si128();
+		for (j = 0; j < AGGR; j++) {
+			a = _mm_loadu_si128((const __m128i *)(in + BC_LEN * j));
+			a = _mm_shuffle_epi8(a, bswap);
+			if (j == 0) {
+				a = _mm_xor_si128(a, y);
+			}
+			clmul_acc(&lo, &hi, a, hp[AGGR - 1 - j]);
+		}
+		y = clmul_red(lo, hi);
+	}
+	for (; i < n; i++, in += BC_LEN) {
+		lo = hi = _mm_setzero_si128();
+		a = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)in), bswap);
+		clmul_acc(&lo, &hi, _mm_xor_si128(a, y), hp[0]);
+		y = clmul_red(lo, hi);
+	}
+	_mm_storeu_si128((__m128i *)x, _mm_shuffle_epi8(y, bswap));
+}
+
+#endif
+
+/**
+ * Absorbs blocks into a GHASH accumulator, using PCLMULQDQ when the processor
+ * supports it.
+ *
+ * @param[in,out] x			- the accumulator.
+ * @param[in] h				- the powers of the hash key.
+ * @param[in] in			- the blocks.
+ * @param[in] n				- the number of blocks.
+ */
+static void gcm_ghash(uint8_t *x, const uint8_t *h, const uint8_t *in, int n) {
+#if ARCH == X64 && defined(__GNUC__)
+	if (arch_features() & ARCH_CLMUL) {
+		ghash_clmul(x, h, in, n);
+		return;
+	}
+#endif
+	ghash_ct(x, h, in, n);
+}
+
+/**
+ * Absorbs a byte string into a GHASH accumulator, padding the last block
+ * with zeros.
+ *
+ * @param[in,out] x			- the accumulator.
+ * @param[in] h				- the powers of the hash key.
+ * @param[in] in			- the bytes.
+ * @param[in] len			- the number of bytes.
+ */
+static void gcm_absorb(uint8_t *x, const uint8_t *h, const uint8_t *in,
+		int len) {
+	uint8_t b[BC_LEN] = { 0 };
+
+	gcm_ghash(x, h, in, len / BC_LEN);
+	if (len % BC_LEN != 0) {
+		memcpy(b, in + len - len % BC_LEN, len % BC_LEN);
+		gcm_ghash(x, h, b, 1);
+	}
+}
+
+/**
+ * Generates blocks of key stream in counter mode and advances the counter.
+ *
+ * @param[out] ks			- the key stream.
+ * @param[in,out] ctr		- the counter block.
+ * @param[in] n				- the number of blocks.
+ * @param[in] w				- the number of bytes in the incremented counter.
+ * @param[in] key			- the expanded key.
+ */
+static void ctr_gen(uint8_t *ks, uint8_t *ctr, int n, int w,
+		const bc_aes_t *key) {
+	int i, j;
+
+	for (i = 0; i < n; i++) {
+		memcpy(ks + BC_LEN * i, ctr, BC_LEN);
+		/* The counter is public, so the carry may stop early. */
+		for (j = BC_LEN - 1; j >= BC_LEN - w && ++ctr[j] == 0; j--);
+	}
+	bc_aes_ecb_enc(ks, ks, n * BC_LEN, key);
+}
+
+/**
+ * Adds a key stream to a byte string, a machine word at a time.
+ *
+ * @param[out] out			- the result.
+ * @param[in] in			- the byte string.
+ * @param[in] ks			- the key stream.
+ * @param[in] len			- the number of bytes.
+ */
+static void ctr_add(uint8_t *out, const uint8_t *in, const uint8_t *ks,
+		int len) {
+	uint64_t a, b;
+	int i;
+
+	for (i = 0; i + 8 <= len; i += 8) {
+		memcpy(&a, in + i, 8);
+		memcpy(&b, ks + i, 8);
+		a ^= b;
+		memcpy(out + i, &a, 8);
+	}
+	for (; i < len; i++) {
+		out[i] = in[i] ^ ks[i];
+	}
+}
+
+#if ARCH == X64 && defined(__GNUC__)
+
+/**
+ * Adds the key stream of AES-NI in counter mode to full blocks, generating
+ * the counter blocks in registers and interleaving eight blocks.
+ *
+ * @param[out] out			- the resulting blocks.
+ * @param[in] in			- the input blocks.
+ * @param[in] n				- the number of blocks.
+ * @param[in,out] ctr		- the counter block.
+ * @param[in] w				- the number of bytes in the incremented counter.
+ * @param[in] key			- the expanded key.
+ */
+__attribute__((target("aes,ssse3,sse2")))
+static void aesni_ctr(uint8_t *out, const uint8_t *in, int n, uint8_t *ctr,
+		int w, const bc_aes_t *key) {
+	const __m128i bswap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11,
+			12, 13, 14, 15);
+	const __m128i one = _mm_set_epi32(0, 0, 0, 1);
+	__m128i rk[BC_AES_NR + 1], b[PIPE], c;
+	int i, j, r, m;
+
+	for (r = 0; r <= key->nr; r++) {
+		rk[r] = _mm_loadu_si128((const __m128i *)(key->ek + BC_LEN * r));
+	}
+	/* Keep the counter byte-reflected, so that it can be added to. */
+	c = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)ctr), bswap);
+	for (i = 0; i < n; i += m) {
+		m = MIN(PIPE, n - i);
+		for (j = 0; j < m; j++) {
+			b[j] = _mm_xor_si128(_mm_shuffle_epi8(c, bswap), rk[0]);
+			if (w == 4) {
+				c = _mm_add_epi32(c, one);
+			} else {
+				c = _mm_add_epi64(c, one);
+				if (_mm_cvtsi128_si64(c) == 0) {
+					c = _mm_add_epi64(c, _mm_slli_si128(one, 8));
+				}
+			}
+		}
+		if (m == PIPE) {
+			for (r = 1; r < key->nr; r++) {
+				for (j = 0; j < PIPE; j++) {
+					b[j] = _mm_aesenc_si128(b[j], rk[r]);
+				}
+			}
+			for (j = 0; j < PIPE; j++) {
+				b[j] = _mm_aesenclast_si128(b[j], rk[key->nr]);
+			}
+		} else {
+			for (j = 0; j < m; j++) {
+				for (r = 1; r < key->nr; r++) {
+					b[j] = _mm_aesenc_si128(b[j], rk[r]);
+				}
+				b[j] = _mm_aesenclast_si128(b[j], rk[key->nr]);
+			}
+		}
+		for (j = 0; j < m; j++) {
+			b[j] = _mm_xor_si128(b[j],
+					_mm_loadu_si128((const __m128i *)(in + BC_LEN * (i + j))));
+			_mm_storeu_si128((__m128i *)(out + BC_LEN * (i + j)), b[j]);
+		}
+	}
+	_mm_storeu_si128((__m128i *)ctr, _mm_shuffle_epi8(c, bswap));
+}
+
+#endif
+
+/**
+ * Adds the key stream of counter mode to full blocks and advances the
+ * counter, using AES-NI when the processor supports it.
+ *
+ * @param[out] out			- the resulting blocks.
+ * @param[in] in			- the input blocks.
+ * @param[in] n				- the number of blocks.
+ * @param[in,out] ctr		- the counter block.
+ * @param[in] w				- the number of bytes in the incremented counter.
+ * @param[in] key			- the expanded key.
+ */
+static void ctr_xor(uint8_t *out, const uint8_t *in, int n, uint8_t *ctr,
+		int w, const bc_aes_t *key) {
+	uint8_t ks[PIPE * BC_LEN];
+	int i, m;
+
+#if ARCH == X64 && defined(__GNUC__)
+	if (arch_features() & ARCH_AESNI) {
+		aesni_ctr(out, in, n, ctr, w, key);
+		return;
+	}
+#endif
+	for (i = 0; i < n; i += m) {
+		m = MIN(PIPE, n - i);
+		ctr_gen(ks, ctr, m, w, key);
+		ctr_add(out + BC_LEN * i, in + BC_LEN * i, ks, BC_LEN * m);
+	}
+}
+
+/**
+ * Encrypts or decrypts data in GCM mode, authenticating the ciphertext.
+ *
+ * @param[in,out] ctx		- the GCM context.
+ * @param[out] out			- the output bytes.
+ * @param[in] in			- the input bytes.
+ * @param[in] len			- the number of bytes.
+ * @param[in] dec			- the flag to indicate that the input is the
+ * 							ciphertext.
+ */
+static void gcm_update(bc_gcm_t *ctx, uint8_t *out, const uint8_t *in,
+		int len, int dec) {
+	uint8_t b;
+	int i, l;
+
+	if (ctx->msg_len == 0 && ctx->used > 0) {
+		/* Close the additional data with a padded block. */
+		memset(ctx->buf + ctx->used, 0, BC_LEN - ctx->used);
+		gcm_ghash(ctx->x, ctx->h, ctx->buf, 1);
+		ctx->used = 0;
+	}
+	ctx->msg_len += len;
+
+	/* Finish the partial block left by the previous call. */
+	for (i = 0; i < len && ctx->used > 0; i++) {
+		b = in[i];
+		out[i] = b ^ ctx->ks[ctx->used];
+		ctx->buf[ctx->used++] = (dec ? b : out[i]);
+		if (ctx->used == BC_LEN) {
+			gcm_ghash(ctx->x, ctx->h, ctx->buf, 1);
+			ctx->used = 0;
+		}
+	}
+
+	/* Process the full blocks in batches. */
+	for (; len - i >= BC_LEN; i += l) {
+		l = MIN(CHUNK * BC_LEN, (len - i) - (len - i) % BC_LEN);
+		if (dec) {
+			gcm_ghash(ctx->x, ctx->h, in + i, l / BC_LEN);
+		}
+		ctr_xor(out + i, in + i, l / BC_LEN, ctx->ctr, 4, &ctx->key);
+		if (!dec) {
+			gcm_ghash(ctx->x, ctx->h, out + i, l / BC_LEN);
+		}
+	}
+
+	/* Start a partial block with the remaining bytes. */
+	if (i < len) {
+		ctr_gen(ctx->ks, ctx->ctr, 1, 4, &ctx->key);
+		for (; i < len; i++) {
+			b = in[i];
+			out[i] = b ^ ctx->ks[ctx->used];
+			ctx->buf[ctx->used++] = (dec ? b : out[i]);
+		}
+	}
+}
+
+/**
+ * Computes the authentication tag of a GCM context.
+ *
+ * @param[in,out] ctx		- the GCM context.
+ * @param[out] tag			- the tag.
+ */
+static void gcm_tag(bc_gcm_t *ctx, uint8_t *tag) {
+	uint8_t b[BC_LEN];
+
+	if (ctx->used > 0) {
+		memset(ctx->buf + ctx->used, 0, BC_LEN - ctx->used);
+		gcm_ghash(ctx->x, ctx->h, ctx->buf, 1);
+		ctx->used = 0;
+	}
+	store64(b, 8 * ctx->aad_len);
+	store64(b + 8, 8 * ctx->msg_len);
+	gcm_ghash(ctx->x, ctx->h, b, 1);
+	bc_aes_ecb_enc(tag, ctx->j0, BC_LEN, &ctx->key);
+	for (int i = 0; i < BC_LEN; i++) {
+		tag[i] ^= ctx->x[i];
+	}
+}
+
+/*============================================================================*/
+/* Public definitions                                                         */
+/*============================================================================*/
+
+int bc_aes_ctr_enc(uint8_t *out, int *out_len, uint8_t *in,
+		int in_len, uint8_t *key, int key_len, uint8_t *iv) {
+	bc_aes_t k;
+	uint8_t ctr[BC_LEN], ks[BC_LEN];
+	int l = in_len - in_len % BC_LEN;
+
+	if (*out_len < in_len || in_len < 0) {
+		return STS_ERR;
+	}
+	if (bc_aes_key(&k, key, key_len) != STS_OK) {
+		return STS_ERR;
+	}
+
+	memcpy(ctr, iv, BC_LEN);
+	ctr_xor(out, in, l / BC_LEN, ctr, BC_LEN, &k);
+	if (l < in_len) {
+		ctr_gen(ks, ctr, 1, BC_LEN, &k);
+		ctr_add(out + l, in + l, ks, in_len - l);
+	}
+	util_wipe(&k, sizeof(k));
+	util_wipe(ks, sizeof(ks));
+	*out_len = in_len;
+	return STS_OK;
+}
+
+int bc_aes_ctr_dec(uint8_t *out, int *out_len, uint8_t *in,
+		int in_len, uint8_t *key, int key_len, uint8_t *iv) {
+	return bc_aes_ctr_enc(out, out_len, in, in_len, key, key_len, iv);
+}
+
+int bc_aes_gcm_init(bc_gcm_t *ctx, uint8_t *key, int key_len, uint8_t *iv,
+		int iv_len) {
+	uint8_t b[BC_LEN] = { 0 };
+	int i;
+
+	if (iv_len <= 0 || bc_aes_key(&ctx->key, key, key_len) != STS_OK) {
+		return STS_ERR;
+	}
+
+	/* Compute the hash key H and its powers up to H^AGGR. */
+	memset(ctx->h, 0, sizeof(ctx->h));
+	bc_aes_ecb_enc(ctx->h, b, BC_LEN, &ctx->key);
+	for (i = 1; i < AGGR; i++) {
+		memcpy(ctx->h + BC_LEN * i, ctx->h + BC_LEN * (i - 1), BC_LEN);
+		gcm_ghash(ctx->h + BC_LEN * i, ctx->h, b, 1);
+	}
+
+	memset(ctx->x, 0, BC_LEN);
+	if (iv_len == 12) {
+		memcpy(ctx->j0, iv, 12);
+		memset(ctx->j0 + 12, 0, 3);
+		ctx->j0[15] = 1;
+	} else {
+		gcm_absorb(ctx->x, ctx->h, iv, iv_len);
+		store64(b + 8, 8 * (uint64_t)iv_len);
+		gcm_ghash(ctx->x, ctx->h, b, 1);
+		memcpy(ctx->j0, ctx->x, BC_LEN);
+		memset(ctx->x, 0, BC_LEN);
+	}
+	memcpy(ctx->ctr, ctx->j0, BC_LEN);
+	for (i = BC_LEN - 1; i >= BC_LEN - 4 && ++ctx->ctr[i] == 0; i--);
+	ctx->used = 0;
+	ctx->aad_len = ctx->msg_len = 0;
+	return STS_OK;
+}
+
+void bc_aes_gcm_aad(bc_gcm_t *ctx, uint8_t *aad, int aad_len) {
+	int i = 0, l;
+
+	ctx->aad_len += aad_len;
+	while (i < aad_len && ctx->used > 0) {
+		ctx->buf[ctx->used++] = aad[i++];
+		if (ctx->used == BC_LEN) {
+			gcm_ghash(ctx->x, ctx->h, ctx->buf, 1);
+			ctx->used = 0;
+		}
+	}
+	l = (aad_len - i) - (aad_len - i) % BC_LEN;
+	gcm_ghash(ctx->x, ctx->h, aad + i, l / BC_LEN);
+	for (i += l; i < aad_len; i++) {
+		ctx->buf[ctx->used++] = aad[i];
+	}
+}
+
+void bc_aes_gcm_enc_update(bc_gcm_t *ctx, uint8_t *out, uint8_t *in,
+		int len) {
+	gcm_update(ctx, out, in, len, 0);
+}
+
+void bc_aes_gcm_dec_update(bc_gcm_t *ctx, uint8_t *out, uint8_t *in,
+		int len) {
+	gcm_update(ctx, out, in, len, 1);
+}
+
+void bc_aes_gcm_enc_final(bc_gcm_t *ctx, uint8_t *tag) {
+	gcm_tag(ctx, tag);
+	/* The round keys, the hash key and the key stream are no longer needed. */
+	util_wipe(ctx, sizeof(bc_gcm_t));
+}
+
+int bc_aes_gcm_dec_final(bc_gcm_t *ctx, uint8_t *tag) {
+	uint8_t t[BC_TAG_LEN];
+
+	gcm_tag(ctx, t);
+	util_wipe(ctx, sizeof(bc_gcm_t));
+	if (util_cmp_const(t, tag, BC_TAG_LEN) != CMP_EQ) {
+		return STS_ERR;
+	}
+	return STS_OK;
+}
+
+int bc_aes_gcm_enc(uint8_t *out, int *out_len, uint8_t *in, int in_len,
+		uint8_t *key, int key_len, uint8_t *iv, int iv_len, uint8_t *aad,
+		int aad_len) {
+	bc_gcm_t ctx;
+
+	if (*out_len < in_len + BC_TAG_LEN || in_len < 0) {
+		return STS_ERR;
+	}
+	if (bc_aes_gcm_init(&ctx, key, key_len, iv, iv_len) != STS_OK) {
+		return STS_ERR;
+	}
+	bc_aes_gcm_aad(&ctx, aad, aad_len);
+	bc_aes_gcm_enc_update(&ctx, out, in, in_len);
+	bc_aes_gcm_enc_final(&ctx, out + in_len);
+	*out_len = in_len + BC_TAG_LEN;
+	return STS_OK;
+}
+
+int bc_aes_gcm_dec(uint8_t *out, int *out_len, uint8_t *in, int in_len,
+		uint8_t *key, int key_len, uint8_t *iv, int iv_len, uint8_t *aad,
+		int aad_len) {
+	bc_gcm_t ctx;
+	int len = in_len - BC_TAG_LEN;
+
+	if (len < 0 || *out_len < len) {
+		return STS_ERR;
+	}
+	if (bc_aes_gcm_init(&ctx, key, key_len, iv, iv_len) != STS_OK) {
+		return STS_ERR;
+	}
+	bc_aes_gcm_aad(&ctx, aad, aad_len);
+	bc_aes_gcm_dec_update(&ctx, out, in, len);
+	if (bc_aes_gcm_dec_final(&ctx, in + len) != STS_OK) {
+		/* Do not release unauthenticated plaintext. */
+		memset(out, 0, len);
+		return STS_ERR;
+	}
+	*out_len = len;
+	return STS_OK;
+}
@@ -0,0 +1,475 @@
+/*
+ * RELIC is an Efficient LIbrary for Cryptography
+ * Copyright (C) 2007-2015 RELIC Authors
+ *
+ * This file is part of RELIC. RELIC is legal property of its developers,
+ * whose names are not listed here. Please refer to the COPYRIGHT file
+ * for contact information.
+ *
+ * RELIC is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * RELIC is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with RELIC. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ *
+ * Implementation of the Poly1305 one-time authenticator.
+ *
+ * @version $Id$
+ * @ingroup bc
+ */
+
+#include <string.h>
+
+#include "relic_core.h"
+#include "relic_bc.h"
+#include "relic_arch.h"
+
+#if ARCH == X64 && defined(__GNUC__)
+#include <immintrin.h>
+#endif
+
+/*============================================================================*/
+/* Private definitions                                                        */
+/*============================================================================*/
+
+/**
+ * Mask of the 26-bit limbs.
+ */
+#define M26			0x3FFFFFF
+
+/**
+ * Minimum number of blocks for which the AVX2 code pays off.
+ */
+#define VECT		8
+
+/**
+ * Reads a 32-bit integer in little-endian order.
+ *
+ * @param[in] b				- the bytes.
+ * @return the integer.
+ */
+static uint32_t load32(const uint8_t *b) {
+	return b[0] | (b[1] << 8) | (b[2] << 16) | ((uint32_t)b[3] << 24);
+}
+
+/**
+ * Writes a 32-bit integer in little-endian order.
+ *
+ * @param[out] b			- the bytes.
+ * @param[in] a				- the integer.
+ */
+static void store32(uint8_t *b, uint32_t a) {
+	b[0] = (uint8_t)a;
+	b[1] = (uint8_t)(a >> 8);
+	b[2] = (uint8_t)(a >> 16);
+	b[3] = (uint8_t)(a >> 24);
+}
+
+/**
+ * Absorbs blocks into the accumulator with 26-bit limbs and 64-bit products,
+ * as h = (h + m) * r modulo 2^130 - 5.
+ *
+ * @param[in,out] h			- the accumulator.
+ * @param[in] r				- the multiplier.
+ * @param[in] in			- the blocks.
+ * @param[in] n				- the number of blocks.
+ * @param[in] hibit			- the bit appended to each block, 0 or 2^24.
+ */
+static void poly_26(uint32_t *h, const uint32_t *r, const uint8_t *in, int n,
+		uint32_t hibit) {
+	uint32_t h0 = h[0], h1 = h[1], h2 = h[2], h3 = h[3], h4 = h[4];
+	uint32_t s1 = r[1] * 5, s2 = r[2] * 5, s3 = r[3] * 5, s4 = r[4] * 5;
+	uint64_t d0, d1, d2, d3, d4;
+	uint32_t c;
+
+	for (int i = 0; i < n; i++, in += 16) {
+		h0 += load32(in) & M26;
+		h1 += (load32(in + 3) >> 2) & M26;
+		h2 += (load32(in + 6) >> 4) & M26;
+		h3 += (load32(in + 9) >> 6) & M26;
+		h4 += (load32(in + 12) >> 8) | hibit;
+
+		d0 = (uint64_t)h0 * r[0] + (uint64_t)h1 * s4 + (uint64_t)h2 * s3 +
+				(uint64_t)h3 * s2 + (uint64_t)h4 * s1;
+		d1 = (uint64_t)h0 * r[1] + (uint64_t)h1 * r[0] + (uint64_t)h2 * s4 +
+				(uint64_t)h3 * s3 + (uint64_t)h4 * s2;
+		d2 = (uint64_t)h0 * r[2] + (uint64_t)h1 * r[1] + (uint64_t)h2 * r[0] +
+				(uint64_t)h3 * s4 + (uint64_t)h4 * s3;
+		d3 = (uint64_t)h0 * r[3] + (uint64_t)h1 * r[2] + (uint64_t)h2 * r[1] +
+				(uint64_t)h3 * r[0] + (uint64_t)h4 * s4;
+		d4 = (uint64_t)h0 * r[4] + (uint64_t)h1 * r[3] + (uint64_t)h2 * r[2] +
+				(uint64_t)h3 * r[1] + (uint64_t)h4 * r[0];
+
+		c = (uint32_t)(d0 >> 26);
+		h0 = (uint32_t)d0 & M26;
+		d1 += c;
+		c = (uint32_t)(d1 >> 26);
+		h1 = (uint32_t)d1 & M26;
+		d2 += c;
+		c = (uint32_t)(d2 >> 26);
+		h2 = (uint32_t)d2 & M26;
+		d3 += c;
+		c = (uint32_t)(d3 >> 26);
+		h3 = (uint32_t)d3 & M26;
+		d4 += c;
+		c = (uint32_t)(d4 >> 26);
+		h4 = (uint32_t)d4 & M26;
+		h0 += c * 5;
+		c = h0 >> 26;
+		h0 &= M26;
+		h1 += c;
+	}
+	h[0] = h0;
+	h[1] = h1;
+	h[2] = h2;
+	h[3] = h3;
+	h[4] = h4;
+}
+
+#if WSIZE == 64 && defined(__SIZEOF_INT128__)
+
+/**
+ * Mask of the 44-bit limbs.
+ */
+#define M44			0xFFFFFFFFFFFULL
+
+/**
+ * Mask of the top 42-bit limb.
+ */
+#define M42			0x3FFFFFFFFFFULL
+
+/**
+ * Absorbs blocks into the accumulator with 44-bit limbs and 128-bit products,
+ * which needs fewer multiplications than 26-bit limbs on 64-bit processors.
+ * The accumulator is converted from and back to 26-bit limbs.
+ *
+ * @param[in,out] h			- the accumulator.
+ * @param[in] r				- the multiplier.
+ * @param[in] in			- the blocks.
+ * @param[in] n				- the number of blocks.
+ */
+static void poly_44(uint32_t *h, const uint32_t *r, const uint8_t *in, int n) {
+	uint64_t h0, h1, h2, r0, r1, r2, s1, s2, t0, t1, c;
+	unsigned __int128 d0, d1, d2;
+
+	/* The 26-bit limbs may exceed their size, so carries are propagated. */
+	t0 = h[0] + ((uint64_t)h[1] << 26);
+	h0 = t0 & M44;
+	t1 = (t0 >> 44) + ((uint64_t)h[2] << 8) + ((uint64_t)h[3] << 34);
+	h1 = t1 & M44;
+	h2 = (t1 >> 44) + ((uint64_t)h[4] << 16);
+	t0 = r[0] + ((uint64_t)r[1] << 26);
+	r0 = t0 & M44;
+	t1 = (t0 >> 44) + ((uint64_t)r[2] << 8) + ((uint64_t)r[3] << 34);
+	r1 = t1 & M44;
+	r2 = (t1 >> 44) + ((uint64_t)r[4] << 16);
+	/* The top limb has 42 bits, so wrapping around 2^132 multiplies by 20. */
+	s1 = r1 * 20;
+	s2 = r2 * 20;
+
+	for (int i = 0; i < n; i++, in += 16) {
+		t0 = load32(in) | ((uint64_t)load32(in + 4) << 32);
+		t1 = load32(in + 8) | ((uint64_t)load32(in + 12) << 32);
+		h0 += t0 & M44;
+		h1 += ((t0 >> 44) | (t1 << 20)) & M44;
+		h2 += ((t1 >> 24) & M42) | ((uint64_t)1 << 40);
+
+		d0 = (unsigned __int128)h0 * r0 + (unsigned __int128)h1 * s2 +
+				(unsigned __int128)h2 * s1;
+		d1 = (unsigned __int128)h0 * r1 + (unsigned __int128)h1 * r0 +
+				(unsigned __int128)h2 * s2;
+		d2 = (unsigned __int128)h0 * r2 + (unsigned __int128)h1 * r1 +
+				(unsigned __int128)h2 * r0;
+
+		c = (uint64_t)(d0 >> 44);
+		h0 = (uint64_t)d0 & M44;
+		d1 += c;
+		c = (uint64_t)(d1 >> 44);
+		h1 = (uint64_t)d1 & M44;
+		d2 += c;
+		c = (uint64_t)(d2 >> 42);
+		h2 = (uint64_t)d2 & M42;
+		h0 += c * 5;
+		c = h0 >> 44;
+		h0 &= M44;
+		h1 += c;
+	}
+
+	h[0] = (uint32_t)h0 & M26;
+	h[1] = (uint32_t)((h0 >> 26) | (h1 << 18)) & M26;
+	h[2] = (uint32_t)(h1 >> 8) & M26;
+	t0 = (h1 >> 34) + (h2 << 10);
+	h[3] = (uint32_t)t0 & M26;
+	h[4] = (uint32_t)(t0 >> 26);
+}
+
+#endif
+
+#if ARCH == X64 && defined(__GNUC__)
+
+/**
+ * Multiplies four accumulators by four multipliers in the 64-bit lanes of
+ * AVX2 registers, with 26-bit limbs, and partially reduces the results.
+ *
+ * @param[in,out] h			- the limbs of the accumulators.
+ * @param[in] r				- the limbs of the multipliers.
+ * @param[in] s				- the limbs of the multipliers times five.
+ */
+__attribute__((target("avx2")))
+static inline void poly_mul_avx2(__m256i *h, const __m256i *r,
+		const __m256i *s) {
+	const __m256i m = _mm256_set1_epi64x(M26);
+	__m256i d[5], c;
+
+#define MUL(A, B)	_mm256_mul_epu32(A, B)
+#define ADD(A, B)	_mm256_add_epi64(A, B)
+	d[0] = ADD(ADD(ADD(MUL(h[0], r[0]), MUL(h[1], s[4])), ADD(MUL(h[2], s[3]),
+			MUL(h[3], s[2]))), MUL(h[4], s[1]));
+	d[1] = ADD(ADD(ADD(MUL(h[0], r[1]), MUL(h[1], r[0])), ADD(MUL(h[2], s[4]),
+			MUL(h[3], s[3]))), MUL(h[4], s[2]));
+	d[2] = ADD(ADD(ADD(MUL(h[0], r[2]), MUL(h[1], r[1])), ADD(MUL(h[2], r[0]),
+			MUL(h[3], s[4]))), MUL(h[4], s[3]));
+	d[3] = ADD(ADD(ADD(MUL(h[0], r[3]), MUL(h[1], r[2])), ADD(MUL(h[2], r[1]),
+			MUL(h[3], r[0]))), MUL(h[4], s[4]));
+	d[4] = ADD(ADD(ADD(MUL(h[0], r[4]), MUL(h[1], r[3])), ADD(MUL(h[2], r[2]),
+			MUL(h[3], r[1]))), MUL(h[4], r[0]));
+#undef MUL
+#undef ADD
+
+	for (int i = 0; i < 4; i++) {
+		c = _mm256_srli_epi64(d[i], 26);
+		h[i] = _mm256_and_si256(d[i], m);
+		d[i + 1] = _mm256_add_epi64(d[i + 1], c);
+	}
+	c = _mm256_srli_epi64(d[4], 26);
+	h[4] = _mm256_and_si256(d[4], m);
+	h[0] = _mm256_add_epi64(h[0], _mm256_add_epi64(c, _mm256_slli_epi64(c, 2)));
+	c = _mm256_srli_epi64(h[0], 26);
+	h[0] = _mm256_and_si256(h[0], m);
+	h[1] = _mm256_add_epi64(h[1], c);
+}
+
+/**
+ * Absorbs a multiple of four blocks into the accumulator with AVX2. Four
+ * accumulators take every fourth block and are multiplied by r^4, and the
+ * last blocks are multiplied by r^4, r^3, r^2 and r before the accumulators
+ * are added together.
+ *
+ * @param[in,out] h			- the accumulator.
+ * @param[in] r				- the multiplier and its powers up to r^4.
+ * @param[in] in			- the blocks.
+ * @param[in] n				- the number of blocks, a multiple of four.
+ */
+__attribute__((target("avx2")))
+static void poly_avx2(uint32_t *h, uint32_t (*r)[5], const uint8_t *in,
+		int n) {
+	const __m256i m = _mm256_set1_epi64x(M26);
+	const __m256i hibit = _mm256_set1_epi64x(1 << 24);
+	__m256i r4[5], s4[5], rn[5], sn[5], v[5], a, b, t0, t1;
+	uint64_t d[5], l[4];
+	uint32_t c;
+	int i, j;
+
+	for (i = 0; i < 5; i++) {
+		r4[i] = _mm256_set1_epi64x(r[3][i]);
+		rn[i] = _mm256_set_epi64x(r[0][i], r[1][i], r[2][i], r[3][i]);
+		s4[i] = _mm256_add_epi64(r4[i], _mm256_slli_epi64(r4[i], 2));
+		sn[i] = _mm256_add_epi64(rn[i], _mm256_slli_epi64(rn[i], 2));
+		v[i] = _mm256_set_epi64x(0, 0, 0, h[i]);
+	}
+
+	for (j = 0; j < n; j += 4, in += 64) {
+		/* Gather the low and high halves of the four blocks. */
+		a = _mm256_loadu_si256((const __m256i *)in);
+		b = _mm256_loadu_si256((const __m256i *)(in + 32));
+		t0 = _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(a, b), 0xD8);
+		t1 = _mm256_permute4x64_epi64(_mm256_unpackhi_epi64(a, b), 0xD8);
+		v[0] = _mm256_add_epi64(v[0], _mm256_and_si256(t0, m));
+		v[1] = _mm256_add_epi64(v[1],
+				_mm256_and_si256(_mm256_srli_epi64(t0, 26), m));
+		v[2] = _mm256_add_epi64(v[2], _mm256_and_si256(_mm256_or_si256(
+				_mm256_srli_epi64(t0, 52), _mm256_slli_epi64(t1, 12)), m));
+		v[3] = _mm256_add_epi64(v[3],
+				_mm256_and_si256(_mm256_srli_epi64(t1, 14), m));
+		v[4] = _mm256_add_epi64(v[4],
+				_mm256_or_si256(_mm256_srli_epi64(t1, 40), hibit));
+		if (j + 4 < n) {
+			poly_mul_avx2(v, r4, s4);
+		} else {
+			poly_mul_avx2(v, rn, sn);
+		}
+	}
+
+	for (i = 0; i < 5; i++) {
+		_mm256_storeu_si256((__m256i *)l, v[i]);
+		d[i] = l[0] + l[1] + l[2] + l[3];
+	}
+	for (i = 0; i < 4; i++) {
+		d[i + 1] += d[i] >> 26;
+		h[i] = (uint32_t)d[i] & M26;
+	}
+	c = (uint32_t)(d[4] >> 26);
+	h[4] = (uint32_t)d[4] & M26;
+	h[0] += c * 5;
+	h[1] += h[0] >> 26;
+	h[0] &= M26;
+}
+
+#endif
+
+/**
+ * Absorbs full blocks into the accumulator with the fastest available code.
+ *
+ * @param[in,out] ctx		- the Poly1305 context.
+ * @param[in] in			- the blocks.
+ * @param[in] n				- the number of blocks.
+ */
+static void poly_blocks(bc_poly1305_t *ctx, const uint8_t *in, int n) {
+#if ARCH == X64 && defined(__GNUC__)
+	if (n >= VECT && (arch_features() & ARCH_AVX2)) {
+		int k = n - n % 4;
+		poly_avx2(ctx->h, ctx->r, in, k);
+		in += 16 * k;
+		n -= k;
+	}
+#endif
+#if WSIZE == 64 && defined(__SIZEOF_INT128__)
+	poly_44(ctx->h, ctx->r[0], in, n);
+#else
+	poly_26(ctx->h, ctx->r[0], in, n, 1 << 24);
+#endif
+}
+
+/*============================================================================*/
+/* Public definitions                                                         */
+/*============================================================================*/
+
+void bc_poly1305_init(bc_poly1305_t *ctx, uint8_t *key) {
+	uint8_t z[16] = { 0 };
+
+	/* Clamp r as required by the specification. */
+	ctx->r[0][0] = load32(key) & 0x3FFFFFF;
+	ctx->r[0][1] = (load32(key + 3) >> 2) & 0x3FFFF03;
+	ctx->r[0][2] = (load32(key + 6) >> 4) & 0x3FFC0FF;
+	ctx->r[0][3] = (load32(key + 9) >> 6) & 0x3F03FFF;
+	ctx->r[0][4] = (load32(key + 12) >> 8) & 0x00FFFFF;
+	/* Compute r^2, r^3 and r^4 as (r^i + 0) * r. */
+	for (int i = 1; i < 4; i++) {
+		memcpy(ctx->r[i], ctx->r[i - 1], sizeof(ctx->r[i]));
+		poly_26(ctx->r[i], ctx->r[0], z, 1, 0);
+	}
+	memcpy(ctx->s, key + 16, 16);
+	memset(ctx->h, 0, sizeof(ctx->h));
+	ctx->used = 0;
+}
+
+void bc_poly1305_update(bc_poly1305_t *ctx, uint8_t *in, int len) {
+	int l;
+
+	if (ctx->used > 0) {
+		l = MIN(16 - ctx->used, len);
+		memcpy(ctx->buf + ctx->used, in, l);
+		ctx->used += l;
+		in += l;
+		len -= l;
+		if (ctx->used < 16) {
+			return;
+		}
+		poly_blocks(ctx, ctx->buf, 1);
+		ctx->used = 0;
+	}
+	poly_blocks(ctx, in, len / 16);
+	in += len - len % 16;
+	memcpy(ctx->buf, in, len % 16);
+	ctx->used = len % 16;
+}
+
+void bc_poly1305_final(bc_poly1305_t *ctx, uint8_t *tag) {
+	uint32_t h0, h1, h2, h3, h4, g0, g1, g2, g3, g4, c, mask;
+	uint64_t f;
+
+	if (ctx->used > 0) {
+		/* Pad the last block with a one bit instead of the high bit. */
+		ctx->buf[ctx->used] = 1;
+		memset(ctx->buf + ctx->used + 1, 0, 15 - ctx->used);
+		poly_26(ctx->h, ctx->r[0], ctx->buf, 1, 0);
+		ctx->used = 0;
+	}
+
+	h0 = ctx->h[0];
+	h1 = ctx->h[1];
+	h2 = ctx->h[2];
+	h3 = ctx->h[3];
+	h4 = ctx->h[4];
+
+	/* Fully carry the accumulator. */
+	c = h1 >> 26;
+	h1 &= M26;
+	h2 += c;
+	c = h2 >> 26;
+	h2 &= M26;
+	h3 += c;
+	c = h3 >> 26;
+	h3 &= M26;
+	h4 += c;
+	c = h4 >> 26;
+	h4 &= M26;
+	h0 += c * 5;
+	c = h0 >> 26;
+	h0 &= M26;
+	h1 += c;
+
+	/* Compute h + -p and select it in constant time if h >= p. */
+	g0 = h0 + 5;
+	c = g0 >> 26;
+	g0 &= M26;
+	g1 = h1 + c;
+	c = g1 >> 26;
+	g1 &= M26;
+	g2 = h2 + c;
+	c = g2 >> 26;
+	g2 &= M26;
+	g3 = h3 + c;
+	c = g3 >> 26;
+	g3 &= M26;
+	g4 = h4 + c - (1 << 26);
+	mask = (g4 >> 31) - 1;
+	h0 = (h0 & ~mask) | (g0 & mask);
+	h1 = (h1 & ~mask) | (g1 & mask);
+	h2 = (h2 & ~mask) | (g2 & mask);
+	h3 = (h3 & ~mask) | (g3 & mask);
+	h4 = (h4 & ~mask) | (g4 & mask);
+
+	/* Compute h + s modulo 2^128. */
+	h0 = h0 | (h1 << 26);
+	h1 = (h1 >> 6) | (h2 << 20);
+	h2 = (h2 >> 12) | (h3 << 14);
+	h3 = (h3 >> 18) | (h4 << 8);
+	f = (uint64_t)h0 + load32(ctx->s);
+	store32(tag, (uint32_t)f);
+	f = (uint64_t)h1 + load32(ctx->s + 4) + (f >> 32);
+	store32(tag + 4, (uint32_t)f);
+	f = (uint64_t)h2 + load32(ctx->s + 8) + (f >> 32);
+	store32(tag + 8, (uint32_t)f);
+	f = (uint64_t)h3 + load32(ctx->s + 12) + (f >> 32);
+	store32(tag + 12, (uint32_t)f);
+}
+
+void bc_poly1305(uint8_t *tag, uint8_t *in, int len, uint8_t *key) {
+	bc_poly1305_t ctx;
+
+	bc_poly1305_init(&ctx, key);
+	bc_poly1305_update(&ctx, in, len);
+	bc_poly1305_final(&ctx, tag);
+}
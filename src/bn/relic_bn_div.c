@@ -137,6 +137,7 @@ static void bn_div_imp(bn_t c, bn_t d, const bn_t a, const bn_t b) {
 void bn_div(bn_t c, const bn_t a, const bn_t b) {
 	if (bn_is_zero(b)) {
 		THROW(ERR_NO_VALID);
+		return;
 	}
 	bn_div_imp(c, NULL, a, b);
 }
@@ -144,6 +145,7 @@ void bn_div(bn_t c, const bn_t a, const bn_t b) {
 void bn_div_rem(bn_t c, bn_t d, const bn_t a, const bn_t b) {
 	if (bn_is_zero(b)) {
 		THROW(ERR_NO_VALID);
+		return;
 	}
 	bn_div_imp(c, d, a, b);
 }
@@ -156,6 +158,7 @@ void bn_div_dig(bn_t c, const bn_t a, dig_t b) {
 
 	if (b == 0) {
 		THROW(ERR_NO_VALID);
+		return;
 	}
 
 	if (b == 1 || bn_is_zero(a) == 1) {
@@ -195,6 +198,7 @@ void bn_div_rem_dig(bn_t c, dig_t *d, const bn_t a, dig_t b) {
 
 	if (b == 0) {
 		THROW(ERR_NO_VALID);
+		return;
 	}
 
 	if (b == 1 || bn_is_zero(a) == 1) {
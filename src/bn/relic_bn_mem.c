@@ -68,6 +68,7 @@ void bn_init(bn_t a, int digits) {
 	if (a->dp == NULL) {
 		free(a);
 		THROW(ERR_NO_MEMORY);
+		return;
 	}
 #else
 	/* Verify if the number of digits is sane. */
@@ -78,7 +79,7 @@ void bn_init(bn_t a, int digits) {
 	}
 #if ALLOC == STATIC
 	if (a != NULL) {
-		a->dp = pool_get();
+		a->dp = pool_get(digits);
 		if (a->dp == NULL) {
 			THROW(ERR_NO_MEMORY);
 		}
@@ -158,6 +158,7 @@ void bn_mod_pre_monty(bn_t u, const bn_t m) {
 
 	if ((b & 0x01) == 0) {
 		THROW(ERR_NO_VALID);
+		return;
 	}
 
 	x = (((b + 2) & 4) << 1) + b;	/* here x*a==1 mod 2**4 */
@@ -246,7 +247,7 @@ void bn_mod_monty_basic(bn_t c, const bn_t a, const bn_t m, const bn_t u) {
 
 #endif /* BN_MUL == BASIC || !defined(STRIP) */
 
-#if BN_MUL == COMBA || !defined(STRIP)
+#if BN_MUL == COMBA || BN_MUL == TOOMC || !defined(STRIP)
 
 void bn_mod_monty_comba(bn_t c, const bn_t a, const bn_t m, const bn_t u) {
 	int digits;
@@ -276,7 +277,7 @@ void bn_mod_monty_comba(bn_t c, const bn_t a, const bn_t m, const bn_t u) {
 	}
 }
 
-#endif /* BN_MUL == COMBA || !defined(STRIP) */
+#endif /* BN_MUL == COMBA || BN_MUL == TOOMC || !defined(STRIP) */
 
 #endif /* BN_MOD == MONTY || (WITH_FP && FP_RDC == MONTY) || !defined(STRIP) */
 
@@ -339,3 +340,60 @@ void bn_mod_pmers(bn_t c, const bn_t a, const bn_t m, const bn_t u) {
 }
 
 #endif /* BN_MOD == PMERS || !defined(STRIP) */
+
+void bn_mod_ctx_set(bn_mod_ctx_t ctx, const bn_t m) {
+	bn_copy(ctx->m, m);
+	bn_mod_pre(ctx->u, m);
+#if BN_MOD == MONTY
+	/* r2 = R^2 mod m, with R = 2^(m->used * BN_DIGIT). */
+	bn_set_2b(ctx->r2, 2 * m->used * BN_DIGIT);
+	bn_mod_basic(ctx->r2, ctx->r2, m);
+#else
+	bn_zero(ctx->r2);
+#endif
+}
+
+int bn_mod_ctx_cmp(const bn_mod_ctx_t ctx, const bn_t m) {
+	return bn_cmp(ctx->m, m);
+}
+
+void bn_mod_ctx_conv(bn_t c, const bn_t a, const bn_mod_ctx_t ctx) {
+	if (bn_sign(a) == BN_NEG || bn_cmp(a, ctx->m) != CMP_LT) {
+		bn_mod_basic(c, a, ctx->m);
+		if (bn_sign(c) == BN_NEG) {
+			bn_add(c, c, ctx->m);
+		}
+	} else {
+		bn_copy(c, a);
+	}
+#if BN_MOD == MONTY
+	/* Multiplying by R^2 and reducing gives a * R mod m. */
+	bn_mul(c, c, ctx->r2);
+	bn_mod_monty(c, c, ctx->m, ctx->u);
+#endif
+}
+
+void bn_mod_ctx_back(bn_t c, const bn_t a, const bn_mod_ctx_t ctx) {
+#if BN_MOD == MONTY
+	bn_mod_monty(c, a, ctx->m, ctx->u);
+#else
+	bn_copy(c, a);
+#endif
+}
+
+void bn_mod_ctx_mul(bn_t c, const bn_t a, const bn_t b,
+		const bn_mod_ctx_t ctx) {
+	bn_mul(c, a, b);
+	bn_mod(c, c, ctx->m, ctx->u);
+}
+
+void bn_mul_mod_ctx(bn_t c, const bn_t a, const bn_t b,
+		const bn_mod_ctx_t ctx) {
+	bn_mul(c, a, b);
+	bn_mod(c, c, ctx->m, ctx->u);
+#if BN_MOD == MONTY
+	/* Cancel the factor R^(-1) introduced by the reduction. */
+	bn_mul(c, c, ctx->r2);
+	bn_mod(c, c, ctx->m, ctx->u);
+#endif
+}
@@ -36,7 +36,7 @@
 /* Private definitions                                                        */
 /*============================================================================*/
 
-#if BN_KARAT > 0 || !defined(STRIP)
+#if BN_KARAT > 0 || BN_MUL == TOOMC || !defined(STRIP)
 
 /**
  * Multiplies two multiple precision integers using recursive Karatsuba
@@ -108,7 +108,10 @@ static void bn_mul_karat_imp(bn_t c, const bn_t a, const bn_t b, int level) {
 #if BN_MUL == BASIC
 			bn_mul_basic(a0b0, a0, b0);
 			bn_mul_basic(a1b1, a1, b1);
-#elif BN_MUL == COMBA
+#elif BN_MUL == TOOMC
+			bn_mul_toomc(a0b0, a0, b0);
+			bn_mul_toomc(a1b1, a1, b1);
+#else
 			bn_mul_comba(a0b0, a0, b0);
 			bn_mul_comba(a1b1, a1, b1);
 #endif
@@ -126,7 +129,9 @@ static void bn_mul_karat_imp(bn_t c, const bn_t a, const bn_t b, int level) {
 		if (level <= 1) {
 #if BN_MUL == BASIC
 			bn_mul_basic(t, a1, b1);
-#elif BN_MUL == COMBA
+#elif BN_MUL == TOOMC
+			bn_mul_toomc(t, a1, b1);
+#else
 			bn_mul_comba(t, a1, b1);
 #endif
 		} else {
@@ -223,7 +228,7 @@ void bn_mul_basic(bn_t c, const bn_t a, const bn_t b) {
 
 #endif
 
-#if BN_MUL == COMBA || !defined(STRIP)
+#if BN_MUL == COMBA || BN_MUL == TOOMC || !defined(STRIP)
 
 void bn_mul_comba(bn_t c, const bn_t a, const bn_t b) {
 	int digits;
@@ -264,10 +269,146 @@ void bn_mul_comba(bn_t c, const bn_t a, const bn_t b) {
 
 #endif
 
-#if BN_KARAT > 0 || !defined(STRIP)
+#if BN_KARAT > 0 || BN_MUL == TOOMC || !defined(STRIP)
 
 void bn_mul_karat(bn_t c, const bn_t a, const bn_t b) {
 	bn_mul_karat_imp(c, a, b, BN_KARAT);
 }
 
 #endif
+
+#if BN_MUL == TOOMC || !defined(STRIP)
+
+void bn_mul_toom3(bn_t c, const bn_t a, const bn_t b) {
+	int k;
+	bn_t a0, a1, a2, b0, b1, b2, r0, r1, r2, r3, r4, t;
+
+	bn_null(a0);
+	bn_null(a1);
+	bn_null(a2);
+	bn_null(b0);
+	bn_null(b1);
+	bn_null(b2);
+	bn_null(r0);
+	bn_null(r1);
+	bn_null(r2);
+	bn_null(r3);
+	bn_null(r4);
+	bn_null(t);
+
+	/* Compute a third of the digits of the largest operand. */
+	k = (MAX(a->used, b->used) + 2) / 3;
+
+	TRY {
+		bn_new(a0);
+		bn_new(a1);
+		bn_new(a2);
+		bn_new(b0);
+		bn_new(b1);
+		bn_new(b2);
+		bn_new(r0);
+		bn_new(r1);
+		bn_new(r2);
+		bn_new(r3);
+		bn_new(r4);
+		bn_new(t);
+
+		/* a = a2 || a1 || a0 and b = b2 || b1 || b0. */
+		bn_abs(t, a);
+		bn_mod_2b(a0, t, k * BN_DIGIT);
+		bn_rsh(t, t, k * BN_DIGIT);
+		bn_mod_2b(a1, t, k * BN_DIGIT);
+		bn_rsh(a2, t, k * BN_DIGIT);
+		bn_abs(t, b);
+		bn_mod_2b(b0, t, k * BN_DIGIT);
+		bn_rsh(t, t, k * BN_DIGIT);
+		bn_mod_2b(b1, t, k * BN_DIGIT);
+		bn_rsh(b2, t, k * BN_DIGIT);
+
+		/* r0 = a(0) * b(0) and r4 = a(inf) * b(inf). */
+		bn_mul_toomc(r0, a0, b0);
+		bn_mul_toomc(r4, a2, b2);
+
+		/* r1 = a(1) * b(1), r2 = a(-1) * b(-1). */
+		bn_add(t, a0, a2);
+		bn_sub(r3, t, a1);
+		bn_add(t, t, a1);
+		bn_add(a1, b0, b2);
+		bn_sub(r2, a1, b1);
+		bn_add(a1, a1, b1);
+		bn_mul_toomc(r1, t, a1);
+		/* Keep a(-1) and b(-1) to evaluate at -2. */
+		bn_copy(t, r3);
+		bn_copy(a1, r2);
+		bn_mul_toomc(r2, r3, r2);
+
+		/* r3 = a(-2) * b(-2), with x(-2) = 2 * (x(-1) + x2) - x0. */
+		bn_add(t, t, a2);
+		bn_dbl(t, t);
+		bn_sub(t, t, a0);
+		bn_add(a1, a1, b2);
+		bn_dbl(a1, a1);
+		bn_sub(a1, a1, b0);
+		bn_mul_toomc(r3, t, a1);
+
+		/* Interpolate using the sequence by Bodrato. */
+		bn_sub(r3, r3, r1);
+		bn_div_dig(r3, r3, 3);
+		bn_sub(r1, r1, r2);
+		bn_hlv(r1, r1);
+		bn_sub(r2, r2, r0);
+		bn_sub(r3, r2, r3);
+		bn_hlv(r3, r3);
+		bn_dbl(t, r4);
+		bn_add(r3, r3, t);
+		bn_add(r2, r2, r1);
+		bn_sub(r2, r2, r4);
+		bn_sub(r1, r1, r3);
+
+		/* c = r4 * x^4 + r3 * x^3 + r2 * x^2 + r1 * x + r0, x = 2^(k digits). */
+		bn_lsh(t, r4, k * BN_DIGIT);
+		bn_add(t, t, r3);
+		bn_lsh(t, t, k * BN_DIGIT);
+		bn_add(t, t, r2);
+		bn_lsh(t, t, k * BN_DIGIT);
+		bn_add(t, t, r1);
+		bn_lsh(t, t, k * BN_DIGIT);
+		bn_add(t, t, r0);
+
+		t->sign = a->sign ^ b->sign;
+		bn_copy(c, t);
+		bn_trim(c);
+	}
+	CATCH_ANY {
+		THROW(ERR_CAUGHT);
+	}
+	FINALLY {
+		bn_free(a0);
+		bn_free(a1);
+		bn_free(a2);
+		bn_free(b0);
+		bn_free(b1);
+		bn_free(b2);
+		bn_free(r0);
+		bn_free(r1);
+		bn_free(r2);
+		bn_free(r3);
+		bn_free(r4);
+		bn_free(t);
+	}
+}
+
+void bn_mul_toomc(bn_t c, const bn_t a, const bn_t b) {
+	int n = MIN(a->used, b->used), m = MAX(a->used, b->used);
+
+	if (n < BN_MUL_KARAT) {
+		bn_mul_comba(c, a, b);
+	} else if (n < BN_MUL_TOOM3 || 3 * n < 2 * m) {
+		/* Unbalanced operands are better served by Karatsuba. */
+		bn_mul_karat_imp(c, a, b, 1);
+	} else {
+		bn_mul_toom3(c, a, b);
+	}
+}
+
+#endif
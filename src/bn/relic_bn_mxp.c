@@ -40,15 +40,31 @@
  */
 #define TABLE_SIZE			64
 
-/*============================================================================*/
-/* Public definitions                                                         */
-/*============================================================================*/
+/**
+ * Width of the fixed window used in constant-time exponentiation.
+ */
+#define CONST_WIDTH			5
+
+/**
+ * Number of entries in the table used in constant-time exponentiation.
+ */
+#define CONST_SIZE			(1 << CONST_WIDTH)
 
 #if BN_MXP == BASIC || !defined(STRIP)
 
-void bn_mxp_basic(bn_t c, const bn_t a, const bn_t b, const bn_t m) {
+/**
+ * Exponentiates a multiple precision integer modulo a precomputed modulus
+ * using the binary method.
+ *
+ * @param[out] c			- the result.
+ * @param[in] a				- the basis.
+ * @param[in] b				- the exponent.
+ * @param[in] ctx			- the precomputed modulus.
+ */
+static void mxp_basic(bn_t c, const bn_t a, const bn_t b,
+		const bn_mod_ctx_t ctx) {
 	int i, l;
-	bn_t t, u, r;
+	bn_t t, r;
 
 	if (bn_is_zero(b)) {
 		bn_set_dig(c, 1);
@@ -56,47 +72,33 @@ void bn_mxp_basic(bn_t c, const bn_t a, const bn_t b, const bn_t m) {
 	}
 
 	bn_null(t);
-	bn_null(u);
 	bn_null(r);
 
 	TRY {
 		bn_new(t);
-		bn_new(u);
 		bn_new(r);
 
-		bn_mod_pre(u, m);
-
 		l = bn_bits(b);
 
-#if BN_MOD == MONTY
-		bn_mod_monty_conv(t, a, m);
-#else
-		bn_copy(t, a);
-#endif
-
+		bn_mod_ctx_conv(t, a, ctx);
 		bn_copy(r, t);
 
 		for (i = l - 2; i >= 0; i--) {
 			bn_sqr(r, r);
-			bn_mod(r, r, m, u);
+			bn_mod(r, r, ctx->m, ctx->u);
 			if (bn_get_bit(b, i)) {
 				bn_mul(r, r, t);
-				bn_mod(r, r, m, u);
+				bn_mod(r, r, ctx->m, ctx->u);
 			}
 		}
 
-#if BN_MOD == MONTY
-		bn_mod_monty_back(c, r, m);
-#else
-		bn_copy(c, r);
-#endif
+		bn_mod_ctx_back(c, r, ctx);
 	}
 	CATCH_ANY {
 		THROW(ERR_CAUGHT);
 	}
 	FINALLY {
 		bn_free(t);
-		bn_free(u);
 		bn_free(r);
 	}
 }
@@ -105,13 +107,22 @@ void bn_mxp_basic(bn_t c, const bn_t a, const bn_t b, const bn_t m) {
 
 #if BN_MXP == SLIDE || !defined(STRIP)
 
-void bn_mxp_slide(bn_t c, const bn_t a, const bn_t b, const bn_t m) {
-	bn_t tab[TABLE_SIZE], t, u, r;
+/**
+ * Exponentiates a multiple precision integer modulo a precomputed modulus
+ * using the sliding window method.
+ *
+ * @param[out] c			- the result.
+ * @param[in] a				- the basis.
+ * @param[in] b				- the exponent.
+ * @param[in] ctx			- the precomputed modulus.
+ */
+static void mxp_slide(bn_t c, const bn_t a, const bn_t b,
+		const bn_mod_ctx_t ctx) {
+	bn_t tab[TABLE_SIZE], t, r;
 	int i, j, l, w = 1;
 	uint8_t win[BN_BITS];
 
 	bn_null(t);
-	bn_null(u);
 	bn_null(r);
 	/* Initialize table. */
 	for (i = 0; i < TABLE_SIZE; i++) {
@@ -139,26 +150,19 @@ void bn_mxp_slide(bn_t c, const bn_t a, const bn_t b, const bn_t m) {
 		}
 
 		bn_new(t);
-		bn_new(u);
 		bn_new(r);
-		bn_mod_pre(u, m);
 
-#if BN_MOD == MONTY
-		bn_set_dig(r, 1);
-		bn_mod_monty_conv(r, r, m);
-		bn_mod_monty_conv(t, a, m);
-#else /* BN_MOD == BARRT || BN_MOD == RADIX */
 		bn_set_dig(r, 1);
-		bn_copy(t, a);
-#endif
+		bn_mod_ctx_conv(r, r, ctx);
+		bn_mod_ctx_conv(t, a, ctx);
 
 		bn_copy(tab[1], t);
 		bn_sqr(t, tab[1]);
-		bn_mod(t, t, m, u);
+		bn_mod(t, t, ctx->m, ctx->u);
 		/* Create table. */
 		for (i = 1; i < 1 << (w - 1); i++) {
 			bn_mul(tab[2 * i + 1], tab[2 * i - 1], t);
-			bn_mod(tab[2 * i + 1], tab[2 * i + 1], m, u);
+			bn_mod(tab[2 * i + 1], tab[2 * i + 1], ctx->m, ctx->u);
 		}
 
 		l = BN_BITS + 1;
@@ -166,22 +170,18 @@ void bn_mxp_slide(bn_t c, const bn_t a, const bn_t b, const bn_t m) {
 		for (i = 0; i < l; i++) {
 			if (win[i] == 0) {
 				bn_sqr(r, r);
-				bn_mod(r, r, m, u);
+				bn_mod(r, r, ctx->m, ctx->u);
 			} else {
 				for (j = 0; j < util_bits_dig(win[i]); j++) {
 					bn_sqr(r, r);
-					bn_mod(r, r, m, u);
+					bn_mod(r, r, ctx->m, ctx->u);
 				}
 				bn_mul(r, r, tab[win[i]]);
-				bn_mod(r, r, m, u);
+				bn_mod(r, r, ctx->m, ctx->u);
 			}
 		}
 		bn_trim(r);
-#if BN_MOD == MONTY
-		bn_mod_monty_back(c, r, m);
-#else
-		bn_copy(c, r);
-#endif
+		bn_mod_ctx_back(c, r, ctx);
 	}
 	CATCH_ANY {
 		THROW(ERR_CAUGHT);
@@ -190,41 +190,40 @@ void bn_mxp_slide(bn_t c, const bn_t a, const bn_t b, const bn_t m) {
 		for (i = 1; i < (1 << w); i++) {
 			bn_free(tab[i]);
 		}
-		bn_free(u);
 		bn_free(t);
 		bn_free(r);
 	}
 }
 
-
 #endif
 
 #if BN_MXP == MONTY || !defined(STRIP)
 
-void bn_mxp_monty(bn_t c, const bn_t a, const bn_t b, const bn_t m) {
-	bn_t tab[2], u;
+/**
+ * Exponentiates a multiple precision integer modulo a precomputed modulus
+ * using the Montgomery powering ladder.
+ *
+ * @param[out] c			- the result.
+ * @param[in] a				- the basis.
+ * @param[in] b				- the exponent.
+ * @param[in] ctx			- the precomputed modulus.
+ */
+static void mxp_monty(bn_t c, const bn_t a, const bn_t b,
+		const bn_mod_ctx_t ctx) {
+	bn_t tab[2];
 	dig_t mask;
 	int t;
 
 	bn_null(tab[0]);
 	bn_null(tab[1]);
-	bn_null(u);
 
 	TRY {
-		bn_new(u);
-		bn_mod_pre(u, m);
-
 		bn_new(tab[0]);
 		bn_new(tab[1]);
 
-#if BN_MOD == MONTY
-		bn_set_dig(tab[0], 1);
-		bn_mod_monty_conv(tab[0], tab[0], m);
-		bn_mod_monty_conv(tab[1], a, m);
-#else
 		bn_set_dig(tab[0], 1);
-		bn_copy(tab[1], a);
-#endif
+		bn_mod_ctx_conv(tab[0], tab[0], ctx);
+		bn_mod_ctx_conv(tab[1], a, ctx);
 
 		for (int i = bn_bits(b) - 1; i >= 0; i--) {
 			int j = bn_get_bit(b, i);
@@ -234,34 +233,251 @@ void bn_mxp_monty(bn_t c, const bn_t a, const bn_t b, const bn_t m) {
 			tab[0]->used ^= t;
 			tab[1]->used ^= t;
 			bn_mul(tab[0], tab[0], tab[1]);
-			bn_mod(tab[0], tab[0], m, u);
+			bn_mod(tab[0], tab[0], ctx->m, ctx->u);
 			bn_sqr(tab[1], tab[1]);
-			bn_mod(tab[1], tab[1], m, u);
+			bn_mod(tab[1], tab[1], ctx->m, ctx->u);
 			dv_swap_cond(tab[0]->dp, tab[1]->dp, BN_DIGS, j ^ 1);
 			mask = -(j ^ 1);
 			t = (tab[0]->used ^ tab[1]->used) & mask;
 			tab[0]->used ^= t;
-			tab[1]->used ^= t;			
+			tab[1]->used ^= t;
 		}
 
-#if BN_MOD == MONTY
-		bn_mod_monty_back(c, tab[0], m);
-#else
-		bn_copy(c, tab[0]);
-#endif
-
+		bn_mod_ctx_back(c, tab[0], ctx);
 	} CATCH_ANY {
 		THROW(ERR_CAUGHT);
 	}
 	FINALLY {
 		bn_free(tab[1]);
 		bn_free(tab[0]);
-		bn_free(u);
 	}
 }
 
 #endif
 
+/**
+ * Stores an integer in an interleaved table, so that the digits in the same
+ * position of all entries are contiguous in memory.
+ *
+ * @param[out] tab			- the table.
+ * @param[in] a				- the integer to store.
+ * @param[in] idx			- the index of the entry.
+ * @param[in] digits		- the number of digits of each entry.
+ */
+static void mxp_scatter(dig_t *tab, const bn_t a, int idx, int digits) {
+	for (int j = 0; j < digits; j++) {
+		tab[j * CONST_SIZE + idx] = (j < a->used ? a->dp[j] : 0);
+	}
+}
+
+/**
+ * Reads an integer from an interleaved table. Every entry is read and masked,
+ * so the memory access pattern does not depend on the index.
+ *
+ * @param[out] c			- the integer read.
+ * @param[in] tab			- the table.
+ * @param[in] idx			- the index of the entry.
+ * @param[in] digits		- the number of digits of each entry.
+ */
+static void mxp_gather(bn_t c, const dig_t *tab, int idx, int digits) {
+	dig_t d, mask;
+
+	bn_grow(c, digits);
+	for (int j = 0; j < digits; j++) {
+		d = 0;
+		for (int i = 0; i < CONST_SIZE; i++) {
+			/* The mask is all ones if i == idx and zero otherwise. */
+			mask = -(((dig_t)(i ^ idx) - 1) >> (BN_DIGIT - 1));
+			d |= tab[j * CONST_SIZE + i] & mask;
+		}
+		c->dp[j] = d;
+	}
+	c->used = digits;
+	c->sign = BN_POS;
+	bn_trim(c);
+}
+
+/**
+ * Exponentiates a multiple precision integer modulo a precomputed modulus
+ * using a fixed window and a table read in constant time.
+ *
+ * @param[out] c			- the result.
+ * @param[in] a				- the basis.
+ * @param[in] b				- the exponent.
+ * @param[in] ctx			- the precomputed modulus.
+ */
+static void mxp_const(bn_t c, const bn_t a, const bn_t b,
+		const bn_mod_ctx_t ctx) {
+	dig_t tab[CONST_SIZE * BN_SIZE];
+	int i, j, k, l, w, digits = ctx->m->used;
+	bn_t t, r;
+
+	if (bn_is_zero(b)) {
+		bn_set_dig(c, 1);
+		return;
+	}
+
+	bn_null(t);
+	bn_null(r);
+
+	TRY {
+		bn_new(t);
+		bn_new(r);
+
+		/* Build the table with a^i for 0 <= i < 2^w. */
+		bn_set_dig(r, 1);
+		bn_mod_ctx_conv(r, r, ctx);
+		mxp_scatter(tab, r, 0, digits);
+		bn_mod_ctx_conv(t, a, ctx);
+		mxp_scatter(tab, t, 1, digits);
+		bn_copy(r, t);
+		for (i = 2; i < CONST_SIZE; i++) {
+			bn_mul(r, r, t);
+			bn_mod(r, r, ctx->m, ctx->u);
+			mxp_scatter(tab, r, i, digits);
+		}
+
+		/* Process every window, multiplying even when it is zero. */
+		l = (bn_bits(b) + CONST_WIDTH - 1) / CONST_WIDTH;
+		for (i = l - 1; i >= 0; i--) {
+			w = 0;
+			for (k = CONST_WIDTH - 1; k >= 0; k--) {
+				w = (w << 1) | bn_get_bit(b, i * CONST_WIDTH + k);
+			}
+			if (i == l - 1) {
+				mxp_gather(r, tab, w, digits);
+				continue;
+			}
+			for (j = 0; j < CONST_WIDTH; j++) {
+				bn_sqr(r, r);
+				bn_mod(r, r, ctx->m, ctx->u);
+			}
+			mxp_gather(t, tab, w, digits);
+			bn_mul(r, r, t);
+			bn_mod(r, r, ctx->m, ctx->u);
+		}
+
+		bn_mod_ctx_back(c, r, ctx);
+	}
+	CATCH_ANY {
+		THROW(ERR_CAUGHT);
+	}
+	FINALLY {
+		bn_free(t);
+		bn_free(r);
+	}
+}
+
+/*============================================================================*/
+/* Public definitions                                                         */
+/*============================================================================*/
+
+#if BN_MXP == BASIC || !defined(STRIP)
+
+void bn_mxp_basic(bn_t c, const bn_t a, const bn_t b, const bn_t m) {
+	bn_mod_ctx_t ctx;
+
+	if (bn_is_zero(b)) {
+		bn_set_dig(c, 1);
+		return;
+	}
+
+	bn_mod_ctx_null(ctx);
+
+	TRY {
+		bn_mod_ctx_new(ctx);
+		bn_mod_ctx_set(ctx, m);
+		mxp_basic(c, a, b, ctx);
+	}
+	CATCH_ANY {
+		THROW(ERR_CAUGHT);
+	}
+	FINALLY {
+		bn_mod_ctx_free(ctx);
+	}
+}
+
+#endif
+
+#if BN_MXP == SLIDE || !defined(STRIP)
+
+void bn_mxp_slide(bn_t c, const bn_t a, const bn_t b, const bn_t m) {
+	bn_mod_ctx_t ctx;
+
+	bn_mod_ctx_null(ctx);
+
+	TRY {
+		bn_mod_ctx_new(ctx);
+		bn_mod_ctx_set(ctx, m);
+		mxp_slide(c, a, b, ctx);
+	}
+	CATCH_ANY {
+		THROW(ERR_CAUGHT);
+	}
+	FINALLY {
+		bn_mod_ctx_free(ctx);
+	}
+}
+
+#endif
+
+#if BN_MXP == MONTY || !defined(STRIP)
+
+void bn_mxp_monty(bn_t c, const bn_t a, const bn_t b, const bn_t m) {
+	bn_mod_ctx_t ctx;
+
+	bn_mod_ctx_null(ctx);
+
+	TRY {
+		bn_mod_ctx_new(ctx);
+		bn_mod_ctx_set(ctx, m);
+		mxp_monty(c, a, b, ctx);
+	}
+	CATCH_ANY {
+		THROW(ERR_CAUGHT);
+	}
+	FINALLY {
+		bn_mod_ctx_free(ctx);
+	}
+}
+
+#endif
+
+void bn_mxp_const(bn_t c, const bn_t a, const bn_t b, const bn_t m) {
+	bn_mod_ctx_t ctx;
+
+	bn_mod_ctx_null(ctx);
+
+	TRY {
+		bn_mod_ctx_new(ctx);
+		bn_mod_ctx_set(ctx, m);
+		mxp_const(c, a, b, ctx);
+	}
+	CATCH_ANY {
+		THROW(ERR_CAUGHT);
+	}
+	FINALLY {
+		bn_mod_ctx_free(ctx);
+	}
+}
+
+void bn_mxp_const_ctx(bn_t c, const bn_t a, const bn_t b,
+		const bn_mod_ctx_t ctx) {
+	mxp_const(c, a, b, ctx);
+}
+
+void bn_mxp_ctx(bn_t c, const bn_t a, const bn_t b, const bn_mod_ctx_t ctx) {
+#if BN_MXP == BASIC
+	mxp_basic(c, a, b, ctx);
+#elif BN_MXP == SLIDE
+	mxp_slide(c, a, b, ctx);
+#elif BN_MXP == MONTY
+	mxp_monty(c, a, b, ctx);
+#elif BN_MXP == CONST
+	mxp_const(c, a, b, ctx);
+#endif
+}
+
 void bn_mxp_dig(bn_t c, const bn_t a, dig_t b, const bn_t m) {
 	int i, l;
 	bn_t t, u, r;
@@ -316,3 +532,105 @@ void bn_mxp_dig(bn_t c, const bn_t a, dig_t b, const bn_t m) {
 		bn_free(r);
 	}
 }
+
+void bn_mxp_dig_ctx(bn_t c, const bn_t a, dig_t b, const bn_mod_ctx_t ctx) {
+	int i, l;
+	bn_t t, r;
+
+	if (b == 0) {
+		bn_set_dig(c, 1);
+		return;
+	}
+
+	bn_null(t);
+	bn_null(r);
+
+	TRY {
+		bn_new(t);
+		bn_new(r);
+
+		l = util_bits_dig(b);
+
+		bn_mod_ctx_conv(t, a, ctx);
+		bn_copy(r, t);
+
+		for (i = l - 2; i >= 0; i--) {
+			bn_sqr(r, r);
+			bn_mod(r, r, ctx->m, ctx->u);
+			if (b & ((dig_t)1 << i)) {
+				bn_mul(r, r, t);
+				bn_mod(r, r, ctx->m, ctx->u);
+			}
+		}
+
+		bn_mod_ctx_back(c, r, ctx);
+	}
+	CATCH_ANY {
+		THROW(ERR_CAUGHT);
+	}
+	FINALLY {
+		bn_free(t);
+		bn_free(r);
+	}
+}
+
+void bn_mxp_pre(bn_t *t, const bn_t a, const bn_mod_ctx_t ctx) {
+	bn_mod_ctx_conv(t[0], a, ctx);
+	for (int i = 1; i < BN_XP_TABLE; i++) {
+		bn_copy(t[i], t[i - 1]);
+		for (int j = 0; j < BN_XP_WIDTH; j++) {
+			bn_sqr(t[i], t[i]);
+			bn_mod(t[i], t[i], ctx->m, ctx->u);
+		}
+	}
+}
+
+void bn_mxp_fix(bn_t c, const bn_t *t, const bn_t b, const bn_mod_ctx_t ctx) {
+	int i, j, l, d[BN_XP_TABLE];
+	bn_t u, v;
+
+	if (bn_sign(b) == BN_NEG || bn_bits(b) > BN_XP_TABLE * BN_XP_WIDTH) {
+		THROW(ERR_NO_VALID);
+		return;
+	}
+
+	bn_null(u);
+	bn_null(v);
+
+	TRY {
+		bn_new(u);
+		bn_new(v);
+
+		/* Split the exponent into windows b = sum d_i * 2^(BN_XP_WIDTH * i). */
+		l = (bn_bits(b) + BN_XP_WIDTH - 1) / BN_XP_WIDTH;
+		for (i = 0; i < l; i++) {
+			d[i] = 0;
+			for (j = 0; j < BN_XP_WIDTH; j++) {
+				d[i] |= bn_get_bit(b, i * BN_XP_WIDTH + j) << j;
+			}
+		}
+
+		/* Yao's method: u = prod_{j > 0} v_j, v_j = prod_{d_i >= j} t[i]. */
+		bn_set_dig(u, 1);
+		bn_mod_ctx_conv(u, u, ctx);
+		bn_copy(v, u);
+		for (j = (1 << BN_XP_WIDTH) - 1; j > 0; j--) {
+			for (i = 0; i < l; i++) {
+				if (d[i] == j) {
+					bn_mul(v, v, t[i]);
+					bn_mod(v, v, ctx->m, ctx->u);
+				}
+			}
+			bn_mul(u, u, v);
+			bn_mod(u, u, ctx->m, ctx->u);
+		}
+		bn_mod_ctx_back(c, u, ctx);
+	}
+	CATCH_ANY {
+		THROW(ERR_CAUGHT);
+	}
+	FINALLY {
+		bn_free(u);
+		bn_free(v);
+	}
+}
@@ -122,6 +122,11 @@ static const dig_t primes[] = {
 #endif
 };
 
+/**
+ * Number of odd candidates sieved from each random starting point.
+ */
+#define SIEVE_RANGE	(1 << 16)
+
 #if BN_MOD == PMERS
 
 /**
@@ -166,6 +171,99 @@ static void bn_exp(bn_t c, const bn_t a, const bn_t b, const bn_t m) {
 
 #endif
 
+#if BN_GEN == BASIC || BN_GEN == SAFEP || !defined(STRIP)
+
+/**
+ * Generates a random prime, or a random safe prime a = 2q + 1, by sieving
+ * consecutive odd candidates. The residues of the candidate modulo the small
+ * primes are computed once and updated with single-precision additions, so
+ * that the Miller-Rabin test only runs on candidates without small factors.
+ *
+ * @param[out] a			- the result.
+ * @param[in] bits			- the length of the number in bits.
+ * @param[in] safe			- the flag to generate a safe prime.
+ */
+static void bn_gen_prime_imp(bn_t a, int bits, int safe) {
+	dig_t res[BASIC_TESTS];
+	int i, j, k, found = 0;
+	bn_t t;
+
+	bn_null(t);
+
+	/* Only sieve with primes smaller than any candidate. */
+	for (k = 1; k < BASIC_TESTS; k++) {
+		if (bits - 2 < BN_DIGIT &&
+				(bits < 3 || (primes[k] >> (bits - 2)) != 0)) {
+			break;
+		}
+	}
+
+	TRY {
+		bn_new(t);
+
+		while (!found) {
+			do {
+				bn_rand(a, BN_POS, bits);
+			} while (bn_bits(a) != bits);
+			if (safe) {
+				/* Sieve q = (a - 1)/2 instead. */
+				bn_rsh(a, a, 1);
+			}
+			if (bn_is_even(a)) {
+				bn_add_dig(a, a, 1);
+			}
+			for (i = 1; i < k; i++) {
+				bn_mod_dig(&res[i], a, primes[i]);
+			}
+
+			for (j = 0; j < SIEVE_RANGE && !found; j++) {
+				/* Skip if a, or 2a + 1 for safe primes, has a small factor. */
+				for (i = 1; i < k; i++) {
+					if (res[i] == 0 || (safe && res[i] == (primes[i] >> 1))) {
+						break;
+					}
+				}
+				if (i == k) {
+					if (safe) {
+						bn_dbl(t, a);
+						bn_add_dig(t, t, 1);
+					} else {
+						bn_copy(t, a);
+					}
+					if (bn_bits(t) != bits) {
+						/* Ran past the bit length, start over. */
+						break;
+					}
+					if (k == BASIC_TESTS) {
+						found = bn_is_prime_rabin(a) &&
+								(!safe || bn_is_prime_rabin(t));
+					} else {
+						found = bn_is_prime(a) && (!safe || bn_is_prime(t));
+					}
+				}
+				if (!found) {
+					bn_add_dig(a, a, 2);
+					for (i = 1; i < k; i++) {
+						res[i] += 2;
+						if (res[i] >= primes[i]) {
+							res[i] -= primes[i];
+						}
+					}
+				}
+			}
+		}
+		bn_copy(a, t);
+	}
+	CATCH_ANY {
+		THROW(ERR_CAUGHT);
+	}
+	FINALLY {
+		bn_free(t);
+	}
+}
+
+#endif
+
 /*============================================================================*/
 /* Public definitions                                                         */
 /*============================================================================*/
@@ -390,14 +488,7 @@ int bn_is_prime_solov(const bn_t a) {
 #if BN_GEN == BASIC || !defined(STRIP)
 
 void bn_gen_prime_basic(bn_t a, int bits) {
-	while (1) {
-		do {
-			bn_rand(a, BN_POS, bits);
-		} while (bn_bits(a) != bits);
-		if (bn_is_prime(a)) {
-			return;
-		}
-	}
+	bn_gen_prime_imp(a, bits, 0);
 }
 
 #endif
@@ -405,23 +496,7 @@ void bn_gen_prime_basic(bn_t a, int bits) {
 #if BN_GEN == SAFEP || !defined(STRIP)
 
 void bn_gen_prime_safep(bn_t a, int bits) {
-	while (1) {
-		do {
-			bn_rand(a, BN_POS, bits);
-		} while (bn_bits(a) != bits);
-		/* Check if (a - 1)/2 is prime. */
-		bn_sub_dig(a, a, 1);
-		bn_rsh(a, a, 1);
-		if (bn_is_prime(a)) {
-			/* Restore a. */
-			bn_lsh(a, a, 1);
-			bn_add_dig(a, a, 1);
-			if (bn_is_prime(a)) {
-				/* Should be prime now. */
-				return;
-			}
-		}
-	}
+	bn_gen_prime_imp(a, bits, 1);
 }
 
 #endif
@@ -98,6 +98,7 @@ void bn_rec_win(uint8_t *win, int *len, const bn_t k, int w) {
 	
 	if (*len < CEIL(l, w)) {
 		THROW(ERR_NO_BUFFER);
+		return;
 	}
 
 	j = 0;
@@ -115,6 +116,7 @@ void bn_rec_slw(uint8_t *win, int *len, const bn_t k, int w) {
 
 	if (*len < CEIL(l, w)) {
 		THROW(ERR_NO_BUFFER);
+		return;
 	}
 
 	i = l - 1;
@@ -143,6 +145,7 @@ void bn_rec_naf(int8_t *naf, int *len, const bn_t k, int w) {
 
 	if (*len < (bn_bits(k) + 1)) {
 		THROW(ERR_NO_BUFFER);
+		return;
 	}
 
 	bn_null(t);
@@ -422,6 +425,7 @@ void bn_rec_tnaf(int8_t *tnaf, int *len, const bn_t k, int8_t u, int m, int w) {
 
 	if (*len < (bn_bits(k) + 1)) {
 		THROW(ERR_NO_BUFFER);
+		return;
 	}
 
 	TRY {
@@ -548,6 +552,7 @@ void bn_rec_rtnaf(int8_t *tnaf, int *len, const bn_t k, int8_t u, int m, int w)
 
 	if (*len < (bn_bits(k) + 1)) {
 		THROW(ERR_NO_BUFFER);
+		return;
 	}
 
 	TRY {
@@ -686,6 +691,7 @@ void bn_rec_reg(int8_t *naf, int *len, const bn_t k, int n, int w) {
 
 	if (*len < l) {
 		THROW(ERR_NO_BUFFER);
+		return;
 	}
 
 	TRY {
@@ -733,6 +739,7 @@ void bn_rec_jsf(int8_t *jsf, int *len, const bn_t k, const bn_t l) {
 
 	if (*len < (2 * bn_bits(k) + 1)) {
 		THROW(ERR_NO_BUFFER);
+		return;
 	}
 
 	TRY {
@@ -37,7 +37,7 @@
 /* Private definitions                                                        */
 /*============================================================================*/
 
-#if BN_KARAT > 0 || !defined(STRIP)
+#if BN_KARAT > 0 || BN_SQR == TOOMC || !defined(STRIP)
 
 /**
  * Computes the square of a multiple precision integer using recursive Karatsuba
@@ -90,12 +90,15 @@ static void bn_sqr_karat_imp(bn_t c, const bn_t a, int level) {
 #if BN_SQR == BASIC
 			bn_sqr_basic(a0a0, a0);
 			bn_sqr_basic(a1a1, a1);
-#elif BN_SQR == COMBA
-			bn_sqr_comba(a0a0, a0);
-			bn_sqr_comba(a1a1, a1);
+#elif BN_SQR == TOOMC
+			bn_sqr_toomc(a0a0, a0);
+			bn_sqr_toomc(a1a1, a1);
 #elif BN_SQR == MULTP
 			bn_mul_comba(a0a0, a0, a0);
 			bn_mul_comba(a1a1, a1, a1);
+#else
+			bn_sqr_comba(a0a0, a0);
+			bn_sqr_comba(a1a1, a1);
 #endif
 		} else {
 			bn_sqr_karat_imp(a0a0, a0, level - 1);
@@ -109,10 +112,12 @@ static void bn_sqr_karat_imp(bn_t c, const bn_t a, int level) {
 			/* t = (a1 + a0)*(a1 + a0) */
 #if BN_SQR == BASIC
 			bn_sqr_basic(t, t);
-#elif BN_SQR == COMBA
-			bn_sqr_comba(t, t);
+#elif BN_SQR == TOOMC
+			bn_sqr_toomc(t, t);
 #elif BN_SQR == MULTP
 			bn_mul_comba(t, t, t);
+#else
+			bn_sqr_comba(t, t);
 #endif
 		} else {
 			bn_sqr_karat_imp(t, t, level - 1);
@@ -188,7 +193,7 @@ void bn_sqr_basic(bn_t c, const bn_t a) {
 
 #endif
 
-#if BN_SQR == COMBA || !defined(STRIP)
+#if BN_SQR == COMBA || BN_SQR == TOOMC || !defined(STRIP)
 
 void bn_sqr_comba(bn_t c, const bn_t a) {
 	int digits;
@@ -218,10 +223,117 @@ void bn_sqr_comba(bn_t c, const bn_t a) {
 
 #endif
 
-#if BN_KARAT > 0 || !defined(STRIP)
+#if BN_KARAT > 0 || BN_SQR == TOOMC || !defined(STRIP)
 
 void bn_sqr_karat(bn_t c, const bn_t a) {
 	bn_sqr_karat_imp(c, a, BN_KARAT);
 }
 
 #endif
+
+#if BN_SQR == TOOMC || !defined(STRIP)
+
+void bn_sqr_toom3(bn_t c, const bn_t a) {
+	int k;
+	bn_t a0, a1, a2, r0, r1, r2, r3, r4, t;
+
+	bn_null(a0);
+	bn_null(a1);
+	bn_null(a2);
+	bn_null(r0);
+	bn_null(r1);
+	bn_null(r2);
+	bn_null(r3);
+	bn_null(r4);
+	bn_null(t);
+
+	/* Compute a third of the digits of a. */
+	k = (a->used + 2) / 3;
+
+	TRY {
+		bn_new(a0);
+		bn_new(a1);
+		bn_new(a2);
+		bn_new(r0);
+		bn_new(r1);
+		bn_new(r2);
+		bn_new(r3);
+		bn_new(r4);
+		bn_new(t);
+
+		/* a = a2 || a1 || a0. */
+		bn_abs(t, a);
+		bn_mod_2b(a0, t, k * BN_DIGIT);
+		bn_rsh(t, t, k * BN_DIGIT);
+		bn_mod_2b(a1, t, k * BN_DIGIT);
+		bn_rsh(a2, t, k * BN_DIGIT);
+
+		/* r0 = a(0)^2 and r4 = a(inf)^2. */
+		bn_sqr_toomc(r0, a0);
+		bn_sqr_toomc(r4, a2);
+
+		/* r1 = a(1)^2, r2 = a(-1)^2 and r3 = a(-2)^2. */
+		bn_add(t, a0, a2);
+		bn_sub(r3, t, a1);
+		bn_add(t, t, a1);
+		bn_sqr_toomc(r1, t);
+		bn_sqr_toomc(r2, r3);
+		bn_add(r3, r3, a2);
+		bn_dbl(r3, r3);
+		bn_sub(r3, r3, a0);
+		bn_sqr_toomc(r3, r3);
+
+		/* Interpolate using the sequence by Bodrato. */
+		bn_sub(r3, r3, r1);
+		bn_div_dig(r3, r3, 3);
+		bn_sub(r1, r1, r2);
+		bn_hlv(r1, r1);
+		bn_sub(r2, r2, r0);
+		bn_sub(r3, r2, r3);
+		bn_hlv(r3, r3);
+		bn_dbl(t, r4);
+		bn_add(r3, r3, t);
+		bn_add(r2, r2, r1);
+		bn_sub(r2, r2, r4);
+		bn_sub(r1, r1, r3);
+
+		/* c = r4 * x^4 + r3 * x^3 + r2 * x^2 + r1 * x + r0, x = 2^(k digits). */
+		bn_lsh(t, r4, k * BN_DIGIT);
+		bn_add(t, t, r3);
+		bn_lsh(t, t, k * BN_DIGIT);
+		bn_add(t, t, r2);
+		bn_lsh(t, t, k * BN_DIGIT);
+		bn_add(t, t, r1);
+		bn_lsh(t, t, k * BN_DIGIT);
+		bn_add(t, t, r0);
+
+		bn_copy(c, t);
+		bn_trim(c);
+	}
+	CATCH_ANY {
+		THROW(ERR_CAUGHT);
+	}
+	FINALLY {
+		bn_free(a0);
+		bn_free(a1);
+		bn_free(a2);
+		bn_free(r0);
+		bn_free(r1);
+		bn_free(r2);
+		bn_free(r3);
+		bn_free(r4);
+		bn_free(t);
+	}
+}
+
+void bn_sqr_toomc(bn_t c, const bn_t a) {
+	if (a->used < BN_SQR_KARAT) {
+		bn_sqr_comba(c, a);
+	} else if (a->used < BN_SQR_TOOM3) {
+		bn_sqr_karat_imp(c, a, 1);
+	} else {
+		bn_sqr_toom3(c, a);
+	}
+}
+
+#endif
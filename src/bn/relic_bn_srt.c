@@ -42,6 +42,7 @@ void bn_srt(bn_t c, bn_t a) {
 	
 	if (bn_sign(a) == BN_NEG) {
 		THROW(ERR_NO_VALID);
+		return;
 	}
 	
 	bits = bn_bits(a);
@@ -33,6 +33,297 @@
 
 #include "relic_core.h"
 
+/*============================================================================*/
+/* Private definitions                                                        */
+/*============================================================================*/
+
+/**
+ * Maximum number of precomputed powers of the radix used in conversions.
+ */
+#define STR_LEVELS		16
+
+/**
+ * Number of digit-sized chunks below which strings are converted directly.
+ */
+#define STR_CHUNKS		8
+
+/**
+ * Returns the value of a character in a given radix, or a value not smaller
+ * than the radix if the character is not a valid digit.
+ *
+ * @param[in] c				- the character.
+ * @param[in] radix			- the radix.
+ * @return the value of the digit.
+ */
+static int str_value(char c, int radix) {
+	if (radix < 36) {
+		c = (char)TOUPPER(c);
+	}
+	if (c >= '0' && c <= '9') {
+		return c - '0';
+	}
+	if (c >= 'A' && c <= 'Z') {
+		return c - 'A' + 10;
+	}
+	if (c >= 'a' && c <= 'z') {
+		return c - 'a' + 36;
+	}
+	if (c == '+') {
+		return 62;
+	}
+	if (c == '/') {
+		return 63;
+	}
+	return 64;
+}
+
+/**
+ * Returns the base-2 logarithm of the radix if it is a power of two, or zero
+ * otherwise.
+ *
+ * @param[in] radix			- the radix.
+ * @return the logarithm of the radix.
+ */
+static int str_log(int radix) {
+	if ((radix & (radix - 1)) == 0) {
+		return util_bits_dig(radix) - 1;
+	}
+	return 0;
+}
+
+/**
+ * Computes the largest power of the radix that fits in a digit.
+ *
+ * @param[out] big			- the power of the radix.
+ * @param[in] radix			- the radix.
+ * @return the number of radix digits packed in a digit.
+ */
+static int str_chunk(dig_t *big, int radix) {
+	int c = 1;
+
+	*big = (dig_t)radix;
+	while (*big <= DMASK / (dig_t)radix) {
+		*big *= (dig_t)radix;
+		c++;
+	}
+	return c;
+}
+
+/**
+ * Counts the digits of a positive integer in a radix that is not a power of
+ * two by searching for the largest power of the radix not larger than it.
+ *
+ * @param[in] a				- the integer.
+ * @param[in] radix			- the radix.
+ * @param[in] p				- the table of powers of the radix.
+ * @param[in] levels		- the number of powers in the table.
+ * @param[in] c				- the number of radix digits packed in a digit.
+ * @return the number of digits.
+ */
+static int str_count(const bn_t a, int radix, const bn_t *p, int levels,
+		int c) {
+	int i, n = 1, bits = bn_bits(a);
+	bn_t t, x;
+
+	bn_null(t);
+	bn_null(x);
+
+	TRY {
+		bn_new(t);
+		bn_new(x);
+
+		/* Find the largest x = big^m <= a, with m written in binary. */
+		bn_set_dig(x, 1);
+		for (i = levels - 1; i >= 0; i--) {
+			if (bn_bits(x) + bn_bits(p[i]) - 1 <= bits) {
+				bn_mul(t, x, p[i]);
+				if (bn_cmp(t, a) != CMP_GT) {
+					bn_copy(x, t);
+					n += c << i;
+				}
+			}
+		}
+		/* Now a / x < big, count the remaining digits one by one. */
+		bn_mul_dig(t, x, (dig_t)radix);
+		while (bn_cmp(t, a) != CMP_GT) {
+			bn_mul_dig(t, t, (dig_t)radix);
+			n++;
+		}
+	}
+	CATCH_ANY {
+		THROW(ERR_CAUGHT);
+	}
+	FINALLY {
+		bn_free(t);
+		bn_free(x);
+	}
+	return n;
+}
+
+/**
+ * Reads a string of valid digits in a power-of-two radix by placing each
+ * digit directly in its bit position.
+ *
+ * @param[out] a			- the result.
+ * @param[in] str			- the string of digits.
+ * @param[in] len			- the number of digits.
+ * @param[in] radix			- the radix.
+ */
+static void str_read_pow(bn_t a, const char *str, int len, int radix) {
+	int i, j, k, log = str_log(radix);
+	int digits = (len * log + BN_DIGIT - 1) / BN_DIGIT;
+	dig_t d;
+
+	if (len == 0) {
+		bn_zero(a);
+		return;
+	}
+
+	bn_grow(a, digits);
+	dv_zero(a->dp, digits);
+
+	for (i = len - 1, j = 0; i >= 0; i--, j += log) {
+		d = (dig_t)str_value(str[i], radix);
+		a->dp[j / BN_DIGIT] |= d << (j % BN_DIGIT);
+		k = j % BN_DIGIT + log - BN_DIGIT;
+		if (k > 0) {
+			a->dp[j / BN_DIGIT + 1] |= d >> (log - k);
+		}
+	}
+	a->used = digits;
+	a->sign = BN_POS;
+	bn_trim(a);
+}
+
+/**
+ * Writes exactly len digits of a positive integer in a power-of-two radix by
+ * extracting the bit slice of each digit.
+ *
+ * @param[out] str			- the string of digits.
+ * @param[in] len			- the number of digits.
+ * @param[in] a				- the integer.
+ * @param[in] radix			- the radix.
+ */
+static void str_write_pow(char *str, int len, const bn_t a, int radix) {
+	int i, j, log = str_log(radix);
+	dig_t d;
+
+	for (i = len - 1, j = 0; i >= 0; i--, j += log) {
+		d = a->dp[j / BN_DIGIT] >> (j % BN_DIGIT);
+		if (j % BN_DIGIT + log > BN_DIGIT && j / BN_DIGIT + 1 < a->used) {
+			d |= a->dp[j / BN_DIGIT + 1] << (BN_DIGIT - j % BN_DIGIT);
+		}
+		str[i] = util_conv_char(d & (dig_t)(radix - 1));
+	}
+}
+
+/**
+ * Reads a string of valid digits in any radix by splitting it at a
+ * precomputed power of the radix and combining both halves with a single
+ * multiplication.
+ *
+ * @param[out] a			- the result.
+ * @param[in] str			- the string of digits.
+ * @param[in] len			- the number of digits.
+ * @param[in] radix			- the radix.
+ * @param[in] p				- the table of powers of the radix.
+ * @param[in] levels		- the number of powers in the table.
+ * @param[in] c				- the number of radix digits packed in a digit.
+ * @param[in] big			- the largest power of the radix in a digit.
+ */
+static void str_read_imp(bn_t a, const char *str, int len, int radix,
+		const bn_t *p, int levels, int c, dig_t big) {
+	int i, j, k;
+	dig_t d;
+	bn_t t;
+
+	bn_null(t);
+
+	if (len <= c * STR_CHUNKS) {
+		/* Accumulate one digit-sized chunk at a time. */
+		bn_zero(a);
+		for (i = 0, k = len - c * ((len - 1) / c); i < len; k = c) {
+			for (d = 0, j = 0; j < k; j++, i++) {
+				d = d * (dig_t)radix + (dig_t)str_value(str[i], radix);
+			}
+			bn_mul_dig(a, a, big);
+			bn_add_dig(a, a, d);
+		}
+		return;
+	}
+
+	for (i = 0; i + 1 < levels && (c << (i + 1)) < len; i++);
+	k = c << i;
+
+	TRY {
+		bn_new(t);
+		str_read_imp(t, str, len - k, radix, p, levels, c, big);
+		str_read_imp(a, str + len - k, k, radix, p, levels, c, big);
+		bn_mul(t, t, p[i]);
+		bn_add(a, a, t);
+	}
+	CATCH_ANY {
+		THROW(ERR_CAUGHT);
+	}
+	FINALLY {
+		bn_free(t);
+	}
+}
+
+/**
+ * Writes exactly len digits of a positive integer in any radix by splitting
+ * it with a single division by a precomputed power of the radix. The integer
+ * is destroyed in the process.
+ *
+ * @param[out] str			- the string of digits.
+ * @param[in] len			- the number of digits.
+ * @param[in,out] a			- the integer.
+ * @param[in] radix			- the radix.
+ * @param[in] p				- the table of powers of the radix.
+ * @param[in] levels		- the number of powers in the table.
+ * @param[in] c				- the number of radix digits packed in a digit.
+ * @param[in] big			- the largest power of the radix in a digit.
+ */
+static void str_write_imp(char *str, int len, bn_t a, int radix,
+		const bn_t *p, int levels, int c, dig_t big) {
+	int i, j;
+	dig_t d;
+	bn_t q;
+
+	bn_null(q);
+
+	if (len <= c * STR_CHUNKS) {
+		/* Extract one digit-sized chunk at a time. */
+		for (i = len; i > 0;) {
+			d = 0;
+			if (!bn_is_zero(a)) {
+				bn_div_rem_dig(a, &d, a, big);
+			}
+			for (j = 0; j < c && i > 0; j++) {
+				str[--i] = util_conv_char(d % (dig_t)radix);
+				d /= (dig_t)radix;
+			}
+		}
+		return;
+	}
+
+	for (i = 0; i + 1 < levels && (c << (i + 1)) < len; i++);
+	j = c << i;
+
+	TRY {
+		bn_new(q);
+		bn_div_rem(q, a, a, p[i]);
+		str_write_imp(str, len - j, q, radix, p, levels, c, big);
+		str_write_imp(str + len - j, j, a, radix, p, levels, c, big);
+	}
+	CATCH_ANY {
+		THROW(ERR_CAUGHT);
+	}
+	FINALLY {
+		bn_free(q);
+	}
+}
+
 /*============================================================================*/
 /* Public definitions                                                         */
 /*============================================================================*/
@@ -182,7 +473,7 @@ void bn_rand(bn_t a, int sign, int bits) {
 
 	bn_grow(a, digits);
 
-	rand_bytes((uint8_t *)a->dp, digits * sizeof(dig_t));
+	rand_bytes_small((uint8_t *)a->dp, digits * sizeof(dig_t));
 
 	a->used = digits;
 	a->sign = sign;
@@ -224,19 +515,14 @@ void bn_print(const bn_t a) {
 }
 
 int bn_size_str(const bn_t a, int radix) {
-	int digits = 0;
-	bn_t t;
-
-	bn_null(t);
-
-	/* Binary case requires the bits, a sign and the null terminator. */
-	if (radix == 2) {
-		return bn_bits(a) + (a->sign == BN_NEG ? 1 : 0) + 1;
-	}
+	int i, c, levels, digits = 0;
+	dig_t big;
+	bn_t t, p[STR_LEVELS];
 
 	/* Check the radix. */
 	if (radix < 2 || radix > 64) {
 		THROW(ERR_NO_VALID);
+		return 0;
 	}
 
 	if (bn_is_zero(a)) {
@@ -247,33 +533,53 @@ int bn_size_str(const bn_t a, int radix) {
 		digits++;
 	}
 
-	TRY {
-		bn_new(t);
-		bn_copy(t, a);
+	/* Power-of-two radices require the bits, a sign and the terminator. */
+	if (str_log(radix) != 0) {
+		i = str_log(radix);
+		return digits + (bn_bits(a) + i - 1) / i + 1;
+	}
 
-		t->sign = BN_POS;
+	bn_null(t);
+	for (i = 0; i < STR_LEVELS; i++) {
+		bn_null(p[i]);
+	}
 
-		while (!bn_is_zero(t)) {
-			bn_div_dig(t, t, (dig_t)radix);
-			digits++;
+	TRY {
+		bn_new(t);
+		bn_abs(t, a);
+
+		c = str_chunk(&big, radix);
+		/* Compute powers of the radix up to the integer itself. */
+		bn_new(p[0]);
+		bn_set_dig(p[0], big);
+		for (levels = 1; levels < STR_LEVELS &&
+				2 * bn_bits(p[levels - 1]) - 1 <= bn_bits(t); levels++) {
+			bn_new(p[levels]);
+			bn_sqr(p[levels], p[levels - 1]);
 		}
+		digits += str_count(t, radix, p, levels, c);
 	} CATCH_ANY {
 		THROW(ERR_CAUGHT);
 	} FINALLY {
 		bn_free(t);
+		for (i = 0; i < STR_LEVELS; i++) {
+			bn_free(p[i]);
+		}
 	}
 
 	return digits + 1;
 }
 
 void bn_read_str(bn_t a, const char *str, int len, int radix) {
-	int sign, i, j;
-	char c;
+	int sign, i, j, c, levels = 0;
+	dig_t big;
+	bn_t p[STR_LEVELS];
 
 	bn_zero(a);
 
 	if (radix < 2 || radix > 64) {
 		THROW(ERR_NO_VALID)
+		return;
 	}
 
 	j = 0;
@@ -284,41 +590,61 @@ void bn_read_str(bn_t a, const char *str, int len, int radix) {
 		sign = BN_POS;
 	}
 
-	while (str[j] && j < len) {
-		c = (char)((radix < 36) ? TOUPPER(str[j]) : str[j]);
-		for (i = 0; i < 64; i++) {
-			if (c == util_conv_char(i)) {
-				break;
+	/* Digits are consumed up to the first invalid character. */
+	for (i = j; i < len && str[i] && str_value(str[i], radix) < radix; i++);
+	len = i - j;
+	str += j;
+
+	if (str_log(radix) != 0) {
+		str_read_pow(a, str, len, radix);
+		a->sign = sign;
+		return;
+	}
+
+	for (i = 0; i < STR_LEVELS; i++) {
+		bn_null(p[i]);
+	}
+
+	TRY {
+		c = str_chunk(&big, radix);
+		if (len > c * STR_CHUNKS) {
+			/* Compute powers of the radix up to half the string length. */
+			bn_new(p[0]);
+			bn_set_dig(p[0], big);
+			for (levels = 1; levels < STR_LEVELS && (c << levels) < len;
+					levels++) {
+				bn_new(p[levels]);
+				bn_sqr(p[levels], p[levels - 1]);
 			}
 		}
-
-		if (i < radix) {
-			bn_mul_dig(a, a, (dig_t)radix);
-			bn_add_dig(a, a, (dig_t)i);
-		} else {
-			break;
+		str_read_imp(a, str, len, radix, p, levels, c, big);
+	}
+	CATCH_ANY {
+		THROW(ERR_CAUGHT);
+	}
+	FINALLY {
+		for (i = 0; i < STR_LEVELS; i++) {
+			bn_free(p[i]);
 		}
-		j++;
 	}
 
 	a->sign = sign;
 }
 
 void bn_write_str(char *str, int len, const bn_t a, int radix) {
-	bn_t t;
-	dig_t d;
-	int digits, l, i, j;
-	char c;
-
-	bn_null(t);
+	bn_t t, p[STR_LEVELS];
+	dig_t big;
+	int c, l, i, j, levels;
 
 	l = bn_size_str(a, radix);
 	if (len < l) {
 		THROW(ERR_NO_BUFFER);
+		return;
 	}
 
 	if (radix < 2 || radix > 64) {
 		THROW(ERR_NO_VALID)
+		return;
 	}
 
 	if (bn_is_zero(a) == 1) {
@@ -327,38 +653,34 @@ void bn_write_str(char *str, int len, const bn_t a, int radix) {
 		return;
 	}
 
+	bn_null(t);
+	for (i = 0; i < STR_LEVELS; i++) {
+		bn_null(p[i]);
+	}
+
 	TRY {
 		bn_new(t);
-		bn_copy(t, a);
+		bn_abs(t, a);
 
 		j = 0;
-		if (t->sign == BN_NEG) {
+		if (a->sign == BN_NEG) {
 			str[j] = '-';
 			j++;
-			t->sign = BN_POS;
-		}
-
-		digits = 0;
-		while (!bn_is_zero(t)) {
-			bn_div_rem_dig(t, &d, t, (dig_t)radix);
-			str[j] = util_conv_char(d);
-			digits++;
-			j++;
-		}
-
-		/* Reverse the digits of the string. */
-		i = 0;
-		if (str[0] == '-') {
-			i = 1;
 		}
 
-		j = l - 2;
-		while (i < j) {
-			c = str[i];
-			str[i] = str[j];
-			str[j] = c;
-			++i;
-			--j;
+		/* Digits are written directly in place, most significant first. */
+		if (str_log(radix) != 0) {
+			str_write_pow(str + j, l - j - 1, t, radix);
+		} else {
+			c = str_chunk(&big, radix);
+			bn_new(p[0]);
+			bn_set_dig(p[0], big);
+			for (levels = 1; levels < STR_LEVELS &&
+					2 * bn_bits(p[levels - 1]) - 1 <= bn_bits(t); levels++) {
+				bn_new(p[levels]);
+				bn_sqr(p[levels], p[levels - 1]);
+			}
+			str_write_imp(str + j, l - j - 1, t, radix, p, levels, c, big);
 		}
 
 		str[l - 1] = '\0';
@@ -368,6 +690,9 @@ void bn_write_str(char *str, int len, const bn_t a, int radix) {
 	}
 	FINALLY {
 		bn_free(t);
+		for (i = 0; i < STR_LEVELS; i++) {
+			bn_free(p[i]);
+		}
 	}
 }
 
@@ -423,6 +748,7 @@ void bn_write_bin(uint8_t *bin, int len, const bn_t a) {
 
 	if (len < size) {
 		THROW(ERR_NO_BUFFER);
+		return;
 	}
 
 	k = 0;
@@ -468,6 +794,7 @@ void bn_write_raw(dig_t *raw, int len, const bn_t a) {
 
 	if (len < size) {
 		THROW(ERR_NO_BUFFER);
+		return;
 	}
 
 	for (i = 0; i < size; i++) {
@@ -29,6 +29,7 @@
  * @ingroup cp
  */
 
+#include <limits.h>
 #include <string.h>
 
 #include "relic_core.h"
@@ -39,10 +40,57 @@
 #include "relic_cp.h"
 #include "relic_md.h"
 
+/*============================================================================*/
+/* Private definitions                                                        */
+/*============================================================================*/
+
+/**
+ * Computes the exponent (p - 1)(q - 1)/t that maps ciphertexts to the subgroup
+ * of order t.
+ *
+ * @param[out] c			- the exponent.
+ * @param[in] prv			- the private key.
+ */
+static void bdpe_exp(bn_t c, bdpe_t prv) {
+	bn_mul(c, prv->p, prv->q);
+	bn_sub(c, c, prv->p);
+	bn_sub(c, c, prv->q);
+	bn_add_dig(c, c, 1);
+	bn_div_dig(c, c, prv->t);
+}
+
+/**
+ * Tests if the precomputed modulus of a key matches its field, which holds for
+ * keys produced by cp_bdpe_gen() or by cp_bdpe_prepare().
+ *
+ * @param[in] key			- the key.
+ * @return 1 if the key can be used, 0 otherwise.
+ */
+static int bdpe_ready(const bdpe_st *key) {
+	return bn_mod_ctx_cmp(key->mn, key->n) == CMP_EQ;
+}
+
 /*============================================================================*/
 /* Public definitions                                                         */
 /*============================================================================*/
 
+int cp_bdpe_prepare(bdpe_t key) {
+	int result = STS_OK;
+
+	if (key == NULL || bn_is_zero(key->n)) {
+		return STS_ERR;
+	}
+
+	TRY {
+		bn_mod_ctx_set(key->mn, key->n);
+	}
+	CATCH_ANY {
+		result = STS_ERR;
+	}
+
+	return result;
+}
+
 int cp_bdpe_gen(bdpe_t pub, bdpe_t prv, dig_t block, int bits) {
 	bn_t t, r;
 	int result = STS_OK;
@@ -95,11 +143,13 @@ int cp_bdpe_gen(bdpe_t pub, bdpe_t prv, dig_t block, int bits) {
 		bn_add_dig(prv->q, prv->q, 1);
 		bn_mul(pub->n, prv->p, prv->q);
 		bn_copy(prv->n, pub->n);
+		bn_mod_ctx_set(pub->mn, pub->n);
+		bn_mod_ctx_set(prv->mn, prv->n);
 
 		/* Select random y such that y^{(p-1)(q-1)}/block \neq 1 mod N. */
 		do {
 			bn_rand(pub->y, BN_POS, bits);
-			bn_mxp(r, pub->y, t, pub->n);
+			bn_mxp_ctx(r, pub->y, t, pub->mn);
 		} while (bn_cmp_dig(r, 1) == CMP_EQ);
 
 		bn_copy(prv->y, pub->y);
@@ -116,29 +166,31 @@ int cp_bdpe_gen(bdpe_t pub, bdpe_t prv, dig_t block, int bits) {
 }
 
 int cp_bdpe_enc(uint8_t *out, int *out_len, dig_t in, bdpe_t pub) {
-	bn_t m, u;
+	bn_t m, t, u;
 	int size, result = STS_OK;
 
 	bn_null(m);
+	bn_null(t);
 	bn_null(u);
 
 	size = bn_size_bin(pub->n);
 
-	if (in > pub->t) {
+	if (in > pub->t || !bdpe_ready(pub)) {
 		return STS_ERR;
 	}
 
 	TRY {
 		bn_new(m);
+		bn_new(t);
 		bn_new(u);
 
 		bn_set_dig(m, in);
 
 		bn_rand_mod(u, pub->n);
-		bn_mxp(m, pub->y, m, pub->n);
-		bn_mxp_dig(u, u, pub->t, pub->n);
-		bn_mul(m, m, u);
-		bn_mod(m, m, pub->n);
+		bn_mxp_ctx(m, pub->y, m, pub->mn);
+		bn_set_dig(t, pub->t);
+		bn_mxp_ctx(u, u, t, pub->mn);
+		bn_mul_mod_ctx(m, m, u, pub->mn);
 
 		if (size <= *out_len) {
 			*out_len = size;
@@ -153,6 +205,7 @@ int cp_bdpe_enc(uint8_t *out, int *out_len, dig_t in, bdpe_t pub) {
 	}
 	FINALLY {
 		bn_free(m);
+		bn_free(t);
 		bn_free(u);
 	}
 
@@ -160,44 +213,125 @@ int cp_bdpe_enc(uint8_t *out, int *out_len, dig_t in, bdpe_t pub) {
 }
 
 int cp_bdpe_dec(dig_t *out, uint8_t *in, int in_len, bdpe_t prv) {
-	bn_t m, t, z;
-	int i, size, result = STS_OK;
+	dlog_t d;
+	int result = STS_OK;
+
+	dlog_null(d);
+
+	TRY {
+		dlog_new(d);
+
+		result = cp_bdpe_pre(d, prv);
+		if (result == STS_OK) {
+			result = cp_bdpe_dec_fix(out, in, in_len, d, prv);
+		}
+	} CATCH_ANY {
+		result = STS_ERR;
+	}
+	FINALLY {
+		dlog_free(d);
+	}
+
+	return result;
+}
+
+int cp_bdpe_pre(dlog_t d, bdpe_t prv) {
+	bn_t t, u, z;
+	uint8_t bin[BN_BITS / 8 + 1];
+	int j, size, result = STS_OK;
+
+	if (prv->t == 0 || prv->t > INT_MAX || !bdpe_ready(prv)) {
+		return STS_ERR;
+	}
+
+	bn_null(t);
+	bn_null(u);
+	bn_null(z);
+
+	TRY {
+		bn_new(t);
+		bn_new(u);
+		bn_new(z);
+
+		size = bn_size_bin(prv->n);
+		if (cp_dlog_init(d, (int)prv->t) != STS_OK) {
+			THROW(ERR_NO_MEMORY);
+		}
+
+		/* Store the baby steps z = t^j for t = y^((p-1)(q-1)/block). */
+		bdpe_exp(t, prv);
+		bn_mxp_ctx(t, prv->y, t, prv->mn);
+		/* The steps are kept in the internal representation of the modulus. */
+		bn_mod_ctx_conv(u, t, prv->mn);
+		bn_set_dig(z, 1);
+		bn_mod_ctx_conv(z, z, prv->mn);
+		for (j = 0; j < d->m; j++) {
+			bn_write_bin(bin, size, z);
+			cp_dlog_add(d, bin, size, j);
+			bn_mod_ctx_mul(z, z, u, prv->mn);
+		}
+		bn_mod_ctx_back(z, z, prv->mn);
+
+		/* The giant step is t^(-m). */
+		bn_gcd_ext(u, t, NULL, z, prv->n);
+		if (bn_sign(t) == BN_NEG) {
+			bn_add(t, t, prv->n);
+		}
+		bn_write_bin(bin, size, t);
+		if (cp_dlog_step(d, bin, size) != STS_OK) {
+			THROW(ERR_NO_MEMORY);
+		}
+	} CATCH_ANY {
+		result = STS_ERR;
+	}
+	FINALLY {
+		bn_free(t);
+		bn_free(u);
+		bn_free(z);
+	}
+
+	return result;
+}
+
+int cp_bdpe_dec_fix(dig_t *out, uint8_t *in, int in_len, dlog_t d,
+		bdpe_t prv) {
+	bn_t m, t;
+	uint8_t bin[BN_BITS / 8 + 1];
+	long long i;
+	int j, size, result = STS_ERR;
 
 	size = bn_size_bin(prv->n);
 
-	if (in_len < 0 || in_len != size) {
+	if (in_len < 0 || in_len != size || d->step == NULL || d->len != size ||
+			!bdpe_ready(prv)) {
 		return STS_ERR;
 	}
 
 	bn_null(m);
 	bn_null(t);
-	bn_null(z);
 
 	TRY {
 		bn_new(m);
 		bn_new(t);
-		bn_new(z);
 
-		/* Compute t = (p-1)(q-1)/block. */
-		bn_mul(t, prv->p, prv->q);
-		bn_sub(t, t, prv->p);
-		bn_sub(t, t, prv->q);
-		bn_add_dig(t, t, 1);
-		bn_div_dig(t, t, prv->t);
+		bdpe_exp(t, prv);
 		bn_read_bin(m, in, in_len);
-		bn_mxp(m, m, t, prv->n);
-		bn_mxp(t, prv->y, t, prv->n);
-
-		for (i = 0; i < prv->t; i++) {
-			bn_mxp_dig(z, t, i, prv->n);
-			if (bn_cmp(z, m) == CMP_EQ) {
-				*out = i;
+		bn_mxp_ctx(m, m, t, prv->mn);
+		bn_read_bin(t, d->step, d->len);
+		/* Use the same representation as the baby steps. */
+		bn_mod_ctx_conv(m, m, prv->mn);
+		bn_mod_ctx_conv(t, t, prv->mn);
+
+		/* Multiply m by the giant step until it hits a baby step. */
+		for (i = 0; i < d->max; i += d->m) {
+			bn_write_bin(bin, size, m);
+			j = cp_dlog_get(d, bin, size);
+			if (j >= 0 && i + j < d->max) {
+				*out = i + j;
+				result = STS_OK;
 				break;
 			}
-		}
-
-		if (i == prv->t) {
-			result = STS_ERR;
+			bn_mod_ctx_mul(m, m, t, prv->mn);
 		}
 	} CATCH_ANY {
 		result = STS_ERR;
@@ -205,7 +339,6 @@ int cp_bdpe_dec(dig_t *out, uint8_t *in, int in_len, bdpe_t prv) {
 	FINALLY {
 		bn_free(m);
 		bn_free(t);
-		bn_free(z);
 	}
 
 	return result;
@@ -363,4 +363,328 @@ int cp_bgn_dec(dig_t *out, gt_t in[4], bgn_t prv) {
 	}
 
 	return result;
-}
\ No newline at end of file
+}
+int cp_bgn_pre1(dlog_t d, int max, bgn_t prv) {
+	bn_t r, n;
+	g1_t s, u;
+	uint8_t bin[12 * FP_BYTES];
+	int j, len, result = STS_OK;
+
+	bn_null(n);
+	bn_null(r);
+	g1_null(s);
+	g1_null(u);
+
+	TRY {
+		bn_new(n);
+		bn_new(r);
+		g1_new(s);
+		g1_new(u);
+
+		if (cp_dlog_init(d, max) != STS_OK) {
+			THROW(ERR_NO_VALID);
+		}
+
+		/* Store the baby steps U = j(xy - z)G. */
+		g1_get_ord(n);
+		bn_mul(r, prv->x, prv->y);
+		bn_sub(r, r, prv->z);
+		bn_mod(r, r, n);
+		g1_mul_gen(s, r);
+		g1_set_infty(u);
+		for (j = 0; j < d->m; j++) {
+			len = g1_size_bin(u, 1);
+			g1_write_bin(bin, len, u, 1);
+			cp_dlog_add(d, bin, len, j);
+			g1_add(u, u, s);
+			g1_norm(u, u);
+		}
+
+		/* The giant step is -m(xy - z)G. */
+		g1_neg(u, u);
+		len = g1_size_bin(u, 1);
+		g1_write_bin(bin, len, u, 1);
+		if (cp_dlog_step(d, bin, len) != STS_OK) {
+			THROW(ERR_NO_MEMORY);
+		}
+	} CATCH_ANY {
+		result = STS_ERR;
+	}
+	FINALLY {
+		bn_free(n);
+		bn_free(r);
+		g1_free(s);
+		g1_free(u);
+	}
+
+	return result;
+}
+
+int cp_bgn_dec1_fix(dig_t *out, g1_t in[2], dlog_t d, bgn_t prv) {
+	g1_t s, t;
+	uint8_t bin[12 * FP_BYTES];
+	long long i;
+	int j, len, result = STS_ERR;
+
+	if (d->step == NULL) {
+		return STS_ERR;
+	}
+
+	g1_null(s);
+	g1_null(t);
+
+	TRY {
+		g1_new(s);
+		g1_new(t);
+
+		/* Compute T = x(ym + r)G - (zm + xr)G = m(xy - z)G. */
+		g1_mul(t, in[0], prv->x);
+		g1_sub(t, t, in[1]);
+		g1_norm(t, t);
+		g1_read_bin(s, d->step, d->len);
+
+		/* Add the giant step to T until it hits a baby step. */
+		for (i = 0; i < d->max; i += d->m) {
+			len = g1_size_bin(t, 1);
+			g1_write_bin(bin, len, t, 1);
+			j = cp_dlog_get(d, bin, len);
+			if (j >= 0 && i + j < d->max) {
+				*out = i + j;
+				result = STS_OK;
+				break;
+			}
+			g1_add(t, t, s);
+			g1_norm(t, t);
+		}
+	} CATCH_ANY {
+		result = STS_ERR;
+	}
+	FINALLY {
+		g1_free(s);
+		g1_free(t);
+	}
+
+	return result;
+}
+
+int cp_bgn_pre2(dlog_t d, int max, bgn_t prv) {
+	bn_t r, n;
+	g2_t s, u;
+	uint8_t bin[12 * FP_BYTES];
+	int j, len, result = STS_OK;
+
+	bn_null(n);
+	bn_null(r);
+	g2_null(s);
+	g2_null(u);
+
+	TRY {
+		bn_new(n);
+		bn_new(r);
+		g2_new(s);
+		g2_new(u);
+
+		if (cp_dlog_init(d, max) != STS_OK) {
+			THROW(ERR_NO_VALID);
+		}
+
+		/* Store the baby steps U = j(xy - z)G. */
+		g2_get_ord(n);
+		bn_mul(r, prv->x, prv->y);
+		bn_sub(r, r, prv->z);
+		bn_mod(r, r, n);
+		g2_mul_gen(s, r);
+		g2_set_infty(u);
+		for (j = 0; j < d->m; j++) {
+			len = g2_size_bin(u, 1);
+			g2_write_bin(bin, len, u, 1);
+			cp_dlog_add(d, bin, len, j);
+			g2_add(u, u, s);
+			g2_norm(u, u);
+		}
+
+		/* The giant step is -m(xy - z)G. */
+		g2_neg(u, u);
+		len = g2_size_bin(u, 1);
+		g2_write_bin(bin, len, u, 1);
+		if (cp_dlog_step(d, bin, len) != STS_OK) {
+			THROW(ERR_NO_MEMORY);
+		}
+	} CATCH_ANY {
+		result = STS_ERR;
+	}
+	FINALLY {
+		bn_free(n);
+		bn_free(r);
+		g2_free(s);
+		g2_free(u);
+	}
+
+	return result;
+}
+
+int cp_bgn_dec2_fix(dig_t *out, g2_t in[2], dlog_t d, bgn_t prv) {
+	g2_t s, t;
+	uint8_t bin[12 * FP_BYTES];
+	long long i;
+	int j, len, result = STS_ERR;
+
+	if (d->step == NULL) {
+		return STS_ERR;
+	}
+
+	g2_null(s);
+	g2_null(t);
+
+	TRY {
+		g2_new(s);
+		g2_new(t);
+
+		/* Compute T = x(ym + r)G - (zm + xr)G = m(xy - z)G. */
+		g2_mul(t, in[0], prv->x);
+		g2_sub(t, t, in[1]);
+		g2_norm(t, t);
+		g2_read_bin(s, d->step, d->len);
+
+		/* Add the giant step to T until it hits a baby step. */
+		for (i = 0; i < d->max; i += d->m) {
+			len = g2_size_bin(t, 1);
+			g2_write_bin(bin, len, t, 1);
+			j = cp_dlog_get(d, bin, len);
+			if (j >= 0 && i + j < d->max) {
+				*out = i + j;
+				result = STS_OK;
+				break;
+			}
+			g2_add(t, t, s);
+			g2_norm(t, t);
+		}
+	} CATCH_ANY {
+		result = STS_ERR;
+	}
+	FINALLY {
+		g2_free(s);
+		g2_free(t);
+	}
+
+	return result;
+}
+
+int cp_bgn_pre(dlog_t d, int max, bgn_t prv) {
+	bn_t r, n;
+	g1_t g;
+	g2_t h;
+	gt_t s, u;
+	uint8_t bin[12 * FP_BYTES];
+	int j, len, result = STS_OK;
+
+	bn_null(n);
+	bn_null(r);
+	g1_null(g);
+	g2_null(h);
+	gt_null(s);
+	gt_null(u);
+
+	TRY {
+		bn_new(n);
+		bn_new(r);
+		g1_new(g);
+		g2_new(h);
+		gt_new(s);
+		gt_new(u);
+
+		if (cp_dlog_init(d, max) != STS_OK) {
+			THROW(ERR_NO_VALID);
+		}
+
+		/* Store the baby steps U = e(g, h)^(j(xy - z)^2). */
+		gt_get_ord(n);
+		bn_mul(r, prv->x, prv->y);
+		bn_sub(r, r, prv->z);
+		bn_sqr(r, r);
+		bn_mod(r, r, n);
+		g1_get_gen(g);
+		g2_get_gen(h);
+		pc_map(s, g, h);
+		gt_exp(s, s, r);
+		gt_set_unity(u);
+		len = gt_size_bin(u, 0);
+		for (j = 0; j < d->m; j++) {
+			gt_write_bin(bin, len, u, 0);
+			cp_dlog_add(d, bin, len, j);
+			gt_mul(u, u, s);
+		}
+
+		/* The giant step is e(g, h)^(-m(xy - z)^2). */
+		gt_inv(u, u);
+		gt_write_bin(bin, len, u, 0);
+		if (cp_dlog_step(d, bin, len) != STS_OK) {
+			THROW(ERR_NO_MEMORY);
+		}
+	} CATCH_ANY {
+		result = STS_ERR;
+	}
+	FINALLY {
+		bn_free(n);
+		bn_free(r);
+		g1_free(g);
+		g2_free(h);
+		gt_free(s);
+		gt_free(u);
+	}
+
+	return result;
+}
+
+int cp_bgn_dec_fix(dig_t *out, gt_t in[4], dlog_t d, bgn_t prv) {
+	gt_t s, t, u;
+	uint8_t bin[12 * FP_BYTES];
+	long long i;
+	int j, len, result = STS_ERR;
+
+	if (d->step == NULL) {
+		return STS_ERR;
+	}
+
+	gt_null(s);
+	gt_null(t);
+	gt_null(u);
+
+	TRY {
+		gt_new(s);
+		gt_new(t);
+		gt_new(u);
+
+		/* Compute T = in[0]^(x^2) * (in[1] * in[2])^(-x) * in[3]. */
+		gt_exp(t, in[0], prv->x);
+		gt_exp(t, t, prv->x);
+		gt_mul(u, in[1], in[2]);
+		gt_exp(u, u, prv->x);
+		gt_inv(u, u);
+		gt_mul(t, t, u);
+		gt_mul(t, t, in[3]);
+		gt_read_bin(s, d->step, d->len);
+
+		/* Multiply T by the giant step until it hits a baby step. */
+		len = gt_size_bin(t, 0);
+		for (i = 0; i < d->max; i += d->m) {
+			gt_write_bin(bin, len, t, 0);
+			j = cp_dlog_get(d, bin, len);
+			if (j >= 0 && i + j < d->max) {
+				*out = i + j;
+				result = STS_OK;
+				break;
+			}
+			gt_mul(t, t, s);
+		}
+	} CATCH_ANY {
+		result = STS_ERR;
+	}
+	FINALLY {
+		gt_free(s);
+		gt_free(t);
+		gt_free(u);
+	}
+
+	return result;
+}
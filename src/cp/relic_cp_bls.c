@@ -29,10 +29,84 @@
  * @ingroup cp
  */
 
+#include <stdlib.h>
+
 #include "relic.h"
 #include "relic_test.h"
 #include "relic_bench.h"
 
+/*============================================================================*/
+/* Private definitions                                                        */
+/*============================================================================*/
+
+/**
+ * Arguments shared by the tasks of a batch of BLS verifications.
+ */
+typedef struct {
+	/** The verification results. */
+	int *v;
+	/** The signatures. */
+	g1_t *s;
+	/** The signed messages mapped to G_1. */
+	g1_t *p;
+	/** The public keys. */
+	g2_t *q;
+} bls_lot_t;
+
+/**
+ * Verifies a signature given the signed message already mapped to G_1.
+ *
+ * @param[in] s				- the signature.
+ * @param[in] p				- the mapped message.
+ * @param[in] q				- the public key.
+ * @return a boolean value indicating the verification result.
+ */
+static int bls_ver_map(g1_t s, g1_t p, g2_t q) {
+	g2_t g;
+	gt_t e1, e2;
+	int result = 0;
+
+	g2_null(g);
+	gt_null(e1);
+	gt_null(e2);
+
+	TRY {
+		g2_new(g);
+		gt_new(e1);
+		gt_new(e2);
+
+		g2_get_gen(g);
+
+		pc_map(e1, p, q);
+		pc_map(e2, s, g);
+
+		if (gt_cmp(e1, e2) == CMP_EQ) {
+			result = 1;
+		}
+	}
+	CATCH_ANY {
+		THROW(ERR_CAUGHT);
+	}
+	FINALLY {
+		g2_free(g);
+		gt_free(e1);
+		gt_free(e2);
+	}
+	return result;
+}
+
+/**
+ * Verifies the i-th signature of a batch.
+ *
+ * @param[in,out] args		- the arguments of the batch.
+ * @param[in] i				- the index of the signature.
+ */
+static void bls_ver_one(void *args, int i) {
+	bls_lot_t *a = (bls_lot_t *)args;
+
+	a->v[i] = bls_ver_map(a->s[i], a->p[i], a->q[i]);
+}
+
 /*============================================================================*/
 /* Public definitions                                                         */
 /*============================================================================*/
@@ -81,39 +155,75 @@ int cp_bls_sig(g1_t s, uint8_t *msg, int len, bn_t d) {
 
 int cp_bls_ver(g1_t s, uint8_t *msg, int len, g2_t q) {
 	g1_t p;
-	g2_t g;
-	gt_t e1, e2;
 	int result = 0;
 
 	g1_null(p);
-	g2_null(g);
-	gt_null(e1);
-	gt_null(e2);
 
 	TRY {
 		g1_new(p);
-		g2_new(g);
-		gt_new(e1);
-		gt_new(e2);
+		g1_map(p, msg, len);
+		result = bls_ver_map(s, p, q);
+	}
+	CATCH_ANY {
+		THROW(ERR_CAUGHT);
+	}
+	FINALLY {
+		g1_free(p);
+	}
+	return result;
+}
 
-		g2_get_gen(g);
+int cp_bls_ver_batch(int *v, g1_t *s, uint8_t **msg, int *len, g2_t *q,
+		int n) {
+	bls_lot_t args;
+	int i, *t, result = 1;
+	g1_t *p;
 
-		g1_map(p, msg, len);
-		pc_map(e1, p, q);
-		pc_map(e2, s, g);
+	if (s == NULL || q == NULL || n <= 0) {
+		return 0;
+	}
 
-		if (gt_cmp(e1, e2) == CMP_EQ) {
-			result = 1;
+	t = (int *)malloc(n * sizeof(int));
+	p = (g1_t *)malloc(n * sizeof(g1_t));
+	if (t == NULL || p == NULL) {
+		free(t);
+		free(p);
+		return 0;
+	}
+
+	for (i = 0; i < n; i++) {
+		g1_null(p[i]);
+	}
+
+	TRY {
+		for (i = 0; i < n; i++) {
+			g1_new(p[i]);
+		}
+
+		args.v = (v != NULL ? v : t);
+		args.s = s;
+		args.p = p;
+		args.q = q;
+
+		for (i = 0; i < n; i++) {
+			args.v[i] = 0;
+		}
+		g1_map_lot(p, msg, len, n);
+		multi_run(bls_ver_one, &args, n);
+
+		for (i = 0; i < n; i++) {
+			result &= args.v[i];
 		}
 	}
 	CATCH_ANY {
 		THROW(ERR_CAUGHT);
 	}
 	FINALLY {
-		g1_free(p);
-		g2_free(g);
-		gt_free(e1);
-		gt_free(e2);
+		for (i = 0; i < n; i++) {
+			g1_free(p[i]);
+		}
+		free(t);
+		free(p);
 	}
 	return result;
 }
@@ -0,0 +1,252 @@
+/*
+ * RELIC is an Efficient LIbrary for Cryptography
+ * Copyright (C) 2007-2015 RELIC Authors
+ *
+ * This file is part of RELIC. RELIC is legal property of its developers,
+ * whose names are not listed here. Please refer to the COPYRIGHT file
+ * for contact information.
+ *
+ * RELIC is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * RELIC is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with RELIC. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ *
+ * Implementation of baby-step giant-step tables for discrete logarithms in
+ * small ranges.
+ *
+ * @version $Id$
+ * @ingroup cp
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "relic_core.h"
+#include "relic_conf.h"
+#include "relic_util.h"
+#include "relic_cp.h"
+#include "relic_md.h"
+
+/*============================================================================*/
+/* Private definitions                                                        */
+/*============================================================================*/
+
+/**
+ * Length in bytes of the serialized header of a table.
+ */
+#define DLOG_HEAD		(8)
+
+/**
+ * Length in bytes of a serialized baby step.
+ */
+#define DLOG_ITEM		(12)
+
+/**
+ * Computes the fingerprint of a serialized group element.
+ *
+ * @param[in] bin			- the serialized group element.
+ * @param[in] len			- the length of the serialization in bytes.
+ * @return the fingerprint.
+ */
+static uint64_t dlog_key(uint8_t *bin, int len) {
+	uint8_t h[MD_LEN];
+	uint64_t key = 0;
+
+	md_map(h, bin, len);
+	for (int i = 0; i < 8; i++) {
+		key = (key << 8) | h[i];
+	}
+	return key;
+}
+
+/**
+ * Inserts a fingerprint into the hash table with linear probing.
+ *
+ * @param[in,out] d			- the table.
+ * @param[in] key			- the fingerprint.
+ * @param[in] j				- the exponent.
+ */
+static void dlog_put(dlog_t d, uint64_t key, int j) {
+	int i = (int)(key & (d->cap - 1));
+
+	while (d->val[i] != -1) {
+		if (d->key[i] == key) {
+			/* Keep the smallest exponent of a repeated baby step. */
+			return;
+		}
+		i = (i + 1) & (d->cap - 1);
+	}
+	d->key[i] = key;
+	d->val[i] = j;
+}
+
+/**
+ * Writes a 32-bit integer in big-endian order.
+ *
+ * @param[out] bin			- the byte vector.
+ * @param[in] a				- the integer.
+ */
+static void dlog_write32(uint8_t *bin, uint32_t a) {
+	for (int i = 3; i >= 0; i--) {
+		bin[i] = a & 0xFF;
+		a >>= 8;
+	}
+}
+
+/**
+ * Reads a 32-bit integer in big-endian order.
+ *
+ * @param[in] bin			- the byte vector.
+ * @return the integer.
+ */
+static uint32_t dlog_read32(uint8_t *bin) {
+	return ((uint32_t)bin[0] << 24) | ((uint32_t)bin[1] << 16) |
+			((uint32_t)bin[2] << 8) | (uint32_t)bin[3];
+}
+
+/*============================================================================*/
+/* Public definitions                                                         */
+/*============================================================================*/
+
+int cp_dlog_init(dlog_t d, int max) {
+	int m = 1, cap = 2;
+
+	if (d == NULL || max <= 0) {
+		return STS_ERR;
+	}
+
+	/* Use m = ceil(sqrt(max)) baby steps and a table at most half full. */
+	while ((long long)m * m < max) {
+		m++;
+	}
+	while (cap < 2 * m) {
+		cap <<= 1;
+	}
+
+	free(d->key);
+	free(d->val);
+	free(d->step);
+	d->key = (uint64_t *)calloc(cap, sizeof(uint64_t));
+	d->val = (int *)malloc(cap * sizeof(int));
+	d->step = NULL;
+	d->len = 0;
+	if (d->key == NULL || d->val == NULL) {
+		free(d->key);
+		free(d->val);
+		d->key = NULL;
+		d->val = NULL;
+		d->max = d->m = d->cap = 0;
+		return STS_ERR;
+	}
+	for (int i = 0; i < cap; i++) {
+		d->val[i] = -1;
+	}
+	d->max = max;
+	d->m = m;
+	d->cap = cap;
+	return STS_OK;
+}
+
+void cp_dlog_add(dlog_t d, uint8_t *bin, int len, int j) {
+	dlog_put(d, dlog_key(bin, len), j);
+}
+
+int cp_dlog_get(dlog_t d, uint8_t *bin, int len) {
+	uint64_t key = dlog_key(bin, len);
+	int i = (int)(key & (d->cap - 1));
+
+	while (d->val[i] != -1) {
+		if (d->key[i] == key) {
+			return d->val[i];
+		}
+		i = (i + 1) & (d->cap - 1);
+	}
+	return -1;
+}
+
+int cp_dlog_step(dlog_t d, uint8_t *bin, int len) {
+	uint8_t *step = (uint8_t *)malloc(len);
+
+	if (step == NULL) {
+		return STS_ERR;
+	}
+	memcpy(step, bin, len);
+	free(d->step);
+	d->step = step;
+	d->len = len;
+	return STS_OK;
+}
+
+int cp_dlog_size_bin(dlog_t d) {
+	return DLOG_HEAD + d->len + d->m * DLOG_ITEM;
+}
+
+int cp_dlog_write_bin(uint8_t *bin, int len, dlog_t d) {
+	int i, k;
+
+	if (d->val == NULL || len < cp_dlog_size_bin(d)) {
+		return STS_ERR;
+	}
+
+	dlog_write32(bin, d->max);
+	dlog_write32(bin + 4, d->len);
+	memcpy(bin + DLOG_HEAD, d->step, d->len);
+	k = DLOG_HEAD + d->len;
+	for (i = 0; i < d->cap; i++) {
+		if (d->val[i] != -1) {
+			dlog_write32(bin + k, d->key[i] >> 32);
+			dlog_write32(bin + k + 4, d->key[i] & 0xFFFFFFFF);
+			dlog_write32(bin + k + 8, d->val[i]);
+			k += DLOG_ITEM;
+		}
+	}
+	/* Fill the slots of repeated baby steps, which are never looked up. */
+	while (k < cp_dlog_size_bin(d)) {
+		memcpy(bin + k, bin + k - DLOG_ITEM, DLOG_ITEM);
+		k += DLOG_ITEM;
+	}
+	return STS_OK;
+}
+
+int cp_dlog_read_bin(dlog_t d, uint8_t *bin, int len) {
+	uint64_t key;
+	int i, k, max, step, j;
+
+	if (len < DLOG_HEAD) {
+		return STS_ERR;
+	}
+	max = (int)dlog_read32(bin);
+	step = (int)dlog_read32(bin + 4);
+	if (max <= 0 || step < 0 || step > len - DLOG_HEAD) {
+		return STS_ERR;
+	}
+	if (cp_dlog_init(d, max) != STS_OK) {
+		return STS_ERR;
+	}
+	if (len != cp_dlog_size_bin(d) + step ||
+			cp_dlog_step(d, bin + DLOG_HEAD, step) != STS_OK) {
+		return STS_ERR;
+	}
+	k = DLOG_HEAD + step;
+	for (i = 0; i < d->m; i++, k += DLOG_ITEM) {
+		key = ((uint64_t)dlog_read32(bin + k) << 32) | dlog_read32(bin + k + 4);
+		j = (int)dlog_read32(bin + k + 8);
+		if (j < 0 || j >= d->m) {
+			return STS_ERR;
+		}
+		dlog_put(d, key, j);
+	}
+	return STS_OK;
+}
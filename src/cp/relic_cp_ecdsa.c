@@ -29,9 +29,48 @@
  * @ingroup cp
  */
 
+#include <stdlib.h>
+
 #include "relic.h"
 #include "relic_test.h"
 
+/*============================================================================*/
+/* Private definitions                                                        */
+/*============================================================================*/
+
+/**
+ * Arguments shared by the tasks of a batch of ECDSA verifications.
+ */
+typedef struct {
+	/** The verification results. */
+	int *v;
+	/** The first components of the signatures. */
+	bn_t *r;
+	/** The second components of the signatures. */
+	bn_t *s;
+	/** The signed messages. */
+	uint8_t **msg;
+	/** The message lengths in bytes. */
+	int *len;
+	/** The flag to indicate the message format. */
+	int hash;
+	/** The public keys. */
+	ec_t *q;
+} ecdsa_lot_t;
+
+/**
+ * Verifies the i-th signature of a batch.
+ *
+ * @param[in,out] args		- the arguments of the batch.
+ * @param[in] i				- the index of the signature.
+ */
+static void ecdsa_ver_one(void *args, int i) {
+	ecdsa_lot_t *a = (ecdsa_lot_t *)args;
+
+	a->v[i] = cp_ecdsa_ver(a->r[i], a->s[i], a->msg[i], a->len[i], a->hash,
+			a->q[i]);
+}
+
 /*============================================================================*/
 /* Public definitions                                                         */
 /*============================================================================*/
@@ -79,6 +118,21 @@ int cp_ecdsa_sig(bn_t r, bn_t s, uint8_t *msg, int len, int hash, bn_t d) {
 		ec_new(p);
 
 		ec_curve_get_ord(n);
+
+		/* The message is hashed once, before any retry. */
+		if (!hash) {
+			md_map(h, msg, len);
+			msg = h;
+			len = MD_LEN;
+		}
+		if (8 * len > bn_bits(n)) {
+			len = CEIL(bn_bits(n), 8);
+			bn_read_bin(e, msg, len);
+			bn_rsh(e, e, 8 * len - bn_bits(n));
+		} else {
+			bn_read_bin(e, msg, len);
+		}
+
 		do {
 			do {
 				bn_rand_mod(k, n);
@@ -87,19 +141,6 @@ int cp_ecdsa_sig(bn_t r, bn_t s, uint8_t *msg, int len, int hash, bn_t d) {
 				bn_mod(r, x, n);
 			} while (bn_is_zero(r));
 
-			if (!hash) {
-				md_map(h, msg, len);
-				msg = h;
-				len = MD_LEN;
-			}
-			if (8 * len > bn_bits(n)) {
-				len = CEIL(bn_bits(n), 8);
-				bn_read_bin(e, msg, len);
-				bn_rsh(e, e, 8 * len - bn_bits(n));
-			} else {
-				bn_read_bin(e, msg, len);
-			}
-
 			bn_mul(s, d, r);
 			bn_mod(s, s, n);
 			bn_add(s, s, e);
@@ -202,3 +243,69 @@ int cp_ecdsa_ver(bn_t r, bn_t s, uint8_t *msg, int len, int hash, ec_t q) {
 	}
 	return result;
 }
+
+int cp_ecdsa_ver_batch(int *v, bn_t *r, bn_t *s, uint8_t **msg, int *len,
+		int hash, ec_t *q, int n) {
+	ecdsa_lot_t args;
+	int i, *t, *l, result = 1;
+	uint8_t *digest, **h;
+
+	if (r == NULL || s == NULL || q == NULL || n <= 0) {
+		return 0;
+	}
+
+	t = (int *)malloc(n * sizeof(int));
+	l = (int *)malloc(n * sizeof(int));
+	digest = (uint8_t *)malloc(n * MD_LEN);
+	h = (uint8_t **)malloc(n * sizeof(uint8_t *));
+	if (t == NULL || l == NULL || digest == NULL || h == NULL) {
+		free(t);
+		free(l);
+		free(digest);
+		free(h);
+		return 0;
+	}
+
+	args.v = (v != NULL ? v : t);
+	args.r = r;
+	args.s = s;
+	args.msg = msg;
+	args.len = len;
+	args.hash = hash;
+	args.q = q;
+
+	for (i = 0; i < n; i++) {
+		args.v[i] = 0;
+	}
+
+	TRY {
+		if (!hash) {
+			/* Short messages are hashed together in parallel lanes. */
+			for (i = 0; i < n; i++) {
+				h[i] = digest + i * MD_LEN;
+				l[i] = MD_LEN;
+			}
+			md_map_lot(h, msg, len, n);
+			args.msg = h;
+			args.len = l;
+			args.hash = 1;
+		}
+
+		multi_run(ecdsa_ver_one, &args, n);
+
+		for (i = 0; i < n; i++) {
+			result &= args.v[i];
+		}
+	}
+	CATCH_ANY {
+		result = 0;
+	}
+	FINALLY {
+		free(t);
+		free(l);
+		free(digest);
+		free(h);
+	}
+
+	return result;
+}
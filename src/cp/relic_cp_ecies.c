@@ -38,6 +38,153 @@
 #include "relic_md.h"
 #include "relic_bc.h"
 
+/*============================================================================*/
+/* Private definitions                                                        */
+/*============================================================================*/
+
+/**
+ * Length in bytes of the nonce of the authenticated ciphers.
+ */
+#define ECIES_NONCE		12
+
+/**
+ * Authenticated cipher used to protect the message, with the same interface
+ * as bc_aes_gcm_enc() and bc_aes_gcm_dec().
+ */
+typedef int (*ecies_aead_t)(uint8_t *, int *, uint8_t *, int, uint8_t *, int,
+		uint8_t *, int, uint8_t *, int);
+
+/**
+ * Derives the symmetric key from the shared point.
+ *
+ * @param[out] key			- the symmetric key.
+ * @param[in] size			- the key length in bytes.
+ * @param[in] p				- the shared point.
+ */
+static void ecies_kdf(uint8_t *key, int size, ec_t p) {
+	bn_t x;
+	int l;
+	uint8_t _x[FC_BYTES + 1];
+
+	bn_null(x);
+
+	TRY {
+		bn_new(x);
+
+		ec_get_x(x, p);
+		l = bn_size_bin(x);
+		if (bn_bits(x) % 8 == 0) {
+			/* Compatibility with BouncyCastle. */
+			l = l + 1;
+		}
+		bn_write_bin(_x, l, x);
+		md_kdf2(key, size, _x, l);
+	}
+	CATCH_ANY {
+		THROW(ERR_CAUGHT);
+	}
+	FINALLY {
+		util_wipe(_x, sizeof(_x));
+		bn_free(x);
+	}
+}
+
+/**
+ * Encrypts using the ECIES cryptosystem with an authenticated cipher.
+ *
+ * @param[out] r 			- the resulting elliptic curve point.
+ * @param[out] out			- the output buffer.
+ * @param[in, out] out_len	- the buffer capacity and number of bytes written.
+ * @param[in] in			- the input buffer.
+ * @param[in] in_len		- the number of bytes to encrypt.
+ * @param[in] q				- the public key.
+ * @param[in] enc			- the authenticated encryption function.
+ * @param[in] size			- the key length in bytes.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+static int ecies_aead_enc(ec_t r, uint8_t *out, int *out_len, uint8_t *in,
+		int in_len, ec_t q, ecies_aead_t enc, int size) {
+	bn_t k, n;
+	ec_t p;
+	int result = STS_OK;
+	uint8_t key[size + ECIES_NONCE];
+
+	bn_null(k);
+	bn_null(n);
+	ec_null(p);
+
+	TRY {
+		bn_new(k);
+		bn_new(n);
+		ec_new(p);
+
+		ec_curve_get_ord(n);
+		bn_rand_mod(k, n);
+
+		ec_mul_gen(r, k);
+		ec_mul(p, q, k);
+		/* The key is followed by the nonce in the output of the KDF. */
+		ecies_kdf(key, size + ECIES_NONCE, p);
+		if (enc(out, out_len, in, in_len, key, 8 * size, key + size,
+				ECIES_NONCE, NULL, 0) != STS_OK) {
+			result = STS_ERR;
+		}
+	}
+	CATCH_ANY {
+		result = STS_ERR;
+	}
+	FINALLY {
+		util_wipe(key, sizeof(key));
+		bn_free(k);
+		bn_free(n);
+		ec_free(p);
+	}
+
+	return result;
+}
+
+/**
+ * Decrypts using the ECIES cryptosystem with an authenticated cipher.
+ *
+ * @param[out] out			- the output buffer.
+ * @param[in, out] out_len	- the buffer capacity and number of bytes written.
+ * @param[in] r 			- the elliptic curve point.
+ * @param[in] in			- the input buffer.
+ * @param[in] in_len		- the number of bytes to decrypt.
+ * @param[in] d				- the private key.
+ * @param[in] dec			- the authenticated decryption function.
+ * @param[in] size			- the key length in bytes.
+ * @return STS_OK if no errors occurred, STS_ERR otherwise.
+ */
+static int ecies_aead_dec(uint8_t *out, int *out_len, ec_t r, uint8_t *in,
+		int in_len, bn_t d, ecies_aead_t dec, int size) {
+	ec_t p;
+	int result = STS_OK;
+	uint8_t key[size + ECIES_NONCE];
+
+	ec_null(p);
+
+	TRY {
+		ec_new(p);
+
+		ec_mul(p, r, d);
+		ecies_kdf(key, size + ECIES_NONCE, p);
+		if (dec(out, out_len, in, in_len, key, 8 * size, key + size,
+				ECIES_NONCE, NULL, 0) != STS_OK) {
+			result = STS_ERR;
+		}
+	}
+	CATCH_ANY {
+		result = STS_ERR;
+	}
+	FINALLY {
+		util_wipe(key, sizeof(key));
+		ec_free(p);
+	}
+
+	return result;
+}
+
 /*============================================================================*/
 /* Public definitions                                                         */
 /*============================================================================*/
@@ -109,6 +256,8 @@ int cp_ecies_enc(ec_t r, uint8_t *out, int *out_len, uint8_t *in, int in_len,
 		result = STS_ERR;
 	}
 	FINALLY {
+		util_wipe(_x, sizeof(_x));
+		util_wipe(key, sizeof(key));
 		bn_free(k);
 		bn_free(n);
 		bn_free(x);
@@ -155,9 +304,35 @@ int cp_ecies_dec(uint8_t *out, int *out_len, ec_t r, uint8_t *in, int in_len,
 		result = STS_ERR;
 	}
 	FINALLY {
+		util_wipe(_x, sizeof(_x));
+		util_wipe(key, sizeof(key));
 		bn_free(x);
 		ec_free(p);
 	}
 
 	return result;
 }
+
+int cp_ecies_gcm_enc(ec_t r, uint8_t *out, int *out_len, uint8_t *in,
+		int in_len, ec_t q) {
+	return ecies_aead_enc(r, out, out_len, in, in_len, q, bc_aes_gcm_enc,
+			CEIL(ec_param_level(), 8));
+}
+
+int cp_ecies_gcm_dec(uint8_t *out, int *out_len, ec_t r, uint8_t *in,
+		int in_len, bn_t d) {
+	return ecies_aead_dec(out, out_len, r, in, in_len, d, bc_aes_gcm_dec,
+			CEIL(ec_param_level(), 8));
+}
+
+int cp_ecies_chacha_enc(ec_t r, uint8_t *out, int *out_len, uint8_t *in,
+		int in_len, ec_t q) {
+	return ecies_aead_enc(r, out, out_len, in, in_len, q, bc_chacha_enc,
+			BC_CHACHA_KEY);
+}
+
+int cp_ecies_chacha_dec(uint8_t *out, int *out_len, ec_t r, uint8_t *in,
+		int in_len, bn_t d) {
+	return ecies_aead_dec(out, out_len, r, in, in_len, d, bc_chacha_dec,
+			BC_CHACHA_KEY);
+}
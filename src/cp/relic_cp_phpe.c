@@ -29,6 +29,7 @@
  * @ingroup cp
  */
 
+#include <stdlib.h>
 #include <string.h>
 
 #include "relic_core.h"
@@ -39,146 +40,465 @@
 #include "relic_cp.h"
 #include "relic_md.h"
 
+/*============================================================================*/
+/* Private definitions                                                        */
+/*============================================================================*/
+
+/**
+ * Encrypts a plaintext given the random input of the noise. Computes
+ * c = (1 + mn) * r^n mod n^2, or c = (1 + mn) * h^r mod n^2 if a
+ * precomputation table for h is given.
+ *
+ * @param[out] c			- the resulting ciphertext.
+ * @param[in] m				- the plaintext, smaller than n.
+ * @param[in] r				- the random input of the noise.
+ * @param[in] t				- the precomputation table, or NULL.
+ * @param[in] pub			- the public key.
+ */
+static void phpe_enc_imp(bn_t c, const bn_t m, const bn_t r, const bn_t *t,
+		phpe_st *pub) {
+	bn_t g, s;
+
+	bn_null(g);
+	bn_null(s);
+
+	TRY {
+		bn_new(g);
+		bn_new(s);
+
+		if (t == NULL) {
+			bn_mxp_ctx(s, r, pub->n, pub->mn);
+		} else {
+			bn_mxp_fix(s, t, r, pub->mn);
+		}
+		/* With g = n + 1, g^m = 1 + mn mod n^2 and no exponentiation is needed. */
+		bn_mul(g, m, pub->n);
+		bn_add_dig(g, g, 1);
+		bn_mul_mod_ctx(c, g, s, pub->mn);
+	}
+	CATCH_ANY {
+		THROW(ERR_CAUGHT);
+	}
+	FINALLY {
+		bn_free(g);
+		bn_free(s);
+	}
+}
+
+/**
+ * Draws the random input of the noise of an encryption, an element of Z_n^*
+ * or, if a precomputation table is used, an exponent as long as n.
+ *
+ * @param[out] r			- the random input.
+ * @param[in] t				- the precomputation table, or NULL.
+ * @param[in] pub			- the public key.
+ */
+static void phpe_rand(bn_t r, const bn_t *t, phpe_st *pub) {
+	if (t == NULL) {
+		bn_rand_mod(r, pub->n);
+	} else {
+		bn_rand(r, BN_POS, bn_bits(pub->n));
+	}
+}
+
+/**
+ * Reads a ciphertext and checks that it is smaller than n^2.
+ *
+ * @param[out] c			- the ciphertext.
+ * @param[in] in			- the input buffer.
+ * @param[in] in_len		- the number of bytes to read.
+ * @param[in] pub			- the public key.
+ * @return STS_OK if the ciphertext is valid, STS_ERR otherwise.
+ */
+static int phpe_read(bn_t c, uint8_t *in, int in_len, phpe_st *pub) {
+	bn_t t;
+	int result = STS_ERR;
+
+	if (in_len <= 0 || in_len > 2 * bn_size_bin(pub->n)) {
+		return STS_ERR;
+	}
+
+	bn_null(t);
+
+	TRY {
+		bn_new(t);
+
+		bn_read_bin(c, in, in_len);
+		bn_sqr(t, pub->n);
+		if (bn_cmp(c, t) == CMP_LT) {
+			result = STS_OK;
+		}
+	}
+	CATCH_ANY {
+		result = STS_ERR;
+	}
+	FINALLY {
+		bn_free(t);
+	}
+
+	return result;
+}
+
+/**
+ * Writes a ciphertext as a string of twice the length of n.
+ *
+ * @param[out] out			- the output buffer.
+ * @param[in, out] out_len	- the buffer capacity and number of bytes written.
+ * @param[in] c				- the ciphertext.
+ * @param[in] pub			- the public key.
+ * @return STS_OK if the buffer is large enough, STS_ERR otherwise.
+ */
+static int phpe_write(uint8_t *out, int *out_len, const bn_t c, phpe_st *pub) {
+	int size = 2 * bn_size_bin(pub->n);
+
+	if (size > *out_len) {
+		return STS_ERR;
+	}
+	*out_len = size;
+	bn_write_bin(out, size, c);
+	return STS_OK;
+}
+
+/**
+ * Type that represents a batch of encryptions.
+ */
+typedef struct {
+	/** The plaintexts, replaced by the ciphertexts. */
+	bn_t *m;
+	/** The random inputs of the noise. */
+	bn_t *r;
+	/** The precomputation table, or NULL. */
+	const bn_t *t;
+	/** The public key. */
+	phpe_st *pub;
+} phpe_lot_t;
+
+/**
+ * Computes the i-th encryption of a batch.
+ *
+ * @param[in,out] args		- the arguments of the batch.
+ * @param[in] i				- the index of the encryption.
+ */
+static void phpe_enc_one(void *args, int i) {
+	phpe_lot_t *a = (phpe_lot_t *)args;
+
+	phpe_enc_imp(a->m[i], a->m[i], a->r[i], a->t, a->pub);
+}
+
 /*============================================================================*/
 /* Public definitions                                                         */
 /*============================================================================*/
 
-int cp_phpe_gen(bn_t n, bn_t l, int bits) {
-	bn_t p, q;
+int cp_phpe_gen(phpe_t pub, phpe_t prv, int bits) {
+	bn_t t;
 	int result = STS_OK;
 
-	bn_null(p);
-	bn_null(q);
+	bn_null(t);
 
 	TRY {
-		bn_new(p);
-		bn_new(q);
+		bn_new(t);
 
 		/* Generate primes p and q of equivalent length. */
 		do {
-			bn_gen_prime(p, bits / 2);
-			bn_gen_prime(q, bits / 2);
-		} while (bn_cmp(p, q) == CMP_EQ);
+			bn_gen_prime(prv->p, bits / 2);
+			bn_gen_prime(prv->q, bits / 2);
+		} while (bn_cmp(prv->p, prv->q) == CMP_EQ);
 
-		/* Compute n = pq and l = \phi(n). */
-		bn_mul(n, p, q);
-		bn_sub_dig(p, p, 1);
-		bn_sub_dig(q, q, 1);
-		bn_mul(l, p, q);
+		/* Compute n = pq and the CRT constants for g = n + 1. */
+		bn_mul(prv->n, prv->p, prv->q);
+		bn_gcd_ext(t, prv->qi, NULL, prv->q, prv->p);
+		if (bn_sign(prv->qi) == BN_NEG) {
+			bn_add(prv->qi, prv->qi, prv->p);
+		}
+		bn_sub(prv->hp, prv->p, prv->qi);
+		bn_gcd_ext(t, prv->hq, NULL, prv->p, prv->q);
+		if (bn_sign(prv->hq) == BN_NEG) {
+			bn_add(prv->hq, prv->hq, prv->q);
+		}
+		bn_sub(prv->hq, prv->q, prv->hq);
+
+		bn_sqr(t, prv->n);
+		bn_mod_ctx_set(prv->mn, t);
+		bn_mod_ctx_set(pub->mn, t);
+		bn_sqr(t, prv->p);
+		bn_mod_ctx_set(prv->mp, t);
+		bn_sqr(t, prv->q);
+		bn_mod_ctx_set(prv->mq, t);
+
+		bn_copy(pub->n, prv->n);
 	}
 	CATCH_ANY {
 		result = STS_ERR;
 	}
 	FINALLY {
-		bn_free(p);
-		bn_free(q);
+		bn_free(t);
 	}
 
 	return result;
 }
 
-int cp_phpe_enc(uint8_t *out, int *out_len, uint8_t *in, int in_len, bn_t n) {
-	bn_t g, m, r, s;
-	int size, result = STS_OK;
+int cp_phpe_enc(uint8_t *out, int *out_len, uint8_t *in, int in_len,
+		phpe_t pub) {
+	return cp_phpe_enc_fix(out, out_len, in, in_len, NULL, pub);
+}
 
-	bn_null(g);
-	bn_null(m);
-	bn_null(r);
-	bn_null(s);
+int cp_phpe_pre(bn_t *t, phpe_t pub) {
+	bn_t h;
+	int result = STS_OK;
+
+	bn_null(h);
+
+	TRY {
+		bn_new(h);
+
+		/* Fix h = r^n mod n^2 for a random r in Z_n^*. */
+		bn_rand_mod(h, pub->n);
+		bn_mxp_ctx(h, h, pub->n, pub->mn);
+		bn_mxp_pre(t, h, pub->mn);
+	}
+	CATCH_ANY {
+		result = STS_ERR;
+	}
+	FINALLY {
+		bn_free(h);
+	}
+
+	return result;
+}
 
-	size = bn_size_bin(n);
+int cp_phpe_enc_fix(uint8_t *out, int *out_len, uint8_t *in, int in_len,
+		const bn_t *t, phpe_t pub) {
+	bn_t m, r;
+	int result = STS_OK;
 
-	if (n == NULL || in_len <= 0 || in_len > size) {
+	if (pub == NULL || in_len <= 0 || in_len > bn_size_bin(pub->n)) {
 		return STS_ERR;
 	}
 
+	bn_null(m);
+	bn_null(r);
+
 	TRY {
-		bn_new(g);
 		bn_new(m);
 		bn_new(r);
-		bn_new(s);
 
-		/* Represent m as a padded element of Z_n. */
 		bn_read_bin(m, in, in_len);
-
-		/* Generate r in Z_n^*. */
-		bn_rand_mod(r, n);
-
-		/* Compute c = (g^m)(r^n) mod n^2. */
-		bn_add_dig(g, n, 1);
-		bn_sqr(s, n);
-		bn_mxp(m, g, m, s);
-		bn_mxp(r, r, n, s);
-		bn_mul(m, m, r);
-		bn_mod(m, m, s);
-		if (2 * size <= *out_len) {
-			*out_len = 2 * size;
-			memset(out, 0, *out_len);
-			bn_write_bin(out, *out_len, m);
-		} else {
+		if (bn_cmp(m, pub->n) != CMP_LT) {
 			result = STS_ERR;
+		} else {
+			phpe_rand(r, t, pub);
+			phpe_enc_imp(m, m, r, t, pub);
+			result = phpe_write(out, out_len, m, pub);
 		}
 	}
 	CATCH_ANY {
 		result = STS_ERR;
 	}
 	FINALLY {
-		bn_free(g);
 		bn_free(m);
 		bn_free(r);
-		bn_free(s);		
 	}
 
 	return result;
 }
 
-int cp_phpe_dec(uint8_t *out, int out_len, uint8_t *in, int in_len, bn_t n,
-	bn_t l) {
-	bn_t c, u, s;
-	int size, result = STS_OK;
+int cp_phpe_enc_batch(uint8_t **out, int *out_len, uint8_t **in, int *in_len,
+		const bn_t *t, phpe_t pub, int n) {
+	phpe_lot_t args;
+	bn_t *m, *r;
+	int i, result = STS_OK;
 
-	size = bn_size_bin(n);
+	if (pub == NULL || n <= 0) {
+		return STS_ERR;
+	}
 
-	if (in_len < 0 || in_len != 2 * size) {
+	m = (bn_t *)malloc(n * sizeof(bn_t));
+	r = (bn_t *)malloc(n * sizeof(bn_t));
+	if (m == NULL || r == NULL) {
+		free(m);
+		free(r);
+		return STS_ERR;
+	}
+
+	for (i = 0; i < n; i++) {
+		bn_null(m[i]);
+		bn_null(r[i]);
+	}
+
+	TRY {
+		for (i = 0; i < n; i++) {
+			bn_new(m[i]);
+			bn_new(r[i]);
+		}
+
+		/* Read the plaintexts and draw the randomness in the calling thread. */
+		for (i = 0; i < n && result == STS_OK; i++) {
+			if (in_len[i] <= 0 || in_len[i] > bn_size_bin(pub->n)) {
+				result = STS_ERR;
+			} else {
+				bn_read_bin(m[i], in[i], in_len[i]);
+				if (bn_cmp(m[i], pub->n) != CMP_LT) {
+					result = STS_ERR;
+				} else {
+					phpe_rand(r[i], t, pub);
+				}
+			}
+		}
+
+		if (result == STS_OK) {
+			args.m = m;
+			args.r = r;
+			args.t = t;
+			args.pub = pub;
+			multi_run(phpe_enc_one, &args, n);
+
+			for (i = 0; i < n && result == STS_OK; i++) {
+				result = phpe_write(out[i], &out_len[i], m[i], pub);
+			}
+		}
+	}
+	CATCH_ANY {
+		result = STS_ERR;
+	}
+	FINALLY {
+		for (i = 0; i < n; i++) {
+			bn_free(m[i]);
+			bn_free(r[i]);
+		}
+		free(m);
+		free(r);
+	}
+
+	return result;
+}
+
+int cp_phpe_add(uint8_t *out, int *out_len, uint8_t *a, int a_len, uint8_t *b,
+		int b_len, phpe_t pub) {
+	bn_t c, d;
+	int result = STS_OK;
+
+	if (pub == NULL) {
 		return STS_ERR;
 	}
 
 	bn_null(c);
-	bn_null(u);
-	bn_null(s);
+	bn_null(d);
 
 	TRY {
 		bn_new(c);
-		bn_new(u);
-		bn_new(s);
+		bn_new(d);
 
-		/* Compute (c^l mod n^2) * u mod n. */
-		bn_sqr(s, n);
-		bn_read_bin(c, in, in_len);
-		bn_mxp(c, c, l, s);
-		bn_sub_dig(c, c, 1);
-		bn_div(c, c, n);
-		bn_gcd_ext(s, u, NULL, l, n);
-		if (bn_sign(u) == BN_NEG) {
-			bn_add(u, u, n);
+		if (phpe_read(c, a, a_len, pub) != STS_OK ||
+				phpe_read(d, b, b_len, pub) != STS_OK) {
+			result = STS_ERR;
+		} else {
+			bn_mul_mod_ctx(c, c, d, pub->mn);
+			result = phpe_write(out, out_len, c, pub);
 		}
-		bn_mul(c, c, u);
-		bn_mod(c, c, n);
+	}
+	CATCH_ANY {
+		result = STS_ERR;
+	}
+	FINALLY {
+		bn_free(c);
+		bn_free(d);
+	}
+
+	return result;
+}
+
+int cp_phpe_mul(uint8_t *out, int *out_len, uint8_t *in, int in_len, bn_t k,
+		phpe_t pub) {
+	bn_t c;
+	int result = STS_OK;
+
+	if (pub == NULL || bn_sign(k) == BN_NEG) {
+		return STS_ERR;
+	}
 
-		size = bn_size_bin(c);
-		if (size <= out_len) {
-			memset(out, 0, out_len);
-			bn_write_bin(out + (out_len - size), size, c);
+	bn_null(c);
+
+	TRY {
+		bn_new(c);
+
+		if (phpe_read(c, in, in_len, pub) != STS_OK) {
+			result = STS_ERR;
 		} else {
+			bn_mxp_ctx(c, c, k, pub->mn);
+			result = phpe_write(out, out_len, c, pub);
+		}
+	}
+	CATCH_ANY {
+		result = STS_ERR;
+	}
+	FINALLY {
+		bn_free(c);
+	}
+
+	return result;
+}
+
+int cp_phpe_dec(uint8_t *out, int out_len, uint8_t *in, int in_len,
+		phpe_t prv) {
+	bn_t c, s, t;
+	int size, result = STS_OK;
+
+	if (prv == NULL || in_len != 2 * bn_size_bin(prv->n)) {
+		return STS_ERR;
+	}
+
+	bn_null(c);
+	bn_null(s);
+	bn_null(t);
+
+	TRY {
+		bn_new(c);
+		bn_new(s);
+		bn_new(t);
+
+		if (phpe_read(c, in, in_len, prv) != STS_OK) {
 			result = STS_ERR;
+		} else {
+			/* m_p = L_p(c^(p - 1) mod p^2) * h_p mod p, L_p(x) = (x - 1)/p. */
+			bn_sub_dig(t, prv->p, 1);
+			bn_mxp_const_ctx(s, c, t, prv->mp);
+			bn_sub_dig(s, s, 1);
+			bn_div(s, s, prv->p);
+			bn_mul(s, s, prv->hp);
+			bn_mod(s, s, prv->p);
+			/* m_q = L_q(c^(q - 1) mod q^2) * h_q mod q, L_q(x) = (x - 1)/q. */
+			bn_sub_dig(t, prv->q, 1);
+			bn_mxp_const_ctx(c, c, t, prv->mq);
+			bn_sub_dig(c, c, 1);
+			bn_div(c, c, prv->q);
+			bn_mul(c, c, prv->hq);
+			bn_mod(c, c, prv->q);
+			/* m = m_q + q * ((m_p - m_q) * q^(-1) mod p). */
+			bn_sub(s, s, c);
+			bn_mul(s, s, prv->qi);
+			bn_mod(s, s, prv->p);
+			if (bn_sign(s) == BN_NEG) {
+				bn_add(s, s, prv->p);
+			}
+			bn_mul(s, s, prv->q);
+			bn_add(c, c, s);
+
+			size = bn_size_bin(c);
+			if (size <= out_len) {
+				memset(out, 0, out_len);
+				bn_write_bin(out + (out_len - size), size, c);
+			} else {
+				result = STS_ERR;
+			}
 		}
-	} CATCH_ANY {
+	}
+	CATCH_ANY {
 		result = STS_ERR;
 	}
 	FINALLY {
 		bn_free(c);
-		bn_free(u);
 		bn_free(s);
+		bn_free(t);
 	}
 
 	return result;
@@ -29,6 +29,7 @@
  * @ingroup cp
  */
 
+#include <stdlib.h>
 #include <string.h>
 
 #include "relic_core.h"
@@ -217,6 +218,34 @@ static const uint8_t sh512_id[] =
 		{ 0x30, 0x51, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65,
 			0x03, 0x04, 0x02, 0x03, 0x05, 0x00, 0x04, 0x40 };
 
+/**
+ * ASN.1 identifier of the hash function SHA3-256.
+ */
+static const uint8_t sh3_256_id[] =
+		{ 0x30, 0x31, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65,
+			0x03, 0x04, 0x02, 0x08, 0x05, 0x00, 0x04, 0x20 };
+
+/**
+ * ASN.1 identifier of the hash function SHA3-512.
+ */
+static const uint8_t sh3_512_id[] =
+		{ 0x30, 0x51, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65,
+			0x03, 0x04, 0x02, 0x0a, 0x05, 0x00, 0x04, 0x40 };
+
+/**
+ * ASN.1 identifier of the hash function BLAKE2s-256 (RFC 7693).
+ */
+static const uint8_t b2s_256_id[] =
+		{ 0x30, 0x33, 0x30, 0x0f, 0x06, 0x0b, 0x2b, 0x06, 0x01, 0x04, 0x01,
+			0x8d, 0x3a, 0x0c, 0x02, 0x02, 0x08, 0x05, 0x00, 0x04, 0x20 };
+
+/**
+ * ASN.1 identifier of the hash function BLAKE2b-512 (RFC 7693).
+ */
+static const uint8_t b2b_512_id[] =
+		{ 0x30, 0x53, 0x30, 0x0f, 0x06, 0x0b, 0x2b, 0x06, 0x01, 0x04, 0x01,
+			0x8d, 0x3a, 0x0c, 0x02, 0x01, 0x10, 0x05, 0x00, 0x04, 0x40 };
+
 /**
  * Returns a pointer to the ASN.1 identifier of a hash function according to the
  * PKCS#1 v1.5 padding standard.
@@ -242,6 +271,18 @@ static uint8_t *hash_id(int md, int *len) {
 		case SH512:
 			*len = sizeof(sh512_id);
 			return (uint8_t *)sh512_id;
+		case SH3_256:
+			*len = sizeof(sh3_256_id);
+			return (uint8_t *)sh3_256_id;
+		case SH3_512:
+			*len = sizeof(sh3_512_id);
+			return (uint8_t *)sh3_512_id;
+		case B2S_256:
+			*len = sizeof(b2s_256_id);
+			return (uint8_t *)b2s_256_id;
+		case B2B_512:
+			*len = sizeof(b2b_512_id);
+			return (uint8_t *)b2b_512_id;
 		default:
 			THROW(ERR_NO_VALID);
 			return NULL;
@@ -259,8 +300,8 @@ static uint8_t *hash_id(int md, int *len) {
  * @return STS_ERR if errors occurred, STS_OK otherwise.
  */
 static int pad_pkcs1(bn_t m, int *p_len, int m_len, int k_len, int operation) {
-	uint8_t *id, pad = 0;
-	int len, result = STS_OK;
+	uint8_t *id, pad = 0, eb[k_len];
+	int j, len, result = STS_OK;
 	bn_t t;
 
 	bn_null(t);
@@ -279,7 +320,7 @@ static int pad_pkcs1(bn_t m, int *p_len, int m_len, int k_len, int operation) {
 				for (int i = 0; i < *p_len; i++) {
 					bn_lsh(m, m, 8);
 					do {
-						rand_bytes(&pad, 1);
+						rand_bytes_small(&pad, 1);
 					} while (pad == 0);
 					bn_add_dig(m, m, pad);
 				}
@@ -348,63 +389,43 @@ static int pad_pkcs1(bn_t m, int *p_len, int m_len, int k_len, int operation) {
 				bn_lsh(m, m, m_len * 8);
 				break;
 			case RSA_VER:
-				m_len = k_len - 1;
-				bn_rsh(t, m, 8 * m_len);
-				if (!bn_is_zero(t)) {
-					result = STS_ERR;
-				}
-				m_len--;
-				bn_rsh(t, m, 8 * m_len);
-				pad = (uint8_t)t->dp[0];
-				if (pad != RSA_PRV) {
+			case RSA_VER_HASH:
+				/* EB = 00 | 01 | PS | 00 | D, parsed from one serialization. */
+				if (bn_size_bin(m) > k_len) {
 					result = STS_ERR;
+					break;
 				}
-				do {
-					m_len--;
-					bn_rsh(t, m, 8 * m_len);
-					pad = (uint8_t)t->dp[0];
-				} while (pad != 0 && m_len > 0);
-				if (m_len == 0) {
+				bn_write_bin(eb, k_len, m);
+				if (eb[0] != 0 || eb[1] != RSA_PRV) {
 					result = STS_ERR;
 				}
-				/* Remove padding and trailing zero. */
-				id = hash_id(MD_MAP, &len);
-				m_len -= len;
-
-				bn_rsh(t, m, m_len * 8);
-				int r = 0;
-				for (int i = 0; i < len; i++) {
-					pad = (uint8_t)t->dp[0];
-					r |= pad - id[len - i - 1];
-					bn_rsh(t, t, 8);
+				j = 2;
+				while (j < k_len && eb[j] == RSA_PAD) {
+					j++;
 				}
-				*p_len = k_len - m_len;
-				bn_mod_2b(m, m, m_len * 8);
-				result = (r == 0 ? STS_OK : STS_ERR);
-				break;
-			case RSA_VER_HASH:
-				m_len = k_len - 1;
-				bn_rsh(t, m, 8 * m_len);
-				if (!bn_is_zero(t)) {
+				/* PS must have at least eight bytes and end in a zero. */
+				if (j == k_len || eb[j] != 0 || j - 2 < RSA_PAD_LEN - 3) {
 					result = STS_ERR;
+					break;
 				}
-				m_len--;
-				bn_rsh(t, m, 8 * m_len);
-				pad = (uint8_t)t->dp[0];
-				if (pad != RSA_PRV) {
-					result = STS_ERR;
+				/* Remove padding and trailing zero. */
+				j = k_len - j - 1;
+				if (operation == RSA_VER) {
+					id = hash_id(MD_MAP, &len);
+					if (j < len || util_cmp_const(eb + k_len - j, id,
+							len) != CMP_EQ) {
+						result = STS_ERR;
+						break;
+					}
+					j -= len;
 				}
-				do {
-					m_len--;
-					bn_rsh(t, m, 8 * m_len);
-					pad = (uint8_t)t->dp[0];
-				} while (pad != 0 && m_len > 0);
-				if (m_len == 0) {
+				/* The digest must fill the rest of the block exactly. */
+				if (j != m_len) {
 					result = STS_ERR;
+					break;
 				}
-				/* Remove padding and trailing zero. */
-				*p_len = k_len - m_len;
-				bn_mod_2b(m, m, m_len * 8);
+				*p_len = k_len - j;
+				bn_mod_2b(m, m, j * 8);
 				break;
 		}
 	}
@@ -455,7 +476,7 @@ static int pad_pkcs2(bn_t m, int *p_len, int m_len, int k_len, int operation) {
 				break;
 			case RSA_ENC_FIN:
 				/* EB = 00 | maskedSeed | maskedDB. */
-				rand_bytes(h1, MD_LEN);
+				rand_bytes_small(h1, MD_LEN);
 				md_mgf1(mask, k_len - MD_LEN - 1, h1, MD_LEN);
 				bn_read_bin(t, mask, k_len - MD_LEN - 1);
 				for (int i = 0; i < t->used; i++) {
@@ -583,10 +604,437 @@ static int pad_pkcs2(bn_t m, int *p_len, int m_len, int k_len, int operation) {
 
 #endif
 
+/**
+ * Tests if the precomputed moduli of a key match its fields, which holds for
+ * keys produced by the key generation functions or by cp_rsa_prepare().
+ *
+ * @param[in] key			- the RSA key.
+ * @return 1 if the key can be used, 0 otherwise.
+ */
+static int rsa_ready(const rsa_st *key) {
+	return bn_mod_ctx_cmp(key->mn, key->n) == CMP_EQ &&
+			(bn_is_zero(key->p) || bn_mod_ctx_cmp(key->mp, key->p) == CMP_EQ) &&
+			(bn_is_zero(key->q) || bn_mod_ctx_cmp(key->mq, key->q) == CMP_EQ);
+}
+
+/**
+ * Computes c = c^e mod n with a public key. Exponents that fit in a digit,
+ * such as 65537, use a plain square-and-multiply chain.
+ *
+ * @param[in,out] c			- the input on entry and the result on exit.
+ * @param[in] pub			- the public key.
+ */
+static void rsa_pub(bn_t c, rsa_st *pub) {
+	dig_t e;
+
+	if (bn_bits(pub->e) <= BN_DIGIT) {
+		bn_get_dig(&e, pub->e);
+		bn_mxp_dig_ctx(c, c, e, pub->mn);
+	} else {
+		bn_mxp_ctx(c, c, pub->e, pub->mn);
+	}
+}
+
+/**
+ * Arguments shared by the tasks of a batch of RSA verifications.
+ */
+typedef struct {
+	/** The verification results. */
+	int *v;
+	/** The signatures. */
+	uint8_t **sig;
+	/** The signature lengths in bytes. */
+	int *sig_len;
+	/** The signed messages. */
+	uint8_t **msg;
+	/** The message lengths in bytes. */
+	int *msg_len;
+	/** The flag to indicate the message format. */
+	int hash;
+	/** The public key. */
+	rsa_st *pub;
+} rsa_ver_lot_t;
+
+/**
+ * Verifies the i-th signature of a batch.
+ *
+ * @param[in,out] args		- the arguments of the batch.
+ * @param[in] i				- the index of the signature.
+ */
+static void rsa_ver_one(void *args, int i) {
+	rsa_ver_lot_t *a = (rsa_ver_lot_t *)args;
+
+	a->v[i] = cp_rsa_ver(a->sig[i], a->sig_len[i], a->msg[i], a->msg_len[i],
+			a->hash, a->pub);
+}
+
+#if CP_RSA == QUICK || !defined(STRIP)
+
+/**
+ * Type that represents the two independent halves of an RSA key generation or
+ * private-key operation.
+ */
+typedef struct {
+	/** The values computed modulo p and modulo q. */
+	bn_st *m[2];
+	/** The exponents modulo p - 1 and modulo q - 1. */
+	bn_st *d[2];
+	/** The private key. */
+	rsa_st *prv;
+	/** The length of the prime factors in bits. */
+	int bits;
+} rsa_crt_t;
+
+/**
+ * Generates the i-th prime factor of an RSA modulus.
+ *
+ * @param[in,out] args		- the arguments of the key generation.
+ * @param[in] i				- the index of the prime factor.
+ */
+static void rsa_gen_one(void *args, int i) {
+	rsa_crt_t *a = (rsa_crt_t *)args;
+
+	bn_gen_prime(a->m[i], a->bits);
+}
+
+/**
+ * Computes the i-th half of a private-key operation, m1 = c^dP mod p or
+ * m2 = c^dQ mod q.
+ *
+ * @param[in,out] args		- the arguments of the private-key operation.
+ * @param[in] i				- the index of the half.
+ */
+static void rsa_crt_one(void *args, int i) {
+	rsa_crt_t *a = (rsa_crt_t *)args;
+
+	if (i == 0) {
+		bn_mxp_const_ctx(a->m[0], a->m[0], a->d[0], a->prv->mp);
+	} else {
+		bn_mxp_const_ctx(a->m[1], a->m[1], a->d[1], a->prv->mq);
+	}
+}
+
+/**
+ * Computes m = c^d mod n using the Chinese Remainder Theorem and Garner's
+ * recombination, where d is given by its residues modulo p - 1 and q - 1. The
+ * halves modulo p and q run on separate threads when the thread pool has more
+ * than one core.
+ *
+ * @param[in,out] c			- the input on entry and the result on exit.
+ * @param[out] t			- a temporary value.
+ * @param[in] dp			- the exponent modulo p - 1.
+ * @param[in] dq			- the exponent modulo q - 1.
+ * @param[in] prv			- the private key.
+ */
+static void rsa_crt(bn_t c, bn_t t, bn_t dp, bn_t dq, rsa_st *prv) {
+	rsa_crt_t args;
+
+	bn_copy(t, c);
+	args.m[0] = c;
+	args.m[1] = t;
+	args.d[0] = dp;
+	args.d[1] = dq;
+	args.prv = prv;
+	args.bits = 0;
+
+	/* m1 = c^dP mod p and m2 = c^dQ mod q. */
+	multi_run(rsa_crt_one, &args, 2);
+
+	/* m1 = m1 - m2 mod p. */
+	bn_sub(c, c, t);
+	while (bn_sign(c) == BN_NEG) {
+		bn_add(c, c, prv->p);
+	}
+	bn_mod(c, c, prv->p);
+	/* m1 = qInv(m1 - m2) mod p. */
+	bn_mul_mod_ctx(c, c, prv->qi, prv->mp);
+	/* m = m2 + m1 * q. */
+	bn_mul(c, c, prv->q);
+	bn_add(c, c, t);
+}
+
+/**
+ * Type that represents a batch of private-key operations.
+ */
+typedef struct {
+	/** The inputs, replaced by the results. */
+	bn_t *m;
+	/** The private keys. */
+	rsa_t *prv;
+	/** The indices of the inputs to process. */
+	int *idx;
+} rsa_lot_t;
+
+/**
+ * Computes the i-th private-key operation of a batch independently.
+ *
+ * @param[in,out] args		- the arguments of the batch.
+ * @param[in] i				- the index of the operation.
+ */
+static void rsa_lot_one(void *args, int i) {
+	rsa_lot_t *a = (rsa_lot_t *)args;
+	int j = a->idx[i];
+	bn_t t;
+
+	bn_null(t);
+
+	TRY {
+		bn_new(t);
+
+		rsa_crt(a->m[j], t, a->prv[j]->dp, a->prv[j]->dq, a->prv[j]);
+	}
+	CATCH_ANY {
+		THROW(ERR_CAUGHT);
+	}
+	FINALLY {
+		bn_free(t);
+	}
+}
+
+/**
+ * Tests if a batch of private keys admits Fiat's batch RSA, that is, if the
+ * keys share the same modulus and have pairwise coprime public exponents.
+ *
+ * @param[in] prv			- the private keys.
+ * @param[in] n				- the number of keys.
+ * @return 1 if the batch can share one exponentiation, 0 otherwise.
+ */
+static int rsa_is_fiat(rsa_t *prv, int n) {
+	bn_t t;
+	int i, j, result = (n > 1);
+
+	bn_null(t);
+
+	TRY {
+		bn_new(t);
+
+		for (i = 1; i < n && result; i++) {
+			if (bn_cmp(prv[i]->n, prv[0]->n) != CMP_EQ) {
+				result = 0;
+			}
+			for (j = 0; j < i && result; j++) {
+				bn_gcd(t, prv[i]->e, prv[j]->e);
+				if (bn_cmp_dig(t, 1) != CMP_EQ) {
+					result = 0;
+				}
+			}
+		}
+	}
+	CATCH_ANY {
+		THROW(ERR_CAUGHT);
+	}
+	FINALLY {
+		bn_free(t);
+	}
+
+	return result;
+}
+
+/**
+ * Computes c = a^(-1) mod b.
+ *
+ * @param[out] c			- the result.
+ * @param[in] a				- the element to invert.
+ * @param[in] b				- the modulus.
+ */
+static void rsa_inv(bn_t c, bn_t a, bn_t b) {
+	bn_t t;
+
+	bn_null(t);
+
+	TRY {
+		bn_new(t);
+
+		bn_gcd_ext(t, c, NULL, a, b);
+		if (bn_cmp_dig(t, 1) != CMP_EQ) {
+			THROW(ERR_NO_VALID);
+		}
+		bn_mod(c, c, b);
+		if (bn_sign(c) == BN_NEG) {
+			bn_add(c, c, b);
+		}
+	}
+	CATCH_ANY {
+		THROW(ERR_CAUGHT);
+	}
+	FINALLY {
+		bn_free(t);
+	}
+}
+
+/**
+ * Computes m_i = m_i^(1/e_i) mod n for a batch of private keys. When the keys
+ * share the modulus and have pairwise coprime public exponents, Fiat's batch
+ * RSA combines the inputs along a binary tree, takes a single e-th root with
+ * e = e_1 * ... * e_n and splits it back into the individual roots with
+ * exponentiations by small exponents. Otherwise, the operations are computed
+ * independently on the thread pool. Inputs that are not units modulo n, such
+ * as zero, are left out and keep their value, so that they cannot stop the
+ * operations on the other inputs.
+ *
+ * @param[in,out] m			- the inputs on entry and the results on exit.
+ * @param[out] ok			- STS_OK for each input processed, STS_ERR otherwise.
+ * @param[in] prv			- the private keys.
+ * @param[in] n				- the number of operations.
+ */
+static void rsa_batch(bn_t *m, int *ok, rsa_t *prv, int n) {
+	bn_t s, t, u, v, w, *e, *x;
+	rsa_lot_t args;
+	rsa_st *key;
+	int i, k, l, r, b, *idx;
+
+	e = (bn_t *)malloc(2 * n * sizeof(bn_t));
+	x = (bn_t *)malloc(2 * n * sizeof(bn_t));
+	idx = (int *)malloc(n * sizeof(int));
+	if (e == NULL || x == NULL || idx == NULL) {
+		free(e);
+		free(x);
+		free(idx);
+		THROW(ERR_NO_MEMORY);
+		return;
+	}
+
+	bn_null(s);
+	bn_null(t);
+	bn_null(u);
+	bn_null(v);
+	bn_null(w);
+	for (i = 0; i < 2 * n; i++) {
+		bn_null(e[i]);
+		bn_null(x[i]);
+	}
+
+	TRY {
+		bn_new(s);
+		bn_new(t);
+		bn_new(u);
+		bn_new(v);
+		bn_new(w);
+		for (i = 0; i < 2 * n; i++) {
+			bn_new(e[i]);
+			bn_new(x[i]);
+		}
+
+		/* Keep the inputs 0 < m_i < n with gcd(m_i, n) = 1. */
+		for (i = b = 0; i < n; i++) {
+			ok[i] = STS_ERR;
+			if (bn_sign(m[i]) == BN_POS && bn_cmp(m[i], prv[i]->n) == CMP_LT) {
+				bn_gcd(t, m[i], prv[i]->n);
+				if (bn_cmp_dig(t, 1) == CMP_EQ) {
+					ok[i] = STS_OK;
+					idx[b++] = i;
+				}
+			}
+		}
+
+		if (b < 2 || !rsa_is_fiat(prv, n)) {
+			args.m = m;
+			args.prv = prv;
+			args.idx = idx;
+			multi_run(rsa_lot_one, &args, b);
+		} else {
+			/* The keys share the modulus and its factors. */
+			key = prv[idx[0]];
+
+			/* Node k has children 2k and 2k + 1, and the inputs are leaves. */
+			for (i = 0; i < b; i++) {
+				bn_copy(x[b + i], m[idx[i]]);
+				bn_copy(e[b + i], prv[idx[i]]->e);
+			}
+
+			/* Percolate up: x_k = x_l^e_r * x_r^e_l and e_k = e_l * e_r. */
+			for (k = b - 1; k > 0; k--) {
+				l = 2 * k;
+				r = 2 * k + 1;
+				bn_mul(e[k], e[l], e[r]);
+				bn_mxp_ctx(t, x[l], e[r], key->mn);
+				bn_mxp_ctx(u, x[r], e[l], key->mn);
+				bn_mul_mod_ctx(x[k], t, u, key->mn);
+			}
+
+			/* x_1 = x_1^(1/e_1) mod n, the only full-size exponentiation. */
+			bn_sub_dig(t, key->p, 1);
+			rsa_inv(u, e[1], t);
+			bn_sub_dig(t, key->q, 1);
+			rsa_inv(v, e[1], t);
+			rsa_crt(x[1], t, u, v, key);
+
+			/* Percolate down, splitting y_k = y_l * y_r at each node. */
+			for (k = 1; k < b; k++) {
+				l = 2 * k;
+				r = 2 * k + 1;
+				/* X = u * e_l is 0 modulo e_l and 1 modulo e_r. */
+				rsa_inv(u, e[l], e[r]);
+				bn_mul(v, u, e[l]);
+				bn_sub_dig(v, v, 1);
+				bn_div(v, v, e[r]);
+				/* y_k^X = y_r * w, with w = x_l^(X/e_l) * x_r^((X - 1)/e_r). */
+				bn_mxp_ctx(t, x[l], u, key->mn);
+				bn_mxp_ctx(w, x[r], v, key->mn);
+				bn_mul_mod_ctx(w, w, t, key->mn);
+				bn_mul(u, u, e[l]);
+				bn_mxp_ctx(s, x[k], u, key->mn);
+				/* One inversion gives y_r = s/w and y_l = y_k * w/s. */
+				bn_mul_mod_ctx(t, s, w, key->mn);
+				rsa_inv(v, t, key->n);
+				bn_mul_mod_ctx(x[r], s, s, key->mn);
+				bn_mul_mod_ctx(x[r], x[r], v, key->mn);
+				bn_mul_mod_ctx(x[l], w, w, key->mn);
+				bn_mul_mod_ctx(x[l], x[l], v, key->mn);
+				bn_mul_mod_ctx(x[l], x[l], x[k], key->mn);
+			}
+
+			for (i = 0; i < b; i++) {
+				bn_copy(m[idx[i]], x[b + i]);
+			}
+		}
+	}
+	CATCH_ANY {
+		THROW(ERR_CAUGHT);
+	}
+	FINALLY {
+		bn_free(s);
+		bn_free(t);
+		bn_free(u);
+		bn_free(v);
+		bn_free(w);
+		for (i = 0; i < 2 * n; i++) {
+			bn_free(e[i]);
+			bn_free(x[i]);
+		}
+		free(e);
+		free(x);
+		free(idx);
+	}
+}
+
+#endif
+
 /*============================================================================*/
 /* Public definitions                                                         */
 /*============================================================================*/
 
+int cp_rsa_prepare(rsa_t key) {
+	int result = STS_OK;
+
+	if (key == NULL || bn_is_zero(key->n)) {
+		return STS_ERR;
+	}
+
+	TRY {
+		bn_mod_ctx_set(key->mn, key->n);
+		if (!bn_is_zero(key->p) && !bn_is_zero(key->q)) {
+			bn_mod_ctx_set(key->mp, key->p);
+			bn_mod_ctx_set(key->mq, key->q);
+		}
+	}
+	CATCH_ANY {
+		result = STS_ERR;
+	}
+
+	return result;
+}
+
 #if CP_RSA == BASIC || !defined(STRIP)
 
 int cp_rsa_gen_basic(rsa_t pub, rsa_t prv, int bits) {
@@ -635,6 +1083,11 @@ int cp_rsa_gen_basic(rsa_t pub, rsa_t prv, int bits) {
 		if (bn_cmp_dig(r, 1) == CMP_EQ) {
 			bn_add_dig(prv->p, prv->p, 1);
 			bn_add_dig(prv->q, prv->q, 1);
+
+			bn_mod_ctx_set(pub->mn, pub->n);
+			bn_mod_ctx_set(prv->mn, prv->n);
+			bn_mod_ctx_set(prv->mp, prv->p);
+			bn_mod_ctx_set(prv->mq, prv->q);
 		}
 	}
 	CATCH_ANY {
@@ -654,6 +1107,7 @@ int cp_rsa_gen_basic(rsa_t pub, rsa_t prv, int bits) {
 
 int cp_rsa_gen_quick(rsa_t pub, rsa_t prv, int bits) {
 	bn_t t, r;
+	rsa_crt_t args;
 	int result = STS_OK;
 
 	if (pub == NULL || prv == NULL || bits == 0) {
@@ -667,10 +1121,13 @@ int cp_rsa_gen_quick(rsa_t pub, rsa_t prv, int bits) {
 		bn_new(t);
 		bn_new(r);
 
-		/* Generate different primes p and q. */
+		/* Generate different primes p and q, searching for both at once. */
+		args.m[0] = prv->p;
+		args.m[1] = prv->q;
+		args.prv = prv;
+		args.bits = bits / 2;
 		do {
-			bn_gen_prime(prv->p, bits / 2);
-			bn_gen_prime(prv->q, bits / 2);
+			multi_run(rsa_gen_one, &args, 2);
 		} while (bn_cmp(prv->p, prv->q) == CMP_EQ);
 
 		/* Swap p and q so that p is smaller. */
@@ -691,6 +1148,7 @@ int cp_rsa_gen_quick(rsa_t pub, rsa_t prv, int bits) {
 
 		bn_set_2b(pub->e, 16);
 		bn_add_dig(pub->e, pub->e, 1);
+		bn_copy(prv->e, pub->e);
 
 		/* d = e^(-1) mod phi(n). */
 		bn_gcd_ext(r, prv->d, NULL, pub->e, t);
@@ -713,6 +1171,12 @@ int cp_rsa_gen_quick(rsa_t pub, rsa_t prv, int bits) {
 				bn_add(prv->qi, prv->qi, prv->p);
 			}
 
+			/* Precompute the moduli used by every key operation. */
+			bn_mod_ctx_set(pub->mn, pub->n);
+			bn_mod_ctx_set(prv->mn, prv->n);
+			bn_mod_ctx_set(prv->mp, prv->p);
+			bn_mod_ctx_set(prv->mq, prv->q);
+
 			result = STS_OK;
 		}
 	}
@@ -727,6 +1191,78 @@ int cp_rsa_gen_quick(rsa_t pub, rsa_t prv, int bits) {
 	return result;
 }
 
+int cp_rsa_gen_batch(rsa_t *pub, rsa_t *prv, int n, int bits) {
+	bn_t t, r, p, q;
+	int i, j, result = STS_OK;
+
+	if (pub == NULL || prv == NULL || n <= 0 || bits == 0) {
+		return STS_ERR;
+	}
+
+	bn_null(t);
+	bn_null(r);
+	bn_null(p);
+	bn_null(q);
+
+	TRY {
+		bn_new(t);
+		bn_new(r);
+		bn_new(p);
+		bn_new(q);
+
+		/* The first key pair fixes the modulus shared by the batch. */
+		result = cp_rsa_gen_quick(pub[0], prv[0], bits);
+
+		/* phi(n) = (p - 1)(q - 1). */
+		bn_sub_dig(p, prv[0]->p, 1);
+		bn_sub_dig(q, prv[0]->q, 1);
+		bn_mul(t, p, q);
+
+		for (i = 0, j = 1; i < n && result == STS_OK; i++) {
+			if (i > 0) {
+				bn_copy(pub[i]->n, pub[0]->n);
+				bn_copy(prv[i]->n, prv[0]->n);
+				bn_copy(prv[i]->p, prv[0]->p);
+				bn_copy(prv[i]->q, prv[0]->q);
+				bn_copy(prv[i]->qi, prv[0]->qi);
+				bn_mod_ctx_set(pub[i]->mn, pub[i]->n);
+				bn_mod_ctx_set(prv[i]->mn, prv[i]->n);
+				bn_mod_ctx_set(prv[i]->mp, prv[i]->p);
+				bn_mod_ctx_set(prv[i]->mq, prv[i]->q);
+			}
+
+			/* e is the next small odd prime coprime to phi(n). */
+			do {
+				bn_set_dig(pub[i]->e, bn_get_prime(j++));
+				if (bn_is_zero(pub[i]->e)) {
+					THROW(ERR_NO_VALID);
+					break;
+				}
+				bn_gcd_ext(r, prv[i]->d, NULL, pub[i]->e, t);
+			} while (bn_cmp_dig(r, 1) != CMP_EQ);
+			bn_copy(prv[i]->e, pub[i]->e);
+
+			/* d = e^(-1) mod phi(n), dP = d mod (p - 1), dQ = d mod (q - 1). */
+			if (bn_sign(prv[i]->d) == BN_NEG) {
+				bn_add(prv[i]->d, prv[i]->d, t);
+			}
+			bn_mod(prv[i]->dp, prv[i]->d, p);
+			bn_mod(prv[i]->dq, prv[i]->d, q);
+		}
+	}
+	CATCH_ANY {
+		result = STS_ERR;
+	}
+	FINALLY {
+		bn_free(t);
+		bn_free(r);
+		bn_free(p);
+		bn_free(q);
+	}
+
+	return result;
+}
+
 #endif
 
 int cp_rsa_enc(uint8_t *out, int *out_len, uint8_t *in, int in_len, rsa_t pub) {
@@ -738,7 +1274,8 @@ int cp_rsa_enc(uint8_t *out, int *out_len, uint8_t *in, int in_len, rsa_t pub) {
 
 	size = bn_size_bin(pub->n);
 
-	if (pub == NULL || in_len <= 0 || in_len > (size - RSA_PAD_LEN)) {
+	if (pub == NULL || in_len <= 0 || in_len > (size - RSA_PAD_LEN) ||
+			!rsa_ready(pub)) {
 		return STS_ERR;
 	}
 
@@ -762,7 +1299,7 @@ int cp_rsa_enc(uint8_t *out, int *out_len, uint8_t *in, int in_len, rsa_t pub) {
 #if CP_RSAPD == PKCS2
 			pad_pkcs2(eb, &pad_len, in_len, size, RSA_ENC_FIN);
 #endif
-			bn_mxp(eb, eb, pub->e, pub->n);
+			rsa_pub(eb, pub);
 
 			if (size <= *out_len) {
 				*out_len = size;
@@ -794,7 +1331,8 @@ int cp_rsa_dec_basic(uint8_t *out, int *out_len, uint8_t *in, int in_len, rsa_t
 
 	size = bn_size_bin(prv->n);
 
-	if (prv == NULL || in_len != size || in_len < RSA_PAD_LEN) {
+	if (prv == NULL || in_len != size || in_len < RSA_PAD_LEN ||
+			!rsa_ready(prv)) {
 		return STS_ERR;
 	}
 
@@ -806,7 +1344,7 @@ int cp_rsa_dec_basic(uint8_t *out, int *out_len, uint8_t *in, int in_len, rsa_t
 		bn_new(eb);
 
 		bn_read_bin(eb, in, in_len);
-		bn_mxp(eb, eb, prv->d, prv->n);
+		bn_mxp_ctx(eb, eb, prv->d, prv->mn);
 
 		if (bn_cmp(eb, prv->n) != CMP_LT) {
 			result = STS_ERR;
@@ -855,7 +1393,8 @@ int cp_rsa_dec_quick(uint8_t *out, int *out_len, uint8_t *in, int in_len, rsa_t
 
 	size = bn_size_bin(prv->n);
 
-	if (prv == NULL || in_len != size || in_len < RSA_PAD_LEN) {
+	if (prv == NULL || in_len != size || in_len < RSA_PAD_LEN ||
+			!rsa_ready(prv)) {
 		return STS_ERR;
 	}
 
@@ -865,26 +1404,8 @@ int cp_rsa_dec_quick(uint8_t *out, int *out_len, uint8_t *in, int in_len, rsa_t
 
 		bn_read_bin(eb, in, in_len);
 
-		bn_copy(m, eb);
-
-		/* m1 = c^dP mod p. */
-		bn_mxp(eb, eb, prv->dp, prv->p);
-
-		/* m2 = c^dQ mod q. */
-		bn_mxp(m, m, prv->dq, prv->q);
-
-		/* m1 = m1 - m2 mod p. */
-		bn_sub(eb, eb, m);
-		while (bn_sign(eb) == BN_NEG) {
-			bn_add(eb, eb, prv->p);
-		}
-		bn_mod(eb, eb, prv->p);
-		/* m1 = qInv(m1 - m2) mod p. */
-		bn_mul(eb, eb, prv->qi);
-		bn_mod(eb, eb, prv->p);
-		/* m = m2 + m1 * q. */
-		bn_mul(eb, eb, prv->q);
-		bn_add(eb, eb, m);
+		/* m = c^d mod n, with the halves modulo p and q in parallel. */
+		rsa_crt(eb, m, prv->dp, prv->dq, prv);
 
 		if (bn_cmp(eb, prv->n) != CMP_LT) {
 			result = STS_ERR;
@@ -920,6 +1441,89 @@ int cp_rsa_dec_quick(uint8_t *out, int *out_len, uint8_t *in, int in_len, rsa_t
 	return result;
 }
 
+int cp_rsa_dec_batch(int *v, uint8_t **out, int *out_len, uint8_t **in,
+		int *in_len, rsa_t *prv, int n) {
+	bn_t *eb;
+	int i, size, pad_len, *ok, result = STS_OK;
+
+	if (prv == NULL || n <= 0) {
+		return STS_ERR;
+	}
+
+	eb = (bn_t *)malloc(n * sizeof(bn_t));
+	ok = (int *)malloc(n * sizeof(int));
+	if (eb == NULL || ok == NULL) {
+		free(eb);
+		free(ok);
+		return STS_ERR;
+	}
+
+	for (i = 0; i < n; i++) {
+		bn_null(eb[i]);
+	}
+
+	TRY {
+		for (i = 0; i < n; i++) {
+			bn_new(eb[i]);
+			size = bn_size_bin(prv[i]->n);
+			/* Malformed ciphertexts and unprepared keys fail on their own. */
+			if (in_len[i] == size && in_len[i] >= RSA_PAD_LEN &&
+					rsa_ready(prv[i])) {
+				bn_read_bin(eb[i], in[i], in_len[i]);
+			} else {
+				bn_zero(eb[i]);
+			}
+		}
+
+		/* m_i = c_i^d_i mod n, sharing one exponentiation if possible. */
+		rsa_batch(eb, ok, prv, n);
+
+		for (i = 0; i < n; i++) {
+			size = bn_size_bin(prv[i]->n);
+			if (ok[i] != STS_OK) {
+				continue;
+			}
+			ok[i] = STS_ERR;
+#if CP_RSAPD == BASIC
+			if (pad_basic(eb[i], &pad_len, in_len[i], size, RSA_DEC) == STS_OK) {
+#elif CP_RSAPD == PKCS1
+			if (pad_pkcs1(eb[i], &pad_len, in_len[i], size, RSA_DEC) == STS_OK) {
+#elif CP_RSAPD == PKCS2
+			if (pad_pkcs2(eb[i], &pad_len, in_len[i], size, RSA_DEC) == STS_OK) {
+#endif
+				size = size - pad_len;
+
+				if (size <= out_len[i]) {
+					memset(out[i], 0, size);
+					bn_write_bin(out[i], size, eb[i]);
+					out_len[i] = size;
+					ok[i] = STS_OK;
+				}
+			}
+		}
+	}
+	CATCH_ANY {
+		for (i = 0; i < n; i++) {
+			ok[i] = STS_ERR;
+		}
+	}
+	FINALLY {
+		for (i = 0; i < n; i++) {
+			if (ok[i] != STS_OK) {
+				result = STS_ERR;
+			}
+			if (v != NULL) {
+				v[i] = ok[i];
+			}
+			bn_free(eb[i]);
+		}
+		free(eb);
+		free(ok);
+	}
+
+	return result;
+}
+
 #endif
 
 #if CP_RSA == BASIC || !defined(STRIP)
@@ -929,7 +1533,7 @@ int cp_rsa_sig_basic(uint8_t *sig, int *sig_len, uint8_t *msg, int msg_len, int
 	int size, pad_len, result = STS_OK;
 	uint8_t h[MD_LEN];
 
-	if (prv == NULL || msg_len < 0) {
+	if (prv == NULL || msg_len < 0 || !rsa_ready(prv)) {
 		return STS_ERR;
 	}
 
@@ -980,7 +1584,7 @@ int cp_rsa_sig_basic(uint8_t *sig, int *sig_len, uint8_t *msg, int msg_len, int
 			pad_pkcs2(eb, &pad_len, bn_bits(prv->n), size, RSA_SIG_FIN);
 #endif
 
-			bn_mxp(eb, eb, prv->d, prv->n);
+			bn_mxp_ctx(eb, eb, prv->d, prv->mn);
 
 			size = bn_size_bin(prv->n);
 
@@ -1015,7 +1619,7 @@ int cp_rsa_sig_quick(uint8_t *sig, int *sig_len, uint8_t *msg, int msg_len, int
 	int pad_len, size, result = STS_OK;
 	uint8_t h[MD_LEN];
 
-	if (prv == NULL || msg_len < 0) {
+	if (prv == NULL || msg_len < 0 || !rsa_ready(prv)) {
 		return STS_ERR;
 	}
 
@@ -1066,26 +1670,8 @@ int cp_rsa_sig_quick(uint8_t *sig, int *sig_len, uint8_t *msg, int msg_len, int
 			pad_pkcs2(eb, &pad_len, bn_bits(prv->n), size, RSA_SIG_FIN);
 #endif
 
-			bn_copy(m, eb);
-
-			/* m1 = c^dP mod p. */
-			bn_mxp(eb, eb, prv->dp, prv->p);
-
-			/* m2 = c^dQ mod q. */
-			bn_mxp(m, m, prv->dq, prv->q);
-
-			/* m1 = m1 - m2 mod p. */
-			bn_sub(eb, eb, m);
-			while (bn_sign(eb) == BN_NEG) {
-				bn_add(eb, eb, prv->p);
-			}
-			bn_mod(eb, eb, prv->p);
-			/* m1 = qInv(m1 - m2) mod p. */
-			bn_mul(eb, eb, prv->qi);
-			bn_mod(eb, eb, prv->p);
-			/* m = m2 + m1 * q. */
-			bn_mul(eb, eb, prv->q);
-			bn_add(eb, eb, m);
+			/* m = c^d mod n, with the halves modulo p and q in parallel. */
+			rsa_crt(eb, m, prv->dp, prv->dq, prv);
 			bn_mod(eb, eb, prv->n);
 
 			size = bn_size_bin(prv->n);
@@ -1112,6 +1698,126 @@ int cp_rsa_sig_quick(uint8_t *sig, int *sig_len, uint8_t *msg, int msg_len, int
 	return result;
 }
 
+int cp_rsa_sig_batch(uint8_t **sig, int *sig_len, uint8_t **msg, int *msg_len,
+		int hash, rsa_t *prv, int n) {
+	bn_t m, *eb;
+	int i, pad_len, size, *ok, result = STS_OK;
+	uint8_t h[MD_LEN];
+
+	if (prv == NULL || n <= 0) {
+		return STS_ERR;
+	}
+
+	for (i = 0; i < n; i++) {
+		if (msg_len[i] < 0 || !rsa_ready(prv[i])) {
+			return STS_ERR;
+		}
+		pad_len = (!hash ? MD_LEN : msg_len[i]);
+#if CP_RSAPD == PKCS2
+		size = bn_bits(prv[i]->n) - 1;
+		size = (size / 8) + (size % 8 > 0);
+		if (pad_len > (size - 2)) {
+			return STS_ERR;
+		}
+#else
+		size = bn_size_bin(prv[i]->n);
+		if (pad_len > (size - RSA_PAD_LEN)) {
+			return STS_ERR;
+		}
+#endif
+	}
+
+	eb = (bn_t *)malloc(n * sizeof(bn_t));
+	ok = (int *)malloc(n * sizeof(int));
+	if (eb == NULL || ok == NULL) {
+		free(eb);
+		free(ok);
+		return STS_ERR;
+	}
+
+	bn_null(m);
+	for (i = 0; i < n; i++) {
+		bn_null(eb[i]);
+	}
+
+	TRY {
+		bn_new(m);
+		for (i = 0; i < n; i++) {
+			bn_new(eb[i]);
+		}
+
+		int operation = (!hash ? RSA_SIG : RSA_SIG_HASH);
+
+		for (i = 0; i < n && result == STS_OK; i++) {
+			pad_len = (!hash ? MD_LEN : msg_len[i]);
+#if CP_RSAPD == PKCS2
+			size = bn_bits(prv[i]->n) - 1;
+			size = (size / 8) + (size % 8 > 0);
+#else
+			size = bn_size_bin(prv[i]->n);
+#endif
+			bn_zero(eb[i]);
+
+#if CP_RSAPD == BASIC
+			if (pad_basic(eb[i], &pad_len, pad_len, size, operation) == STS_OK) {
+#elif CP_RSAPD == PKCS1
+			if (pad_pkcs1(eb[i], &pad_len, pad_len, size, operation) == STS_OK) {
+#elif CP_RSAPD == PKCS2
+			if (pad_pkcs2(eb[i], &pad_len, pad_len, size, operation) == STS_OK) {
+#endif
+				if (!hash) {
+					md_map(h, msg[i], msg_len[i]);
+					bn_read_bin(m, h, MD_LEN);
+					bn_add(eb[i], eb[i], m);
+				} else {
+					bn_read_bin(m, msg[i], msg_len[i]);
+					bn_add(eb[i], eb[i], m);
+				}
+
+#if CP_RSAPD == PKCS2
+				pad_pkcs2(eb[i], &pad_len, bn_bits(prv[i]->n), size, RSA_SIG_FIN);
+#endif
+			} else {
+				result = STS_ERR;
+			}
+		}
+
+		if (result == STS_OK) {
+			/* s_i = m_i^d_i mod n, sharing one exponentiation if possible. */
+			rsa_batch(eb, ok, prv, n);
+
+			for (i = 0; i < n; i++) {
+				if (ok[i] != STS_OK) {
+					result = STS_ERR;
+					continue;
+				}
+				bn_mod(eb[i], eb[i], prv[i]->n);
+				size = bn_size_bin(prv[i]->n);
+				if (size <= sig_len[i]) {
+					memset(sig[i], 0, size);
+					bn_write_bin(sig[i], size, eb[i]);
+					sig_len[i] = size;
+				} else {
+					result = STS_ERR;
+				}
+			}
+		}
+	}
+	CATCH_ANY {
+		result = STS_ERR;
+	}
+	FINALLY {
+		bn_free(m);
+		for (i = 0; i < n; i++) {
+			bn_free(eb[i]);
+		}
+		free(eb);
+		free(ok);
+	}
+
+	return result;
+}
+
 #endif
 
 int cp_rsa_ver(uint8_t *sig, int sig_len, uint8_t *msg, int msg_len, int hash, rsa_t pub) {
@@ -1122,7 +1828,7 @@ int cp_rsa_ver(uint8_t *sig, int sig_len, uint8_t *msg, int msg_len, int hash, r
 	/* We suppose that the signature is invalid. */
 	result = 0;
 
-	if (pub == NULL || msg_len < 0) {
+	if (pub == NULL || msg_len < 0 || !rsa_ready(pub)) {
 		return 0;
 	}
 
@@ -1154,14 +1860,14 @@ int cp_rsa_ver(uint8_t *sig, int sig_len, uint8_t *msg, int msg_len, int hash, r
 
 		bn_read_bin(eb, sig, sig_len);
 
-		bn_mxp(eb, eb, pub->e, pub->n);
+		rsa_pub(eb, pub);
 
 		int operation = (!hash ? RSA_VER : RSA_VER_HASH);
 
 #if CP_RSAPD == BASIC
 		if (pad_basic(eb, &pad_len, MD_LEN, size, operation) == STS_OK) {
 #elif CP_RSAPD == PKCS1
-		if (pad_pkcs1(eb, &pad_len, MD_LEN, size, operation) == STS_OK) {
+		if (pad_pkcs1(eb, &pad_len, pad_len, size, operation) == STS_OK) {
 #elif CP_RSAPD == PKCS2
 		if (pad_pkcs2(eb, &pad_len, bn_bits(pub->n), size, operation) == STS_OK) {
 #endif
@@ -1188,16 +1894,21 @@ int cp_rsa_ver(uint8_t *sig, int sig_len, uint8_t *msg, int msg_len, int hash, r
 				result = util_cmp_const(h1, h2, msg_len);
 			}
 #else
-			memset(h1, 0, MAX(msg_len, MD_LEN));
-			bn_write_bin(h1, size - pad_len, eb);
-
-			if (!hash) {
-				md_map(h2, msg, msg_len);
-				/* Everything went ok, so signature status is changed. */
-				result = util_cmp_const(h1, h2, MD_LEN);
+			if (size - pad_len > MAX(msg_len, MD_LEN)) {
+				/* Never write more than the digest buffer can hold. */
+				result = CMP_NE;
 			} else {
-				/* Everything went ok, so signature status is changed. */
-				result = util_cmp_const(h1, msg, msg_len);
+				memset(h1, 0, MAX(msg_len, MD_LEN));
+				bn_write_bin(h1, size - pad_len, eb);
+
+				if (!hash) {
+					md_map(h2, msg, msg_len);
+					/* Everything went ok, so signature status is changed. */
+					result = util_cmp_const(h1, h2, MD_LEN);
+				} else {
+					/* Everything went ok, so signature status is changed. */
+					result = util_cmp_const(h1, msg, msg_len);
+				}
 			}
 #endif
 			result = (result == CMP_EQ ? 1 : 0);
@@ -1215,3 +1926,46 @@ int cp_rsa_ver(uint8_t *sig, int sig_len, uint8_t *msg, int msg_len, int hash, r
 
 	return result;
 }
+
+int cp_rsa_ver_batch(int *v, uint8_t **sig, int *sig_len, uint8_t **msg,
+		int *msg_len, int hash, rsa_t pub, int n) {
+	rsa_ver_lot_t args;
+	int i, *t, result = 1;
+
+	if (pub == NULL || n <= 0 || !rsa_ready(pub)) {
+		return 0;
+	}
+
+	t = (int *)malloc(n * sizeof(int));
+	if (t == NULL) {
+		return 0;
+	}
+
+	args.v = (v != NULL ? v : t);
+	args.sig = sig;
+	args.sig_len = sig_len;
+	args.msg = msg;
+	args.msg_len = msg_len;
+	args.hash = hash;
+	args.pub = pub;
+
+	for (i = 0; i < n; i++) {
+		args.v[i] = 0;
+	}
+
+	TRY {
+		multi_run(rsa_ver_one, &args, n);
+
+		for (i = 0; i < n; i++) {
+			result &= args.v[i];
+		}
+	}
+	CATCH_ANY {
+		result = 0;
+	}
+	FINALLY {
+		free(t);
+	}
+
+	return result;
+}
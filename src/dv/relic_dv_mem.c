@@ -89,7 +89,7 @@ void dv_new_statc(dv_t *a, int digits) {
 		THROW(ERR_NO_PRECI);
 	}
 
-	(*a) = pool_get();
+	(*a) = pool_get(digits);
 	if ((*a) == NULL) {
 		THROW(ERR_NO_MEMORY);
 	}
@@ -56,6 +56,7 @@ void dv_zero(dig_t *a, int digits) {
 
 	if (digits > DV_DIGS) {
 		THROW(ERR_NO_PRECI);
+		return;
 	}
 
 	for (i = 0; i < digits; i++, a++)
@@ -537,7 +537,7 @@ void eb_read_bin(eb_t a, const uint8_t *bin, int len) {
 				break;
 			default:
 				THROW(ERR_NO_VALID);
-				break;
+				return;
 		}
 		eb_upk(a, a);
 	}
@@ -178,7 +178,7 @@ void ed_read_bin(ed_t a, const uint8_t *bin, int len) {
 				break;
 			default:
 				THROW(ERR_NO_VALID);
-				break;
+				return;
 		}
 		ed_upk(a, a);
 	}
@@ -188,6 +188,7 @@ void ed_read_bin(ed_t a, const uint8_t *bin, int len) {
 			fp_read_bin(a->x, bin + FP_BYTES + 1, FP_BYTES);
 		} else {
 			THROW(ERR_NO_VALID);
+			return;
 		}
 	}
 
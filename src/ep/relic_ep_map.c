@@ -29,17 +29,24 @@
  * @ingroup ep
  */
 
+#include <stdlib.h>
+
 #include "relic_core.h"
 #include "relic_md.h"
 
 /*============================================================================*/
-/* Public definitions                                                         */
+/* Private definitions                                                        */
 /*============================================================================*/
 
-void ep_map(ep_t p, const uint8_t *msg, int len) {
+/**
+ * Maps a digest to a point in a prime elliptic curve.
+ *
+ * @param[out] p			- the result.
+ * @param[in] digest		- the digest of the message to map.
+ */
+static void ep_map_dig(ep_t p, const uint8_t *digest) {
 	bn_t k;
 	fp_t t;
-	uint8_t digest[MD_LEN];
 
 	bn_null(k);
 	fp_null(t);
@@ -48,7 +55,6 @@ void ep_map(ep_t p, const uint8_t *msg, int len) {
 		bn_new(k);
 		fp_new(t);
 
-		md_map(digest, msg, len);
 		bn_read_bin(k, digest, MIN(FP_BYTES, MD_LEN));
 
 		fp_prime_conv(p->x, k);
@@ -81,3 +87,74 @@ void ep_map(ep_t p, const uint8_t *msg, int len) {
 		fp_free(t);
 	}
 }
+
+/**
+ * Arguments shared by the tasks of a batch of maps.
+ */
+typedef struct {
+	/** The resulting points. */
+	ep_t *p;
+	/** The digests of the messages. */
+	uint8_t **h;
+} ep_map_lot_t;
+
+/**
+ * Maps the i-th digest of a batch.
+ *
+ * @param[in,out] args		- the arguments of the batch.
+ * @param[in] i				- the index of the digest.
+ */
+static void ep_map_one(void *args, int i) {
+	ep_map_lot_t *a = (ep_map_lot_t *)args;
+
+	ep_map_dig(a->p[i], a->h[i]);
+}
+
+/*============================================================================*/
+/* Public definitions                                                         */
+/*============================================================================*/
+
+void ep_map(ep_t p, const uint8_t *msg, int len) {
+	uint8_t digest[MD_LEN];
+
+	md_map(digest, msg, len);
+	ep_map_dig(p, digest);
+}
+
+void ep_map_lot(ep_t *p, uint8_t **msg, int *len, int n) {
+	ep_map_lot_t args;
+	uint8_t *digest, **h;
+	int i;
+
+	if (n <= 0) {
+		return;
+	}
+
+	digest = (uint8_t *)malloc(n * MD_LEN);
+	h = (uint8_t **)malloc(n * sizeof(uint8_t *));
+	if (digest == NULL || h == NULL) {
+		free(digest);
+		free(h);
+		THROW(ERR_NO_MEMORY);
+		return;
+	}
+
+	TRY {
+		for (i = 0; i < n; i++) {
+			h[i] = digest + i * MD_LEN;
+		}
+		/* Short messages are hashed together in parallel lanes. */
+		md_map_lot(h, msg, len, n);
+
+		args.p = p;
+		args.h = h;
+		multi_run(ep_map_one, &args, n);
+	}
+	CATCH_ANY {
+		THROW(ERR_CAUGHT);
+	}
+	FINALLY {
+		free(digest);
+		free(h);
+	}
+}
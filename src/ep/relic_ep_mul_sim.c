@@ -357,6 +357,38 @@ static void ep_mul_sim_plain(ep_t r, const ep_t p, const bn_t k, const ep_t q,
 
 #endif /* EP_SIM == INTER */
 
+/**
+ * Arguments shared by the tasks of a multiple simultaneous multiplication.
+ */
+typedef struct {
+	/** The partial results, one for each pair of points. */
+	ep_t *t;
+	/** The points to multiply. */
+	const ep_t *p;
+	/** The integers. */
+	const bn_t *k;
+	/** The number of points. */
+	int n;
+} ep_mul_lot_t;
+
+/**
+ * Multiplies and adds the i-th pair of points of a multiple simultaneous
+ * multiplication.
+ *
+ * @param[in,out] args		- the arguments of the multiplication.
+ * @param[in] i				- the index of the pair.
+ */
+static void ep_mul_sim_pair(void *args, int i) {
+	ep_mul_lot_t *a = (ep_mul_lot_t *)args;
+
+	if (2 * i + 1 < a->n) {
+		ep_mul_sim(a->t[i], a->p[2 * i], a->k[2 * i], a->p[2 * i + 1],
+				a->k[2 * i + 1]);
+	} else {
+		ep_mul(a->t[i], a->p[2 * i], a->k[2 * i]);
+	}
+}
+
 /*============================================================================*/
 /* Public definitions                                                         */
 /*============================================================================*/
@@ -600,3 +632,45 @@ void ep_mul_sim_gen(ep_t r, const bn_t k, const ep_t q, const bn_t m) {
 		ep_free(g);
 	}
 }
+
+void ep_mul_sim_lot(ep_t r, const ep_t *p, const bn_t *k, int n) {
+	int i, m = (n + 1) / 2;
+	ep_mul_lot_t args;
+
+	if (n <= 0) {
+		ep_set_infty(r);
+		return;
+	}
+
+	ep_t t[m];
+
+	for (i = 0; i < m; i++) {
+		ep_null(t[i]);
+	}
+
+	TRY {
+		for (i = 0; i < m; i++) {
+			ep_new(t[i]);
+		}
+
+		args.t = t;
+		args.p = p;
+		args.k = k;
+		args.n = n;
+		multi_run(ep_mul_sim_pair, &args, m);
+
+		ep_copy(r, t[0]);
+		for (i = 1; i < m; i++) {
+			ep_add(r, r, t[i]);
+		}
+		ep_norm(r, r);
+	}
+	CATCH_ANY {
+		THROW(ERR_CAUGHT);
+	}
+	FINALLY {
+		for (i = 0; i < m; i++) {
+			ep_free(t[i]);
+		}
+	}
+}
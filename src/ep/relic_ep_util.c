@@ -255,7 +255,7 @@ void ep_read_bin(ep_t a, const uint8_t *bin, int len) {
 				break;
 			default:
 				THROW(ERR_NO_VALID);
-				break;
+				return;
 		}
 		ep_upk(a, a);
 	}
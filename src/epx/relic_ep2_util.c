@@ -240,7 +240,7 @@ void ep2_read_bin(ep2_t a, uint8_t *bin, int len) {
 				break;
 			default:
 				THROW(ERR_NO_VALID);
-				break;
+				return;
 		}
 		ep2_upk(a, a);
 	}
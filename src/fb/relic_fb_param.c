@@ -136,7 +136,7 @@ void fb_param_set(int param) {
 			break;
 		default:
 			THROW(ERR_NO_VALID);
-			break;
+			return;
 	}
 	core_get()->fb_id = param;
 }
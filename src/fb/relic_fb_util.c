@@ -150,7 +150,7 @@ void fb_set_dig(fb_t c, dig_t a) {
 void fb_rand(fb_t a) {
 	int bits, digits;
 
-	rand_bytes((uint8_t *)a, FB_DIGS * sizeof(dig_t));
+	rand_bytes_small((uint8_t *)a, FB_DIGS * sizeof(dig_t));
 
 	SPLIT(bits, digits, FB_BITS, FB_DIG_LOG);
 	if (bits > 0) {
@@ -180,6 +180,7 @@ int fb_size_str(const fb_t a, int radix) {
 
 	if (!valid_radix(radix)) {
 		THROW(ERR_NO_VALID);
+		return 0;
 	}
 
 	TRY {
@@ -209,6 +210,7 @@ void fb_read_str(fb_t a, const char *str, int len, int radix) {
 	l = log_radix(radix);
 	if (!valid_radix(radix)) {
 		THROW(ERR_NO_VALID);
+		return;
 	}
 
 	j = 0;
@@ -224,6 +226,7 @@ void fb_read_str(fb_t a, const char *str, int len, int radix) {
 			carry = fb_lshb_low(a, a, l);
 			if (carry != 0) {
 				THROW(ERR_NO_BUFFER);
+				return;
 			}
 			fb_add_dig(a, a, (dig_t)i);
 		} else {
@@ -243,12 +246,14 @@ void fb_write_str(char *str, int len, const fb_t a, int radix) {
 	l = fb_size_str(a, radix);
 	if (len < l) {
 		THROW(ERR_NO_BUFFER);
+		return;
 	}
 	len = l;
 
 	l = log_radix(radix);
 	if (!valid_radix(radix)) {
 		THROW(ERR_NO_VALID)
+		return;
 	}
 
 	if (fb_is_zero(a) == 1) {
@@ -297,6 +302,7 @@ void fb_read_bin(fb_t a, const uint8_t *bin, int len) {
 
 	if (len != FB_BYTES) {
 		THROW(ERR_NO_BUFFER);
+		return;
 	}
 
 	TRY {
@@ -321,6 +327,7 @@ void fb_write_bin(uint8_t *bin, int len, const fb_t a) {
 
 	if (len != FB_BYTES) {
 		THROW(ERR_NO_BUFFER);
+		return;
 	}
 
 	TRY {
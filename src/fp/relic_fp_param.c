@@ -153,6 +153,7 @@ void fp_param_get_sps(int *s, int *len) {
 
 	if (*len < MAX_TERMS) {
 		THROW(ERR_NO_BUFFER);
+		return;
 	}
 
 	TRY {
@@ -225,6 +226,7 @@ void fp_param_get_sps(int *s, int *len) {
 void fp_param_get_map(int *s, int *len) {
 	if (*len < FP_BITS) {
 		THROW(ERR_NO_BUFFER);
+		return;
 	}
 
 	for (int i = 0; i < FP_BITS; i++) {
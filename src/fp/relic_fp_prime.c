@@ -50,6 +50,7 @@ static void fp_prime_set(const bn_t p) {
 
 	if (p->used != FP_DIGS) {
 		THROW(ERR_NO_VALID);
+		return;
 	}
 
 	dv_null(s);
@@ -382,14 +383,15 @@ void fp_prime_set_pmers(const int *f, int len) {
 	bn_null(p);
 	bn_null(t);
 
+	if (len >= MAX_TERMS) {
+		THROW(ERR_NO_VALID);
+		return;
+	}
+
 	TRY {
 		bn_new(p);
 		bn_new(t);
 
-		if (len >= MAX_TERMS) {
-			THROW(ERR_NO_VALID);
-		}
-
 		bn_set_2b(p, f[len - 1]);
 		for (int i = len - 2; i > 0; i--) {
 			if (f[i] > 0) {
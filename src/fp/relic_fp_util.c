@@ -109,7 +109,7 @@ void fp_set_dig(fp_t c, dig_t a) {
 void fp_rand(fp_t a) {
 	int bits, digits;
 
-	rand_bytes((uint8_t *)a, FP_DIGS * sizeof(dig_t));
+	rand_bytes_small((uint8_t *)a, FP_DIGS * sizeof(dig_t));
 
 	SPLIT(bits, digits, FP_BITS, FP_DIG_LOG);
 	if (bits > 0) {
@@ -234,6 +234,7 @@ void fp_read_bin(fp_t a, const uint8_t *bin, int len) {
 
 	if (len != FP_BYTES) {
 		THROW(ERR_NO_BUFFER);
+		return;
 	}
 
 	TRY {
@@ -264,6 +265,7 @@ void fp_write_bin(uint8_t *bin, int len, const fp_t a) {
 
 	if (len != FP_BYTES) {
 		THROW(ERR_NO_BUFFER);
+		return;
 	}
 
 	TRY {
@@ -75,6 +75,7 @@ int fp2_size_bin(fp2_t a, int pack) {
 void fp2_read_bin(fp2_t a, uint8_t *bin, int len) {
 	if (len != FP_BYTES + 1 && len != 2 * FP_BYTES) {
 		THROW(ERR_NO_BUFFER);
+		return;
 	}
 	if (len == FP_BYTES + 1) {
 		fp_read_bin(a[0], bin, FP_BYTES);
@@ -160,6 +161,7 @@ int fp3_size_bin(fp3_t a) {
 void fp3_read_bin(fp3_t a, uint8_t *bin, int len) {
 	if (len != 3 * FP_BYTES) {
 		THROW(ERR_NO_BUFFER);
+		return;
 	}
 	fp_read_bin(a[0], bin, FP_BYTES);
 	fp_read_bin(a[1], bin + FP_BYTES, FP_BYTES);
@@ -169,6 +171,7 @@ void fp3_read_bin(fp3_t a, uint8_t *bin, int len) {
 void fp3_write_bin(uint8_t *bin, int len, fp3_t a) {
 	if (len != 3 * FP_BYTES) {
 		THROW(ERR_NO_BUFFER);
+		return;
 	}
 	fp_write_bin(bin, FP_BYTES, a[0]);
 	fp_write_bin(bin + FP_BYTES, FP_BYTES, a[1]);
@@ -216,6 +219,7 @@ int fp6_size_bin(fp6_t a) {
 void fp6_read_bin(fp6_t a, uint8_t *bin, int len) {
 	if (len != 6 * FP_BYTES) {
 		THROW(ERR_NO_BUFFER);
+		return;
 	}
 	fp2_read_bin(a[0], bin, 2 * FP_BYTES);
 	fp2_read_bin(a[1], bin + 2 * FP_BYTES, 2 * FP_BYTES);
@@ -225,6 +229,7 @@ void fp6_read_bin(fp6_t a, uint8_t *bin, int len) {
 void fp6_write_bin(uint8_t *bin, int len, fp6_t a) {
 	if (len != 6 * FP_BYTES) {
 		THROW(ERR_NO_BUFFER);
+		return;
 	}
 	fp2_write_bin(bin, 2 * FP_BYTES, a[0], 0);
 	fp2_write_bin(bin + 2 * FP_BYTES, 2 * FP_BYTES, a[1], 0);
@@ -276,6 +281,7 @@ int fp12_size_bin(fp12_t a, int pack) {
 void fp12_read_bin(fp12_t a, uint8_t *bin, int len) {
 	if (len != 8 * FP_BYTES && len != 12 * FP_BYTES) {
 		THROW(ERR_NO_BUFFER);
+		return;
 	}
 	if (len == 8 * FP_BYTES) {
 		fp2_zero(a[0][0]);
@@ -297,22 +303,21 @@ void fp12_write_bin(uint8_t *bin, int len, fp12_t a, int pack) {
 
 	fp12_null(t);
 
+	if (len != (pack ? 8 : 12) * FP_BYTES) {
+		THROW(ERR_NO_BUFFER);
+		return;
+	}
+
 	TRY {
 		fp12_new(t);
 
 		if (pack) {
-			if (len != 8 * FP_BYTES) {
-				THROW(ERR_NO_BUFFER);
-			}
 			fp12_pck(t, a);
 			fp2_write_bin(bin, 2 * FP_BYTES, a[0][1], 0);
 			fp2_write_bin(bin + 2 * FP_BYTES, 2 * FP_BYTES, a[0][2], 0);
 			fp2_write_bin(bin + 4 * FP_BYTES, 2 * FP_BYTES, a[1][0], 0);
 			fp2_write_bin(bin + 6 * FP_BYTES, 2 * FP_BYTES, a[1][2], 0);
 		} else {
-			if (len != 12 * FP_BYTES) {
-				THROW(ERR_NO_BUFFER);
-			}
 			fp6_write_bin(bin, 6 * FP_BYTES, a[0]);
 			fp6_write_bin(bin + 6 * FP_BYTES, 6 * FP_BYTES, a[1]);
 		}
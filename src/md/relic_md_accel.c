@@ -0,0 +1,423 @@
+/*
+ * RELIC is an Efficient LIbrary for Cryptography
+ * Copyright (C) 2007-2015 RELIC Authors
+ *
+ * This file is part of RELIC. RELIC is legal property of its developers,
+ * whose names are not listed here. Please refer to the COPYRIGHT file
+ * for contact information.
+ *
+ * RELIC is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * RELIC is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with RELIC. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ *
+ * Implementation of the hardware-accelerated SHA compression functions used
+ * by the reference code and by the multi-buffer hash functions.
+ *
+ * @version $Id$
+ * @ingroup md
+ */
+
+#include <string.h>
+
+#include "relic_conf.h"
+#include "relic_arch.h"
+#include "sha.h"
+
+/*============================================================================*/
+/* Private definitions                                                        */
+/*============================================================================*/
+
+#if ARCH == X64 && defined(__GNUC__)
+
+#include <immintrin.h>
+
+/**
+ * Round constants of SHA-256.
+ */
+static const uint32_t sha256_k[64] = {
+	0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1,
+	0x923F82A4, 0xAB1C5ED5, 0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3,
+	0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174, 0xE49B69C1, 0xEFBE4786,
+	0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+	0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147,
+	0x06CA6351, 0x14292967, 0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13,
+	0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85, 0xA2BFE8A1, 0xA81A664B,
+	0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+	0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A,
+	0x5B9CCA4F, 0x682E6FF3, 0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208,
+	0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2
+};
+
+/**
+ * Rotates a 32-bit word to the right.
+ */
+#define ROTR(X, N)		(((X) >> (N)) | ((X) << (32 - (N))))
+
+/**
+ * Reads a big-endian 32-bit word.
+ *
+ * @param[in] p			- the bytes to read.
+ * @return the word.
+ */
+static inline uint32_t load_be32(const uint8_t *p) {
+	uint32_t w;
+
+	memcpy(&w, p, sizeof(w));
+	return __builtin_bswap32(w);
+}
+
+/**
+ * Compresses blocks with the SHA-256 instructions.
+ *
+ * @param[in,out] h		- the intermediate hash.
+ * @param[in] in		- the blocks to compress.
+ * @param[in] n			- the number of blocks.
+ */
+__attribute__((target("sha,sse4.1")))
+static void sha256_shani(uint32_t *h, const uint8_t *in, unsigned int n) {
+	__m128i s0, s1, t, k, save0, save1, w[4];
+	const __m128i mask = _mm_set_epi64x(0x0C0D0E0F08090A0BULL,
+			0x0405060700010203ULL);
+	int i;
+
+	/* Rearrange the state into the ABEF/CDGH layout of the instructions. */
+	t = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)h), 0xB1);
+	s1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)(h + 4)), 0x1B);
+	s0 = _mm_alignr_epi8(t, s1, 8);
+	s1 = _mm_blend_epi16(s1, t, 0xF0);
+
+	while (n-- > 0) {
+		save0 = s0;
+		save1 = s1;
+		for (i = 0; i < 16; i++) {
+			if (i < 4) {
+				t = _mm_loadu_si128((const __m128i *)(in + 16 * i));
+				w[i] = _mm_shuffle_epi8(t, mask);
+			} else {
+				t = _mm_alignr_epi8(w[(i + 3) & 3], w[(i + 2) & 3], 4);
+				t = _mm_add_epi32(_mm_sha256msg1_epu32(w[i & 3],
+								w[(i + 1) & 3]), t);
+				w[i & 3] = _mm_sha256msg2_epu32(t, w[(i + 3) & 3]);
+			}
+			k = _mm_loadu_si128((const __m128i *)(sha256_k + 4 * i));
+			t = _mm_add_epi32(w[i & 3], k);
+			s1 = _mm_sha256rnds2_epu32(s1, s0, t);
+			t = _mm_shuffle_epi32(t, 0x0E);
+			s0 = _mm_sha256rnds2_epu32(s0, s1, t);
+		}
+		s0 = _mm_add_epi32(s0, save0);
+		s1 = _mm_add_epi32(s1, save1);
+		in += SHA256_Message_Block_Size;
+	}
+
+	t = _mm_shuffle_epi32(s0, 0x1B);
+	s1 = _mm_shuffle_epi32(s1, 0xB1);
+	s0 = _mm_blend_epi16(t, s1, 0xF0);
+	s1 = _mm_alignr_epi8(s1, t, 8);
+	_mm_storeu_si128((__m128i *)h, s0);
+	_mm_storeu_si128((__m128i *)(h + 4), s1);
+}
+
+/**
+ * Performs four SHA-1 rounds with the round function selected by an
+ * immediate operand.
+ *
+ * @param[in] abcd		- the first four state words.
+ * @param[in] e			- the fifth state word added to the message.
+ * @param[in] f			- the index of the round function.
+ * @return the updated state words.
+ */
+__attribute__((target("sha,sse4.1")))
+static inline __m128i sha1_rnds4(__m128i abcd, __m128i e, int f) {
+	switch (f) {
+		case 0:
+			return _mm_sha1rnds4_epu32(abcd, e, 0);
+		case 1:
+			return _mm_sha1rnds4_epu32(abcd, e, 1);
+		case 2:
+			return _mm_sha1rnds4_epu32(abcd, e, 2);
+		default:
+			return _mm_sha1rnds4_epu32(abcd, e, 3);
+	}
+}
+
+/**
+ * Compresses blocks with the SHA-1 instructions.
+ *
+ * @param[in,out] h		- the intermediate hash.
+ * @param[in] in		- the blocks to compress.
+ * @param[in] n			- the number of blocks.
+ */
+__attribute__((target("sha,sse4.1")))
+static void sha1_shani(uint32_t *h, const uint8_t *in, unsigned int n) {
+	__m128i abcd, save, last, t, e[2], w[4];
+	const __m128i mask = _mm_set_epi64x(0x0001020304050607ULL,
+			0x08090A0B0C0D0E0FULL);
+	int i;
+
+	abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)h), 0x1B);
+	e[0] = _mm_set_epi32((int)h[4], 0, 0, 0);
+
+	while (n-- > 0) {
+		save = abcd;
+		last = e[0];
+		for (i = 0; i < 20; i++) {
+			if (i < 4) {
+				t = _mm_loadu_si128((const __m128i *)(in + 16 * i));
+				w[i] = _mm_shuffle_epi8(t, mask);
+			}
+			if (i == 0) {
+				e[0] = _mm_add_epi32(e[0], w[0]);
+			} else {
+				e[i & 1] = _mm_sha1nexte_epu32(e[i & 1], w[i & 3]);
+			}
+			e[(i + 1) & 1] = abcd;
+			if (i >= 3 && i <= 18) {
+				w[(i + 1) & 3] = _mm_sha1msg2_epu32(w[(i + 1) & 3], w[i & 3]);
+			}
+			abcd = sha1_rnds4(abcd, e[i & 1], i / 5);
+			if (i >= 1 && i <= 16) {
+				w[(i - 1) & 3] = _mm_sha1msg1_epu32(w[(i - 1) & 3], w[i & 3]);
+			}
+			if (i >= 2 && i <= 17) {
+				w[(i - 2) & 3] = _mm_xor_si128(w[(i - 2) & 3], w[i & 3]);
+			}
+		}
+		/* The last rounds left the state of A to become E in e[0]. */
+		e[0] = _mm_sha1nexte_epu32(e[0], last);
+		abcd = _mm_add_epi32(abcd, save);
+		in += SHA1_Message_Block_Size;
+	}
+
+	abcd = _mm_shuffle_epi32(abcd, 0x1B);
+	_mm_storeu_si128((__m128i *)h, abcd);
+	h[4] = (uint32_t)_mm_extract_epi32(e[0], 3);
+}
+
+/**
+ * Round constants of SHA-512.
+ */
+static const uint64_t sha512_k[80] = {
+	0x428A2F98D728AE22, 0x7137449123EF65CD, 0xB5C0FBCFEC4D3B2F,
+	0xE9B5DBA58189DBBC, 0x3956C25BF348B538, 0x59F111F1B605D019,
+	0x923F82A4AF194F9B, 0xAB1C5ED5DA6D8118, 0xD807AA98A3030242,
+	0x12835B0145706FBE, 0x243185BE4EE4B28C, 0x550C7DC3D5FFB4E2,
+	0x72BE5D74F27B896F, 0x80DEB1FE3B1696B1, 0x9BDC06A725C71235,
+	0xC19BF174CF692694, 0xE49B69C19EF14AD2, 0xEFBE4786384F25E3,
+	0x0FC19DC68B8CD5B5, 0x240CA1CC77AC9C65, 0x2DE92C6F592B0275,
+	0x4A7484AA6EA6E483, 0x5CB0A9DCBD41FBD4, 0x76F988DA831153B5,
+	0x983E5152EE66DFAB, 0xA831C66D2DB43210, 0xB00327C898FB213F,
+	0xBF597FC7BEEF0EE4, 0xC6E00BF33DA88FC2, 0xD5A79147930AA725,
+	0x06CA6351E003826F, 0x142929670A0E6E70, 0x27B70A8546D22FFC,
+	0x2E1B21385C26C926, 0x4D2C6DFC5AC42AED, 0x53380D139D95B3DF,
+	0x650A73548BAF63DE, 0x766A0ABB3C77B2A8, 0x81C2C92E47EDAEE6,
+	0x92722C851482353B, 0xA2BFE8A14CF10364, 0xA81A664BBC423001,
+	0xC24B8B70D0F89791, 0xC76C51A30654BE30, 0xD192E819D6EF5218,
+	0xD69906245565A910, 0xF40E35855771202A, 0x106AA07032BBD1B8,
+	0x19A4C116B8D2D0C8, 0x1E376C085141AB53, 0x2748774CDF8EEB99,
+	0x34B0BCB5E19B48A8, 0x391C0CB3C5C95A63, 0x4ED8AA4AE3418ACB,
+	0x5B9CCA4F7763E373, 0x682E6FF3D6B2B8A3, 0x748F82EE5DEFB2FC,
+	0x78A5636F43172F60, 0x84C87814A1F0AB72, 0x8CC702081A6439EC,
+	0x90BEFFFA23631E28, 0xA4506CEBDE82BDE9, 0xBEF9A3F7B2C67915,
+	0xC67178F2E372532B, 0xCA273ECEEA26619C, 0xD186B8C721C0C207,
+	0xEADA7DD6CDE0EB1E, 0xF57D4F7FEE6ED178, 0x06F067AA72176FBA,
+	0x0A637DC5A2C898A6, 0x113F9804BEF90DAE, 0x1B710B35131C471B,
+	0x28DB77F523047D84, 0x32CAAB7B40C72493, 0x3C9EBE0A15C9BEBC,
+	0x431D67C49C100D4C, 0x4CC5D4BECB3E42B6, 0x597F299CFC657E2A,
+	0x5FCB6FAB3AD6FAEC, 0x6C44198C4A475817
+};
+
+/**
+ * Eight 32-bit lanes of an AVX2 register.
+ */
+typedef uint32_t sha256_v __attribute__((vector_size(32)));
+
+/**
+ * Four 64-bit lanes of an AVX2 register.
+ */
+typedef uint64_t sha512_v __attribute__((vector_size(32)));
+
+/**
+ * Reads a big-endian 64-bit word.
+ *
+ * @param[in] p			- the bytes to read.
+ * @return the word.
+ */
+static inline uint64_t load_be64(const uint8_t *p) {
+	uint64_t w;
+
+	memcpy(&w, p, sizeof(w));
+	return __builtin_bswap64(w);
+}
+
+/**
+ * Compresses one block of each of eight independent SHA-256 computations,
+ * one per 32-bit lane.
+ *
+ * @param[in,out] h		- the intermediate hashes, indexed by word and lane.
+ * @param[in] in		- the block of each lane.
+ */
+__attribute__((target("avx2")))
+static void sha256_lanes(uint32_t h[8][8], const uint8_t *in[8]) {
+	sha256_v w[16], v[8], t1, t2;
+	int i, l;
+
+	for (i = 0; i < 16; i++) {
+		for (l = 0; l < 8; l++) {
+			w[i][l] = load_be32(in[l] + 4 * i);
+		}
+	}
+	for (i = 0; i < 8; i++) {
+		memcpy(&v[i], h[i], sizeof(v[i]));
+	}
+	for (i = 0; i < 64; i++) {
+		if (i >= 16) {
+			t1 = w[(i - 2) & 15];
+			t2 = w[(i - 15) & 15];
+			w[i & 15] += (ROTR(t1, 17) ^ ROTR(t1, 19) ^ (t1 >> 10)) +
+					w[(i - 7) & 15] + (ROTR(t2, 7) ^ ROTR(t2, 18) ^ (t2 >> 3));
+		}
+		t1 = v[7] + (ROTR(v[4], 6) ^ ROTR(v[4], 11) ^ ROTR(v[4], 25)) +
+				((v[4] & v[5]) ^ (~v[4] & v[6])) + sha256_k[i] + w[i & 15];
+		t2 = (ROTR(v[0], 2) ^ ROTR(v[0], 13) ^ ROTR(v[0], 22)) +
+				((v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]));
+		v[7] = v[6];
+		v[6] = v[5];
+		v[5] = v[4];
+		v[4] = v[3] + t1;
+		v[3] = v[2];
+		v[2] = v[1];
+		v[1] = v[0];
+		v[0] = t1 + t2;
+	}
+	for (i = 0; i < 8; i++) {
+		memcpy(&t1, h[i], sizeof(t1));
+		t1 += v[i];
+		memcpy(h[i], &t1, sizeof(t1));
+	}
+}
+
+/**
+ * Rotates a 64-bit word to the right.
+ */
+#define ROTR64(X, N)	(((X) >> (N)) | ((X) << (64 - (N))))
+
+/**
+ * Compresses one block of each of four independent SHA-512 computations,
+ * one per 64-bit lane.
+ *
+ * @param[in,out] h		- the intermediate hashes, indexed by word and lane.
+ * @param[in] in		- the block of each lane.
+ */
+__attribute__((target("avx2")))
+static void sha512_lanes(uint64_t h[8][4], const uint8_t *in[4]) {
+	sha512_v w[16], v[8], t1, t2;
+	int i, l;
+
+	for (i = 0; i < 16; i++) {
+		for (l = 0; l < 4; l++) {
+			w[i][l] = load_be64(in[l] + 8 * i);
+		}
+	}
+	for (i = 0; i < 8; i++) {
+		memcpy(&v[i], h[i], sizeof(v[i]));
+	}
+	for (i = 0; i < 80; i++) {
+		if (i >= 16) {
+			t1 = w[(i - 2) & 15];
+			t2 = w[(i - 15) & 15];
+			w[i & 15] += (ROTR64(t1, 19) ^ ROTR64(t1, 61) ^ (t1 >> 6)) +
+					w[(i - 7) & 15] + (ROTR64(t2, 1) ^ ROTR64(t2, 8) ^ (t2 >> 7));
+		}
+		t1 = v[7] + (ROTR64(v[4], 14) ^ ROTR64(v[4], 18) ^ ROTR64(v[4], 41)) +
+				((v[4] & v[5]) ^ (~v[4] & v[6])) + sha512_k[i] + w[i & 15];
+		t2 = (ROTR64(v[0], 28) ^ ROTR64(v[0], 34) ^ ROTR64(v[0], 39)) +
+				((v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]));
+		v[7] = v[6];
+		v[6] = v[5];
+		v[5] = v[4];
+		v[4] = v[3] + t1;
+		v[3] = v[2];
+		v[2] = v[1];
+		v[1] = v[0];
+		v[0] = t1 + t2;
+	}
+	for (i = 0; i < 8; i++) {
+		memcpy(&t1, h[i], sizeof(t1));
+		t1 += v[i];
+		memcpy(h[i], &t1, sizeof(t1));
+	}
+}
+
+#endif
+
+/*============================================================================*/
+/* Public definitions                                                         */
+/*============================================================================*/
+
+int SHA1ProcessBlocks(uint32_t *h, const uint8_t *in, unsigned int n) {
+#if ARCH == X64 && defined(__GNUC__)
+	if (arch_features() & ARCH_SHANI) {
+		sha1_shani(h, in, n);
+		return 1;
+	}
+#else
+	(void)h;
+	(void)in;
+	(void)n;
+#endif
+	return 0;
+}
+
+int SHA256ProcessBlocks(uint32_t *h, const uint8_t *in, unsigned int n) {
+#if ARCH == X64 && defined(__GNUC__)
+	if (arch_features() & ARCH_SHANI) {
+		sha256_shani(h, in, n);
+		return 1;
+	}
+#else
+	(void)h;
+	(void)in;
+	(void)n;
+#endif
+	return 0;
+}
+
+int SHA256ProcessLanes(uint32_t h[8][8], const uint8_t *in[8]) {
+#if ARCH == X64 && defined(__GNUC__)
+	if (arch_features() & ARCH_AVX2) {
+		sha256_lanes(h, in);
+		return 1;
+	}
+#else
+	(void)h;
+	(void)in;
+#endif
+	return 0;
+}
+
+int SHA512ProcessLanes(uint64_t h[8][4], const uint8_t *in[4]) {
+#if ARCH == X64 && defined(__GNUC__)
+	if (arch_features() & ARCH_AVX2) {
+		sha512_lanes(h, in);
+		return 1;
+	}
+#else
+	(void)h;
+	(void)in;
+#endif
+	return 0;
+}
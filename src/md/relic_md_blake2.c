@@ -0,0 +1,293 @@
+/*
+ * RELIC is an Efficient LIbrary for Cryptography
+ * Copyright (C) 2007-2015 RELIC Authors
+ *
+ * This file is part of RELIC. RELIC is legal property of its developers,
+ * whose names are not listed here. Please refer to the COPYRIGHT file
+ * for contact information.
+ *
+ * RELIC is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * RELIC is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with RELIC. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ *
+ * Implementation of the BLAKE2s and BLAKE2b hash functions.
+ *
+ * @version $Id$
+ * @ingroup md
+ */
+
+#include <string.h>
+
+#include "relic_conf.h"
+#include "relic_core.h"
+#include "relic_md.h"
+
+/*============================================================================*/
+/* Private definitions                                                        */
+/*============================================================================*/
+
+/**
+ * Message word permutations of each round.
+ */
+static const uint8_t blake2_sigma[12][16] = {
+	{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+	{14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3},
+	{11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4},
+	{7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8},
+	{9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13},
+	{2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9},
+	{12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11},
+	{13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10},
+	{6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5},
+	{10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0},
+	{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+	{14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3}
+};
+
+/**
+ * Initialization vector of BLAKE2s.
+ */
+static const uint32_t blake2s_iv[8] = {
+	0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+	0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+};
+
+/**
+ * Initialization vector of BLAKE2b.
+ */
+static const uint64_t blake2b_iv[8] = {
+	0x6A09E667F3BCC908, 0xBB67AE8584CAA73B, 0x3C6EF372FE94F82B,
+	0xA54FF53A5F1D36F1, 0x510E527FADE682D1, 0x9B05688C2B3E6C1F,
+	0x1F83D9ABFB41BD6B, 0x5BE0CD19137E2179
+};
+
+/**
+ * Rotates a 32-bit word to the right.
+ */
+#define ROTR32(X, N)	(((X) >> (N)) | ((X) << (32 - (N))))
+
+/**
+ * Rotates a 64-bit word to the right.
+ */
+#define ROTR64(X, N)	(((X) >> (N)) | ((X) << (64 - (N))))
+
+/**
+ * Mixing function of BLAKE2s.
+ */
+#define G32(A, B, C, D, X, Y)												\
+	A = A + B + X; D = ROTR32(D ^ A, 16);									\
+	C = C + D; B = ROTR32(B ^ C, 12);										\
+	A = A + B + Y; D = ROTR32(D ^ A, 8);									\
+	C = C + D; B = ROTR32(B ^ C, 7);
+
+/**
+ * Mixing function of BLAKE2b.
+ */
+#define G64(A, B, C, D, X, Y)												\
+	A = A + B + X; D = ROTR64(D ^ A, 32);									\
+	C = C + D; B = ROTR64(B ^ C, 24);										\
+	A = A + B + Y; D = ROTR64(D ^ A, 16);									\
+	C = C + D; B = ROTR64(B ^ C, 63);
+
+/**
+ * Compresses a block into the state of BLAKE2s.
+ *
+ * @param[in,out] ctx		- the context.
+ * @param[in] last			- the flag to indicate the last block.
+ */
+static void blake2s_compress(md_b2s_256_t *ctx, int last) {
+	uint32_t m[16], v[16];
+	const uint8_t *s;
+	int i, r;
+
+	for (i = 0; i < 16; i++) {
+		m[i] = (uint32_t)ctx->buf[4 * i] |
+				((uint32_t)ctx->buf[4 * i + 1] << 8) |
+				((uint32_t)ctx->buf[4 * i + 2] << 16) |
+				((uint32_t)ctx->buf[4 * i + 3] << 24);
+	}
+	for (i = 0; i < 8; i++) {
+		v[i] = ctx->h[i];
+		v[i + 8] = blake2s_iv[i];
+	}
+	v[12] ^= ctx->t[0];
+	v[13] ^= ctx->t[1];
+	if (last) {
+		v[14] = ~v[14];
+	}
+	for (r = 0; r < 10; r++) {
+		s = blake2_sigma[r];
+		G32(v[0], v[4], v[8], v[12], m[s[0]], m[s[1]]);
+		G32(v[1], v[5], v[9], v[13], m[s[2]], m[s[3]]);
+		G32(v[2], v[6], v[10], v[14], m[s[4]], m[s[5]]);
+		G32(v[3], v[7], v[11], v[15], m[s[6]], m[s[7]]);
+		G32(v[0], v[5], v[10], v[15], m[s[8]], m[s[9]]);
+		G32(v[1], v[6], v[11], v[12], m[s[10]], m[s[11]]);
+		G32(v[2], v[7], v[8], v[13], m[s[12]], m[s[13]]);
+		G32(v[3], v[4], v[9], v[14], m[s[14]], m[s[15]]);
+	}
+	for (i = 0; i < 8; i++) {
+		ctx->h[i] ^= v[i] ^ v[i + 8];
+	}
+}
+
+/**
+ * Compresses a block into the state of BLAKE2b.
+ *
+ * @param[in,out] ctx		- the context.
+ * @param[in] last			- the flag to indicate the last block.
+ */
+static void blake2b_compress(md_b2b_512_t *ctx, int last) {
+	uint64_t m[16], v[16];
+	const uint8_t *s;
+	int i, j, r;
+
+	for (i = 0; i < 16; i++) {
+		m[i] = 0;
+		for (j = 7; j >= 0; j--) {
+			m[i] = (m[i] << 8) | ctx->buf[8 * i + j];
+		}
+	}
+	for (i = 0; i < 8; i++) {
+		v[i] = ctx->h[i];
+		v[i + 8] = blake2b_iv[i];
+	}
+	v[12] ^= ctx->t[0];
+	v[13] ^= ctx->t[1];
+	if (last) {
+		v[14] = ~v[14];
+	}
+	for (r = 0; r < 12; r++) {
+		s = blake2_sigma[r];
+		G64(v[0], v[4], v[8], v[12], m[s[0]], m[s[1]]);
+		G64(v[1], v[5], v[9], v[13], m[s[2]], m[s[3]]);
+		G64(v[2], v[6], v[10], v[14], m[s[4]], m[s[5]]);
+		G64(v[3], v[7], v[11], v[15], m[s[6]], m[s[7]]);
+		G64(v[0], v[5], v[10], v[15], m[s[8]], m[s[9]]);
+		G64(v[1], v[6], v[11], v[12], m[s[10]], m[s[11]]);
+		G64(v[2], v[7], v[8], v[13], m[s[12]], m[s[13]]);
+		G64(v[3], v[4], v[9], v[14], m[s[14]], m[s[15]]);
+	}
+	for (i = 0; i < 8; i++) {
+		ctx->h[i] ^= v[i] ^ v[i + 8];
+	}
+}
+
+/*============================================================================*/
+/* Public definitions                                                         */
+/*============================================================================*/
+
+#if MD_MAP == B2S_256 || !defined(STRIP)
+
+void md_b2s_256_init(md_b2s_256_t *ctx) {
+	memcpy(ctx->h, blake2s_iv, sizeof(ctx->h));
+	/* Parameter block: digest length, no key, fanout and depth of one. */
+	ctx->h[0] ^= 0x01010000 ^ MD_LEN_B2S_256;
+	ctx->t[0] = ctx->t[1] = 0;
+	ctx->len = 0;
+}
+
+void md_b2s_256_update(md_b2s_256_t *ctx, const uint8_t *msg, int len) {
+	int l;
+
+	while (len > 0) {
+		/* The last block is kept until finalization. */
+		if (ctx->len == sizeof(ctx->buf)) {
+			ctx->t[0] += sizeof(ctx->buf);
+			ctx->t[1] += (ctx->t[0] < sizeof(ctx->buf));
+			blake2s_compress(ctx, 0);
+			ctx->len = 0;
+		}
+		l = MIN(len, (int)sizeof(ctx->buf) - ctx->len);
+		memcpy(ctx->buf + ctx->len, msg, l);
+		ctx->len += l;
+		msg += l;
+		len -= l;
+	}
+}
+
+void md_b2s_256_final(md_b2s_256_t *ctx, uint8_t *hash) {
+	int i;
+
+	ctx->t[0] += ctx->len;
+	ctx->t[1] += (ctx->t[0] < (uint32_t)ctx->len);
+	memset(ctx->buf + ctx->len, 0, sizeof(ctx->buf) - ctx->len);
+	blake2s_compress(ctx, 1);
+	for (i = 0; i < MD_LEN_B2S_256; i++) {
+		hash[i] = (uint8_t)(ctx->h[i / 4] >> (8 * (i % 4)));
+	}
+}
+
+void md_map_b2s_256(uint8_t *hash, const uint8_t *msg, int len) {
+	md_b2s_256_t ctx;
+
+	md_b2s_256_init(&ctx);
+	md_b2s_256_update(&ctx, msg, len);
+	md_b2s_256_final(&ctx, hash);
+}
+
+#endif
+
+#if MD_MAP == B2B_512 || !defined(STRIP)
+
+void md_b2b_512_init(md_b2b_512_t *ctx) {
+	memcpy(ctx->h, blake2b_iv, sizeof(ctx->h));
+	/* Parameter block: digest length, no key, fanout and depth of one. */
+	ctx->h[0] ^= 0x01010000 ^ MD_LEN_B2B_512;
+	ctx->t[0] = ctx->t[1] = 0;
+	ctx->len = 0;
+}
+
+void md_b2b_512_update(md_b2b_512_t *ctx, const uint8_t *msg, int len) {
+	int l;
+
+	while (len > 0) {
+		/* The last block is kept until finalization. */
+		if (ctx->len == sizeof(ctx->buf)) {
+			ctx->t[0] += sizeof(ctx->buf);
+			ctx->t[1] += (ctx->t[0] < sizeof(ctx->buf));
+			blake2b_compress(ctx, 0);
+			ctx->len = 0;
+		}
+		l = MIN(len, (int)sizeof(ctx->buf) - ctx->len);
+		memcpy(ctx->buf + ctx->len, msg, l);
+		ctx->len += l;
+		msg += l;
+		len -= l;
+	}
+}
+
+void md_b2b_512_final(md_b2b_512_t *ctx, uint8_t *hash) {
+	int i;
+
+	ctx->t[0] += ctx->len;
+	ctx->t[1] += (ctx->t[0] < (uint64_t)ctx->len);
+	memset(ctx->buf + ctx->len, 0, sizeof(ctx->buf) - ctx->len);
+	blake2b_compress(ctx, 1);
+	for (i = 0; i < MD_LEN_B2B_512; i++) {
+		hash[i] = (uint8_t)(ctx->h[i / 8] >> (8 * (i % 8)));
+	}
+}
+
+void md_map_b2b_512(uint8_t *hash, const uint8_t *msg, int len) {
+	md_b2b_512_t ctx;
+
+	md_b2b_512_init(&ctx);
+	md_b2b_512_update(&ctx, msg, len);
+	md_b2b_512_final(&ctx, hash);
+}
+
+#endif
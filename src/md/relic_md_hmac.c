@@ -40,32 +40,54 @@
 /* Public definitions                                                         */
 /*============================================================================*/
 
-void md_hmac(uint8_t *mac, const uint8_t *in, int in_len, const uint8_t *key,
-		int key_len) {
-#if MD_MAP == SHONE || MD_MAP == SH224 || MD_MAP == SH256
-	int block_size = 64;
-#elif MD_MAP == SH384 || MD_MAP == SH512
-	int block_size = 128;
-#endif
-	uint8_t opad[block_size + MD_LEN], ipad[block_size + in_len];
+void md_hmac_init(md_hmac_t *ctx, const uint8_t *key, int key_len) {
+	uint8_t pad[MD_BLOCK], _key[MD_BLOCK];
+	int i;
 
-	if (key_len > block_size) {
-		uint8_t _key[MD_LEN];
+	if (key_len > MD_BLOCK) {
 		md_map(_key, key, key_len);
-		key = _key;
 		key_len = MD_LEN;
-	}
-	if (key_len < block_size) {
-		uint8_t _key[block_size];
+	} else {
 		memcpy(_key, key, key_len);
-		memset(_key + key_len, 0, block_size - key_len);
-		key = _key;
 	}
-	for (int i = 0; i < block_size; i++) {
-		opad[i] = 0x5C ^ key[i];
-		ipad[i] = 0x36 ^ key[i];
+	memset(_key + key_len, 0, MD_BLOCK - key_len);
+	/* Absorb K ^ ipad and K ^ opad once and keep the resulting states. */
+	for (i = 0; i < MD_BLOCK; i++) {
+		pad[i] = 0x36 ^ _key[i];
+	}
+	md_init(&ctx->inner);
+	md_update(&ctx->inner, pad, MD_BLOCK);
+	for (i = 0; i < MD_BLOCK; i++) {
+		pad[i] = 0x5C ^ _key[i];
 	}
-	memcpy(ipad + block_size, in, in_len);
-	md_map(opad + block_size, ipad, block_size + in_len);
-	md_map(mac, opad, block_size + MD_LEN);
+	md_init(&ctx->outer);
+	md_update(&ctx->outer, pad, MD_BLOCK);
+	ctx->ctx = ctx->inner;
+	memset(_key, 0, sizeof(_key));
+	memset(pad, 0, sizeof(pad));
+}
+
+void md_hmac_update(md_hmac_t *ctx, const uint8_t *in, int in_len) {
+	md_update(&ctx->ctx, in, in_len);
+}
+
+void md_hmac_final(md_hmac_t *ctx, uint8_t *mac) {
+	uint8_t h[MD_LEN];
+
+	/* h = H((K ^ ipad) || in). */
+	md_final(&ctx->ctx, h);
+	/* mac = H((K ^ opad) || h). */
+	ctx->ctx = ctx->outer;
+	md_update(&ctx->ctx, h, MD_LEN);
+	md_final(&ctx->ctx, mac);
+	ctx->ctx = ctx->inner;
+}
+
+void md_hmac(uint8_t *mac, const uint8_t *in, int in_len, const uint8_t *key,
+		int key_len) {
+	md_hmac_t ctx;
+
+	md_hmac_init(&ctx, key, key_len);
+	md_hmac_update(&ctx, in, in_len);
+	md_hmac_final(&ctx, mac);
 }
@@ -43,37 +43,94 @@
 void md_kdf1(uint8_t *key, int key_len, const uint8_t *in,
 		int in_len) {
 	uint32_t i, j, d;
-	uint8_t buffer[in_len + sizeof(uint32_t)];
-	uint8_t t[key_len + MD_LEN];
+	uint8_t t[MD_LEN];
+	md_ctx_t ctx, pre;
 
+	/* Absorb the shared secret once and reuse the state for each counter. */
+	md_init(&pre);
+	md_update(&pre, in, in_len);
 	/* d = ceil(kLen/hLen). */
 	d = CEIL(key_len, MD_LEN);
-	memcpy(buffer, in, in_len);
 	for (i = 0; i < d; i++) {
-		j = util_conv_big(i);
 		/* c = integer_to_string(c, 4). */
-		memcpy(buffer + in_len, &j, sizeof(uint32_t));
+		j = util_conv_big(i);
 		/* t = t || hash(z || c). */
-		md_map(t + i * MD_LEN, buffer, in_len + sizeof(uint32_t));
+		ctx = pre;
+		md_update(&ctx, (uint8_t *)&j, sizeof(uint32_t));
+		md_final(&ctx, t);
+		memcpy(key + i * MD_LEN, t, MIN(MD_LEN, key_len - i * MD_LEN));
 	}
-	memcpy(key, t, key_len);
 }
 
 void md_kdf2(uint8_t *key, int key_len, const uint8_t *in,
 		int in_len) {
 	uint32_t i, j, d;
-	uint8_t buffer[in_len + sizeof(uint32_t)];
-	uint8_t t[key_len + MD_LEN];
+	uint8_t t[MD_LEN];
+	md_ctx_t ctx, pre;
 
+	/* Absorb the shared secret once and reuse the state for each counter. */
+	md_init(&pre);
+	md_update(&pre, in, in_len);
 	/* d = ceil(kLen/hLen). */
 	d = CEIL(key_len, MD_LEN);
-	memcpy(buffer, in, in_len);
 	for (i = 1; i <= d; i++) {
-		j = util_conv_big(i);
 		/* c = integer_to_string(c, 4). */
-		memcpy(buffer + in_len, &j, sizeof(uint32_t));
+		j = util_conv_big(i);
 		/* t = t || hash(z || c). */
-		md_map(t + (i - 1) * MD_LEN, buffer, in_len + sizeof(uint32_t));
+		ctx = pre;
+		md_update(&ctx, (uint8_t *)&j, sizeof(uint32_t));
+		md_final(&ctx, t);
+		memcpy(key + (i - 1) * MD_LEN, t,
+				MIN(MD_LEN, key_len - (i - 1) * MD_LEN));
 	}
-	memcpy(key, t, key_len);
+}
+
+void md_hkdf_ext(uint8_t *prk, const uint8_t *salt, int salt_len,
+		const uint8_t *in, int in_len) {
+	uint8_t zero[MD_LEN];
+
+	/* An absent salt is replaced by MD_LEN zero bytes. */
+	if (salt_len == 0) {
+		memset(zero, 0, MD_LEN);
+		salt = zero;
+		salt_len = MD_LEN;
+	}
+	/* PRK = HMAC(salt, IKM). */
+	md_hmac(prk, in, in_len, salt, salt_len);
+}
+
+void md_hkdf_exp(uint8_t *key, int key_len, const uint8_t *prk, int prk_len,
+		const uint8_t *info, int info_len) {
+	uint8_t t[MD_LEN], c;
+	int i, n;
+	md_hmac_t ctx;
+
+	/* N = ceil(L/HashLen) must not exceed 255. */
+	n = CEIL(key_len, MD_LEN);
+	if (n > 255) {
+		THROW(ERR_NO_VALID);
+		return;
+	}
+
+	md_hmac_init(&ctx, prk, prk_len);
+	for (i = 1; i <= n; i++) {
+		/* T(i) = HMAC(PRK, T(i - 1) || info || i). */
+		if (i > 1) {
+			md_hmac_update(&ctx, t, MD_LEN);
+		}
+		md_hmac_update(&ctx, info, info_len);
+		c = (uint8_t)i;
+		md_hmac_update(&ctx, &c, 1);
+		md_hmac_final(&ctx, t);
+		memcpy(key + (i - 1) * MD_LEN, t,
+				MIN(MD_LEN, key_len - (i - 1) * MD_LEN));
+	}
+}
+
+void md_hkdf(uint8_t *key, int key_len, const uint8_t *in, int in_len,
+		const uint8_t *salt, int salt_len, const uint8_t *info, int info_len) {
+	uint8_t prk[MD_LEN];
+
+	md_hkdf_ext(prk, salt, salt_len, in, in_len);
+	md_hkdf_exp(key, key_len, prk, MD_LEN, info, info_len);
 }
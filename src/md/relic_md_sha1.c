@@ -37,26 +37,48 @@
 #include "relic_md.h"
 #include "sha.h"
 
+/*============================================================================*/
+/* Private definitions                                                        */
+/*============================================================================*/
+
+/**
+ * Fails to compile if the public context cannot hold the internal one.
+ */
+typedef char md_shone_fits[
+		sizeof(md_shone_t) >= sizeof(SHA1Context) ? 1 : -1];
+
 /*============================================================================*/
 /* Public definitions                                                         */
 /*============================================================================*/
 
 #if MD_MAP == SHONE || !defined(STRIP)
 
-void md_map_shone(uint8_t *hash, const uint8_t *msg, int len) {
-	SHA1Context ctx;
-
-	if (SHA1Reset(&ctx) != shaSuccess) {
+void md_shone_init(md_shone_t *ctx) {
+	if (SHA1Reset((SHA1Context *)ctx->state) != shaSuccess) {
 		THROW(ERR_NO_VALID);
 	}
-	if (SHA1Input(&ctx, msg, len) != shaSuccess) {
+}
+
+void md_shone_update(md_shone_t *ctx, const uint8_t *msg, int len) {
+	if (SHA1Input((SHA1Context *)ctx->state, msg, len) != shaSuccess) {
 		THROW(ERR_NO_VALID);
 	}
-	if (SHA1Result(&ctx, hash) != shaSuccess) {
+}
+
+void md_shone_final(md_shone_t *ctx, uint8_t *hash) {
+	if (SHA1Result((SHA1Context *)ctx->state, hash) != shaSuccess) {
 		THROW(ERR_NO_VALID);
 	}
 }
 
+void md_map_shone(uint8_t *hash, const uint8_t *msg, int len) {
+	md_shone_t ctx;
+
+	md_shone_init(&ctx);
+	md_shone_update(&ctx, msg, len);
+	md_shone_final(&ctx, hash);
+}
+
 #endif
 
 #if RAND == FIPS
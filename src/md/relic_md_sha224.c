@@ -34,24 +34,46 @@
 #include "relic_md.h"
 #include "sha.h"
 
+/*============================================================================*/
+/* Private definitions                                                        */
+/*============================================================================*/
+
+/**
+ * Fails to compile if the public context cannot hold the internal one.
+ */
+typedef char md_sh224_fits[
+		sizeof(md_sh224_t) >= sizeof(SHA224Context) ? 1 : -1];
+
 /*============================================================================*/
 /* Public definitions                                                         */
 /*============================================================================*/
 
 #if MD_MAP == SH224 || !defined(STRIP)
 
-void md_map_sh224(uint8_t *hash, const uint8_t *msg, int len) {
-	SHA224Context ctx;
-
-	if (SHA224Reset(&ctx) != shaSuccess) {
+void md_sh224_init(md_sh224_t *ctx) {
+	if (SHA224Reset((SHA224Context *)ctx->state) != shaSuccess) {
 		THROW(ERR_NO_VALID);
 	}
-	if (SHA224Input(&ctx, msg, len) != shaSuccess) {
+}
+
+void md_sh224_update(md_sh224_t *ctx, const uint8_t *msg, int len) {
+	if (SHA224Input((SHA224Context *)ctx->state, msg, len) != shaSuccess) {
 		THROW(ERR_NO_VALID);
 	}
-	if (SHA224Result(&ctx, hash) != shaSuccess) {
+}
+
+void md_sh224_final(md_sh224_t *ctx, uint8_t *hash) {
+	if (SHA224Result((SHA224Context *)ctx->state, hash) != shaSuccess) {
 		THROW(ERR_NO_VALID);
 	}
 }
 
+void md_map_sh224(uint8_t *hash, const uint8_t *msg, int len) {
+	md_sh224_t ctx;
+
+	md_sh224_init(&ctx);
+	md_sh224_update(&ctx, msg, len);
+	md_sh224_final(&ctx, hash);
+}
+
 #endif
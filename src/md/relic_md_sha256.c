@@ -29,29 +29,128 @@
  * @ingroup md
  */
 
+#include <string.h>
+
 #include "relic_conf.h"
 #include "relic_core.h"
 #include "relic_md.h"
 #include "sha.h"
 
+/*============================================================================*/
+/* Private definitions                                                        */
+/*============================================================================*/
+
+/**
+ * Fails to compile if the public context cannot hold the internal one.
+ */
+typedef char md_sh256_fits[
+		sizeof(md_sh256_t) >= sizeof(SHA256Context) ? 1 : -1];
+
+/**
+ * Number of messages hashed in parallel by md_map_sh256_x8().
+ */
+#define LANES		8
+
 /*============================================================================*/
 /* Public definitions                                                         */
 /*============================================================================*/
 
 #if MD_MAP == SH256 || !defined(STRIP)
 
-void md_map_sh256(uint8_t *hash, const uint8_t *msg, int len) {
-	SHA256Context ctx;
+void md_sh256_init(md_sh256_t *ctx) {
+	if (SHA256Reset((SHA256Context *)ctx->state) != shaSuccess) {
+		THROW(ERR_NO_VALID);
+	}
+}
 
-	if (SHA256Reset(&ctx) != shaSuccess) {
+void md_sh256_update(md_sh256_t *ctx, const uint8_t *msg, int len) {
+	if (SHA256Input((SHA256Context *)ctx->state, msg, len) != shaSuccess) {
 		THROW(ERR_NO_VALID);
 	}
-	if (SHA256Input(&ctx, msg, len) != shaSuccess) {
+}
+
+void md_sh256_final(md_sh256_t *ctx, uint8_t *hash) {
+	if (SHA256Result((SHA256Context *)ctx->state, hash) != shaSuccess) {
 		THROW(ERR_NO_VALID);
 	}
-	if (SHA256Result(&ctx, hash) != shaSuccess) {
+}
+
+void md_map_sh256(uint8_t *hash, const uint8_t *msg, int len) {
+	md_sh256_t ctx;
+
+	md_sh256_init(&ctx);
+	md_sh256_update(&ctx, msg, len);
+	md_sh256_final(&ctx, hash);
+}
+
+void md_map_sh256_x8(uint8_t **hash, uint8_t **msg, int *len, int n) {
+	SHA256Context ctx;
+	uint32_t h[8][LANES];
+	uint8_t pad[LANES][2 * SHA256_Message_Block_Size];
+	uint8_t zero[SHA256_Message_Block_Size] = { 0 };
+	const uint8_t *in[LANES];
+	int i, j, l, m, r, full[LANES], blocks[LANES], max;
+	uint64_t bits;
+
+	if (SHA256Reset(&ctx) != shaSuccess) {
 		THROW(ERR_NO_VALID);
 	}
+
+	for (i = 0; i < n; i += LANES) {
+		m = MIN(LANES, n - i);
+		max = 0;
+		/* Pad the tail of each message into one or two separate blocks. */
+		for (l = 0; l < LANES; l++) {
+			for (j = 0; j < 8; j++) {
+				h[j][l] = ctx.Intermediate_Hash[j];
+			}
+			blocks[l] = full[l] = 0;
+			if (l < m) {
+				full[l] = len[i + l] / SHA256_Message_Block_Size;
+				r = len[i + l] % SHA256_Message_Block_Size;
+				blocks[l] = full[l] + (r < SHA256_Message_Block_Size - 8 ? 1 : 2);
+				memset(pad[l], 0, sizeof(pad[l]));
+				memcpy(pad[l], msg[i + l] + full[l] * SHA256_Message_Block_Size,
+						r);
+				pad[l][r] = 0x80;
+				r = (blocks[l] - full[l]) * SHA256_Message_Block_Size;
+				bits = (uint64_t)len[i + l] << 3;
+				for (j = 1; j <= 8; j++, bits >>= 8) {
+					pad[l][r - j] = (uint8_t)bits;
+				}
+				max = MAX(max, blocks[l]);
+			}
+		}
+		for (j = 0; j < max; j++) {
+			for (l = 0; l < LANES; l++) {
+				if (j >= blocks[l]) {
+					in[l] = zero;
+				} else if (j < full[l]) {
+					in[l] = msg[i + l] + j * SHA256_Message_Block_Size;
+				} else {
+					in[l] = pad[l] + (j - full[l]) * SHA256_Message_Block_Size;
+				}
+			}
+			if (!SHA256ProcessLanes(h, in)) {
+				/* No vector unit, so hash the remaining messages in turn. */
+				for (l = i; l < n; l++) {
+					md_map_sh256(hash[l], msg[l], len[l]);
+				}
+				return;
+			}
+			/* Lanes that finished are read out before they are reused. */
+			for (l = 0; l < m; l++) {
+				if (j == blocks[l] - 1) {
+					for (r = 0; r < 8; r++) {
+						hash[i + l][4 * r] = (uint8_t)(h[r][l] >> 24);
+						hash[i + l][4 * r + 1] = (uint8_t)(h[r][l] >> 16);
+						hash[i + l][4 * r + 2] = (uint8_t)(h[r][l] >> 8);
+						hash[i + l][4 * r + 3] = (uint8_t)h[r][l];
+					}
+				}
+			}
+		}
+	}
 }
 
 #endif
@@ -0,0 +1,293 @@
+/*
+ * RELIC is an Efficient LIbrary for Cryptography
+ * Copyright (C) 2007-2015 RELIC Authors
+ *
+ * This file is part of RELIC. RELIC is legal property of its developers,
+ * whose names are not listed here. Please refer to the COPYRIGHT file
+ * for contact information.
+ *
+ * RELIC is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * RELIC is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with RELIC. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ *
+ * Implementation of the SHA-3 hash functions and the SHAKE extendable-output
+ * functions over the Keccak-f[1600] permutation.
+ *
+ * @version $Id$
+ * @ingroup md
+ */
+
+#include <string.h>
+
+#include "relic_conf.h"
+#include "relic_core.h"
+#include "relic_md.h"
+
+/*============================================================================*/
+/* Private definitions                                                        */
+/*============================================================================*/
+
+/**
+ * Domain separation bits appended to messages hashed with SHA-3.
+ */
+#define SHA3_PAD		0x06
+
+/**
+ * Domain separation bits appended to messages hashed with SHAKE.
+ */
+#define SHAKE_PAD		0x1F
+
+/**
+ * Rotates a 64-bit word to the left.
+ */
+#define ROTL(X, N)		(((X) << (N)) | ((X) >> (64 - (N))))
+
+/**
+ * Round constants of Keccak-f[1600].
+ */
+static const uint64_t keccak_rc[24] = {
+	0x0000000000000001, 0x0000000000008082, 0x800000000000808A,
+	0x8000000080008000, 0x000000000000808B, 0x0000000080000001,
+	0x8000000080008081, 0x8000000000008009, 0x000000000000008A,
+	0x0000000000000088, 0x0000000080008009, 0x000000008000000A,
+	0x000000008000808B, 0x800000000000008B, 0x8000000000008089,
+	0x8000000000008003, 0x8000000000008002, 0x8000000000000080,
+	0x000000000000800A, 0x800000008000000A, 0x8000000080008081,
+	0x8000000000008080, 0x0000000080000001, 0x8000000080008008
+};
+
+/**
+ * Rotation offsets of the rho step, in the lane order of the pi step.
+ */
+static const int keccak_rho[24] = {
+	1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14,
+	27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44
+};
+
+/**
+ * Lane permutation of the pi step.
+ */
+static const int keccak_pi[24] = {
+	10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4,
+	15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1
+};
+
+/**
+ * Applies the Keccak-f[1600] permutation to a state of 25 lanes.
+ *
+ * @param[in,out] s			- the state.
+ */
+static void keccak_f(uint64_t *s) {
+	uint64_t c0, c1, c2, c3, c4, d, t, u;
+	int i, r, y;
+
+	for (r = 0; r < 24; r++) {
+		/* Theta. */
+		c0 = s[0] ^ s[5] ^ s[10] ^ s[15] ^ s[20];
+		c1 = s[1] ^ s[6] ^ s[11] ^ s[16] ^ s[21];
+		c2 = s[2] ^ s[7] ^ s[12] ^ s[17] ^ s[22];
+		c3 = s[3] ^ s[8] ^ s[13] ^ s[18] ^ s[23];
+		c4 = s[4] ^ s[9] ^ s[14] ^ s[19] ^ s[24];
+		for (y = 0; y < 25; y += 5) {
+			d = c4 ^ ROTL(c1, 1);
+			s[y] ^= d;
+			d = c0 ^ ROTL(c2, 1);
+			s[y + 1] ^= d;
+			d = c1 ^ ROTL(c3, 1);
+			s[y + 2] ^= d;
+			d = c2 ^ ROTL(c4, 1);
+			s[y + 3] ^= d;
+			d = c3 ^ ROTL(c0, 1);
+			s[y + 4] ^= d;
+		}
+		/* Rho and pi. */
+		t = s[1];
+		for (i = 0; i < 24; i++) {
+			u = s[keccak_pi[i]];
+			s[keccak_pi[i]] = ROTL(t, keccak_rho[i]);
+			t = u;
+		}
+		/* Chi. */
+		for (y = 0; y < 25; y += 5) {
+			c0 = s[y];
+			c1 = s[y + 1];
+			c2 = s[y + 2];
+			c3 = s[y + 3];
+			c4 = s[y + 4];
+			s[y] = c0 ^ (~c1 & c2);
+			s[y + 1] = c1 ^ (~c2 & c3);
+			s[y + 2] = c2 ^ (~c3 & c4);
+			s[y + 3] = c3 ^ (~c4 & c0);
+			s[y + 4] = c4 ^ (~c0 & c1);
+		}
+		/* Iota. */
+		s[0] ^= keccak_rc[r];
+	}
+}
+
+/**
+ * Reads a little-endian 64-bit word.
+ *
+ * @param[in] p				- the bytes to read.
+ * @return the word.
+ */
+static uint64_t load_le64(const uint8_t *p) {
+	uint64_t w = 0;
+	int i;
+
+	for (i = 7; i >= 0; i--) {
+		w = (w << 8) | p[i];
+	}
+	return w;
+}
+
+/**
+ * Initializes a sponge with the given rate.
+ *
+ * @param[out] ctx			- the sponge.
+ * @param[in] rate			- the rate in bytes.
+ */
+static void sponge_init(md_sh3_t *ctx, int rate) {
+	memset(ctx->s, 0, sizeof(ctx->s));
+	ctx->pos = 0;
+	ctx->rate = rate;
+}
+
+/**
+ * Absorbs bytes into a sponge.
+ *
+ * @param[in,out] ctx		- the sponge.
+ * @param[in] msg			- the bytes to absorb.
+ * @param[in] len			- the number of bytes.
+ */
+static void sponge_absorb(md_sh3_t *ctx, const uint8_t *msg, int len) {
+	int i;
+
+	while (len > 0) {
+		if (ctx->pos == 0 && len >= ctx->rate) {
+			/* Whole blocks are added a lane at a time. */
+			for (i = 0; i < ctx->rate / 8; i++) {
+				ctx->s[i] ^= load_le64(msg + 8 * i);
+			}
+			keccak_f(ctx->s);
+			msg += ctx->rate;
+			len -= ctx->rate;
+			continue;
+		}
+		ctx->s[ctx->pos / 8] ^= (uint64_t)*msg++ << (8 * (ctx->pos % 8));
+		len--;
+		if (++ctx->pos == ctx->rate) {
+			keccak_f(ctx->s);
+			ctx->pos = 0;
+		}
+	}
+}
+
+/**
+ * Pads the absorbed message and squeezes output bytes from a sponge.
+ *
+ * @param[in,out] ctx		- the sponge.
+ * @param[in] pad			- the domain separation bits.
+ * @param[out] out			- the output bytes.
+ * @param[in] len			- the number of output bytes.
+ */
+static void sponge_squeeze(md_sh3_t *ctx, uint8_t pad, uint8_t *out,
+		int len) {
+	int i;
+
+	ctx->s[ctx->pos / 8] ^= (uint64_t)pad << (8 * (ctx->pos % 8));
+	ctx->s[(ctx->rate - 1) / 8] ^=
+			(uint64_t)0x80 << (8 * ((ctx->rate - 1) % 8));
+	keccak_f(ctx->s);
+	while (len > 0) {
+		for (i = 0; i < MIN(len, ctx->rate); i++) {
+			out[i] = (uint8_t)(ctx->s[i / 8] >> (8 * (i % 8)));
+		}
+		out += i;
+		len -= i;
+		if (len > 0) {
+			keccak_f(ctx->s);
+		}
+	}
+}
+
+/*============================================================================*/
+/* Public definitions                                                         */
+/*============================================================================*/
+
+#if MD_MAP == SH3_256 || !defined(STRIP)
+
+void md_sh3_256_init(md_sh3_256_t *ctx) {
+	sponge_init(ctx, 200 - 2 * MD_LEN_SH3_256);
+}
+
+void md_sh3_256_update(md_sh3_256_t *ctx, const uint8_t *msg, int len) {
+	sponge_absorb(ctx, msg, len);
+}
+
+void md_sh3_256_final(md_sh3_256_t *ctx, uint8_t *hash) {
+	sponge_squeeze(ctx, SHA3_PAD, hash, MD_LEN_SH3_256);
+}
+
+void md_map_sh3_256(uint8_t *hash, const uint8_t *msg, int len) {
+	md_sh3_256_t ctx;
+
+	md_sh3_256_init(&ctx);
+	md_sh3_256_update(&ctx, msg, len);
+	md_sh3_256_final(&ctx, hash);
+}
+
+#endif
+
+#if MD_MAP == SH3_512 || !defined(STRIP)
+
+void md_sh3_512_init(md_sh3_512_t *ctx) {
+	sponge_init(ctx, 200 - 2 * MD_LEN_SH3_512);
+}
+
+void md_sh3_512_update(md_sh3_512_t *ctx, const uint8_t *msg, int len) {
+	sponge_absorb(ctx, msg, len);
+}
+
+void md_sh3_512_final(md_sh3_512_t *ctx, uint8_t *hash) {
+	sponge_squeeze(ctx, SHA3_PAD, hash, MD_LEN_SH3_512);
+}
+
+void md_map_sh3_512(uint8_t *hash, const uint8_t *msg, int len) {
+	md_sh3_512_t ctx;
+
+	md_sh3_512_init(&ctx);
+	md_sh3_512_update(&ctx, msg, len);
+	md_sh3_512_final(&ctx, hash);
+}
+
+#endif
+
+void md_xof_shk128(uint8_t *out, int out_len, const uint8_t *msg, int len) {
+	md_sh3_t ctx;
+
+	sponge_init(&ctx, 168);
+	sponge_absorb(&ctx, msg, len);
+	sponge_squeeze(&ctx, SHAKE_PAD, out, out_len);
+}
+
+void md_xof_shk256(uint8_t *out, int out_len, const uint8_t *msg, int len) {
+	md_sh3_t ctx;
+
+	sponge_init(&ctx, 136);
+	sponge_absorb(&ctx, msg, len);
+	sponge_squeeze(&ctx, SHAKE_PAD, out, out_len);
+}
@@ -34,24 +34,46 @@
 #include "relic_md.h"
 #include "sha.h"
 
+/*============================================================================*/
+/* Private definitions                                                        */
+/*============================================================================*/
+
+/**
+ * Fails to compile if the public context cannot hold the internal one.
+ */
+typedef char md_sh384_fits[
+		sizeof(md_sh384_t) >= sizeof(SHA384Context) ? 1 : -1];
+
 /*============================================================================*/
 /* Public definitions                                                         */
 /*============================================================================*/
 
 #if MD_MAP == SH384 || !defined(STRIP)
 
-void md_map_sh384(uint8_t *hash, const uint8_t *msg, int len) {
-	SHA384Context ctx;
-
-	if (SHA384Reset(&ctx) != shaSuccess) {
+void md_sh384_init(md_sh384_t *ctx) {
+	if (SHA384Reset((SHA384Context *)ctx->state) != shaSuccess) {
 		THROW(ERR_NO_VALID);
 	}
-	if (SHA384Input(&ctx, msg, len) != shaSuccess) {
+}
+
+void md_sh384_update(md_sh384_t *ctx, const uint8_t *msg, int len) {
+	if (SHA384Input((SHA384Context *)ctx->state, msg, len) != shaSuccess) {
 		THROW(ERR_NO_VALID);
 	}
-	if (SHA384Result(&ctx, hash) != shaSuccess) {
+}
+
+void md_sh384_final(md_sh384_t *ctx, uint8_t *hash) {
+	if (SHA384Result((SHA384Context *)ctx->state, hash) != shaSuccess) {
 		THROW(ERR_NO_VALID);
 	}
 }
 
+void md_map_sh384(uint8_t *hash, const uint8_t *msg, int len) {
+	md_sh384_t ctx;
+
+	md_sh384_init(&ctx);
+	md_sh384_update(&ctx, msg, len);
+	md_sh384_final(&ctx, hash);
+}
+
 #endif
@@ -29,28 +29,133 @@
  * @ingroup md
  */
 
+#include <string.h>
+
 #include "relic_conf.h"
 #include "relic_core.h"
 #include "relic_md.h"
 #include "sha.h"
 
+/*============================================================================*/
+/* Private definitions                                                        */
+/*============================================================================*/
+
+/**
+ * Fails to compile if the public context cannot hold the internal one.
+ */
+typedef char md_sh512_fits[
+		sizeof(md_sh512_t) >= sizeof(SHA512Context) ? 1 : -1];
+
+/**
+ * Number of messages hashed in parallel by md_map_sh512_x4().
+ */
+#define LANES		4
+
 /*============================================================================*/
 /* Public definitions                                                         */
 /*============================================================================*/
 
 #if MD_MAP == SH512 || !defined(STRIP)
 
+void md_sh512_init(md_sh512_t *ctx) {
+	if (SHA512Reset((SHA512Context *)ctx->state) != shaSuccess) {
+		THROW(ERR_NO_VALID);
+	}
+}
+
+void md_sh512_update(md_sh512_t *ctx, const uint8_t *msg, int len) {
+	if (SHA512Input((SHA512Context *)ctx->state, msg, len) != shaSuccess) {
+		THROW(ERR_NO_VALID);
+	}
+}
+
+void md_sh512_final(md_sh512_t *ctx, uint8_t *hash) {
+	if (SHA512Result((SHA512Context *)ctx->state, hash) != shaSuccess) {
+		THROW(ERR_NO_VALID);
+	}
+}
+
 void md_map_sh512(uint8_t *hash, const uint8_t *msg, int len) {
+	md_sh512_t ctx;
+
+	md_sh512_init(&ctx);
+	md_sh512_update(&ctx, msg, len);
+	md_sh512_final(&ctx, hash);
+}
+
+void md_map_sh512_x4(uint8_t **hash, uint8_t **msg, int *len, int n) {
 	SHA512Context ctx;
+	uint64_t h[8][LANES], iv[8];
+	uint8_t pad[LANES][2 * SHA512_Message_Block_Size];
+	uint8_t zero[SHA512_Message_Block_Size] = { 0 };
+	const uint8_t *in[LANES];
+	int i, j, l, m, r, full[LANES], blocks[LANES], max;
+	uint64_t bits;
 
 	if (SHA512Reset(&ctx) != shaSuccess) {
 		THROW(ERR_NO_VALID);
 	}
-	if (SHA512Input(&ctx, msg, len) != shaSuccess) {
-		THROW(ERR_NO_VALID);
+	for (j = 0; j < 8; j++) {
+#ifdef USE_32BIT_ONLY
+		iv[j] = ((uint64_t)ctx.Intermediate_Hash[2 * j] << 32) |
+				ctx.Intermediate_Hash[2 * j + 1];
+#else
+		iv[j] = ctx.Intermediate_Hash[j];
+#endif
 	}
-	if (SHA512Result(&ctx, hash) != shaSuccess) {
-		THROW(ERR_NO_VALID);
+
+	for (i = 0; i < n; i += LANES) {
+		m = MIN(LANES, n - i);
+		max = 0;
+		/* Pad the tail of each message into one or two separate blocks. */
+		for (l = 0; l < LANES; l++) {
+			for (j = 0; j < 8; j++) {
+				h[j][l] = iv[j];
+			}
+			blocks[l] = full[l] = 0;
+			if (l < m) {
+				full[l] = len[i + l] / SHA512_Message_Block_Size;
+				r = len[i + l] % SHA512_Message_Block_Size;
+				blocks[l] = full[l] +
+						(r < SHA512_Message_Block_Size - 16 ? 1 : 2);
+				memset(pad[l], 0, sizeof(pad[l]));
+				memcpy(pad[l], msg[i + l] + full[l] * SHA512_Message_Block_Size,
+						r);
+				pad[l][r] = 0x80;
+				r = (blocks[l] - full[l]) * SHA512_Message_Block_Size;
+				bits = (uint64_t)len[i + l] << 3;
+				for (j = 1; j <= 8; j++, bits >>= 8) {
+					pad[l][r - j] = (uint8_t)bits;
+				}
+				max = MAX(max, blocks[l]);
+			}
+		}
+		for (j = 0; j < max; j++) {
+			for (l = 0; l < LANES; l++) {
+				if (j >= blocks[l]) {
+					in[l] = zero;
+				} else if (j < full[l]) {
+					in[l] = msg[i + l] + j * SHA512_Message_Block_Size;
+				} else {
+					in[l] = pad[l] + (j - full[l]) * SHA512_Message_Block_Size;
+				}
+			}
+			if (!SHA512ProcessLanes(h, in)) {
+				/* No vector unit, so hash the remaining messages in turn. */
+				for (l = i; l < n; l++) {
+					md_map_sh512(hash[l], msg[l], len[l]);
+				}
+				return;
+			}
+			/* Lanes that finished are read out before they are reused. */
+			for (l = 0; l < m; l++) {
+				if (j == blocks[l] - 1) {
+					for (r = 0; r < 64; r++) {
+						hash[i + l][r] = (uint8_t)(h[r / 8][l] >> (56 - 8 * (r % 8)));
+					}
+				}
+			}
+		}
 	}
 }
 
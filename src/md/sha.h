@@ -24,6 +24,8 @@
 #endif /* USE_MODIFIED_MACROS */
 
 #define SHA_Parity(x, y, z)  ((x) ^ (y) ^ (z))
+/* WORD must come from the library configuration in every unit. */
+#include "relic_conf.h"
 #if WORD <= 32
 #define USE_32BIT_ONLY
 #endif
@@ -250,4 +252,24 @@ extern int SHA512FinalBits(SHA512Context *, const uint8_t bits,
 extern int SHA512Result(SHA512Context *,
                         uint8_t Message_Digest[SHA512HashSize]);
 
+/*
+ *  Hardware-accelerated compression of whole message blocks, provided
+ *  by relic_md_accel.c. They return zero if the processor lacks the
+ *  needed extensions and the portable code must be used instead.
+ */
+extern int SHA1ProcessBlocks(uint32_t *Intermediate_Hash,
+                        const uint8_t *blocks, unsigned int count);
+extern int SHA256ProcessBlocks(uint32_t *Intermediate_Hash,
+                        const uint8_t *blocks, unsigned int count);
+
+/*
+ *  Compression of one block for each of several independent messages,
+ *  one message per SIMD lane, with the intermediate hashes indexed by
+ *  word and then by lane. They return zero if the lanes are unavailable.
+ */
+extern int SHA256ProcessLanes(uint32_t Intermediate_Hash[8][8],
+                        const uint8_t *blocks[8]);
+extern int SHA512ProcessLanes(uint64_t Intermediate_Hash[8][4],
+                        const uint8_t *blocks[4]);
+
 #endif /* _SHA_H_ */
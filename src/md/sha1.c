@@ -129,7 +129,25 @@ int SHA1Input(SHA1Context *context,
   if (context->Corrupted)
      return context->Corrupted;
 
-  while (length-- && !context->Corrupted) {
+  while (length > 0 && !context->Corrupted) {
+    /* Whole blocks are handed to the accelerated code if available. */
+    if ((context->Message_Block_Index == 0) &&
+      (length >= SHA1_Message_Block_Size) &&
+      SHA1ProcessBlocks(context->Intermediate_Hash, message_array,
+        length / SHA1_Message_Block_Size)) {
+      unsigned int size = length - length % SHA1_Message_Block_Size;
+      uint64_t bits = ((uint64_t)context->Length_High << 32) |
+        context->Length_Low;
+      if (bits + ((uint64_t)size << 3) < bits)
+        context->Corrupted = 1;
+      bits += (uint64_t)size << 3;
+      context->Length_Low = (uint32_t)bits;
+      context->Length_High = (uint32_t)(bits >> 32);
+      message_array += size;
+      length -= size;
+      continue;
+    }
+
     context->Message_Block[context->Message_Block_Index++] =
       (uint8_t)(*message_array & 0xFF);
 
@@ -139,6 +157,7 @@ int SHA1Input(SHA1Context *context,
       SHA1ProcessMessageBlock(context);
 
     message_array++;
+    length--;
   }
 
   return shaSuccess;
@@ -359,6 +378,12 @@ static void SHA1ProcessMessageBlock(SHA1Context *context)
   uint32_t   W[80];           /* Word sequence */
   uint32_t   A, B, C, D, E;   /* Word buffers */
 
+  if (SHA1ProcessBlocks(context->Intermediate_Hash,
+      context->Message_Block, 1)) {
+    context->Message_Block_Index = 0;
+    return;
+  }
+
   /*
    * Initialize the first 16 words in the array W
    */
@@ -234,7 +234,25 @@ int SHA256Input(SHA256Context *context, const uint8_t *message_array,
   if (context->Corrupted)
      return context->Corrupted;
 
-  while (length-- && !context->Corrupted) {
+  while (length > 0 && !context->Corrupted) {
+    /* Whole blocks are handed to the accelerated code if available. */
+    if ((context->Message_Block_Index == 0) &&
+      (length >= SHA256_Message_Block_Size) &&
+      SHA256ProcessBlocks(context->Intermediate_Hash, message_array,
+        length / SHA256_Message_Block_Size)) {
+      unsigned int size = length - length % SHA256_Message_Block_Size;
+      uint64_t bits = ((uint64_t)context->Length_High << 32) |
+        context->Length_Low;
+      if (bits + ((uint64_t)size << 3) < bits)
+        context->Corrupted = 1;
+      bits += (uint64_t)size << 3;
+      context->Length_Low = (uint32_t)bits;
+      context->Length_High = (uint32_t)(bits >> 32);
+      message_array += size;
+      length -= size;
+      continue;
+    }
+
     context->Message_Block[context->Message_Block_Index++] =
     		(uint8_t)(*message_array & 0xFF);
 
@@ -244,6 +262,7 @@ int SHA256Input(SHA256Context *context, const uint8_t *message_array,
       SHA224_256ProcessMessageBlock(context);
 
     message_array++;
+    length--;
   }
 
   return shaSuccess;
@@ -463,6 +482,12 @@ static void SHA224_256ProcessMessageBlock(SHA256Context *context)
   uint32_t   W[64];                   /* Word sequence */
   uint32_t   A, B, C, D, E, F, G, H;  /* Word buffers */
 
+  if (SHA256ProcessBlocks(context->Intermediate_Hash,
+      context->Message_Block, 1)) {
+    context->Message_Block_Index = 0;
+    return;
+  }
+
   /*
    * Initialize the first 16 words in the array W
    */
@@ -300,6 +300,143 @@ static void pp_mil_lit_k12(fp12_t r, ep_t t, ep_t p, ep2_t q, bn_t a) {
 	}
 }
 
+/**
+ * Compute the Miller loop for a product of pairings of type G_2 x G_1 over the
+ * bits of a given parameter represented in sparse form. The squarings of the
+ * accumulator are shared among all pairs.
+ *
+ * @param[out] r			- the result.
+ * @param[out] t			- the resulting points.
+ * @param[in] q				- the first points of the pairings, in G_2.
+ * @param[in] p				- the second points of the pairings, in G_1.
+ * @param[in] m				- the number of pairings.
+ * @param[in] s				- the loop parameter in sparse form.
+ * @param[in] len			- the length of the loop parameter.
+ */
+static void pp_mil_sps_lot_k12(fp12_t r, ep2_t *t, ep2_t *q, ep_t *p, int m,
+		int *s, int len) {
+	fp12_t l;
+	ep_t _p[m];
+	ep2_t _q[m];
+	int i, j;
+
+	fp12_null(l);
+	for (j = 0; j < m; j++) {
+		ep_null(_p[j]);
+		ep2_null(_q[j]);
+	}
+
+	TRY {
+		fp12_new(l);
+		for (j = 0; j < m; j++) {
+			ep_new(_p[j]);
+			ep2_new(_q[j]);
+		}
+
+		fp12_zero(l);
+		for (j = 0; j < m; j++) {
+			ep2_copy(t[j], q[j]);
+			ep2_neg(_q[j], q[j]);
+#if EP_ADD == BASIC
+			fp_copy(_p[j]->x, p[j]->x);
+			fp_neg(_p[j]->y, p[j]->y);
+#else
+			fp_neg(_p[j]->y, p[j]->y);
+			fp_add(_p[j]->x, p[j]->x, p[j]->x);
+			fp_add(_p[j]->x, _p[j]->x, p[j]->x);
+#endif
+		}
+
+		pp_dbl_k12(r, t[0], t[0], _p[0]);
+		for (j = 1; j < m; j++) {
+			pp_dbl_k12(l, t[j], t[j], _p[j]);
+			fp12_mul_dxs(r, r, l);
+		}
+		for (j = 0; j < m; j++) {
+			if (s[len - 2] > 0) {
+				pp_add_k12(l, t[j], q[j], p[j]);
+				fp12_mul_dxs(r, r, l);
+			}
+			if (s[len - 2] < 0) {
+				pp_add_k12(l, t[j], _q[j], p[j]);
+				fp12_mul_dxs(r, r, l);
+			}
+		}
+		for (i = len - 3; i >= 0; i--) {
+			fp12_sqr(r, r);
+			for (j = 0; j < m; j++) {
+				pp_dbl_k12(l, t[j], t[j], _p[j]);
+				fp12_mul_dxs(r, r, l);
+				if (s[i] > 0) {
+					pp_add_k12(l, t[j], q[j], p[j]);
+					fp12_mul_dxs(r, r, l);
+				}
+				if (s[i] < 0) {
+					pp_add_k12(l, t[j], _q[j], p[j]);
+					fp12_mul_dxs(r, r, l);
+				}
+			}
+		}
+	}
+	CATCH_ANY {
+		THROW(ERR_CAUGHT);
+	}
+	FINALLY {
+		fp12_free(l);
+		for (j = 0; j < m; j++) {
+			ep_free(_p[j]);
+			ep2_free(_q[j]);
+		}
+	}
+}
+
+/**
+ * Compute the Miller loop for a product of pairings of type G_1 x G_2 over the
+ * bits of a given parameter. The squarings of the accumulator are shared among
+ * all pairs.
+ *
+ * @param[out] r			- the result.
+ * @param[out] t			- the resulting points.
+ * @param[in] p				- the first points of the pairings, in G_1.
+ * @param[in] q				- the second points of the pairings, in G_2.
+ * @param[in] m				- the number of pairings.
+ * @param[in] a				- the loop parameter.
+ */
+static void pp_mil_lit_lot_k12(fp12_t r, ep_t *t, ep_t *p, ep2_t *q, int m,
+		bn_t a) {
+	fp12_t l;
+	int i, j;
+
+	fp12_null(l);
+
+	TRY {
+		fp12_new(l);
+
+		for (j = 0; j < m; j++) {
+			ep_copy(t[j], p[j]);
+		}
+		fp12_zero(l);
+
+		for (i = bn_bits(a) - 2; i >= 0; i--) {
+			fp12_sqr(r, r);
+			for (j = 0; j < m; j++) {
+				pp_dbl_lit_k12(l, t[j], t[j], q[j]);
+				fp12_mul(r, r, l);
+				if (bn_get_bit(a, i)) {
+					pp_add_lit_k12(l, t[j], p[j], q[j]);
+					fp12_mul(r, r, l);
+				}
+			}
+		}
+	}
+	CATCH_ANY {
+		THROW(ERR_CAUGHT);
+	}
+	FINALLY {
+		fp12_free(l);
+	}
+}
+
 /**
  * Compute the final lines for optimal ate pairings.
  *
@@ -344,6 +481,82 @@ static void pp_fin_k12_oatep(fp12_t r, ep2_t t, ep2_t q, ep_t p) {
 }
 
 
+/**
+ * Arguments shared by the tasks of a product of pairings.
+ */
+typedef struct {
+	/** The partial results, one for each task. */
+	fp12_t *r;
+	/** The first elliptic curve points. */
+	ep_t *p;
+	/** The second elliptic curve points. */
+	ep2_t *q;
+	/** The number of pairings. */
+	int m;
+	/** The number of tasks. */
+	int k;
+} pp_map_lot_t;
+
+/**
+ * Computes a product of pairings of multiple pairs of points. The pairs are
+ * partitioned in contiguous blocks, one for each task, and the tasks are
+ * processed by the thread pool.
+ *
+ * @param[out] r			- the result.
+ * @param[in] p				- the first elliptic curve points.
+ * @param[in] q				- the second elliptic curve points.
+ * @param[in] m				- the number of pairings to evaluate.
+ * @param[in] k				- the number of tasks.
+ * @param[in] task			- the function that computes one block.
+ * @param[in] exp			- flag to indicate if the final exponentiation
+ * 							  is computed over the product.
+ */
+static void pp_map_lot_k12(fp12_t r, ep_t *p, ep2_t *q, int m, int k,
+		void (*task)(void *, int), int exp) {
+	pp_map_lot_t args;
+	int i;
+
+	if (m <= 0) {
+		fp12_set_dig(r, 1);
+		return;
+	}
+
+	fp12_t t[k];
+
+	for (i = 0; i < k; i++) {
+		fp12_null(t[i]);
+	}
+
+	TRY {
+		for (i = 0; i < k; i++) {
+			fp12_new(t[i]);
+		}
+
+		args.r = t;
+		args.p = p;
+		args.q = q;
+		args.m = m;
+		args.k = k;
+		multi_run(task, &args, k);
+
+		fp12_copy(r, t[0]);
+		for (i = 1; i < k; i++) {
+			fp12_mul(r, r, t[i]);
+		}
+		if (exp) {
+			pp_exp_k12(r, r);
+		}
+	}
+	CATCH_ANY {
+		THROW(ERR_CAUGHT);
+	}
+	FINALLY {
+		for (i = 0; i < k; i++) {
+			fp12_free(t[i]);
+		}
+	}
+}
+
 /*============================================================================*/
 /* Public definitions                                                         */
 /*============================================================================*/
@@ -420,6 +633,67 @@ void pp_map_tatep_k12(fp12_t r, ep_t p, ep2_t q) {
 	}
 }
 
+/**
+ * Computes the Miller loop of a product of Tate pairings over the j-th block
+ * of pairs of points.
+ *
+ * @param[in,out] args		- the arguments of the product of pairings.
+ * @param[in] j				- the index of the block.
+ */
+static void pp_mil_tatep_lot(void *args, int j) {
+	pp_map_lot_t *a = (pp_map_lot_t *)args;
+	int i, n = 0, lo = j * a->m / a->k, hi = (j + 1) * a->m / a->k;
+	ep_t t[hi - lo], _p[hi - lo];
+	ep2_t _q[hi - lo];
+	bn_t ord;
+
+	bn_null(ord);
+	for (i = 0; i < hi - lo; i++) {
+		ep_null(t[i]);
+		ep_null(_p[i]);
+		ep2_null(_q[i]);
+	}
+
+	TRY {
+		bn_new(ord);
+		for (i = 0; i < hi - lo; i++) {
+			ep_new(t[i]);
+			ep_new(_p[i]);
+			ep2_new(_q[i]);
+		}
+
+		ep_curve_get_ord(ord);
+		fp12_set_dig(a->r[j], 1);
+
+		for (i = lo; i < hi; i++) {
+			if (!ep_is_infty(a->p[i]) && !ep2_is_infty(a->q[i])) {
+				ep_copy(_p[n], a->p[i]);
+				ep2_copy(_q[n], a->q[i]);
+				n++;
+			}
+		}
+		if (n > 0) {
+			pp_mil_lit_lot_k12(a->r[j], t, _p, _q, n, ord);
+		}
+	}
+	CATCH_ANY {
+		THROW(ERR_CAUGHT);
+	}
+	FINALLY {
+		bn_free(ord);
+		for (i = 0; i < hi - lo; i++) {
+			ep_free(t[i]);
+			ep_free(_p[i]);
+			ep2_free(_q[i]);
+		}
+	}
+}
+
+void pp_map_sim_tatep_k12(fp12_t r, ep_t *p, ep2_t *q, int m) {
+	pp_map_lot_k12(r, p, q, m, MIN(multi_get_cores(), m), pp_mil_tatep_lot,
+			1);
+}
+
 #endif
 
 #if PP_MAP == WEILP || !defined(STRIP)
@@ -516,6 +790,23 @@ void pp_map_weilp_k12(fp12_t r, ep_t p, ep2_t q) {
 	}
 }
 
+/**
+ * Computes the Weil pairing of the i-th pair of points. Blocks are formed by
+ * a single pair.
+ *
+ * @param[in,out] args		- the arguments of the product of pairings.
+ * @param[in] i				- the index of the pair.
+ */
+static void pp_map_weilp_pair(void *args, int i) {
+	pp_map_lot_t *a = (pp_map_lot_t *)args;
+
+	pp_map_weilp_k12(a->r[i], a->p[i], a->q[i]);
+}
+
+void pp_map_sim_weilp_k12(fp12_t r, ep_t *p, ep2_t *q, int m) {
+	pp_map_lot_k12(r, p, q, m, m, pp_map_weilp_pair, 0);
+}
+
 #endif
 
 
@@ -576,4 +867,92 @@ void pp_map_oatep_k12(fp12_t r, ep_t p, ep2_t q) {
 	}
 }
 
+/**
+ * Computes the Miller loop of a product of optimal ate pairings over the j-th
+ * block of pairs of points, including the final lines.
+ *
+ * @param[in,out] args		- the arguments of the product of pairings.
+ * @param[in] j				- the index of the block.
+ */
+static void pp_mil_oatep_lot(void *args, int j) {
+	pp_map_lot_t *a = (pp_map_lot_t *)args;
+	int i, n = 0, lo = j * a->m / a->k, hi = (j + 1) * a->m / a->k;
+	int len = FP_BITS, s[FP_BITS];
+	ep_t _p[hi - lo];
+	ep2_t t[hi - lo], _q[hi - lo];
+	bn_t x;
+
+	bn_null(x);
+	for (i = 0; i < hi - lo; i++) {
+		ep_null(_p[i]);
+		ep2_null(t[i]);
+		ep2_null(_q[i]);
+	}
+
+	TRY {
+		bn_new(x);
+		for (i = 0; i < hi - lo; i++) {
+			ep_new(_p[i]);
+			ep2_new(t[i]);
+			ep2_new(_q[i]);
+		}
+
+		fp_param_get_var(x);
+		bn_mul_dig(x, x, 6);
+		bn_add_dig(x, x, 2);
+		fp_param_get_map(s, &len);
+		fp12_set_dig(a->r[j], 1);
+
+		for (i = lo; i < hi; i++) {
+			if (!ep_is_infty(a->p[i]) && !ep2_is_infty(a->q[i])) {
+				ep_copy(_p[n], a->p[i]);
+				ep2_copy(_q[n], a->q[i]);
+				n++;
+			}
+		}
+
+		if (n > 0) {
+			switch (ep_param_get()) {
+				case BN_P158:
+				case BN_P254:
+				case BN_P256:
+				case BN_P638:
+					pp_mil_sps_lot_k12(a->r[j], t, _q, _p, n, s, len);
+					if (bn_sign(x) == BN_NEG) {
+						fp12_inv_uni(a->r[j], a->r[j]);
+						for (i = 0; i < n; i++) {
+							ep2_neg(t[i], t[i]);
+						}
+					}
+					for (i = 0; i < n; i++) {
+						pp_fin_k12_oatep(a->r[j], t[i], _q[i], _p[i]);
+					}
+					break;
+				case B12_P638:
+					pp_mil_sps_lot_k12(a->r[j], t, _q, _p, n, s, len);
+					if (bn_sign(x) == BN_NEG) {
+						fp12_inv_uni(a->r[j], a->r[j]);
+					}
+					break;
+			}
+		}
+	}
+	CATCH_ANY {
+		THROW(ERR_CAUGHT);
+	}
+	FINALLY {
+		bn_free(x);
+		for (i = 0; i < hi - lo; i++) {
+			ep_free(_p[i]);
+			ep2_free(t[i]);
+			ep2_free(_q[i]);
+		}
+	}
+}
+
+void pp_map_sim_oatep_k12(fp12_t r, ep_t *p, ep2_t *q, int m) {
+	pp_map_lot_k12(r, p, q, m, MIN(multi_get_cores(), m), pp_mil_oatep_lot,
+			1);
+}
+
 #endif
@@ -48,6 +48,7 @@ static void rand_stub(uint8_t *buf, int size, void *args) {
 	
 	if (fd == -1) {
 		THROW(ERR_NO_FILE);
+		return;
 	}
 
 	l = 0;
@@ -55,7 +56,9 @@ static void rand_stub(uint8_t *buf, int size, void *args) {
 		c = read(fd, buf + l, size - l);
 		l += c;
 		if (c == -1) {
+			close(fd);
 			THROW(ERR_NO_READ);
+			return;
 		}
 	} while (l < size);
 
@@ -0,0 +1,84 @@
+/*
+ * RELIC is an Efficient LIbrary for Cryptography
+ * Copyright (C) 2007-2015 RELIC Authors
+ *
+ * This file is part of RELIC. RELIC is legal property of its developers,
+ * whose names are not listed here. Please refer to the COPYRIGHT file
+ * for contact information.
+ *
+ * RELIC is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * RELIC is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with RELIC. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ *
+ * Implementation of the ChaCha20 pseudo-random number generator with fast key
+ * erasure.
+ *
+ * @ingroup rand
+ */
+
+#include <string.h>
+
+#include "relic_conf.h"
+#include "relic_core.h"
+#include "relic_label.h"
+#include "relic_rand.h"
+#include "relic_md.h"
+#include "relic_bc.h"
+#include "relic_err.h"
+
+/*============================================================================*/
+/* Public definitions                                                         */
+/*============================================================================*/
+
+#if RAND == CHACHA
+
+void rand_bytes(uint8_t *buf, int size) {
+	uint8_t iv[BC_CHACHA_IV] = { 0 }, key[BC_CHACHA_KEY] = { 0 };
+	ctx_t *ctx = core_get();
+
+	/* The output is the key stream starting at the second block. */
+	memset(buf, 0, size);
+	bc_chacha20(buf, buf, size, ctx->rand, iv, 1);
+	/* Replace the key with the first block, so past outputs are safe. */
+	bc_chacha20(key, key, BC_CHACHA_KEY, ctx->rand, iv, 0);
+	memcpy(ctx->rand, key, BC_CHACHA_KEY);
+	memset(key, 0, sizeof(key));
+	ctx->counter = ctx->counter + 1;
+}
+
+void rand_seed(uint8_t *buf, int size) {
+	ctx_t *ctx = core_get();
+
+	if (size <= 0) {
+		THROW(ERR_NO_VALID);
+		return;
+	}
+
+	if (ctx->seeded == 0) {
+		/* K = kdf(seed). */
+		md_kdf2(ctx->rand, RAND_SIZE, buf, size);
+	} else {
+		/* K = kdf(K || seed). */
+		uint8_t tmp[RAND_SIZE + size];
+		memcpy(tmp, ctx->rand, RAND_SIZE);
+		memcpy(tmp + RAND_SIZE, buf, size);
+		md_kdf2(ctx->rand, RAND_SIZE, tmp, sizeof(tmp));
+	}
+	rand_flush();
+	ctx->counter = ctx->seeded = 1;
+}
+
+#endif
@@ -87,6 +87,7 @@ void rand_init() {
 	*fd = open(RAND_PATH, O_RDONLY);
 	if (*fd == -1) {
 		THROW(ERR_NO_FILE);
+		return;
 	}
 #else
 
@@ -100,6 +101,7 @@ void rand_init() {
 	fd = open(RAND_PATH, O_RDONLY);
 	if (fd == -1) {
 		THROW(ERR_NO_FILE);
+		return;
 	}
 
 	l = 0;
@@ -107,7 +109,9 @@ void rand_init() {
 		c = read(fd, buf + l, SEED_SIZE - l);
 		l += c;
 		if (c == -1) {
+			close(fd);
 			THROW(ERR_NO_READ);
+			return;
 		}
 	} while (l < SEED_SIZE);
 
@@ -178,6 +182,7 @@ void rand_clean() {
 	close(*fd);
 #endif
 
+	rand_flush();
 #if RAND != CALL
 	memset(core_get()->rand, 0, sizeof(core_get()->rand));
 #else
@@ -186,3 +191,37 @@ void rand_clean() {
 #endif
 	core_get()->seeded = 0;
 }
+
+void rand_bytes_small(uint8_t *buf, int size) {
+#if RAND != CALL && RAND_BUF > 0
+	ctx_t *ctx = core_get();
+	uint8_t *ptr;
+
+	if (size <= 0 || size > RAND_SMALL) {
+		rand_bytes(buf, size);
+		return;
+	}
+
+	if (size > ctx->rand_len) {
+		/* Refill with a single request, overwriting the leftover bytes. */
+		rand_bytes(ctx->rand_buf, RAND_BUF);
+		ctx->rand_len = RAND_BUF;
+	}
+
+	ptr = ctx->rand_buf + (RAND_BUF - ctx->rand_len);
+	memcpy(buf, ptr, size);
+	memset(ptr, 0, size);
+	ctx->rand_len -= size;
+#else
+	rand_bytes(buf, size);
+#endif
+}
+
+void rand_flush(void) {
+#if RAND != CALL && RAND_BUF > 0
+	ctx_t *ctx = core_get();
+
+	memset(ctx->rand_buf, 0, sizeof(ctx->rand_buf));
+	ctx->rand_len = 0;
+#endif
+}
@@ -0,0 +1,212 @@
+/*
+ * RELIC is an Efficient LIbrary for Cryptography
+ * Copyright (C) 2007-2015 RELIC Authors
+ *
+ * This file is part of RELIC. RELIC is legal property of its developers,
+ * whose names are not listed here. Please refer to the COPYRIGHT file
+ * for contact information.
+ *
+ * RELIC is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * RELIC is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with RELIC. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ *
+ * Implementation of the CTR_DRBG pseudo-random number generator with AES-256
+ * and the block cipher derivation function.
+ *
+ * @ingroup rand
+ */
+
+#include <string.h>
+
+#include "relic_conf.h"
+#include "relic_core.h"
+#include "relic_label.h"
+#include "relic_rand.h"
+#include "relic_bc.h"
+#include "relic_err.h"
+
+/*============================================================================*/
+/* Private definitions                                                        */
+/*============================================================================*/
+
+#if RAND == CTR
+
+/**
+ * Length in bytes of the AES-256 key.
+ */
+#define KEY_LEN			32
+
+/**
+ * Length in bytes of the seed, the key followed by the counter block.
+ */
+#define SEED_LEN		(KEY_LEN + BC_LEN)
+
+/**
+ * Maximum number of bytes produced by a single request to the generator.
+ */
+#define RAND_MAX_LEN	(1 << 16)
+
+/**
+ * Number of bytes up to which a request is served with a single key setup.
+ */
+#define RAND_SHORT		256
+
+/**
+ * Adds a small integer to the 128-bit big-endian counter block.
+ *
+ * @param[in,out] v			- the counter block.
+ * @param[in] n				- the integer to add.
+ */
+static void rand_inc(uint8_t *v, int n) {
+	for (int i = BC_LEN - 1; i >= 0; i--) {
+		n += v[i];
+		v[i] = (uint8_t)n;
+		n >>= 8;
+	}
+}
+
+/**
+ * Updates the internal state K || V with provided data of SEED_LEN bytes.
+ *
+ * @param[in] data			- the provided data.
+ */
+static void rand_update(const uint8_t *data) {
+	ctx_t *ctx = core_get();
+	uint8_t t[SEED_LEN], v[BC_LEN];
+	int l = SEED_LEN;
+
+	/* K || V = (AES(K, V + 1) || AES(K, V + 2) || AES(K, V + 3)) ^ data. */
+	memcpy(v, ctx->rand + KEY_LEN, BC_LEN);
+	rand_inc(v, 1);
+	bc_aes_ctr_enc(t, &l, (uint8_t *)data, SEED_LEN, ctx->rand, 8 * KEY_LEN,
+			v);
+	memcpy(ctx->rand, t, SEED_LEN);
+}
+
+/**
+ * Computes the block cipher derivation function.
+ *
+ * @param[out] out			- the SEED_LEN bytes derived.
+ * @param[in] in			- the input string.
+ * @param[in] len			- the number of bytes in the input.
+ */
+static void rand_df(uint8_t *out, const uint8_t *in, int len) {
+	int l = CEIL(BC_LEN + 8 + len + 1, BC_LEN) * BC_LEN;
+	uint8_t s[l], x[BC_LEN], k[KEY_LEN];
+	bc_aes_t key;
+	int i, j, n;
+
+	/* S = IV || L || N || input || 0x80 || 0x00...00, IV set below. */
+	memset(s, 0, l);
+	for (i = 0; i < 4; i++) {
+		s[BC_LEN + i] = (uint8_t)(len >> (24 - 8 * i));
+	}
+	s[BC_LEN + 7] = SEED_LEN;
+	memcpy(s + BC_LEN + 8, in, len);
+	s[BC_LEN + 8 + len] = 0x80;
+
+	/* temp = BCC(K, 0 || S) || BCC(K, 1 || S) || ... with K = 00...1F. */
+	for (i = 0; i < KEY_LEN; i++) {
+		k[i] = i;
+	}
+	bc_aes_key(&key, k, 8 * KEY_LEN);
+	for (n = 0; n < SEED_LEN / BC_LEN; n++) {
+		s[3] = n;
+		memset(x, 0, BC_LEN);
+		for (i = 0; i < l; i += BC_LEN) {
+			for (j = 0; j < BC_LEN; j++) {
+				x[j] ^= s[i + j];
+			}
+			bc_aes_ecb_enc(x, x, BC_LEN, &key);
+		}
+		memcpy(out + n * BC_LEN, x, BC_LEN);
+	}
+
+	/* Encrypt X iteratively under the new key K taken from temp. */
+	bc_aes_key(&key, out, 8 * KEY_LEN);
+	memcpy(x, out + KEY_LEN, BC_LEN);
+	for (n = 0; n < SEED_LEN; n += BC_LEN) {
+		bc_aes_ecb_enc(x, x, BC_LEN, &key);
+		memcpy(out + n, x, BC_LEN);
+	}
+	util_wipe(&key, sizeof(key));
+	util_wipe(s, l);
+}
+
+/**
+ * Generates pseudo-random bytes for a single request to the generator.
+ *
+ * @param[out] buf			- the buffer to write.
+ * @param[in] size			- the number of bytes to write.
+ */
+static void rand_gen(uint8_t *buf, int size) {
+	ctx_t *ctx = core_get();
+	int l, n = (size > RAND_SHORT ? size - size % BC_LEN : 0);
+	uint8_t t[RAND_SHORT + SEED_LEN] = { 0 }, v[BC_LEN];
+
+	/* The output is the key stream of CTR mode starting at V + 1. */
+	memcpy(v, ctx->rand + KEY_LEN, BC_LEN);
+	rand_inc(v, 1);
+	if (n > 0) {
+		memset(buf, 0, n);
+		bc_aes_ctr_enc(buf, &n, buf, n, ctx->rand, 8 * KEY_LEN, v);
+		rand_inc(v, n / BC_LEN);
+	}
+	/* Produce the remaining blocks and the next state with one key setup. */
+	l = CEIL(size - n, BC_LEN) * BC_LEN + SEED_LEN;
+	bc_aes_ctr_enc(t, &l, t, l, ctx->rand, 8 * KEY_LEN, v);
+	memcpy(buf + n, t, size - n);
+	memcpy(ctx->rand, t + l - SEED_LEN, SEED_LEN);
+}
+
+#endif
+
+/*============================================================================*/
+/* Public definitions                                                         */
+/*============================================================================*/
+
+#if RAND == CTR
+
+void rand_bytes(uint8_t *buf, int size) {
+	ctx_t *ctx = core_get();
+
+	/* Split large requests into the maximum allowed by the standard. */
+	for (int i = 0; i < size; i += RAND_MAX_LEN) {
+		rand_gen(buf + i, MIN(RAND_MAX_LEN, size - i));
+		ctx->counter = ctx->counter + 1;
+	}
+}
+
+void rand_seed(uint8_t *buf, int size) {
+	ctx_t *ctx = core_get();
+	uint8_t seed[SEED_LEN];
+
+	if (size <= 0) {
+		THROW(ERR_NO_VALID);
+		return;
+	}
+
+	if (ctx->seeded == 0) {
+		/* K = 0x00...00, V = 0x00...00. */
+		memset(ctx->rand, 0, SEED_LEN);
+	}
+	rand_df(seed, buf, size);
+	rand_update(seed);
+	rand_flush();
+	ctx->counter = ctx->seeded = 1;
+}
+
+#endif
@@ -100,12 +100,14 @@ void rand_seed(uint8_t *buf, int size) {
 
 	if (size < MD_LEN_SHONE) {
 		THROW(ERR_NO_VALID);
+		return;
 	}
 
 	/* XKEY = SEED, throws away additional bytes. */
 	for (i = 0; i < MD_LEN_SHONE; i++) {
 		ctx->rand[i] = buf[i];
 	}
+	rand_flush();
 	ctx->seeded = 1;
 }
 
@@ -170,6 +170,7 @@ void rand_seed(uint8_t *buf, int size) {
 
 	if (size <= 0) {
 		THROW(ERR_NO_VALID);
+		return;
 	}
 
 	if (sizeof(int) > 4 && size > (1 << 32)) {
@@ -192,6 +193,7 @@ void rand_seed(uint8_t *buf, int size) {
 		/* C = hash_df(00 || V). */
 		rand_hash(ctx->rand + 1 + len, len, ctx->rand, len + 1);
 	}
+	rand_flush();
 	ctx->counter = ctx->seeded = 1;
 }
 
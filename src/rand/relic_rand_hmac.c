@@ -0,0 +1,138 @@
+/*
+ * RELIC is an Efficient LIbrary for Cryptography
+ * Copyright (C) 2007-2015 RELIC Authors
+ *
+ * This file is part of RELIC. RELIC is legal property of its developers,
+ * whose names are not listed here. Please refer to the COPYRIGHT file
+ * for contact information.
+ *
+ * RELIC is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * RELIC is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with RELIC. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ *
+ * Implementation of the HMAC_DRBG pseudo-random number generator.
+ *
+ * @ingroup rand
+ */
+
+#include <string.h>
+
+#include "relic_conf.h"
+#include "relic_core.h"
+#include "relic_label.h"
+#include "relic_rand.h"
+#include "relic_md.h"
+#include "relic_err.h"
+
+/*============================================================================*/
+/* Private definitions                                                        */
+/*============================================================================*/
+
+#if RAND == HMAC
+
+/**
+ * Maximum number of bytes produced by a single request to the generator.
+ */
+#define RAND_MAX_LEN	(1 << 16)
+
+/**
+ * Updates the internal state K || V with the provided data.
+ *
+ * @param[in] data			- the provided data.
+ * @param[in] len			- the number of bytes of provided data.
+ */
+static void rand_update(const uint8_t *data, int len) {
+	ctx_t *ctx = core_get();
+	uint8_t *k = ctx->rand, *v = ctx->rand + MD_LEN;
+	md_hmac_t h;
+
+	for (uint8_t i = 0; i <= (len > 0); i++) {
+		/* K = HMAC(K, V || i || data). */
+		md_hmac_init(&h, k, MD_LEN);
+		md_hmac_update(&h, v, MD_LEN);
+		md_hmac_update(&h, &i, 1);
+		if (len > 0) {
+			md_hmac_update(&h, data, len);
+		}
+		md_hmac_final(&h, k);
+		/* V = HMAC(K, V). */
+		md_hmac_init(&h, k, MD_LEN);
+		md_hmac_update(&h, v, MD_LEN);
+		md_hmac_final(&h, v);
+	}
+}
+
+/**
+ * Generates pseudo-random bytes for a single request to the generator.
+ *
+ * @param[out] buf			- the buffer to write.
+ * @param[in] size			- the number of bytes to write.
+ */
+static void rand_gen(uint8_t *buf, int size) {
+	ctx_t *ctx = core_get();
+	uint8_t *v = ctx->rand + MD_LEN;
+	md_hmac_t h;
+
+	/* The key is fixed during the request, so its padding is hashed once. */
+	md_hmac_init(&h, ctx->rand, MD_LEN);
+	while (size > 0) {
+		/* V = HMAC(K, V). */
+		md_hmac_update(&h, v, MD_LEN);
+		md_hmac_final(&h, v);
+		memcpy(buf, v, MIN(MD_LEN, size));
+		buf += MD_LEN;
+		size -= MD_LEN;
+	}
+	rand_update(NULL, 0);
+}
+
+#endif
+
+/*============================================================================*/
+/* Public definitions                                                         */
+/*============================================================================*/
+
+#if RAND == HMAC
+
+void rand_bytes(uint8_t *buf, int size) {
+	ctx_t *ctx = core_get();
+
+	/* Split large requests into the maximum allowed by the standard. */
+	for (int i = 0; i < size; i += RAND_MAX_LEN) {
+		rand_gen(buf + i, MIN(RAND_MAX_LEN, size - i));
+		ctx->counter = ctx->counter + 1;
+	}
+}
+
+void rand_seed(uint8_t *buf, int size) {
+	ctx_t *ctx = core_get();
+
+	if (size <= 0) {
+		THROW(ERR_NO_VALID);
+		return;
+	}
+
+	if (ctx->seeded == 0) {
+		/* K = 0x00...00, V = 0x01...01. */
+		memset(ctx->rand, 0x00, MD_LEN);
+		memset(ctx->rand + MD_LEN, 0x01, MD_LEN);
+	}
+	rand_update(buf, size);
+	rand_flush();
+	ctx->counter = ctx->seeded = 1;
+}
+
+#endif
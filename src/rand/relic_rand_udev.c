@@ -59,12 +59,14 @@ void rand_bytes(uint8_t *buf, int size) {
 		l += c;
 		if (c == -1) {
 			THROW(ERR_NO_READ);
+			return;
 		}
 	} while (l < size);
 }
 
 void rand_seed(uint8_t *buf, int size) {
 	/* Do nothing, only mark as seeded. */
+	rand_flush();
 	core_get()->seeded = 1;
 }
 
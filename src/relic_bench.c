@@ -30,6 +30,7 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "relic_core.h"
@@ -48,6 +49,288 @@ uint32_t micros();
 /* Private definitions                                                        */
 /*============================================================================*/
 
+/**
+ * Maximum length of a benchmark label stored from the baseline.
+ */
+#define BENCH_LABEL		64
+
+/**
+ * Type that represents a benchmark result loaded from the baseline.
+ */
+typedef struct {
+	/** The benchmark label. */
+	char label[BENCH_LABEL];
+	/** The median of the samples. */
+	long long median;
+	/** Flag to indicate if the result was already compared. */
+	int used;
+} bench_base_t;
+
+/**
+ * Flag to indicate if the benchmark environment was read.
+ */
+static int bench_ready = 0;
+
+/**
+ * The results file, or NULL if results are not written.
+ */
+static FILE *bench_file = NULL;
+
+/**
+ * Flag to indicate if results are written in CSV instead of JSON.
+ */
+static int bench_csv = 0;
+
+/**
+ * Number of results already written.
+ */
+static int bench_written = 0;
+
+/**
+ * Number of warm-up executions before the first sample of a benchmark.
+ */
+static int bench_warm = BENCH;
+
+/**
+ * Percentage increase over the baseline flagged as a regression.
+ */
+static int bench_threshold = 10;
+
+/**
+ * The results loaded from the baseline.
+ */
+static bench_base_t *bench_base = NULL;
+
+/**
+ * Number of results loaded from the baseline.
+ */
+static int bench_bases = 0;
+
+/**
+ * Number of regressions found.
+ */
+static int bench_regress = 0;
+
+/**
+ * The unit of the timings.
+ */
+#if TIMER == POSIX || TIMER == ANSI || (OPSYS == DUINO && TIMER == HREAL)
+#define BENCH_UNIT		"microsec"
+#elif TIMER == CYCLE
+#define BENCH_UNIT		"cycles"
+#else
+#define BENCH_UNIT		"nanosec"
+#endif
+
+/**
+ * Compares two timings, used to sort samples.
+ *
+ * @param[in] a				- the first timing.
+ * @param[in] b				- the second timing.
+ * @return negative, zero or positive if a is smaller, equal or larger than b.
+ */
+static int bench_order(const void *a, const void *b) {
+	long long x = *(const long long *)a, y = *(const long long *)b;
+	return (x > y) - (x < y);
+}
+
+/**
+ * Reads a label enclosed in double quotes, undoing the escaping of the JSON
+ * or CSV formats.
+ *
+ * @param[out] label		- the label read.
+ * @param[in] str			- the string starting at the opening quote.
+ * @param[in] csv			- flag to indicate if the string uses CSV escaping.
+ * @return a pointer to the character after the closing quote, or NULL.
+ */
+static const char *bench_unquote(char *label, const char *str, int csv) {
+	int len = 0;
+
+	if (*str++ != '"') {
+		return NULL;
+	}
+	while (*str != '\0') {
+		if (csv && str[0] == '"' && str[1] == '"') {
+			str++;
+		} else if (!csv && str[0] == '\\' && str[1] != '\0') {
+			str++;
+		} else if (*str == '"') {
+			label[len] = '\0';
+			return str + 1;
+		}
+		if (len < BENCH_LABEL - 1) {
+			label[len++] = *str;
+		}
+		str++;
+	}
+	return NULL;
+}
+
+/**
+ * Writes a label enclosed in double quotes, escaping it for the JSON or CSV
+ * formats.
+ *
+ * @param[in] label			- the label to write.
+ */
+static void bench_quote(const char *label) {
+	fputc('"', bench_file);
+	for (; *label != '\0'; label++) {
+		if (*label == '"') {
+			fputc(bench_csv ? '"' : '\\', bench_file);
+		} else if (*label == '\\' && !bench_csv) {
+			fputc('\\', bench_file);
+		}
+		fputc(*label, bench_file);
+	}
+	fputc('"', bench_file);
+}
+
+/**
+ * Loads the medians of a previous run from a results file.
+ *
+ * @param[in] path			- the path of the results file.
+ */
+static void bench_load(const char *path) {
+	char line[1024], label[BENCH_LABEL];
+	const char *ptr;
+	bench_base_t *tmp;
+	FILE *file;
+	int field;
+
+	file = fopen(path, "r");
+	if (file == NULL) {
+		util_print("BENCH: could not read baseline %s\n", path);
+		return;
+	}
+	while (fgets(line, sizeof(line), file) != NULL) {
+		ptr = line;
+		while (*ptr == ' ' || *ptr == '\t') {
+			ptr++;
+		}
+		if (*ptr == '{') {
+			/* JSON record written by bench_print(). */
+			ptr = strstr(ptr, "\"label\": ");
+			if (ptr == NULL) {
+				continue;
+			}
+			ptr = bench_unquote(label, ptr + 9, 0);
+			if (ptr == NULL || (ptr = strstr(ptr, "\"median\": ")) == NULL) {
+				continue;
+			}
+			ptr += 10;
+		} else if (*ptr == '"') {
+			/* CSV record: label, unit, samples, mean, min, median, ... */
+			ptr = bench_unquote(label, ptr, 1);
+			for (field = 0; ptr != NULL && field < 4; field++) {
+				ptr = strchr(ptr + 1, ',');
+			}
+			if (ptr == NULL) {
+				continue;
+			}
+			ptr++;
+		} else {
+			continue;
+		}
+		tmp = realloc(bench_base, (bench_bases + 1) * sizeof(bench_base_t));
+		if (tmp == NULL) {
+			break;
+		}
+		bench_base = tmp;
+		strcpy(bench_base[bench_bases].label, label);
+		bench_base[bench_bases].median = strtoll(ptr, NULL, 10);
+		bench_base[bench_bases].used = 0;
+		bench_bases++;
+	}
+	fclose(file);
+}
+
+/**
+ * Reads the benchmark configuration from the environment and opens the results
+ * file.
+ */
+static void bench_setup(void) {
+	const char *path, *format, *value;
+
+	bench_ready = 1;
+
+	value = getenv("RELIC_BENCH_WARMUP");
+	if (value != NULL) {
+		bench_warm = MAX(0, atoi(value));
+	}
+	value = getenv("RELIC_BENCH_THRESHOLD");
+	if (value != NULL) {
+		bench_threshold = MAX(0, atoi(value));
+	}
+	value = getenv("RELIC_BENCH_BASELINE");
+	if (value != NULL) {
+		bench_load(value);
+	}
+
+	path = getenv("RELIC_BENCH_OUTPUT");
+	if (path == NULL) {
+		return;
+	}
+	format = getenv("RELIC_BENCH_FORMAT");
+	if (format != NULL) {
+		bench_csv = (strcmp(format, "csv") == 0);
+	} else {
+		value = strrchr(path, '.');
+		bench_csv = (value != NULL && strcmp(value, ".csv") == 0);
+	}
+	bench_file = fopen(path, "w");
+	if (bench_file == NULL) {
+		util_print("BENCH: could not write results to %s\n", path);
+		return;
+	}
+	if (bench_csv) {
+		fprintf(bench_file, "label,unit,samples,mean,min,median,p99,stddev\n");
+	} else {
+		fprintf(bench_file, "[\n");
+	}
+}
+
+/**
+ * Computes the statistics of the samples of the current benchmark.
+ *
+ * @param[out] min			- the minimum.
+ * @param[out] med			- the median.
+ * @param[out] p99			- the 99th percentile.
+ * @param[out] dev			- the standard deviation.
+ */
+static void bench_stats(long long *min, long long *med, long long *p99,
+		long long *dev) {
+	ctx_t *ctx = core_get();
+	int n = ctx->sampled;
+	long long t[BENCH], mean = 0, var = 0, r;
+
+	memcpy(t, ctx->samples, n * sizeof(long long));
+	qsort(t, n, sizeof(long long), bench_order);
+
+	*min = t[0];
+	*med = (n % 2 ? t[n / 2] : (t[n / 2 - 1] + t[n / 2]) / 2);
+	*p99 = t[MAX(0, (99 * n + 99) / 100 - 1)];
+
+	for (int i = 0; i < n; i++) {
+		mean += t[i];
+	}
+	mean /= n;
+	for (int i = 0; i < n; i++) {
+		var += (t[i] - mean) * (t[i] - mean);
+	}
+	var /= MAX(1, n - 1);
+
+	/* Integer square root by Newton's method. */
+	r = var;
+	if (r > 0) {
+		long long s = (r + 1) / 2;
+		while (s < r) {
+			r = s;
+			s = (r + var / r) / 2;
+		}
+	}
+	*dev = r;
+}
+
 #if defined(OVERH) && TIMER != NONE && BENCH > 1
 
 /**
@@ -72,6 +355,8 @@ void bench_overhead(void) {
 	int a[BENCH + 1];
 	int *tmpa;
 
+	/* Overhead estimation is not recorded as a benchmark. */
+	ctx->label = NULL;
 	do {
 		ctx->over = 0;
 		for (int l = 0; l < BENCH; l++) {
@@ -115,10 +400,26 @@ void bench_overhead(void) {
 
 #endif /* OVER && TIMER != NONE && BENCH > 1 */
 
-void bench_reset() {
+void bench_reset(const char *label) {
+	ctx_t *ctx = core_get();
+
+	if (!bench_ready) {
+		bench_setup();
+	}
 #if TIMER != NONE
-	core_get()->total = 0;
+	ctx->total = 0;
 #endif
+	ctx->sampled = 0;
+	ctx->warmup = bench_warm;
+	ctx->label = label;
+}
+
+int bench_warmup(void) {
+	ctx_t *ctx = core_get();
+	int r = ctx->warmup;
+
+	ctx->warmup = 0;
+	return r;
 }
 
 void bench_before() {
@@ -160,6 +461,9 @@ void bench_after() {
 
 #if TIMER != NONE
 	ctx->total += result;
+	if (ctx->sampled < BENCH) {
+		ctx->samples[ctx->sampled++] = result;
+	}
 #else
 	(void)result;
 	(void)ctx;
@@ -170,8 +474,15 @@ void bench_compute(int benches) {
 	ctx_t *ctx = core_get();
 #if TIMER != NONE
 	ctx->total = ctx->total / benches;
+	/* Each sample measured benches / sampled executions. */
+	for (int i = 0; i < ctx->sampled; i++) {
+		ctx->samples[i] = ctx->samples[i] * ctx->sampled / benches;
+	}
 #ifdef OVERH
 	ctx->total = ctx->total - ctx->over;
+	for (int i = 0; i < ctx->sampled; i++) {
+		ctx->samples[i] = ctx->samples[i] - ctx->over;
+	}
 #endif /* OVERH */
 #else
 	(void)benches;
@@ -181,21 +492,79 @@ void bench_compute(int benches) {
 
 void bench_print() {
 	ctx_t *ctx = core_get();
+	long long min, med, p99, dev;
 
-#if TIMER == POSIX || TIMER == ANSI || (OPSYS == DUINO && TIMER == HREAL)
-	util_print("%lld microsec", ctx->total);
-#elif TIMER == CYCLE
-	util_print("%lld cycles", ctx->total);
-#else
-	util_print("%lld nanosec", ctx->total);
-#endif
+	util_print("%lld " BENCH_UNIT, ctx->total);
 	if (ctx->total < 0) {
-		util_print(" (overflow or bad overhead estimation)\n");
-	} else {
-		util_print("\n");
+		util_print(" (overflow or bad overhead estimation)");
 	}
+
+	if (ctx->label != NULL && ctx->sampled > 0) {
+		bench_stats(&min, &med, &p99, &dev);
+
+		if (bench_file != NULL) {
+			if (bench_csv) {
+				bench_quote(ctx->label);
+				fprintf(bench_file, ",%s,%d,%lld,%lld,%lld,%lld,%lld\n",
+						BENCH_UNIT, ctx->sampled, ctx->total, min, med, p99,
+						dev);
+			} else {
+				fprintf(bench_file, "%s\t{\"label\": ",
+						bench_written ? ",\n" : "");
+				bench_quote(ctx->label);
+				fprintf(bench_file, ", \"unit\": \"%s\", \"samples\": %d, "
+						"\"mean\": %lld, \"min\": %lld, \"median\": %lld, "
+						"\"p99\": %lld, \"stddev\": %lld}", BENCH_UNIT,
+						ctx->sampled, ctx->total, min, med, p99, dev);
+			}
+			bench_written++;
+		}
+
+		/* Labels may repeat, so match them in the order they appear. */
+		for (int i = 0; i < bench_bases; i++) {
+			if (!bench_base[i].used && strncmp(bench_base[i].label,
+					ctx->label, BENCH_LABEL - 1) == 0) {
+				long long base = bench_base[i].median;
+				bench_base[i].used = 1;
+				if (base > 0 && med * 100 > base * (100 + bench_threshold)) {
+					util_print(" (regression: median %lld, baseline %lld)",
+							med, base);
+					bench_regress++;
+				}
+				break;
+			}
+		}
+	}
+	util_print("\n");
 }
 
 ull_t bench_total() {
 	return core_get()->total;
 }
+
+int bench_clean(void) {
+	int result = STS_OK;
+
+	if (!bench_ready) {
+		return result;
+	}
+	if (bench_file != NULL) {
+		if (!bench_csv) {
+			fprintf(bench_file, "\n]\n");
+		}
+		fclose(bench_file);
+		bench_file = NULL;
+	}
+	free(bench_base);
+	bench_base = NULL;
+	bench_bases = 0;
+	bench_written = 0;
+	bench_ready = 0;
+	if (bench_regress > 0) {
+		util_print("BENCH: %d regression(s) over the baseline.\n",
+				bench_regress);
+		bench_regress = 0;
+		result = STS_ERR;
+	}
+	return result;
+}
@@ -92,10 +92,14 @@ int core_init(void) {
 	core_ctx->reason[ERR_NO_CURVE] = MSG_NO_CURVE;
 	core_ctx->reason[ERR_NO_CONFIG] = MSG_NO_CONFIG;
 	core_ctx->last = NULL;
+	core_ctx->number = ERR_CAUGHT;
+	core_ctx->caught = 0;
 #endif /* CHECK */
 
-#if ALLOC == STATIC
-	core_ctx->next = 0;
+#if BENCH > 0
+	core_ctx->sampled = 0;
+	core_ctx->warmup = 0;
+	core_ctx->label = NULL;
 #endif
 
 #ifdef OVERH
@@ -103,6 +107,11 @@ int core_init(void) {
 #endif
 
 	core_ctx->code = STS_OK;
+	core_ctx->cores = CORES;
+
+#if ALLOC == STATIC
+	pool_init();
+#endif
 
 	TRY {
 		arch_init();
@@ -137,6 +146,8 @@ int core_init(void) {
 }
 
 int core_clean(void) {
+	int result = STS_OK;
+
 	rand_clean();
 #ifdef WITH_FP
 	fp_prime_clean();
@@ -160,8 +171,14 @@ int core_clean(void) {
 	pp_map_clean();
 #endif
 	arch_clean();
+#if BENCH > 0
+	result = bench_clean();
+#endif
+#if ALLOC == STATIC
+	pool_clean();
+#endif
 	core_ctx = NULL;
-	return STS_OK;
+	return result;
 }
 
 ctx_t *core_get() {
@@ -91,9 +91,15 @@ void err_full_msg(const char *function, const char *file, int line,
 
 void err_get_msg(err_t *e, char **msg) {
 	ctx_t *ctx = core_get();
+#ifdef NOJMP
+	*e = ctx->number;
+	*msg = ctx->reason[*e];
+	ctx->number = ERR_CAUGHT;
+#else
 	*e = *(ctx->last->error);
 	*msg = ctx->reason[*e];
 	ctx->last = NULL;
+#endif
 }
 
 #endif /* CHECK */
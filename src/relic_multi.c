@@ -0,0 +1,457 @@
+/*
+ * RELIC is an Efficient LIbrary for Cryptography
+ * Copyright (C) 2007-2015 RELIC Authors
+ *
+ * This file is part of RELIC. RELIC is legal property of its developers,
+ * whose names are not listed here. Please refer to the COPYRIGHT file
+ * for contact information.
+ *
+ * RELIC is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * RELIC is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with RELIC. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ *
+ * Implementation of the thread pool used to split batches of independent
+ * operations among the available processor cores.
+ *
+ * @ingroup relic
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "relic_core.h"
+#include "relic_multi.h"
+#include "relic_util.h"
+
+/*============================================================================*/
+/* Private definitions                                                        */
+/*============================================================================*/
+
+/**
+ * Packs a range of tasks [L, H) in a single word.
+ */
+#define MULTI_PACK(L, H)	(((uint64_t)(L) << 32) | (uint32_t)(H))
+
+/**
+ * Returns the first task of a packed range.
+ */
+#define MULTI_LOW(R)		((int)((R) >> 32))
+
+/**
+ * Returns the task after the last one in a packed range.
+ */
+#define MULTI_HIGH(R)		((int)(uint32_t)(R))
+
+#if MULTI != NONE
+
+/**
+ * Reads a shared variable.
+ */
+#define MULTI_LOAD(A)		__atomic_load_n(A, __ATOMIC_ACQUIRE)
+
+/**
+ * Writes a shared variable.
+ */
+#define MULTI_STORE(A, B)	__atomic_store_n(A, B, __ATOMIC_RELEASE)
+
+/**
+ * Replaces a shared variable if it still holds an expected value, otherwise
+ * updates the expected value with the current one.
+ */
+#define MULTI_CAS(A, B, C)													\
+	__atomic_compare_exchange_n(A, B, C, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+
+/**
+ * Type that represents a batch of tasks being processed by the thread pool.
+ */
+typedef struct {
+	/** The function that processes one task. */
+	void (*task)(void *, int);
+	/** The arguments shared by all tasks. */
+	void *args;
+	/** The number of threads taking part in the batch. */
+	int threads;
+	/** The range of tasks still to be claimed by each thread. */
+	uint64_t range[CORES];
+	/** Flag to indicate if some task raised an error. */
+	int code;
+	/** The error raised by a task. */
+	err_t error;
+	/** Identifier of the prime field configured by the caller. */
+	int fp_id;
+	/** Identifier of the prime elliptic curve configured by the caller. */
+	int ep_id;
+	/** Type of the twist configured by the caller. */
+	int ep2_twist;
+	/** Identifier of the binary elliptic curve configured by the caller. */
+	int eb_id;
+	/** Identifier of the Edwards elliptic curve configured by the caller. */
+	int ed_id;
+#if RAND != CALL
+	/** Seed drawn from the generator of the caller for the worker threads. */
+	uint8_t seed[SEED_SIZE];
+#else
+	/** The callback used by the caller to obtain random bytes. */
+	void (*rand_call)(uint8_t *, int, void *);
+	/** The argument passed to the callback. */
+	void *rand_args;
+#endif
+} multi_job_t;
+
+/**
+ * Configures the library context of the current thread with the parameters
+ * chosen by the thread that submitted a batch. The generator of the thread is
+ * replaced by one derived from the generator of the caller.
+ *
+ * @param[in] job			- the batch of tasks.
+ * @param[in] id			- the thread identifier inside the batch.
+ */
+static void multi_sync(const multi_job_t *job, int id) {
+#if RAND != CALL
+	uint8_t seed[SEED_SIZE];
+#endif
+
+	if (core_get() == NULL) {
+		core_init();
+	}
+#if RAND != CALL
+	memcpy(seed, job->seed, SEED_SIZE);
+	seed[0] ^= (uint8_t)id;
+	seed[1] ^= (uint8_t)(id >> 8);
+	core_get()->seeded = 0;
+	rand_seed(seed, SEED_SIZE);
+	util_wipe(seed, SEED_SIZE);
+#else
+	rand_seed(job->rand_call, job->rand_args);
+	(void)id;
+#endif
+#ifdef WITH_FP
+	if (job->fp_id != 0 && fp_param_get() != job->fp_id) {
+		fp_param_set(job->fp_id);
+	}
+#endif
+#ifdef WITH_EP
+	if (job->ep_id != 0 && ep_param_get() != job->ep_id) {
+		ep_param_set(job->ep_id);
+#ifdef WITH_PP
+		ep2_curve_set_twist(job->ep2_twist);
+#endif
+	}
+#endif
+#ifdef WITH_EB
+	if (job->eb_id != 0 && eb_param_get() != job->eb_id) {
+		eb_param_set(job->eb_id);
+	}
+#endif
+#ifdef WITH_ED
+	if (job->ed_id != 0 && ed_param_get() != job->ed_id) {
+		ed_param_set(job->ed_id);
+	}
+#endif
+	(void)job;
+}
+
+/**
+ * Claims the next task to be processed by a thread. Tasks are taken from the
+ * range owned by the thread and, when it is empty, half of the range of another
+ * thread is stolen.
+ *
+ * @param[in,out] job		- the batch of tasks.
+ * @param[in] id			- the thread identifier inside the batch.
+ * @return the index of the claimed task or -1 if no task remains.
+ */
+static int multi_take(multi_job_t *job, int id) {
+	uint64_t r;
+	int v, low, mid, high;
+
+	r = MULTI_LOAD(&job->range[id]);
+	while (MULTI_LOW(r) < MULTI_HIGH(r)) {
+		if (MULTI_CAS(&job->range[id], &r,
+				MULTI_PACK(MULTI_LOW(r) + 1, MULTI_HIGH(r)))) {
+			return MULTI_LOW(r);
+		}
+	}
+
+	for (v = 1; v < job->threads; v++) {
+		uint64_t *victim = &job->range[(id + v) % job->threads];
+		r = MULTI_LOAD(victim);
+		while (MULTI_LOW(r) < MULTI_HIGH(r)) {
+			low = MULTI_LOW(r);
+			high = MULTI_HIGH(r);
+			mid = low + (high - low) / 2;
+			if (MULTI_CAS(victim, &r, MULTI_PACK(low, mid))) {
+				/* Our own range is empty, so no other thread touches it. */
+				MULTI_STORE(&job->range[id], MULTI_PACK(mid + 1, high));
+				return mid;
+			}
+		}
+	}
+	return -1;
+}
+
+/**
+ * Processes tasks of a batch until no task remains to be claimed.
+ *
+ * @param[in,out] job		- the batch of tasks.
+ * @param[in] id			- the thread identifier inside the batch.
+ */
+static void multi_work(multi_job_t *job, int id) {
+	ctx_t *ctx;
+	err_t e;
+	int i, code;
+
+	if (id != 0) {
+		multi_sync(job, id);
+	}
+	ctx = core_get();
+	code = ctx->code;
+	while ((i = multi_take(job, id)) != -1) {
+		/* Errors are recorded and thrown again by the caller of the batch. */
+		e = ERR_CAUGHT;
+		ctx->code = STS_OK;
+		TRY {
+			job->task(job->args, i);
+		}
+		CATCH(e) {
+			ctx->code = STS_ERR;
+		}
+		if (ctx->code == STS_ERR) {
+			if (e != ERR_CAUGHT) {
+				MULTI_STORE(&job->error, e);
+			}
+			MULTI_STORE(&job->code, STS_ERR);
+		}
+	}
+	ctx->code = code;
+}
+
+#if MULTI == PTHREAD
+
+/**
+ * Protects the state of the thread pool.
+ */
+static pthread_mutex_t multi_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * Serializes batches submitted by different threads.
+ */
+static pthread_mutex_t multi_busy = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * Signals the worker threads that a new batch was submitted.
+ */
+static pthread_cond_t multi_wake = PTHREAD_COND_INITIALIZER;
+
+/**
+ * Signals the submitting thread that a worker thread left the batch.
+ */
+static pthread_cond_t multi_done = PTHREAD_COND_INITIALIZER;
+
+/**
+ * Guarantees that the worker threads are created only once.
+ */
+static pthread_once_t multi_once = PTHREAD_ONCE_INIT;
+
+/**
+ * The batch currently open to worker threads, or NULL.
+ */
+static multi_job_t *multi_job = NULL;
+
+/**
+ * Counter of submitted batches.
+ */
+static int multi_epoch = 0;
+
+/**
+ * Number of worker threads currently processing a batch.
+ */
+static int multi_active = 0;
+
+/**
+ * Number of worker threads created.
+ */
+static int multi_spawned = 0;
+
+/**
+ * Flag to indicate if the current thread is processing a batch, in which case
+ * nested batches run sequentially.
+ */
+static __thread int multi_worker = 0;
+
+/**
+ * Main loop of a worker thread.
+ *
+ * @param[in] ptr			- the thread identifier inside a batch.
+ * @return NULL.
+ */
+static void *multi_loop(void *ptr) {
+	int id = (int)(intptr_t)ptr, epoch = 0;
+	multi_job_t *job;
+
+	multi_worker = 1;
+	core_init();
+
+	pthread_mutex_lock(&multi_lock);
+	for (;;) {
+		while (multi_job == NULL || multi_epoch == epoch) {
+			pthread_cond_wait(&multi_wake, &multi_lock);
+		}
+		epoch = multi_epoch;
+		job = multi_job;
+		if (id >= job->threads) {
+			continue;
+		}
+		multi_active++;
+		pthread_mutex_unlock(&multi_lock);
+
+		multi_work(job, id);
+
+		pthread_mutex_lock(&multi_lock);
+		multi_active--;
+		pthread_cond_signal(&multi_done);
+	}
+	return NULL;
+}
+
+/**
+ * Creates the worker threads.
+ */
+static void multi_spawn(void) {
+	pthread_attr_t attr;
+	pthread_t thread;
+
+	pthread_attr_init(&attr);
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+	for (int i = 1; i < CORES; i++) {
+		if (pthread_create(&thread, &attr, multi_loop, (void *)(intptr_t)i)) {
+			break;
+		}
+		multi_spawned++;
+	}
+	pthread_attr_destroy(&attr);
+}
+
+#endif /* MULTI == PTHREAD */
+
+#endif /* MULTI != NONE */
+
+/*============================================================================*/
+/* Public definitions                                                         */
+/*============================================================================*/
+
+int multi_get_cores(void) {
+	return core_get()->cores;
+}
+
+void multi_set_cores(int cores) {
+	core_get()->cores = MAX(1, MIN(cores, CORES));
+}
+
+void multi_run(void (*task)(void *, int), void *args, int n) {
+	ctx_t *ctx = core_get();
+	int i, threads = MIN(ctx->cores, n);
+
+#if MULTI == PTHREAD
+	pthread_once(&multi_once, multi_spawn);
+	threads = MIN(threads, multi_spawned + 1);
+	if (multi_worker) {
+		threads = 1;
+	}
+#elif MULTI == OPENMP
+	if (omp_in_parallel()) {
+		threads = 1;
+	}
+#else
+	threads = 1;
+#endif
+
+	if (threads <= 1) {
+		for (i = 0; i < n; i++) {
+			task(args, i);
+		}
+		return;
+	}
+
+#if MULTI != NONE
+	multi_job_t job;
+
+	job.task = task;
+	job.args = args;
+	job.threads = threads;
+	job.code = STS_OK;
+	job.error = ERR_CAUGHT;
+	for (i = 0; i < threads; i++) {
+		job.range[i] = MULTI_PACK(i * n / threads, (i + 1) * n / threads);
+	}
+	job.fp_id = job.ep_id = job.ep2_twist = job.eb_id = job.ed_id = 0;
+#ifdef WITH_FP
+	job.fp_id = ctx->fp_id;
+#endif
+#ifdef WITH_EP
+	job.ep_id = ctx->ep_id;
+#endif
+#ifdef WITH_EPX
+	job.ep2_twist = ctx->ep2_is_twist;
+#endif
+#ifdef WITH_EB
+	job.eb_id = ctx->eb_id;
+#endif
+#ifdef WITH_ED
+	job.ed_id = ctx->ed_id;
+#endif
+#if RAND != CALL
+	rand_bytes(job.seed, SEED_SIZE);
+#else
+	job.rand_call = ctx->rand_call;
+	job.rand_args = ctx->rand_args;
+#endif
+
+#if MULTI == PTHREAD
+	pthread_mutex_lock(&multi_busy);
+	pthread_mutex_lock(&multi_lock);
+	multi_job = &job;
+	multi_epoch++;
+	pthread_cond_broadcast(&multi_wake);
+	pthread_mutex_unlock(&multi_lock);
+
+	multi_worker = 1;
+	multi_work(&job, 0);
+	multi_worker = 0;
+
+	/* Every task was claimed, close the batch and wait for the workers. */
+	pthread_mutex_lock(&multi_lock);
+	multi_job = NULL;
+	while (multi_active > 0) {
+		pthread_cond_wait(&multi_done, &multi_lock);
+	}
+	pthread_mutex_unlock(&multi_lock);
+	pthread_mutex_unlock(&multi_busy);
+#elif MULTI == OPENMP
+#pragma omp parallel num_threads(threads)
+	{
+		multi_work(&job, omp_get_thread_num());
+	}
+#endif
+
+#if RAND != CALL
+	util_wipe(job.seed, SEED_SIZE);
+#endif
+
+	if (job.code == STS_ERR) {
+		THROW(job.error);
+	}
+#endif
+}
@@ -41,44 +41,278 @@
 #include "relic_pool.h"
 
 /*============================================================================*/
-/* Public definitions                                                         */
+/* Private definitions                                                        */
 /*============================================================================*/
 
 #if ALLOC == STATIC
 
-dig_t *pool_get(void) {
-	int i, r;
-	ctx_t *ctx = core_get();
+/**
+ * Precision in digits of the size class for field elements.
+ */
+#define POOL_DIGS_FP	MAX(FP_DIGS, FB_DIGS)
 
-	if (ctx->next == POOL_EMPTY) {
-		return NULL;
+/**
+ * Number of digits needed to keep the pool elements aligned.
+ */
+#define POOL_UNIT		(ALIGN > (int)sizeof(dig_t) ? ALIGN / (int)sizeof(dig_t) : 1)
+
+/**
+ * Rounds a number of digits to a multiple of the alignment unit.
+ */
+#define POOL_CEIL(D)	(((D) + POOL_UNIT - 1) / POOL_UNIT * POOL_UNIT)
+
+/**
+ * Number of digits reserved for the header of each pool element.
+ */
+#define POOL_HDR		POOL_CEIL((int)((sizeof(pool_hdr_t) + sizeof(dig_t) - 1) / sizeof(dig_t)))
+
+/**
+ * Number of digits occupied by each element of a size class, including header.
+ */
+#define POOL_STRIDE(D)	(POOL_HDR + POOL_CEIL(D))
+
+#if MULTI == NONE
+
+/**
+ * Reads a shared variable.
+ */
+#define POOL_LOAD(A)		(*(A))
+
+/**
+ * Writes a shared variable.
+ */
+#define POOL_STORE(A, B)	(*(A) = (B))
+
+/**
+ * Replaces a shared variable if it still holds an expected value, otherwise
+ * updates the expected value with the current one.
+ */
+#define POOL_CAS(A, B, C)													\
+	(*(A) == *(B) ? (*(A) = (C), 1) : (*(B) = *(A), 0))
+
+/**
+ * Adds a value to a shared variable and returns the new value.
+ */
+#define POOL_ADD(A, B)		(*(A) += (B))
+
+#else
+
+#define POOL_LOAD(A)		__atomic_load_n(A, __ATOMIC_ACQUIRE)
+
+#define POOL_STORE(A, B)	__atomic_store_n(A, B, __ATOMIC_RELEASE)
+
+#define POOL_CAS(A, B, C)													\
+	__atomic_compare_exchange_n(A, B, C, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+
+#define POOL_ADD(A, B)		__atomic_add_fetch(A, B, __ATOMIC_ACQ_REL)
+
+#endif
+
+/**
+ * The statically reserved first slab of each size class.
+ */
+static align dig_t pool_slab_fp[POOL_SIZE * POOL_STRIDE(POOL_DIGS_FP)];
+static align dig_t pool_slab_bn[POOL_SIZE * POOL_STRIDE(BN_SIZE)];
+static align dig_t pool_slab_dv[POOL_SIZE * POOL_STRIDE(DV_DIGS)];
+
+/**
+ * The global pool of digit vectors, shared by all threads.
+ */
+static pool_t pool[POOL_CLASSES] = {
+	{ 0, 0, { pool_slab_fp } },
+	{ 0, 0, { pool_slab_bn } },
+	{ 0, 0, { pool_slab_dv } }
+};
+
+/**
+ * The number of library contexts currently initialized.
+ */
+static int pool_users = 0;
+
+/**
+ * The precision in digits of each size class.
+ */
+static const int pool_digs[POOL_CLASSES] = {
+	POOL_DIGS_FP, BN_SIZE, DV_DIGS
+};
+
+/**
+ * Returns the size class able to store a given number of digits.
+ *
+ * @param[in] digits		- the required precision in digits.
+ * @return the smallest size class with enough capacity, or -1 if none exists.
+ */
+static int pool_kind(int digits) {
+	int i, kind = -1;
+
+	for (i = 0; i < POOL_CLASSES; i++) {
+		if (digits <= pool_digs[i]) {
+			if (kind == -1 || pool_digs[i] < pool_digs[kind]) {
+				kind = i;
+			}
+		}
 	}
+	return kind;
+}
 
-	/** Allocate a free element. */
-	r = ctx->next;
-	ctx->pool[r].state = POOL_USED;
+/**
+ * Returns the header of the pool element at a certain position.
+ *
+ * @param[in] kind			- the size class.
+ * @param[in] pos			- the position of the element inside the class.
+ * @return the address of the element header.
+ */
+static pool_hdr_t *pool_hdr(int kind, uint32_t pos) {
+	dig_t *slab = POOL_LOAD(&pool[kind].slab[pos / POOL_SIZE]);
+
+	return (pool_hdr_t *)(slab + (pos % POOL_SIZE) *
+			POOL_STRIDE(pool_digs[kind]));
+}
+
+/**
+ * Allocates a new slab of memory for a size class.
+ *
+ * @param[in] kind			- the size class.
+ * @return the address of the new slab or NULL if no memory is available.
+ */
+static dig_t *pool_slab(int kind) {
+	size_t size = POOL_SIZE * POOL_STRIDE(pool_digs[kind]) * sizeof(dig_t);
+	dig_t *slab = NULL;
+
+#if ALIGN == 1
+	slab = (dig_t *)malloc(size);
+#elif OPSYS == WINDOWS
+	slab = (dig_t *)_aligned_malloc(size, ALIGN);
+#else
+	if (posix_memalign((void **)&slab, ALIGN, size) != 0) {
+		slab = NULL;
+	}
+#endif
+	return slab;
+}
+
+/**
+ * Releases a slab of memory allocated by pool_slab().
+ *
+ * @param[in] slab			- the slab to release.
+ */
+static void pool_drop(dig_t *slab) {
+#if OPSYS == WINDOWS && ALIGN > 1
+	_aligned_free(slab);
+#else
+	free(slab);
+#endif
+}
 
-	/* Search for a new free element. */
-	for (i = (r + 1) % POOL_SIZE; i != r; i = (i + 1) % POOL_SIZE) {
-		if (ctx->pool[i].state == POOL_FREE) {
-			break;
+/**
+ * Hands out an element that was never used before, growing the size class by
+ * one slab if necessary.
+ *
+ * @param[in] kind			- the size class.
+ * @return the address of the element or NULL if no memory is available.
+ */
+static dig_t *pool_grow(int kind) {
+	pool_t *p = &pool[kind];
+	pool_hdr_t *hdr;
+	dig_t *slab, *null;
+	uint32_t pos;
+
+	pos = POOL_LOAD(&p->fresh);
+	do {
+		if (pos >= (uint32_t)POOL_SIZE * POOL_SLABS) {
+			return NULL;
+		}
+	} while (!POOL_CAS(&p->fresh, &pos, pos + 1));
+
+	if (POOL_LOAD(&p->slab[pos / POOL_SIZE]) == NULL) {
+		slab = pool_slab(kind);
+		if (slab == NULL) {
+			return NULL;
 		}
+		null = NULL;
+		if (!POOL_CAS(&p->slab[pos / POOL_SIZE], &null, slab)) {
+			/* Another thread published this slab first. */
+			pool_drop(slab);
+		}
+	}
+
+	hdr = pool_hdr(kind, pos);
+	hdr->self = pos + 1;
+	hdr->kind = kind;
+	return (dig_t *)hdr + POOL_HDR;
+}
+
+#endif /* ALLOC == STATIC */
+
+/*============================================================================*/
+/* Public definitions                                                         */
+/*============================================================================*/
+
+#if ALLOC == STATIC
+
+dig_t *pool_get(int digits) {
+	int kind = pool_kind(digits);
+	pool_hdr_t *hdr;
+	uint64_t head, next;
+
+	if (kind == -1) {
+		return NULL;
 	}
-	if (i == r) {
-		ctx->next = POOL_EMPTY;
-	} else {
-		ctx->next = i;
+
+	head = POOL_LOAD(&pool[kind].head);
+	while ((uint32_t)head != POOL_EMPTY) {
+		/* Elements are never unmapped, so reading a stale header is safe. */
+		hdr = pool_hdr(kind, (uint32_t)head - 1);
+		next = POOL_LOAD(&hdr->next);
+		next |= ((head >> 32) + 1) << 32;
+		if (POOL_CAS(&pool[kind].head, &head, next)) {
+			return (dig_t *)hdr + POOL_HDR;
+		}
 	}
-	ctx->pool[r].elem[DV_DIGS] = r;
-	return (ctx->pool[r].elem);
+
+	return pool_grow(kind);
 }
 
 void pool_put(dig_t *a) {
-	int pos = a[DV_DIGS];
-	ctx_t *ctx = core_get();
+	pool_hdr_t *hdr = (pool_hdr_t *)(a - POOL_HDR);
+	pool_t *p = &pool[hdr->kind];
+	uint64_t head, next;
+
+	head = POOL_LOAD(&p->head);
+	do {
+		POOL_STORE(&hdr->next, (uint32_t)head);
+		next = (((head >> 32) + 1) << 32) | hdr->self;
+	} while (!POOL_CAS(&p->head, &head, next));
+}
+
+void pool_init(void) {
+	POOL_ADD(&pool_users, 1);
+}
+
+void pool_clean(void) {
+	uint32_t pos, left;
+	int i, j;
 
-	ctx->pool[pos].state = POOL_FREE;
-	ctx->next = pos;
+	if (POOL_ADD(&pool_users, -1) != 0) {
+		return;
+	}
+
+	for (i = 0; i < POOL_CLASSES; i++) {
+		/* Keep the slabs if an element is still referenced. */
+		left = 0;
+		for (pos = (uint32_t)pool[i].head; pos != POOL_EMPTY; left++) {
+			pos = pool_hdr(i, pos - 1)->next;
+		}
+		if (left != pool[i].fresh) {
+			continue;
+		}
+		for (j = 1; j < POOL_SLABS && pool[i].slab[j] != NULL; j++) {
+			pool_drop(pool[i].slab[j]);
+			pool[i].slab[j] = NULL;
+		}
+		pool[i].head = POOL_EMPTY;
+		pool[i].fresh = 0;
+	}
 }
 
 #endif /* ALLOC == STATIC */
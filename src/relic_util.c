@@ -160,6 +160,14 @@ int util_cmp_const(const void * a, const void *b, int size) {
 	return (result == 0 ? CMP_EQ : CMP_NE);
 }
 
+void util_wipe(void *a, int n) {
+	volatile uint8_t *_a = (volatile uint8_t *)a;
+
+	while (n-- > 0) {
+		*_a++ = 0;
+	}
+}
+
 void util_printf(const char *format, ...) {
 #ifndef QUIET
 #if ARCH == AVR && OPSYS == NONE
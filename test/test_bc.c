@@ -0,0 +1,637 @@
+/*
+ * RELIC is an Efficient LIbrary for Cryptography
+ * Copyright (C) 2007-2015 RELIC Authors
+ *
+ * This file is part of RELIC. RELIC is legal property of its developers,
+ * whose names are not listed here. Please refer to the COPYRIGHT file
+ * for contact information.
+ *
+ * RELIC is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * RELIC is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with RELIC. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ *
+ * Tests for implementation of block ciphers.
+ *
+ * @version $Id$
+ * @ingroup test
+ */
+
+#include <stdio.h>
+
+#include "relic.h"
+#include "relic_test.h"
+
+/*
+ * Test vectors taken from:
+ * - FIPS 197, Appendix C
+ * - NIST SP 800-38A, Sections F.2 and F.5
+ * - The Galois/Counter Mode of Operation (GCM), Test Cases 4, 6 and 16
+ * - RFC 8439, Sections 2.4.2, 2.5.2 and 2.8.2
+ */
+
+uint8_t aes_key[] = {
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B,
+	0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+	0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F
+};
+
+uint8_t aes_pt[] = {
+	0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xAA, 0xBB,
+	0xCC, 0xDD, 0xEE, 0xFF
+};
+
+uint8_t aes_ct[3][16] = {
+	{0x69, 0xC4, 0xE0, 0xD8, 0x6A, 0x7B, 0x04, 0x30, 0xD8, 0xCD, 0xB7, 0x80,
+		0x70, 0xB4, 0xC5, 0x5A},
+	{0xDD, 0xA9, 0x7C, 0xA4, 0x86, 0x4C, 0xDF, 0xE0, 0x6E, 0xAF, 0x70, 0xA0,
+		0xEC, 0x0D, 0x71, 0x91},
+	{0x8E, 0xA2, 0xB7, 0xCA, 0x51, 0x67, 0x45, 0xBF, 0xEA, 0xFC, 0x49, 0x90,
+		0x4B, 0x49, 0x60, 0x89}
+};
+
+uint8_t cbc_key[] = {
+	0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7, 0x15, 0x88,
+	0x09, 0xCF, 0x4F, 0x3C
+};
+
+uint8_t cbc_pt[] = {
+	0x6B, 0xC1, 0xBE, 0xE2, 0x2E, 0x40, 0x9F, 0x96, 0xE9, 0x3D, 0x7E, 0x11,
+	0x73, 0x93, 0x17, 0x2A, 0xAE, 0x2D, 0x8A, 0x57, 0x1E, 0x03, 0xAC, 0x9C,
+	0x9E, 0xB7, 0x6F, 0xAC, 0x45, 0xAF, 0x8E, 0x51, 0x30, 0xC8, 0x1C, 0x46,
+	0xA3, 0x5C, 0xE4, 0x11, 0xE5, 0xFB, 0xC1, 0x19, 0x1A, 0x0A, 0x52, 0xEF,
+	0xF6, 0x9F, 0x24, 0x45, 0xDF, 0x4F, 0x9B, 0x17, 0xAD, 0x2B, 0x41, 0x7B,
+	0xE6, 0x6C, 0x37, 0x10
+};
+
+uint8_t cbc_ct[] = {
+	0x76, 0x49, 0xAB, 0xAC, 0x81, 0x19, 0xB2, 0x46, 0xCE, 0xE9, 0x8E, 0x9B,
+	0x12, 0xE9, 0x19, 0x7D, 0x50, 0x86, 0xCB, 0x9B, 0x50, 0x72, 0x19, 0xEE,
+	0x95, 0xDB, 0x11, 0x3A, 0x91, 0x76, 0x78, 0xB2, 0x73, 0xBE, 0xD6, 0xB8,
+	0xE3, 0xC1, 0x74, 0x3B, 0x71, 0x16, 0xE6, 0x9E, 0x22, 0x22, 0x95, 0x16,
+	0x3F, 0xF1, 0xCA, 0xA1, 0x68, 0x1F, 0xAC, 0x09, 0x12, 0x0E, 0xCA, 0x30,
+	0x75, 0x86, 0xE1, 0xA7, 0x8C, 0xB8, 0x28, 0x07, 0x23, 0x0E, 0x13, 0x21,
+	0xD3, 0xFA, 0xE0, 0x0D, 0x18, 0xCC, 0x20, 0x12
+};
+
+uint8_t ctr_iv[] = {
+	0xF0, 0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8, 0xF9, 0xFA, 0xFB,
+	0xFC, 0xFD, 0xFE, 0xFF
+};
+
+uint8_t ctr_ct[] = {
+	0x87, 0x4D, 0x61, 0x91, 0xB6, 0x20, 0xE3, 0x26, 0x1B, 0xEF, 0x68, 0x64,
+	0x99, 0x0D, 0xB6, 0xCE, 0x98, 0x06, 0xF6, 0x6B, 0x79, 0x70, 0xFD, 0xFF,
+	0x86, 0x17, 0x18, 0x7B, 0xB9, 0xFF, 0xFD, 0xFF, 0x5A, 0xE4, 0xDF, 0x3E,
+	0xDB, 0xD5, 0xD3, 0x5E, 0x5B, 0x4F, 0x09, 0x02, 0x0D, 0xB0, 0x3E, 0xAB,
+	0x1E, 0x03, 0x1D, 0xDA, 0x2F, 0xBE, 0x03, 0xD1, 0x79, 0x21, 0x70, 0xA0,
+	0xF3, 0x00, 0x9C, 0xEE
+};
+
+uint8_t gcm_key[] = {
+	0xFE, 0xFF, 0xE9, 0x92, 0x86, 0x65, 0x73, 0x1C, 0x6D, 0x6A, 0x8F, 0x94,
+	0x67, 0x30, 0x83, 0x08, 0xFE, 0xFF, 0xE9, 0x92, 0x86, 0x65, 0x73, 0x1C,
+	0x6D, 0x6A, 0x8F, 0x94, 0x67, 0x30, 0x83, 0x08
+};
+
+uint8_t gcm_pt[] = {
+	0xD9, 0x31, 0x32, 0x25, 0xF8, 0x84, 0x06, 0xE5, 0xA5, 0x59, 0x09, 0xC5,
+	0xAF, 0xF5, 0x26, 0x9A, 0x86, 0xA7, 0xA9, 0x53, 0x15, 0x34, 0xF7, 0xDA,
+	0x2E, 0x4C, 0x30, 0x3D, 0x8A, 0x31, 0x8A, 0x72, 0x1C, 0x3C, 0x0C, 0x95,
+	0x95, 0x68, 0x09, 0x53, 0x2F, 0xCF, 0x0E, 0x24, 0x49, 0xA6, 0xB5, 0x25,
+	0xB1, 0x6A, 0xED, 0xF5, 0xAA, 0x0D, 0xE6, 0x57, 0xBA, 0x63, 0x7B, 0x39
+};
+
+uint8_t gcm_aad[] = {
+	0xFE, 0xED, 0xFA, 0xCE, 0xDE, 0xAD, 0xBE, 0xEF, 0xFE, 0xED, 0xFA, 0xCE,
+	0xDE, 0xAD, 0xBE, 0xEF, 0xAB, 0xAD, 0xDA, 0xD2
+};
+
+uint8_t gcm_iv[] = {
+	0xCA, 0xFE, 0xBA, 0xBE, 0xFA, 0xCE, 0xDB, 0xAD, 0xDE, 0xCA, 0xF8, 0x88
+};
+
+uint8_t gcm_iv_long[] = {
+	0x93, 0x13, 0x22, 0x5D, 0xF8, 0x84, 0x06, 0xE5, 0x55, 0x90, 0x9C, 0x5A,
+	0xFF, 0x52, 0x69, 0xAA, 0x6A, 0x7A, 0x95, 0x38, 0x53, 0x4F, 0x7D, 0xA1,
+	0xE4, 0xC3, 0x03, 0xD2, 0xA3, 0x18, 0xA7, 0x28, 0xC3, 0xC0, 0xC9, 0x51,
+	0x56, 0x80, 0x95, 0x39, 0xFC, 0xF0, 0xE2, 0x42, 0x9A, 0x6B, 0x52, 0x54,
+	0x16, 0xAE, 0xDB, 0xF5, 0xA0, 0xDE, 0x6A, 0x57, 0xA6, 0x37, 0xB3, 0x9B
+};
+
+uint8_t gcm_ct[3][76] = {
+	{0x42, 0x83, 0x1E, 0xC2, 0x21, 0x77, 0x74, 0x24, 0x4B, 0x72, 0x21, 0xB7,
+		0x84, 0xD0, 0xD4, 0x9C, 0xE3, 0xAA, 0x21, 0x2F, 0x2C, 0x02, 0xA4, 0xE0,
+		0x35, 0xC1, 0x7E, 0x23, 0x29, 0xAC, 0xA1, 0x2E, 0x21, 0xD5, 0x14, 0xB2,
+		0x54, 0x66, 0x93, 0x1C, 0x7D, 0x8F, 0x6A, 0x5A, 0xAC, 0x84, 0xAA, 0x05,
+		0x1B, 0xA3, 0x0B, 0x39, 0x6A, 0x0A, 0xAC, 0x97, 0x3D, 0x58, 0xE0, 0x91,
+		0x5B, 0xC9, 0x4F, 0xBC, 0x32, 0x21, 0xA5, 0xDB, 0x94, 0xFA, 0xE9, 0x5A,
+		0xE7, 0x12, 0x1A, 0x47},
+	{0x8C, 0xE2, 0x49, 0x98, 0x62, 0x56, 0x15, 0xB6, 0x03, 0xA0, 0x33, 0xAC,
+		0xA1, 0x3F, 0xB8, 0x94, 0xBE, 0x91, 0x12, 0xA5, 0xC3, 0xA2, 0x11, 0xA8,
+		0xBA, 0x26, 0x2A, 0x3C, 0xCA, 0x7E, 0x2C, 0xA7, 0x01, 0xE4, 0xA9, 0xA4,
+		0xFB, 0xA4, 0x3C, 0x90, 0xCC, 0xDC, 0xB2, 0x81, 0xD4, 0x8C, 0x7C, 0x6F,
+		0xD6, 0x28, 0x75, 0xD2, 0xAC, 0xA4, 0x17, 0x03, 0x4C, 0x34, 0xAE, 0xE5,
+		0x61, 0x9C, 0xC5, 0xAE, 0xFF, 0xFE, 0x0B, 0xFA, 0x46, 0x2A, 0xF4, 0x3C,
+		0x16, 0x99, 0xD0, 0x50},
+	{0x52, 0x2D, 0xC1, 0xF0, 0x99, 0x56, 0x7D, 0x07, 0xF4, 0x7F, 0x37, 0xA3,
+		0x2A, 0x84, 0x42, 0x7D, 0x64, 0x3A, 0x8C, 0xDC, 0xBF, 0xE5, 0xC0, 0xC9,
+		0x75, 0x98, 0xA2, 0xBD, 0x25, 0x55, 0xD1, 0xAA, 0x8C, 0xB0, 0x8E, 0x48,
+		0x59, 0x0D, 0xBB, 0x3D, 0xA7, 0xB0, 0x8B, 0x10, 0x56, 0x82, 0x88, 0x38,
+		0xC5, 0xF6, 0x1E, 0x63, 0x93, 0xBA, 0x7A, 0x0A, 0xBC, 0xC9, 0xF6, 0x62,
+		0x76, 0xFC, 0x6E, 0xCE, 0x0F, 0x4E, 0x17, 0x68, 0xCD, 0xDF, 0x88, 0x53,
+		0xBB, 0x2D, 0x55, 0x1B}
+};
+
+char chacha_pt[] = "Ladies and Gentlemen of the class of '99: If I could "
+		"offer you only one tip for the future, sunscreen would be it.";
+
+uint8_t chacha_iv[] = {
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4A, 0x00, 0x00, 0x00, 0x00
+};
+
+uint8_t chacha_ct[] = {
+	0x6E, 0x2E, 0x35, 0x9A, 0x25, 0x68, 0xF9, 0x80, 0x41, 0xBA, 0x07, 0x28,
+	0xDD, 0x0D, 0x69, 0x81, 0xE9, 0x7E, 0x7A, 0xEC, 0x1D, 0x43, 0x60, 0xC2,
+	0x0A, 0x27, 0xAF, 0xCC, 0xFD, 0x9F, 0xAE, 0x0B, 0xF9, 0x1B, 0x65, 0xC5,
+	0x52, 0x47, 0x33, 0xAB, 0x8F, 0x59, 0x3D, 0xAB, 0xCD, 0x62, 0xB3, 0x57,
+	0x16, 0x39, 0xD6, 0x24, 0xE6, 0x51, 0x52, 0xAB, 0x8F, 0x53, 0x0C, 0x35,
+	0x9F, 0x08, 0x61, 0xD8, 0x07, 0xCA, 0x0D, 0xBF, 0x50, 0x0D, 0x6A, 0x61,
+	0x56, 0xA3, 0x8E, 0x08, 0x8A, 0x22, 0xB6, 0x5E, 0x52, 0xBC, 0x51, 0x4D,
+	0x16, 0xCC, 0xF8, 0x06, 0x81, 0x8C, 0xE9, 0x1A, 0xB7, 0x79, 0x37, 0x36,
+	0x5A, 0xF9, 0x0B, 0xBF, 0x74, 0xA3, 0x5B, 0xE6, 0xB4, 0x0B, 0x8E, 0xED,
+	0xF2, 0x78, 0x5E, 0x42, 0x87, 0x4D
+};
+
+uint8_t poly_key[] = {
+	0x85, 0xD6, 0xBE, 0x78, 0x57, 0x55, 0x6D, 0x33, 0x7F, 0x44, 0x52, 0xFE,
+	0x42, 0xD5, 0x06, 0xA8, 0x01, 0x03, 0x80, 0x8A, 0xFB, 0x0D, 0xB2, 0xFD,
+	0x4A, 0xBF, 0xF6, 0xAF, 0x41, 0x49, 0xF5, 0x1B
+};
+
+uint8_t poly_tag[] = {
+	0xA8, 0x06, 0x1D, 0xC1, 0x30, 0x51, 0x36, 0xC6, 0xC2, 0x2B, 0x8B, 0xAF,
+	0x0C, 0x01, 0x27, 0xA9
+};
+
+uint8_t aead_key[] = {
+	0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8A, 0x8B,
+	0x8C, 0x8D, 0x8E, 0x8F, 0x90, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97,
+	0x98, 0x99, 0x9A, 0x9B, 0x9C, 0x9D, 0x9E, 0x9F
+};
+
+uint8_t aead_iv[] = {
+	0x07, 0x00, 0x00, 0x00, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47
+};
+
+uint8_t aead_aad[] = {
+	0x50, 0x51, 0x52, 0x53, 0xC0, 0xC1, 0xC2, 0xC3, 0xC4, 0xC5, 0xC6, 0xC7
+};
+
+uint8_t aead_ct[] = {
+	0xD3, 0x1A, 0x8D, 0x34, 0x64, 0x8E, 0x60, 0xDB, 0x7B, 0x86, 0xAF, 0xBC,
+	0x53, 0xEF, 0x7E, 0xC2, 0xA4, 0xAD, 0xED, 0x51, 0x29, 0x6E, 0x08, 0xFE,
+	0xA9, 0xE2, 0xB5, 0xA7, 0x36, 0xEE, 0x62, 0xD6, 0x3D, 0xBE, 0xA4, 0x5E,
+	0x8C, 0xA9, 0x67, 0x12, 0x82, 0xFA, 0xFB, 0x69, 0xDA, 0x92, 0x72, 0x8B,
+	0x1A, 0x71, 0xDE, 0x0A, 0x9E, 0x06, 0x0B, 0x29, 0x05, 0xD6, 0xA5, 0xB6,
+	0x7E, 0xCD, 0x3B, 0x36, 0x92, 0xDD, 0xBD, 0x7F, 0x2D, 0x77, 0x8B, 0x8C,
+	0x98, 0x03, 0xAE, 0xE3, 0x28, 0x09, 0x1B, 0x58, 0xFA, 0xB3, 0x24, 0xE4,
+	0xFA, 0xD6, 0x75, 0x94, 0x55, 0x85, 0x80, 0x8B, 0x48, 0x31, 0xD7, 0xBC,
+	0x3F, 0xF4, 0xDE, 0xF0, 0x8E, 0x4B, 0x7A, 0x9D, 0xE5, 0x76, 0xD2, 0x65,
+	0x86, 0xCE, 0xC6, 0x4B, 0x61, 0x16, 0x1A, 0xE1, 0x0B, 0x59, 0x4F, 0x09,
+	0xE2, 0x6A, 0x7E, 0x90, 0x2E, 0xCB, 0xD0, 0x60, 0x06, 0x91
+};
+
+static int aes(void) {
+	int code = STS_ERR;
+	uint8_t iv[BC_LEN], key[32], in[1000];
+	uint8_t out[1000 + BC_LEN], dec[1000 + BC_LEN];
+	int i, in_len, out_len, dec_len;
+	bc_aes_t k;
+
+	TEST_ONCE("aes block encryption/decryption is correct") {
+		for (i = 0; i < 3; i++) {
+			TEST_ASSERT(bc_aes_key(&k, aes_key, 128 + 64 * i) == STS_OK, end);
+			bc_aes_ecb_enc(out, aes_pt, BC_LEN, &k);
+			TEST_ASSERT(memcmp(out, aes_ct[i], BC_LEN) == 0, end);
+			bc_aes_ecb_dec(dec, out, BC_LEN, &k);
+			TEST_ASSERT(memcmp(dec, aes_pt, BC_LEN) == 0, end);
+		}
+		TEST_ASSERT(bc_aes_key(&k, aes_key, 100) == STS_ERR, end);
+	}
+	TEST_END;
+
+	TEST_BEGIN("aes multi-block encryption is consistent") {
+		rand_bytes(key, sizeof(key));
+		rand_bytes(in, 21 * BC_LEN);
+		bc_aes_key(&k, key, 256);
+		bc_aes_ecb_enc(out, in, 21 * BC_LEN, &k);
+		for (int j = 0; j < 21; j++) {
+			bc_aes_ecb_enc(dec, in + j * BC_LEN, BC_LEN, &k);
+			TEST_ASSERT(memcmp(dec, out + j * BC_LEN, BC_LEN) == 0, end);
+		}
+		bc_aes_ecb_dec(dec, out, 21 * BC_LEN, &k);
+		TEST_ASSERT(memcmp(dec, in, 21 * BC_LEN) == 0, end);
+	}
+	TEST_END;
+
+	TEST_ONCE("aes-cbc encryption/decryption is correct") {
+		for (i = 0; i < BC_LEN; i++) {
+			iv[i] = i;
+		}
+		out_len = sizeof(out);
+		TEST_ASSERT(bc_aes_cbc_enc(out, &out_len, cbc_pt, sizeof(cbc_pt),
+				cbc_key, 128, iv) == STS_OK, end);
+		TEST_ASSERT(out_len == sizeof(cbc_ct), end);
+		TEST_ASSERT(memcmp(out, cbc_ct, sizeof(cbc_ct)) == 0, end);
+		dec_len = sizeof(dec);
+		TEST_ASSERT(bc_aes_cbc_dec(dec, &dec_len, out, out_len, cbc_key, 128,
+				iv) == STS_OK, end);
+		TEST_ASSERT(dec_len == sizeof(cbc_pt), end);
+		TEST_ASSERT(memcmp(dec, cbc_pt, sizeof(cbc_pt)) == 0, end);
+	}
+	TEST_END;
+
+	TEST_BEGIN("aes-cbc encryption/decryption is consistent") {
+		rand_bytes(key, sizeof(key));
+		rand_bytes(iv, BC_LEN);
+		rand_bytes((uint8_t *)&in_len, sizeof(in_len));
+		in_len = (in_len & 0x7FFFFFFF) % sizeof(in);
+		rand_bytes(in, in_len);
+		out_len = sizeof(out);
+		TEST_ASSERT(bc_aes_cbc_enc(out, &out_len, in, in_len, key, 192, iv)
+				== STS_OK, end);
+		TEST_ASSERT(out_len == in_len + BC_LEN - (in_len % BC_LEN), end);
+		/* Decrypt in place. */
+		TEST_ASSERT(bc_aes_cbc_dec(out, &out_len, out, out_len, key, 192, iv)
+				== STS_OK, end);
+		TEST_ASSERT(out_len == in_len, end);
+		TEST_ASSERT(memcmp(out, in, in_len) == 0, end);
+	}
+	TEST_END;
+
+	TEST_BEGIN("aes-cbc rejects invalid padding") {
+		rand_bytes(key, 16);
+		rand_bytes(iv, BC_LEN);
+		out_len = sizeof(out);
+		bc_aes_cbc_enc(out, &out_len, in, 20, key, 128, iv);
+		/* Flip the last padding byte through the previous ciphertext. */
+		out[out_len - BC_LEN - 1] ^= 0x20;
+		dec_len = sizeof(dec);
+		TEST_ASSERT(bc_aes_cbc_dec(dec, &dec_len, out, out_len, key, 128, iv)
+				== STS_ERR, end);
+	}
+	TEST_END;
+
+	code = STS_OK;
+
+  end:
+	return code;
+}
+
+static int ctr(void) {
+	int code = STS_ERR;
+	uint8_t iv[BC_LEN], key[32], in[1000], out[1000], dec[1000];
+	int in_len, out_len, dec_len;
+
+	TEST_ONCE("aes-ctr encryption/decryption is correct") {
+		out_len = sizeof(out);
+		TEST_ASSERT(bc_aes_ctr_enc(out, &out_len, cbc_pt, sizeof(cbc_pt),
+				cbc_key, 128, ctr_iv) == STS_OK, end);
+		TEST_ASSERT(out_len == sizeof(ctr_ct), end);
+		TEST_ASSERT(memcmp(out, ctr_ct, sizeof(ctr_ct)) == 0, end);
+		/* A partial last block uses a prefix of the key stream. */
+		out_len = sizeof(out);
+		TEST_ASSERT(bc_aes_ctr_enc(out, &out_len, cbc_pt, 37, cbc_key, 128,
+				ctr_iv) == STS_OK, end);
+		TEST_ASSERT(out_len == 37, end);
+		TEST_ASSERT(memcmp(out, ctr_ct, 37) == 0, end);
+		dec_len = sizeof(dec);
+		TEST_ASSERT(bc_aes_ctr_dec(dec, &dec_len, ctr_ct, sizeof(ctr_ct),
+				cbc_key, 128, ctr_iv) == STS_OK, end);
+		TEST_ASSERT(memcmp(dec, cbc_pt, sizeof(cbc_pt)) == 0, end);
+	}
+	TEST_END;
+
+	TEST_BEGIN("aes-ctr encryption/decryption is consistent") {
+		rand_bytes(key, sizeof(key));
+		rand_bytes(iv, BC_LEN);
+		/* Force a carry out of the lower counter bytes. */
+		memset(iv + 8, 0xFF, 8);
+		rand_bytes((uint8_t *)&in_len, sizeof(in_len));
+		in_len = (in_len & 0x7FFFFFFF) % sizeof(in);
+		rand_bytes(in, in_len);
+		out_len = sizeof(out);
+		TEST_ASSERT(bc_aes_ctr_enc(out, &out_len, in, in_len, key, 256, iv)
+				== STS_OK, end);
+		TEST_ASSERT(out_len == in_len, end);
+		TEST_ASSERT(bc_aes_ctr_dec(out, &out_len, out, out_len, key, 256, iv)
+				== STS_OK, end);
+		TEST_ASSERT(memcmp(out, in, in_len) == 0, end);
+	}
+	TEST_END;
+
+	code = STS_OK;
+
+  end:
+	return code;
+}
+
+static int gcm(void) {
+	int code = STS_ERR;
+	uint8_t iv[BC_LEN], key[32], aad[100], in[1000];
+	uint8_t out[1000 + BC_TAG_LEN], dec[1000 + BC_TAG_LEN];
+	int i, in_len, aad_len, out_len, dec_len, l;
+	bc_gcm_t ctx;
+
+	TEST_ONCE("aes-gcm encryption/decryption is correct") {
+		for (i = 0; i < 3; i++) {
+			uint8_t *v = (i == 1 ? gcm_iv_long : gcm_iv);
+			int v_len = (i == 1 ? sizeof(gcm_iv_long) : sizeof(gcm_iv));
+			int k_len = (i == 2 ? 256 : 128);
+
+			out_len = sizeof(out);
+			TEST_ASSERT(bc_aes_gcm_enc(out, &out_len, gcm_pt, sizeof(gcm_pt),
+					gcm_key, k_len, v, v_len, gcm_aad, sizeof(gcm_aad))
+					== STS_OK, end);
+			TEST_ASSERT(out_len == sizeof(gcm_ct[i]), end);
+			TEST_ASSERT(memcmp(out, gcm_ct[i], out_len) == 0, end);
+			dec_len = sizeof(dec);
+			TEST_ASSERT(bc_aes_gcm_dec(dec, &dec_len, out, out_len, gcm_key,
+					k_len, v, v_len, gcm_aad, sizeof(gcm_aad)) == STS_OK, end);
+			TEST_ASSERT(dec_len == sizeof(gcm_pt), end);
+			TEST_ASSERT(memcmp(dec, gcm_pt, sizeof(gcm_pt)) == 0, end);
+		}
+	}
+	TEST_END;
+
+	TEST_BEGIN("aes-gcm encryption/decryption is consistent") {
+		rand_bytes(key, sizeof(key));
+		rand_bytes(iv, 12);
+		rand_bytes((uint8_t *)&in_len, sizeof(in_len));
+		in_len = (in_len & 0x7FFFFFFF) % sizeof(in);
+		rand_bytes(in, in_len);
+		rand_bytes(aad, sizeof(aad));
+		out_len = sizeof(out);
+		TEST_ASSERT(bc_aes_gcm_enc(out, &out_len, in, in_len, key, 192, iv,
+				12, aad, sizeof(aad)) == STS_OK, end);
+		TEST_ASSERT(out_len == in_len + BC_TAG_LEN, end);
+		/* Decrypt in place. */
+		TEST_ASSERT(bc_aes_gcm_dec(out, &out_len, out, out_len, key, 192, iv,
+				12, aad, sizeof(aad)) == STS_OK, end);
+		TEST_ASSERT(out_len == in_len, end);
+		TEST_ASSERT(memcmp(out, in, in_len) == 0, end);
+	}
+	TEST_END;
+
+	TEST_BEGIN("aes-gcm streaming is consistent") {
+		rand_bytes(key, sizeof(key));
+		rand_bytes(iv, 12);
+		rand_bytes(in, sizeof(in));
+		rand_bytes(aad, sizeof(aad));
+		in_len = sizeof(in) - 7;
+		aad_len = sizeof(aad) - 3;
+		out_len = sizeof(out);
+		bc_aes_gcm_enc(out, &out_len, in, in_len, key, 128, iv, 12, aad,
+				aad_len);
+		/* Feed the same data in irregular pieces. */
+		bc_aes_gcm_init(&ctx, key, 128, iv, 12);
+		for (int j = 0; j < aad_len; j += l) {
+			l = MIN(1 + 7 * (j % 5), aad_len - j);
+			bc_aes_gcm_aad(&ctx, aad + j, l);
+		}
+		for (int j = 0; j < in_len; j += l) {
+			l = MIN(1 + 37 * (j % 7), in_len - j);
+			bc_aes_gcm_enc_update(&ctx, dec + j, in + j, l);
+		}
+		bc_aes_gcm_enc_final(&ctx, dec + in_len);
+		TEST_ASSERT(memcmp(dec, out, out_len) == 0, end);
+		bc_aes_gcm_init(&ctx, key, 128, iv, 12);
+		bc_aes_gcm_aad(&ctx, aad, aad_len);
+		for (int j = 0; j < in_len; j += l) {
+			l = MIN(3 + 53 * (j % 3), in_len - j);
+			bc_aes_gcm_dec_update(&ctx, dec + j, out + j, l);
+		}
+		TEST_ASSERT(bc_aes_gcm_dec_final(&ctx, out + in_len) == STS_OK, end);
+		TEST_ASSERT(memcmp(dec, in, in_len) == 0, end);
+	}
+	TEST_END;
+
+	TEST_BEGIN("aes-gcm rejects modified ciphertexts") {
+		rand_bytes(key, sizeof(key));
+		rand_bytes(iv, 12);
+		rand_bytes(in, 50);
+		out_len = sizeof(out);
+		bc_aes_gcm_enc(out, &out_len, in, 50, key, 128, iv, 12, aad, 10);
+		out[out_len / 2] ^= 0x01;
+		dec_len = sizeof(dec);
+		TEST_ASSERT(bc_aes_gcm_dec(dec, &dec_len, out, out_len, key, 128, iv,
+				12, aad, 10) == STS_ERR, end);
+		out[out_len / 2] ^= 0x01;
+		aad[0] ^= 0x01;
+		TEST_ASSERT(bc_aes_gcm_dec(dec, &dec_len, out, out_len, key, 128, iv,
+				12, aad, 10) == STS_ERR, end);
+		aad[0] ^= 0x01;
+		TEST_ASSERT(bc_aes_gcm_dec(dec, &dec_len, out, out_len, key, 128, iv,
+				12, aad, 10) == STS_OK, end);
+	}
+	TEST_END;
+
+	code = STS_OK;
+
+  end:
+	return code;
+}
+
+static int chacha(void) {
+	int code = STS_ERR;
+	uint8_t iv[BC_CHACHA_IV], key[BC_CHACHA_KEY], aad[100], in[1000];
+	uint8_t out[1000 + BC_TAG_LEN], dec[1000 + BC_TAG_LEN], tag[BC_TAG_LEN];
+	int len, in_len, aad_len, out_len, dec_len, l;
+	bc_poly1305_t mac;
+	bc_chacha_t ctx;
+
+	len = sizeof(chacha_pt) - 1;
+
+	TEST_ONCE("chacha20 encryption/decryption is correct") {
+		bc_chacha20(out, (uint8_t *)chacha_pt, len, aes_key, chacha_iv, 1);
+		TEST_ASSERT(memcmp(out, chacha_ct, len) == 0, end);
+		bc_chacha20(dec, out, len, aes_key, chacha_iv, 1);
+		TEST_ASSERT(memcmp(dec, chacha_pt, len) == 0, end);
+	}
+	TEST_END;
+
+	TEST_BEGIN("chacha20 is consistent with the block function") {
+		rand_bytes(key, sizeof(key));
+		rand_bytes(iv, sizeof(iv));
+		rand_bytes(in, sizeof(in));
+		bc_chacha20(out, in, sizeof(in), key, iv, 7);
+		/* Encrypt each block separately to exercise the scalar code. */
+		for (int j = 0; j < sizeof(in); j += 64) {
+			bc_chacha20(dec + j, in + j, MIN(64, sizeof(in) - j), key, iv,
+					7 + j / 64);
+		}
+		TEST_ASSERT(memcmp(out, dec, sizeof(in)) == 0, end);
+	}
+	TEST_END;
+
+	TEST_ONCE("poly1305 authentication is correct") {
+		bc_poly1305(tag, (uint8_t *)"Cryptographic Forum Research Group", 34,
+				poly_key);
+		TEST_ASSERT(memcmp(tag, poly_tag, BC_TAG_LEN) == 0, end);
+	}
+	TEST_END;
+
+	TEST_BEGIN("poly1305 streaming is consistent") {
+		rand_bytes(key, sizeof(key));
+		rand_bytes(in, sizeof(in));
+		rand_bytes((uint8_t *)&in_len, sizeof(in_len));
+		in_len = (in_len & 0x7FFFFFFF) % sizeof(in);
+		bc_poly1305(tag, in, in_len, key);
+		/* Feed one block at a time to exercise the scalar code. */
+		bc_poly1305_init(&mac, key);
+		for (int j = 0; j < in_len; j += 16) {
+			bc_poly1305_update(&mac, in + j, MIN(16, in_len - j));
+		}
+		bc_poly1305_final(&mac, out);
+		TEST_ASSERT(memcmp(tag, out, BC_TAG_LEN) == 0, end);
+	}
+	TEST_END;
+
+	TEST_ONCE("chacha20-poly1305 encryption/decryption is correct") {
+		out_len = sizeof(out);
+		TEST_ASSERT(bc_chacha_enc(out, &out_len, (uint8_t *)chacha_pt, len,
+				aead_key, 256, aead_iv, sizeof(aead_iv), aead_aad,
+				sizeof(aead_aad)) == STS_OK, end);
+		TEST_ASSERT(out_len == sizeof(aead_ct), end);
+		TEST_ASSERT(memcmp(out, aead_ct, out_len) == 0, end);
+		dec_len = sizeof(dec);
+		TEST_ASSERT(bc_chacha_dec(dec, &dec_len, out, out_len, aead_key, 256,
+				aead_iv, sizeof(aead_iv), aead_aad, sizeof(aead_aad))
+				== STS_OK, end);
+		TEST_ASSERT(dec_len == len, end);
+		TEST_ASSERT(memcmp(dec, chacha_pt, len) == 0, end);
+	}
+	TEST_END;
+
+	TEST_BEGIN("chacha20-poly1305 streaming is consistent") {
+		rand_bytes(key, sizeof(key));
+		rand_bytes(iv, sizeof(iv));
+		rand_bytes(in, sizeof(in));
+		rand_bytes(aad, sizeof(aad));
+		in_len = sizeof(in) - 7;
+		aad_len = sizeof(aad) - 3;
+		out_len = sizeof(out);
+		bc_chacha_enc(out, &out_len, in, in_len, key, 256, iv, sizeof(iv),
+				aad, aad_len);
+		/* Feed the same data in irregular pieces. */
+		bc_chacha_init(&ctx, key, 256, iv, sizeof(iv));
+		for (int j = 0; j < aad_len; j += l) {
+			l = MIN(1 + 7 * (j % 5), aad_len - j);
+			bc_chacha_aad(&ctx, aad + j, l);
+		}
+		for (int j = 0; j < in_len; j += l) {
+			l = MIN(1 + 37 * (j % 7), in_len - j);
+			bc_chacha_enc_update(&ctx, dec + j, in + j, l);
+		}
+		bc_chacha_enc_final(&ctx, dec + in_len);
+		TEST_ASSERT(memcmp(dec, out, out_len) == 0, end);
+		bc_chacha_init(&ctx, key, 256, iv, sizeof(iv));
+		bc_chacha_aad(&ctx, aad, aad_len);
+		for (int j = 0; j < in_len; j += l) {
+			l = MIN(3 + 53 * (j % 3), in_len - j);
+			bc_chacha_dec_update(&ctx, dec + j, out + j, l);
+		}
+		TEST_ASSERT(bc_chacha_dec_final(&ctx, out + in_len) == STS_OK, end);
+		TEST_ASSERT(memcmp(dec, in, in_len) == 0, end);
+	}
+	TEST_END;
+
+	TEST_BEGIN("chacha20-poly1305 rejects modified ciphertexts") {
+		rand_bytes(key, sizeof(key));
+		rand_bytes(iv, sizeof(iv));
+		rand_bytes(in, 50);
+		out_len = sizeof(out);
+		bc_chacha_enc(out, &out_len, in, 50, key, 256, iv, sizeof(iv), aad,
+				10);
+		out[out_len / 2] ^= 0x01;
+		dec_len = sizeof(dec);
+		TEST_ASSERT(bc_chacha_dec(dec, &dec_len, out, out_len, key, 256, iv,
+				sizeof(iv), aad, 10) == STS_ERR, end);
+		out[out_len / 2] ^= 0x01;
+		aad[0] ^= 0x01;
+		TEST_ASSERT(bc_chacha_dec(dec, &dec_len, out, out_len, key, 256, iv,
+				sizeof(iv), aad, 10) == STS_ERR, end);
+		aad[0] ^= 0x01;
+		TEST_ASSERT(bc_chacha_dec(dec, &dec_len, out, out_len, key, 256, iv,
+				sizeof(iv), aad, 10) == STS_OK, end);
+	}
+	TEST_END;
+
+	code = STS_OK;
+
+  end:
+	return code;
+}
+
+int main(void) {
+	if (core_init() != STS_OK) {
+		core_clean();
+		return 1;
+	}
+
+	util_banner("Tests for the BC module:\n", 0);
+
+	if (aes() != STS_OK) {
+		core_clean();
+		return 1;
+	}
+
+	if (ctr() != STS_OK) {
+		core_clean();
+		return 1;
+	}
+
+	if (gcm() != STS_OK) {
+		core_clean();
+		return 1;
+	}
+
+	if (chacha() != STS_OK) {
+		core_clean();
+		return 1;
+	}
+
+#if ARCH == X64
+	/* Run again with the AES-NI, CLMUL and AVX2 code paths disabled. */
+	arch_limit(0);
+
+	util_banner("Tests for the BC module (portable code):\n", 0);
+
+	if (aes() != STS_OK || ctr() != STS_OK || gcm() != STS_OK ||
+			chacha() != STS_OK) {
+		arch_limit(ARCH_ALL);
+		core_clean();
+		return 1;
+	}
+
+	arch_limit(ARCH_ALL);
+#endif
+
+	util_banner("All tests have passed.\n", 0);
+
+	core_clean();
+	return 0;
+}
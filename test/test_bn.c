@@ -30,6 +30,7 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "relic.h"
 #include "relic_test.h"
@@ -247,6 +248,22 @@ static int util(void) {
 		}
 		TEST_END;
 
+		TEST_BEGIN("writing a number matches its digits in every radix") {
+			bn_rand(a, BN_POS, BN_BITS);
+			for (int j = 2; j <= 64; j++) {
+				bn_write_str(str, sizeof(str), a, j);
+				bn_zero(b);
+				for (int k = 0; str[k] != '\0'; k++) {
+					for (digit = 0; util_conv_char(digit) != str[k]; digit++);
+					bn_mul_dig(b, b, (dig_t)j);
+					bn_add_dig(b, b, digit);
+				}
+				TEST_ASSERT(bn_cmp(a, b) == CMP_EQ, end);
+				TEST_ASSERT(bn_size_str(a, j) == (int)strlen(str) + 1, end);
+			}
+		}
+		TEST_END;
+
 		TEST_BEGIN("getting the size of a positive number is correct") {
 			bn_rand(a, BN_POS, BN_BITS);
 			TEST_ASSERT((bn_size_str(a, 2) - 1) == bn_bits(a), end);
@@ -548,6 +565,42 @@ static int multiplication(void) {
 		TEST_END;
 #endif
 
+#if BN_MUL == TOOMC || !defined(STRIP)
+		TEST_BEGIN("toom-3 multiplication is correct") {
+			bn_rand(a, BN_NEG, BN_BITS / 2);
+			bn_rand(b, BN_POS, BN_BITS / 2 - BN_DIGIT);
+			bn_mul_comba(c, a, b);
+			bn_mul_toom3(d, a, b);
+			TEST_ASSERT(bn_cmp(c, d) == CMP_EQ, end);
+			bn_mul_toom3(d, b, a);
+			TEST_ASSERT(bn_cmp(c, d) == CMP_EQ, end);
+		}
+		TEST_END;
+
+		TEST_BEGIN("size-dependent multiplication is correct") {
+			/* Cross each threshold if the product fits in the precision. */
+			int s[] = { BN_DIGS / 2, BN_MUL_KARAT - 1, BN_MUL_KARAT,
+				BN_MUL_TOOM3 - 1, BN_MUL_TOOM3 };
+			for (int k = 0; k < 5; k++) {
+				if (s[k] > BN_DIGS || 2 * s[k] > BN_SIZE) {
+					continue;
+				}
+				bn_rand(a, BN_POS, s[k] * BN_DIGIT);
+				bn_rand(b, BN_NEG, s[k] * BN_DIGIT);
+				bn_mul_comba(c, a, b);
+				bn_mul_toomc(d, a, b);
+				TEST_ASSERT(bn_cmp(c, d) == CMP_EQ, end);
+				bn_mul_toom3(d, a, b);
+				TEST_ASSERT(bn_cmp(c, d) == CMP_EQ, end);
+				bn_rand(b, BN_POS, s[k] * BN_DIGIT / 4);
+				bn_mul_comba(c, a, b);
+				bn_mul_toomc(d, a, b);
+				TEST_ASSERT(bn_cmp(c, d) == CMP_EQ, end);
+			}
+		}
+		TEST_END;
+#endif
+
 	}
 	CATCH_ANY {
 		ERROR(end);
@@ -610,6 +663,32 @@ static int squaring(void) {
 		} TEST_END;
 #endif
 
+#if BN_SQR == TOOMC || !defined(STRIP)
+		TEST_BEGIN("toom-3 squaring is correct") {
+			bn_rand(a, BN_NEG, BN_BITS / 2);
+			bn_sqr_comba(b, a);
+			bn_sqr_toom3(c, a);
+			TEST_ASSERT(bn_cmp(b, c) == CMP_EQ, end);
+		} TEST_END;
+
+		TEST_BEGIN("size-dependent squaring is correct") {
+			/* Cross each threshold if the product fits in the precision. */
+			int s[] = { BN_DIGS / 2, BN_SQR_KARAT - 1, BN_SQR_KARAT,
+				BN_SQR_TOOM3 - 1, BN_SQR_TOOM3 };
+			for (int k = 0; k < 5; k++) {
+				if (s[k] > BN_DIGS || 2 * s[k] > BN_SIZE) {
+					continue;
+				}
+				bn_rand(a, BN_POS, s[k] * BN_DIGIT);
+				bn_sqr_comba(b, a);
+				bn_sqr_toomc(c, a);
+				TEST_ASSERT(bn_cmp(b, c) == CMP_EQ, end);
+				bn_sqr_toom3(c, a);
+				TEST_ASSERT(bn_cmp(b, c) == CMP_EQ, end);
+			}
+		} TEST_END;
+#endif
+
 	}
 	CATCH_ANY {
 		ERROR(end);
@@ -896,7 +975,7 @@ static int reduction(void) {
 		TEST_END;
 #endif
 
-#if (BN_MOD == MONTY && BN_MUL == COMBA) || !defined(STRIP)
+#if (BN_MOD == MONTY && (BN_MUL == COMBA || BN_MUL == TOOMC)) || !defined(STRIP)
 		TEST_BEGIN("comba montgomery reduction is correct") {
 			bn_rand(a, BN_POS, BN_BITS - BN_DIGIT / 2);
 			bn_rand(b, BN_POS, BN_BITS / 2);
@@ -945,16 +1024,28 @@ static int reduction(void) {
 
 static int exponentiation(void) {
 	int code = STS_ERR;
-	bn_t a, b, p;
+	bn_t a, b, c, p, t[BN_XP_TABLE];
+	bn_mod_ctx_t ctx;
+	dig_t g;
 
 	bn_null(a);
 	bn_null(b);
+	bn_null(c);
 	bn_null(p);
+	bn_mod_ctx_null(ctx);
+	for (int i = 0; i < BN_XP_TABLE; i++) {
+		bn_null(t[i]);
+	}
 
 	TRY {
 		bn_new(a);
 		bn_new(b);
+		bn_new(c);
 		bn_new(p);
+		bn_mod_ctx_new(ctx);
+		for (int i = 0; i < BN_XP_TABLE; i++) {
+			bn_new(t[i]);
+		}
 
 #if BN_MOD != PMERS
 		bn_gen_prime(p, BN_BITS);
@@ -973,6 +1064,64 @@ static int exponentiation(void) {
 		}
 		TEST_END;
 
+		bn_mod_ctx_set(ctx, p);
+
+		TEST_BEGIN("modular multiplication with precomputed modulus is correct") {
+			TEST_ASSERT(bn_mod_ctx_cmp(ctx, p) == CMP_EQ, end);
+			bn_rand(a, BN_POS, BN_BITS);
+			bn_mod(a, a, p);
+			bn_rand(b, BN_POS, BN_BITS);
+			bn_mod(b, b, p);
+			bn_mul_mod_ctx(c, a, b, ctx);
+			bn_mod_ctx_conv(t[0], a, ctx);
+			bn_mod_ctx_conv(t[1], b, ctx);
+			bn_mod_ctx_mul(t[0], t[0], t[1], ctx);
+			bn_mod_ctx_back(t[0], t[0], ctx);
+			bn_mul(a, a, b);
+			bn_mod(a, a, p);
+			TEST_ASSERT(bn_cmp(a, c) == CMP_EQ, end);
+			TEST_ASSERT(bn_cmp(a, t[0]) == CMP_EQ, end);
+		}
+		TEST_END;
+
+		TEST_BEGIN("modular exponentiation with precomputed modulus is correct") {
+			bn_rand(a, BN_POS, BN_BITS);
+			bn_rand(b, BN_POS, BN_BITS);
+			bn_mxp(c, a, b, p);
+			bn_mxp_ctx(a, a, b, ctx);
+			TEST_ASSERT(bn_cmp(a, c) == CMP_EQ, end);
+			bn_zero(b);
+			bn_mxp_ctx(a, a, b, ctx);
+			TEST_ASSERT(bn_cmp_dig(a, 1) == CMP_EQ, end);
+		}
+		TEST_END;
+
+		TEST_BEGIN("precomputed modular exponentiation by a digit is correct") {
+			bn_rand(a, BN_POS, BN_BITS);
+			bn_rand(b, BN_POS, BN_DIGIT);
+			bn_get_dig(&g, b);
+			bn_mxp(c, a, b, p);
+			bn_mxp_dig_ctx(a, a, g, ctx);
+			TEST_ASSERT(bn_cmp(a, c) == CMP_EQ, end);
+			bn_mxp_dig_ctx(a, a, 0, ctx);
+			TEST_ASSERT(bn_cmp_dig(a, 1) == CMP_EQ, end);
+		}
+		TEST_END;
+
+		TEST_BEGIN("fixed-base modular exponentiation is correct") {
+			bn_rand(a, BN_POS, BN_BITS);
+			bn_mod(a, a, p);
+			bn_mxp_pre(t, a, ctx);
+			bn_rand(b, BN_POS, BN_BITS);
+			bn_mxp(c, a, b, p);
+			bn_mxp_fix(b, (const bn_t *)t, b, ctx);
+			TEST_ASSERT(bn_cmp(b, c) == CMP_EQ, end);
+			bn_zero(b);
+			bn_mxp_fix(b, (const bn_t *)t, b, ctx);
+			TEST_ASSERT(bn_cmp_dig(b, 1) == CMP_EQ, end);
+		}
+		TEST_END;
+
 		TEST_BEGIN("modular exponentiation with zero power is correct") {
 			bn_rand(a, BN_POS, BN_BITS);
 			bn_zero(b);
@@ -1003,7 +1152,7 @@ static int exponentiation(void) {
 		TEST_END;
 #endif
 
-#if BN_MXP == CONST || !defined(STRIP)
+#if BN_MXP == MONTY || !defined(STRIP)
 		TEST_BEGIN("powering ladder modular exponentiation is correct") {
 			bn_rand(a, BN_POS, BN_BITS);
 			bn_mod(a, a, p);
@@ -1014,6 +1163,20 @@ static int exponentiation(void) {
 		TEST_END;
 #endif
 
+		TEST_BEGIN("constant-time modular exponentiation is correct") {
+			bn_rand(a, BN_POS, BN_BITS);
+			bn_mod(a, a, p);
+			bn_copy(b, a);
+			bn_mxp_const(b, b, p, p);
+			TEST_ASSERT(bn_cmp(a, b) == CMP_EQ, end);
+			bn_rand(a, BN_POS, BN_BITS);
+			bn_rand(b, BN_POS, BN_BITS);
+			bn_mxp_basic(c, a, b, p);
+			bn_mxp_const_ctx(b, a, b, ctx);
+			TEST_ASSERT(bn_cmp(b, c) == CMP_EQ, end);
+		}
+		TEST_END;
+
 	}
 	CATCH_ANY {
 		ERROR(end);
@@ -1022,7 +1185,12 @@ static int exponentiation(void) {
   end:
 	bn_free(a);
 	bn_free(b);
+	bn_free(c);
 	bn_free(p);
+	bn_mod_ctx_free(ctx);
+	for (int i = 0; i < BN_XP_TABLE; i++) {
+		bn_free(t[i]);
+	}
 	return code;
 }
 
@@ -1558,6 +1726,10 @@ static int prime(void) {
 		TEST_ONCE("basic prime generation is consistent") {
 			bn_gen_prime_basic(p, BN_BITS);
 			TEST_ASSERT(bn_is_prime(p) == 1, end);
+			TEST_ASSERT(bn_bits(p) == BN_BITS, end);
+			bn_gen_prime_basic(p, 16);
+			TEST_ASSERT(bn_is_prime(p) == 1, end);
+			TEST_ASSERT(bn_bits(p) == 16, end);
 		} TEST_END;
 #endif
 
@@ -1565,6 +1737,13 @@ static int prime(void) {
 		TEST_ONCE("safe prime generation is consistent") {
 			bn_gen_prime_safep(p, BN_BITS);
 			TEST_ASSERT(bn_is_prime(p) == 1, end);
+			TEST_ASSERT(bn_bits(p) == BN_BITS, end);
+			bn_sub_dig(p, p, 1);
+			bn_hlv(p, p);
+			TEST_ASSERT(bn_is_prime(p) == 1, end);
+			bn_gen_prime_safep(p, 16);
+			TEST_ASSERT(bn_is_prime(p) == 1, end);
+			TEST_ASSERT(bn_bits(p) == 16, end);
 			bn_sub_dig(p, p, 1);
 			bn_hlv(p, p);
 			TEST_ASSERT(bn_is_prime(p) == 1, end);
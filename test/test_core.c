@@ -29,10 +29,40 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 
 #include "relic.h"
 #include "relic_test.h"
 
+static void counter(void *args, int i) {
+	int *count = (int *)args;
+	count[i]++;
+}
+
+static void failer(void *args, int i) {
+	counter(args, i);
+	if (i == 3) {
+		THROW(ERR_NO_VALID);
+	}
+}
+
+#if RAND == CALL
+
+static void source(uint8_t *buf, int size, void *args) {
+	int *calls = (int *)args;
+	__atomic_fetch_add(calls, 1, __ATOMIC_RELAXED);
+	memset(buf, 0, size);
+}
+
+static void drawer(void *args, int i) {
+	uint8_t buf[16];
+	rand_bytes(buf, sizeof(buf));
+	(void)args;
+	(void)i;
+}
+
+#endif
+
 #if MULTI == PTHREAD
 
 void *master(void *ptr) {
@@ -97,6 +127,47 @@ int main(void) {
 		core_set(old_ctx);
 	} TEST_END;
 
+	TEST_ONCE("thread pool runs every task once") {
+		int count[64] = { 0 }, result = 1;
+		for (int i = 1; i <= CORES; i++) {
+			multi_set_cores(i);
+			TEST_ASSERT(multi_get_cores() == i, end);
+			multi_run(counter, count, 64);
+		}
+		for (int i = 0; i < 64; i++) {
+			result &= (count[i] == CORES);
+		}
+		TEST_ASSERT(result == 1, end);
+	} TEST_END;
+
+	TEST_ONCE("thread pool propagates errors") {
+		int count[64] = { 0 }, result = 1;
+		err_get_code();
+		TRY {
+			multi_run(failer, count, 64);
+		}
+		CATCH_ANY {
+			/* The error code is checked below. */
+		}
+		TEST_ASSERT(err_get_code() == STS_ERR, end);
+		/* Tasks after the failing one may not run, but none runs twice. */
+		for (int i = 0; i < 64; i++) {
+			result &= (count[i] <= 1);
+		}
+		TEST_ASSERT(result == 1 && count[3] == 1, end);
+	} TEST_END;
+
+#if RAND == CALL
+	TEST_ONCE("thread pool draws randomness from the caller") {
+		int calls = 0;
+		multi_set_cores(CORES);
+		rand_seed(source, &calls);
+		multi_run(drawer, NULL, 64);
+		rand_seed(NULL, NULL);
+		TEST_ASSERT(calls == 64, end);
+	} TEST_END;
+#endif
+
 	code = STS_OK;
 
 #if MULTI == OPENMP
@@ -30,23 +30,40 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 
 #include "relic.h"
 #include "relic_test.h"
 
 static int rsa(void) {
 	int code = STS_ERR;
-	rsa_t pub, prv;
+	rsa_t pub, prv, pubs[3], prvs[3];
+	bn_t t;
 	uint8_t in[10], out[BN_BITS / 8 + 1], h[MD_LEN];
-	int il, ol;
+	uint8_t ins[3][10], outs[3][BN_BITS / 8 + 1], hs[3][MD_LEN];
+	uint8_t *ip[3], *op[3], *hp[3];
+	int il, ol, cores, j, ils[3], ols[3], hls[3], v[3];
 	int result;
 
+	bn_null(t);
 	rsa_null(pub);
 	rsa_null(prv);
+	for (j = 0; j < 3; j++) {
+		rsa_null(pubs[j]);
+		rsa_null(prvs[j]);
+		ip[j] = ins[j];
+		op[j] = outs[j];
+		hp[j] = hs[j];
+	}
 
 	TRY {
+		bn_new(t);
 		rsa_new(pub);
 		rsa_new(prv);
+		for (j = 0; j < 3; j++) {
+			rsa_new(pubs[j]);
+			rsa_new(prvs[j]);
+		}
 
 		result = cp_rsa_gen(pub, prv, BN_BITS);
 
@@ -60,6 +77,33 @@ static int rsa(void) {
 			TEST_ASSERT(memcmp(in, out, ol) == 0, end);
 		} TEST_END;
 
+		TEST_ONCE("rsa keys with fields set directly are usable") {
+			TEST_ASSERT(result == STS_OK, end);
+			bn_copy(pubs[0]->n, pub->n);
+			bn_copy(pubs[0]->e, pub->e);
+			bn_copy(prvs[0]->n, prv->n);
+			bn_copy(prvs[0]->e, prv->e);
+			bn_copy(prvs[0]->d, prv->d);
+			bn_copy(prvs[0]->p, prv->p);
+			bn_copy(prvs[0]->q, prv->q);
+			bn_copy(prvs[0]->dp, prv->dp);
+			bn_copy(prvs[0]->dq, prv->dq);
+			bn_copy(prvs[0]->qi, prv->qi);
+			il = 10;
+			ol = BN_BITS / 8 + 1;
+			rand_bytes(in, il);
+			/* The keys are rejected until their moduli are precomputed. */
+			TEST_ASSERT(cp_rsa_enc(out, &ol, in, il, pubs[0]) == STS_ERR, end);
+			TEST_ASSERT(cp_rsa_prepare(pubs[0]) == STS_OK, end);
+			TEST_ASSERT(cp_rsa_prepare(prvs[0]) == STS_OK, end);
+			il = 10;
+			ol = BN_BITS / 8 + 1;
+			rand_bytes(in, il);
+			TEST_ASSERT(cp_rsa_enc(out, &ol, in, il, pubs[0]) == STS_OK, end);
+			TEST_ASSERT(cp_rsa_dec(out, &ol, out, ol, prvs[0]) == STS_OK, end);
+			TEST_ASSERT(memcmp(in, out, ol) == 0, end);
+		} TEST_END;
+
 #if CP_RSA == BASIC || !defined(STRIP)
 		result = cp_rsa_gen_basic(pub, prv, BN_BITS);
 
@@ -88,6 +132,28 @@ static int rsa(void) {
 					end);
 			TEST_ASSERT(memcmp(in, out, ol) == 0, end);
 		} TEST_END;
+
+		TEST_ONCE("fast rsa is correct with one or more threads") {
+			cores = multi_get_cores();
+			multi_set_cores(1);
+			TEST_ASSERT(cp_rsa_gen_quick(pub, prv, BN_BITS) == STS_OK, end);
+			multi_set_cores(CORES);
+			il = 10;
+			ol = BN_BITS / 8 + 1;
+			rand_bytes(in, il);
+			TEST_ASSERT(cp_rsa_enc(out, &ol, in, il, pub) == STS_OK, end);
+			TEST_ASSERT(cp_rsa_dec_quick(out, &ol, out, ol, prv) == STS_OK,
+					end);
+			TEST_ASSERT(memcmp(in, out, ol) == 0, end);
+			TEST_ASSERT(cp_rsa_gen_quick(pub, prv, BN_BITS) == STS_OK, end);
+			multi_set_cores(1);
+			ol = BN_BITS / 8 + 1;
+			TEST_ASSERT(cp_rsa_enc(out, &ol, in, il, pub) == STS_OK, end);
+			TEST_ASSERT(cp_rsa_dec_quick(out, &ol, out, ol, prv) == STS_OK,
+					end);
+			TEST_ASSERT(memcmp(in, out, ol) == 0, end);
+			multi_set_cores(cores);
+		} TEST_END;
 #endif
 
 		result = cp_rsa_gen(pub, prv, BN_BITS);
@@ -104,6 +170,63 @@ static int rsa(void) {
 			TEST_ASSERT(cp_rsa_ver(out, ol, h, MD_LEN, 1, pub) == 1, end);
 		} TEST_END;
 
+#if CP_RSAPD == PKCS1
+		TEST_BEGIN("rsa verification rejects malformed padding") {
+			uint8_t eb[BN_BITS / 8 + 1], tail[BN_BITS / 8 + 1];
+			int k = bn_size_bin(pub->n), s, l;
+			il = 10;
+			ol = BN_BITS / 8 + 1;
+			rand_bytes(in, il);
+			TEST_ASSERT(cp_rsa_sig(out, &ol, in, il, 0, prv) == STS_OK, end);
+			/* Recover EB = 00 | 01 | PS | 00 | DigestInfo | H. */
+			bn_read_bin(t, out, ol);
+			bn_mxp(t, t, pub->e, pub->n);
+			bn_write_bin(eb, k, t);
+			for (s = 2; s < k && eb[s] == 0xFF; s++);
+			l = k - s - 1;
+			memcpy(tail, eb + s + 1, l);
+			/* A signature over the untouched block is valid. */
+			bn_read_bin(t, eb, k);
+			bn_mxp(t, t, prv->d, prv->n);
+			bn_write_bin(out, k, t);
+			TEST_ASSERT(cp_rsa_ver(out, k, in, il, 0, pub) == 1, end);
+			/* A single padding byte followed by trailing garbage. */
+			memset(eb + 2, 0xAB, k - 2);
+			eb[2] = 0xFF;
+			eb[3] = 0;
+			memcpy(eb + 4, tail, l);
+			bn_read_bin(t, eb, k);
+			bn_mxp(t, t, prv->d, prv->n);
+			bn_write_bin(out, k, t);
+			TEST_ASSERT(cp_rsa_ver(out, k, in, il, 0, pub) == 0, end);
+			/* Enough padding, but trailing bytes after the digest. */
+			memset(eb + 2, 0xFF, k - 2);
+			eb[s - 4] = 0;
+			memcpy(eb + s - 3, tail, l);
+			bn_read_bin(t, eb, k);
+			bn_mxp(t, t, prv->d, prv->n);
+			bn_write_bin(out, k, t);
+			TEST_ASSERT(cp_rsa_ver(out, k, in, il, 0, pub) == 0, end);
+		} TEST_END;
+#endif
+
+		TEST_BEGIN("rsa batch verification is correct") {
+			TEST_ASSERT(result == STS_OK, end);
+			for (j = 0; j < 3; j++) {
+				ils[j] = 10;
+				ols[j] = BN_BITS / 8 + 1;
+				rand_bytes(ins[j], ils[j]);
+				TEST_ASSERT(cp_rsa_sig(outs[j], &ols[j], ins[j], ils[j], 0,
+								prv) == STS_OK, end);
+			}
+			TEST_ASSERT(cp_rsa_ver_batch(v, op, ols, ip, ils, 0, pub, 3) == 1,
+					end);
+			outs[1][ols[1] - 1] ^= 1;
+			TEST_ASSERT(cp_rsa_ver_batch(v, op, ols, ip, ils, 0, pub, 3) == 0,
+					end);
+			TEST_ASSERT(v[0] == 1 && v[1] == 0 && v[2] == 1, end);
+		} TEST_END;
+
 #if CP_RSA == BASIC || !defined(STRIP)
 		result = cp_rsa_gen_basic(pub, prv, BN_BITS);
 
@@ -138,6 +261,84 @@ static int rsa(void) {
 					end);
 			TEST_ASSERT(cp_rsa_ver(out, ol, h, MD_LEN, 1, pub) == 1, end);
 		} TEST_END;
+
+		result = cp_rsa_gen_batch(pubs, prvs, 3, BN_BITS);
+
+		TEST_BEGIN("batch rsa encryption/decryption is correct") {
+			TEST_ASSERT(result == STS_OK, end);
+			for (j = 0; j < 3; j++) {
+				ils[j] = 10;
+				ols[j] = BN_BITS / 8 + 1;
+				rand_bytes(ins[j], ils[j]);
+				TEST_ASSERT(cp_rsa_enc(outs[j], &ols[j], ins[j], ils[j],
+								pubs[j]) == STS_OK, end);
+			}
+			TEST_ASSERT(cp_rsa_dec_batch(v, op, ols, op, ols, prvs, 3) == STS_OK,
+					end);
+			for (j = 0; j < 3; j++) {
+				TEST_ASSERT(v[j] == STS_OK, end);
+				TEST_ASSERT(ols[j] == ils[j], end);
+				TEST_ASSERT(memcmp(ins[j], outs[j], ils[j]) == 0, end);
+			}
+		} TEST_END;
+
+		TEST_BEGIN("batch rsa decryption rejects bad ciphertexts alone") {
+			TEST_ASSERT(result == STS_OK, end);
+			for (j = 0; j < 3; j++) {
+				ils[j] = 10;
+				ols[j] = BN_BITS / 8 + 1;
+				rand_bytes(ins[j], ils[j]);
+				TEST_ASSERT(cp_rsa_enc(outs[j], &ols[j], ins[j], ils[j],
+								pubs[j]) == STS_OK, end);
+			}
+			/* A zero ciphertext is not invertible modulo n. */
+			memset(outs[1], 0, ols[1]);
+			TEST_ASSERT(cp_rsa_dec_batch(v, op, ols, op, ols, prvs, 3) == STS_ERR,
+					end);
+			TEST_ASSERT(v[0] == STS_OK && v[1] == STS_ERR && v[2] == STS_OK,
+					end);
+			for (j = 0; j < 3; j += 2) {
+				TEST_ASSERT(ols[j] == ils[j], end);
+				TEST_ASSERT(memcmp(ins[j], outs[j], ils[j]) == 0, end);
+			}
+		} TEST_END;
+
+		TEST_BEGIN("batch rsa signature/verification is correct") {
+			TEST_ASSERT(result == STS_OK, end);
+			for (j = 0; j < 3; j++) {
+				ils[j] = 10;
+				ols[j] = BN_BITS / 8 + 1;
+				hls[j] = MD_LEN;
+				rand_bytes(ins[j], ils[j]);
+				md_map(hs[j], ins[j], ils[j]);
+			}
+			TEST_ASSERT(cp_rsa_sig_batch(op, ols, ip, ils, 0, prvs, 3) == STS_OK,
+					end);
+			for (j = 0; j < 3; j++) {
+				TEST_ASSERT(cp_rsa_ver(outs[j], ols[j], ins[j], ils[j], 0,
+								pubs[j]) == 1, end);
+			}
+			TEST_ASSERT(cp_rsa_sig_batch(op, ols, hp, hls, 1, prvs, 3) == STS_OK,
+					end);
+			for (j = 0; j < 3; j++) {
+				TEST_ASSERT(cp_rsa_ver(outs[j], ols[j], hs[j], hls[j], 1,
+								pubs[j]) == 1, end);
+			}
+			/* Empty batches are rejected. */
+			TEST_ASSERT(cp_rsa_sig_batch(op, ols, ip, ils, 0, prvs, 0) == STS_ERR,
+					end);
+			TEST_ASSERT(cp_rsa_dec_batch(NULL, op, ols, op, ols, prvs, 0) == STS_ERR,
+					end);
+			/* Keys with a common exponent are processed independently. */
+			bn_copy(prvs[1]->e, prvs[0]->e);
+			TEST_ASSERT(cp_rsa_sig_batch(op, ols, ip, ils, 0, prvs, 3) == STS_OK,
+					end);
+			bn_copy(prvs[1]->e, pubs[1]->e);
+			for (j = 0; j < 3; j++) {
+				TEST_ASSERT(cp_rsa_ver(outs[j], ols[j], ins[j], ils[j], 0,
+								pubs[j]) == 1, end);
+			}
+		} TEST_END;
 #endif
 	} CATCH_ANY {
 		ERROR(end);
@@ -145,8 +346,13 @@ static int rsa(void) {
 	code = STS_OK;
 
   end:
+	bn_free(t);
 	rsa_free(pub);
 	rsa_free(prv);
+	for (j = 0; j < 3; j++) {
+		rsa_free(pubs[j]);
+		rsa_free(prvs[j]);
+	}
 	return code;
 }
 
@@ -192,9 +398,10 @@ static int rabin(void) {
 static int benaloh(void) {
 	int code = STS_ERR;
 	bdpe_t pub, prv;
+	dlog_t d, e;
 	bn_t a, b;
 	dig_t in, out;
-	uint8_t buf[BN_BITS / 8 + 1];
+	uint8_t buf[BN_BITS / 8 + 1], *tab = NULL;
 	int len;
 	int result;
 
@@ -202,12 +409,16 @@ static int benaloh(void) {
 	bn_null(b);
 	bdpe_null(pub);
 	bdpe_null(prv);
+	dlog_null(d);
+	dlog_null(e);
 
 	TRY {
 		bn_new(a);
 		bn_new(b);
 		bdpe_new(pub);
 		bdpe_new(prv);
+		dlog_new(d);
+		dlog_new(e);
 
 		result = cp_bdpe_gen(pub, prv, bn_get_prime(47), BN_BITS);
 
@@ -240,6 +451,30 @@ static int benaloh(void) {
 			TEST_ASSERT(cp_bdpe_dec(&out, buf, len, prv) == STS_OK, end);
 			TEST_ASSERT(in == out, end);
 		} TEST_END;
+
+		TEST_BEGIN("benaloh decryption with precomputation is correct") {
+			TEST_ASSERT(result == STS_OK, end);
+			TEST_ASSERT(cp_bdpe_pre(d, prv) == STS_OK, end);
+			for (in = 0; in < bn_get_prime(47); in += 13) {
+				len = BN_BITS / 8 + 1;
+				TEST_ASSERT(cp_bdpe_enc(buf, &len, in, pub) == STS_OK, end);
+				TEST_ASSERT(cp_bdpe_dec_fix(&out, buf, len, d, prv) == STS_OK,
+						end);
+				TEST_ASSERT(in == out, end);
+			}
+			len = cp_dlog_size_bin(d);
+			tab = (uint8_t *)malloc(len);
+			TEST_ASSERT(tab != NULL, end);
+			TEST_ASSERT(cp_dlog_write_bin(tab, len, d) == STS_OK, end);
+			TEST_ASSERT(cp_dlog_read_bin(e, tab, len) == STS_OK, end);
+			TEST_ASSERT(cp_dlog_read_bin(e, tab, len - 1) == STS_ERR, end);
+			TEST_ASSERT(cp_dlog_read_bin(e, tab, len) == STS_OK, end);
+			in = bn_get_prime(47) - 1;
+			len = BN_BITS / 8 + 1;
+			TEST_ASSERT(cp_bdpe_enc(buf, &len, in, pub) == STS_OK, end);
+			TEST_ASSERT(cp_bdpe_dec_fix(&out, buf, len, e, prv) == STS_OK, end);
+			TEST_ASSERT(in == out, end);
+		} TEST_END;
 	} CATCH_ANY {
 		ERROR(end);
 	}
@@ -250,78 +485,162 @@ static int benaloh(void) {
 	bn_free(b);
 	bdpe_free(pub);
 	bdpe_free(prv);
+	dlog_free(d);
+	dlog_free(e);
+	free(tab);
 	return code;
 }
 
 static int paillier(void) {
 	int code = STS_ERR;
-	bn_t a, b, c, d, n, l, s;
-	uint8_t in[BN_BITS / 8 + 1], out[BN_BITS / 8 + 1];
-	int in_len, out_len;
+	bn_t a, b, c, t[BN_XP_TABLE];
+	phpe_t pub, prv;
+	uint8_t in[BN_BITS / 8 + 1], out[BN_BITS / 8 + 1], new[BN_BITS / 8 + 1];
+	uint8_t ins[3][BN_BITS / 8 + 1], outs[3][BN_BITS / 8 + 1];
+	uint8_t *ip[3], *op[3];
+	int in_len, out_len, new_len, j, ils[3], ols[3];
 	int result;
 
 	bn_null(a);
 	bn_null(b);
 	bn_null(c);
-	bn_null(d);
-	bn_null(n);
-	bn_null(l);
-	bn_null(s);
+	phpe_null(pub);
+	phpe_null(prv);
+	for (j = 0; j < BN_XP_TABLE; j++) {
+		bn_null(t[j]);
+	}
+	for (j = 0; j < 3; j++) {
+		ip[j] = ins[j];
+		op[j] = outs[j];
+	}
 
 	TRY {
 		bn_new(a);
 		bn_new(b);
 		bn_new(c);
-		bn_new(d);
-		bn_new(n);
-		bn_new(l);
-		bn_new(s);
+		phpe_new(pub);
+		phpe_new(prv);
+		for (j = 0; j < BN_XP_TABLE; j++) {
+			bn_new(t[j]);
+		}
 
-		result = cp_phpe_gen(n, l, BN_BITS / 2);
+		result = cp_phpe_gen(pub, prv, BN_BITS / 2);
 
 		TEST_BEGIN("paillier encryption/decryption is correct") {
 			TEST_ASSERT(result == STS_OK, end);
-			in_len = bn_size_bin(n);
+			in_len = bn_size_bin(pub->n);
 			out_len = BN_BITS / 8 + 1;
 			memset(in, 0, sizeof(in));
 			rand_bytes(in + (in_len - 10), 10);
-			TEST_ASSERT(cp_phpe_enc(out, &out_len, in, in_len, n) == STS_OK,
+			TEST_ASSERT(cp_phpe_enc(out, &out_len, in, in_len, pub) == STS_OK,
+					end);
+			TEST_ASSERT(cp_phpe_dec(out, in_len, out, out_len, prv) == STS_OK,
+					end);
+			TEST_ASSERT(memcmp(in, out, in_len) == 0, end);
+			bn_sub_dig(a, pub->n, 1);
+			bn_write_bin(in, in_len, a);
+			out_len = BN_BITS / 8 + 1;
+			TEST_ASSERT(cp_phpe_enc(out, &out_len, in, in_len, pub) == STS_OK,
 					end);
-			TEST_ASSERT(cp_phpe_dec(out, in_len, out, out_len, n, l) == STS_OK,
+			TEST_ASSERT(cp_phpe_dec(out, in_len, out, out_len, prv) == STS_OK,
 					end);
 			TEST_ASSERT(memcmp(in, out, in_len) == 0, end);
+			bn_write_bin(in, in_len, pub->n);
+			out_len = BN_BITS / 8 + 1;
+			TEST_ASSERT(cp_phpe_enc(out, &out_len, in, in_len, pub) == STS_ERR,
+					end);
 		}
 		TEST_END;
 
 		TEST_BEGIN("paillier encryption/decryption is homomorphic") {
 			TEST_ASSERT(result == STS_OK, end);
-			in_len = bn_size_bin(n);
+			in_len = bn_size_bin(pub->n);
 			out_len = BN_BITS / 8 + 1;
 			memset(in, 0, sizeof(in));
 			rand_bytes(in + (in_len - 10), 10);
 			bn_read_bin(a, in, in_len);
-			TEST_ASSERT(cp_phpe_enc(out, &out_len, in, in_len, n) == STS_OK,
+			TEST_ASSERT(cp_phpe_enc(out, &out_len, in, in_len, pub) == STS_OK,
 					end);
-			bn_read_bin(b, out, out_len);
 			memset(in, 0, sizeof(in));
 			rand_bytes(in + (in_len - 10), 10);
-			bn_read_bin(c, in, in_len);
+			bn_read_bin(b, in, in_len);
+			new_len = BN_BITS / 8 + 1;
+			TEST_ASSERT(cp_phpe_enc(new, &new_len, in, in_len, pub) == STS_OK,
+					end);
+			TEST_ASSERT(cp_phpe_add(out, &out_len, out, out_len, new, new_len,
+							pub) == STS_OK, end);
+			TEST_ASSERT(cp_phpe_dec(out, in_len, out, out_len, prv) == STS_OK,
+					end);
+			bn_add(a, a, b);
+			bn_write_bin(in, in_len, a);
+			TEST_ASSERT(memcmp(in, out, in_len) == 0, end);
+		}
+		TEST_END;
+
+		TEST_BEGIN("paillier scalar multiplication is homomorphic") {
+			TEST_ASSERT(result == STS_OK, end);
+			in_len = bn_size_bin(pub->n);
 			out_len = BN_BITS / 8 + 1;
-			TEST_ASSERT(cp_phpe_enc(out, &out_len, in, in_len, n) == STS_OK,
+			memset(in, 0, sizeof(in));
+			rand_bytes(in + (in_len - 10), 10);
+			bn_read_bin(a, in, in_len);
+			bn_rand(c, BN_POS, 64);
+			TEST_ASSERT(cp_phpe_enc(out, &out_len, in, in_len, pub) == STS_OK,
 					end);
-			bn_read_bin(d, out, out_len);
-			bn_mul(b, b, d);
-			bn_sqr(s, n);
-			bn_mod(b, b, s);
-			bn_write_bin(out, out_len, b);
-			TEST_ASSERT(cp_phpe_dec(out, in_len, out, out_len, n, l) == STS_OK,
+			TEST_ASSERT(cp_phpe_mul(out, &out_len, out, out_len, c,
+							pub) == STS_OK, end);
+			TEST_ASSERT(cp_phpe_dec(out, in_len, out, out_len, prv) == STS_OK,
 					end);
-			bn_add(a, a, c);
+			bn_mul(a, a, c);
 			bn_write_bin(in, in_len, a);
-			bn_read_bin(a, out, in_len);
 			TEST_ASSERT(memcmp(in, out, in_len) == 0, end);
 		}
 		TEST_END;
+
+		TEST_BEGIN("paillier encryption with precomputation is correct") {
+			TEST_ASSERT(result == STS_OK, end);
+			TEST_ASSERT(cp_phpe_pre(t, pub) == STS_OK, end);
+			in_len = bn_size_bin(pub->n);
+			out_len = BN_BITS / 8 + 1;
+			memset(in, 0, sizeof(in));
+			rand_bytes(in + (in_len - 10), 10);
+			TEST_ASSERT(cp_phpe_enc_fix(out, &out_len, in, in_len,
+							(const bn_t *)t, pub) == STS_OK, end);
+			TEST_ASSERT(cp_phpe_dec(new, in_len, out, out_len, prv) == STS_OK,
+					end);
+			TEST_ASSERT(memcmp(in, new, in_len) == 0, end);
+			new_len = BN_BITS / 8 + 1;
+			TEST_ASSERT(cp_phpe_enc_fix(new, &new_len, in, in_len,
+							(const bn_t *)t, pub) == STS_OK, end);
+			TEST_ASSERT(memcmp(out, new, out_len) != 0, end);
+		}
+		TEST_END;
+
+		TEST_BEGIN("paillier batch encryption is correct") {
+			TEST_ASSERT(result == STS_OK, end);
+			for (j = 0; j < 3; j++) {
+				ils[j] = bn_size_bin(pub->n);
+				ols[j] = BN_BITS / 8 + 1;
+				memset(ins[j], 0, sizeof(ins[j]));
+				rand_bytes(ins[j] + (ils[j] - 10), 10);
+			}
+			TEST_ASSERT(cp_phpe_enc_batch(op, ols, ip, ils, NULL, pub,
+							3) == STS_OK, end);
+			for (j = 0; j < 3; j++) {
+				TEST_ASSERT(cp_phpe_dec(out, ils[j], outs[j], ols[j],
+								prv) == STS_OK, end);
+				TEST_ASSERT(memcmp(ins[j], out, ils[j]) == 0, end);
+				ols[j] = BN_BITS / 8 + 1;
+			}
+			TEST_ASSERT(cp_phpe_enc_batch(op, ols, ip, ils, (const bn_t *)t,
+							pub, 3) == STS_OK, end);
+			for (j = 0; j < 3; j++) {
+				TEST_ASSERT(cp_phpe_dec(out, ils[j], outs[j], ols[j],
+								prv) == STS_OK, end);
+				TEST_ASSERT(memcmp(ins[j], out, ils[j]) == 0, end);
+			}
+		}
+		TEST_END;
 	}
 	CATCH_ANY {
 		ERROR(end);
@@ -332,10 +651,11 @@ static int paillier(void) {
 	bn_free(a);
 	bn_free(b);
 	bn_free(c);
-	bn_free(d);
-	bn_free(n);
-	bn_free(l);
-	bn_free(s);
+	phpe_free(pub);
+	phpe_free(prv);
+	for (j = 0; j < BN_XP_TABLE; j++) {
+		bn_free(t[j]);
+	}
 	return code;
 }
 
@@ -604,6 +924,46 @@ static int ecies(void) {
 				TEST_ASSERT(memcmp(in, out, out_len) == 0, end);
 			}
 			TEST_END;
+
+			TEST_BEGIN("ecies with gcm encryption/decryption is correct") {
+				TEST_ASSERT(cp_ecies_gen(d_a, q_a) == STS_OK, end);
+				in_len = BC_LEN - 1;
+				out_len = BC_LEN + MD_LEN;
+				rand_bytes(in, in_len);
+				TEST_ASSERT(cp_ecies_gcm_enc(r, out, &out_len, in, in_len, q_a)
+						== STS_OK, end);
+				TEST_ASSERT(out_len == in_len + BC_TAG_LEN, end);
+				out[0] ^= 0x01;
+				l = out_len;
+				TEST_ASSERT(cp_ecies_gcm_dec(out, &l, r, out, out_len, d_a)
+						== STS_ERR, end);
+				cp_ecies_gcm_enc(r, out, &out_len, in, in_len, q_a);
+				TEST_ASSERT(cp_ecies_gcm_dec(out, &out_len, r, out, out_len, d_a)
+						== STS_OK, end);
+				TEST_ASSERT(out_len == in_len, end);
+				TEST_ASSERT(memcmp(in, out, out_len) == 0, end);
+			}
+			TEST_END;
+
+			TEST_BEGIN("ecies with chacha20-poly1305 encryption/decryption is correct") {
+				TEST_ASSERT(cp_ecies_gen(d_a, q_a) == STS_OK, end);
+				in_len = BC_LEN - 1;
+				out_len = BC_LEN + MD_LEN;
+				rand_bytes(in, in_len);
+				TEST_ASSERT(cp_ecies_chacha_enc(r, out, &out_len, in, in_len, q_a)
+						== STS_OK, end);
+				TEST_ASSERT(out_len == in_len + BC_TAG_LEN, end);
+				out[0] ^= 0x01;
+				l = out_len;
+				TEST_ASSERT(cp_ecies_chacha_dec(out, &l, r, out, out_len, d_a)
+						== STS_ERR, end);
+				cp_ecies_chacha_enc(r, out, &out_len, in, in_len, q_a);
+				TEST_ASSERT(cp_ecies_chacha_dec(out, &out_len, r, out, out_len, d_a)
+						== STS_OK, end);
+				TEST_ASSERT(out_len == in_len, end);
+				TEST_ASSERT(memcmp(in, out, out_len) == 0, end);
+			}
+			TEST_END;
 		}
 #if MD_MAP == SH256
 		uint8_t msg[BC_LEN + MD_LEN];
@@ -661,21 +1021,31 @@ static int ecies(void) {
 }
 
 static int ecdsa(void) {
-	int code = STS_ERR;
-	bn_t d, r, s;
-	ec_t q;
-	uint8_t m[5] = { 0, 1, 2, 3, 4 }, h[MD_LEN];
+	int code = STS_ERR, l[4], v[4];
+	bn_t d, r, s, rs[4], ss[4];
+	ec_t q, qs[4];
+	uint8_t m[5] = { 0, 1, 2, 3, 4 }, h[MD_LEN], ms[4][5], *mp[4];
 
 	bn_null(d);
 	bn_null(r);
 	bn_null(s);
 	ec_null(q);
+	for (int i = 0; i < 4; i++) {
+		bn_null(rs[i]);
+		bn_null(ss[i]);
+		ec_null(qs[i]);
+	}
 
 	TRY {
 		bn_new(d);
 		bn_new(r);
 		bn_new(s);
 		ec_new(q);
+		for (int i = 0; i < 4; i++) {
+			bn_new(rs[i]);
+			bn_new(ss[i]);
+			ec_new(qs[i]);
+		}
 
 		TEST_BEGIN("ecdsa signature is correct") {
 			TEST_ASSERT(cp_ecdsa_gen(d, q) == STS_OK, end);
@@ -686,6 +1056,27 @@ static int ecdsa(void) {
 			TEST_ASSERT(cp_ecdsa_ver(r, s, h, MD_LEN, 1, q) == 1, end);
 		}
 		TEST_END;
+
+		TEST_BEGIN("ecdsa batch verification is correct") {
+			for (int i = 0; i < 4; i++) {
+				memcpy(ms[i], m, sizeof(m));
+				ms[i][0] = i;
+				mp[i] = ms[i];
+				l[i] = sizeof(m);
+				TEST_ASSERT(cp_ecdsa_gen(d, qs[i]) == STS_OK, end);
+				TEST_ASSERT(cp_ecdsa_sig(rs[i], ss[i], mp[i], l[i], 0,
+								d) == STS_OK, end);
+			}
+			TEST_ASSERT(cp_ecdsa_ver_batch(v, rs, ss, mp, l, 0, qs, 4) == 1,
+					end);
+			ms[2][0] ^= 1;
+			TEST_ASSERT(cp_ecdsa_ver_batch(v, rs, ss, mp, l, 0, qs, 4) == 0,
+					end);
+			TEST_ASSERT(v[0] == 1 && v[1] == 1 && v[2] == 0 && v[3] == 1, end);
+			TEST_ASSERT(cp_ecdsa_ver_batch(v, rs, ss, mp, l, 0, qs, 0) == 0,
+					end);
+		}
+		TEST_END;
 	}
 	CATCH_ANY {
 		ERROR(end);
@@ -697,6 +1088,11 @@ static int ecdsa(void) {
 	bn_free(r);
 	bn_free(s);
 	ec_free(q);
+	for (int i = 0; i < 4; i++) {
+		bn_free(rs[i]);
+		bn_free(ss[i]);
+		ec_free(qs[i]);
+	}
 	return code;
 }
 
@@ -889,6 +1285,7 @@ static int bgn(void) {
 	g2_t e[2], f[2];
 	gt_t g[4];
 	bgn_t pub, prv;
+	dlog_t d1, d2, dt;
 	dig_t in, out, t;
 
 	g1_null(c[0]);
@@ -901,6 +1298,9 @@ static int bgn(void) {
 	g2_null(f[1]);
 	bgn_null(pub);
 	bgn_null(prv);
+	dlog_null(d1);
+	dlog_null(d2);
+	dlog_null(dt);
 
 	TRY {
 		g1_new(c[0]);
@@ -913,6 +1313,9 @@ static int bgn(void) {
 		g2_new(f[1]);
 		bgn_new(pub);
 		bgn_new(prv);
+		dlog_new(d1);
+		dlog_new(d2);
+		dlog_new(dt);
 		for (int i = 0; i < 4; i++) {
 			gt_null(g[i]);
 			gt_new(g[i]);
@@ -975,6 +1378,31 @@ static int bgn(void) {
 			TEST_ASSERT(in + in == t, end);
 		} TEST_END;
 
+		TEST_BEGIN("boneh-go-nissim decryption with precomputation is correct") {
+			TEST_ASSERT(cp_bgn_pre1(d1, 1000, prv) == STS_OK, end);
+			TEST_ASSERT(cp_bgn_pre2(d2, 1000, prv) == STS_OK, end);
+			TEST_ASSERT(cp_bgn_pre(dt, 1000, prv) == STS_OK, end);
+			rand_bytes((unsigned char *)&in, sizeof(dig_t));
+			in = in % 1000;
+			TEST_ASSERT(cp_bgn_enc1(c, in, pub) == STS_OK, end);
+			TEST_ASSERT(cp_bgn_dec1_fix(&out, c, d1, prv) == STS_OK, end);
+			TEST_ASSERT(in == out, end);
+			TEST_ASSERT(cp_bgn_enc2(e, 0, pub) == STS_OK, end);
+			TEST_ASSERT(cp_bgn_dec2_fix(&out, e, d2, prv) == STS_OK, end);
+			TEST_ASSERT(out == 0, end);
+			TEST_ASSERT(cp_bgn_enc2(e, 999, pub) == STS_OK, end);
+			TEST_ASSERT(cp_bgn_dec2_fix(&out, e, d2, prv) == STS_OK, end);
+			TEST_ASSERT(out == 999, end);
+			TEST_ASSERT(cp_bgn_enc1(d, 1000, pub) == STS_OK, end);
+			TEST_ASSERT(cp_bgn_dec1_fix(&out, d, d1, prv) == STS_ERR, end);
+			TEST_ASSERT(cp_bgn_enc2(e, 3, pub) == STS_OK, end);
+			in = in % 300;
+			TEST_ASSERT(cp_bgn_enc1(c, in, pub) == STS_OK, end);
+			TEST_ASSERT(cp_bgn_mul(g, c, e) == STS_OK, end);
+			TEST_ASSERT(cp_bgn_dec_fix(&t, g, dt, prv) == STS_OK, end);
+			TEST_ASSERT(3 * in == t, end);
+		} TEST_END;
+
 	} CATCH_ANY {
 		ERROR(end);
 	}
@@ -991,6 +1419,9 @@ static int bgn(void) {
 	g2_free(f[1]);
 	bgn_free(pub);
 	bgn_free(prv);
+	dlog_free(d1);
+	dlog_free(d2);
+	dlog_free(dt);
 	for (int i = 0; i < 4; i++) {
 		gt_free(g[i]);
 	}
@@ -998,20 +1429,28 @@ static int bgn(void) {
 }
 
 static int bls(void) {
-	int code = STS_ERR;
+	int code = STS_ERR, l[4], v[4];
 	bn_t d;
-	g1_t s;
-	g2_t q;
-	uint8_t m[5] = { 0, 1, 2, 3, 4 };
+	g1_t s, ss[4];
+	g2_t q, qs[4];
+	uint8_t m[5] = { 0, 1, 2, 3, 4 }, ms[4][5], *mp[4];
 
 	bn_null(d);
 	g1_null(s);
 	g2_null(q);
+	for (int i = 0; i < 4; i++) {
+		g1_null(ss[i]);
+		g2_null(qs[i]);
+	}
 
 	TRY {
 		bn_new(d);
 		g1_new(s);
 		g2_new(q);
+		for (int i = 0; i < 4; i++) {
+			g1_new(ss[i]);
+			g2_new(qs[i]);
+		}
 
 		TEST_BEGIN("boneh-lynn-schacham short signature is correct") {
 			TEST_ASSERT(cp_bls_gen(d, q) == STS_OK, end);
@@ -1019,6 +1458,23 @@ static int bls(void) {
 			TEST_ASSERT(cp_bls_ver(s, m, sizeof(m), q) == 1, end);
 		}
 		TEST_END;
+
+		TEST_BEGIN("boneh-lynn-schacham batch verification is correct") {
+			for (int i = 0; i < 4; i++) {
+				memcpy(ms[i], m, sizeof(m));
+				ms[i][0] = i;
+				mp[i] = ms[i];
+				l[i] = sizeof(m);
+				TEST_ASSERT(cp_bls_gen(d, qs[i]) == STS_OK, end);
+				TEST_ASSERT(cp_bls_sig(ss[i], mp[i], l[i], d) == STS_OK, end);
+			}
+			TEST_ASSERT(cp_bls_ver_batch(v, ss, mp, l, qs, 4) == 1, end);
+			ms[1][0] ^= 1;
+			TEST_ASSERT(cp_bls_ver_batch(v, ss, mp, l, qs, 4) == 0, end);
+			TEST_ASSERT(v[0] == 1 && v[1] == 0 && v[2] == 1 && v[3] == 1, end);
+			TEST_ASSERT(cp_bls_ver_batch(v, ss, mp, l, qs, 0) == 0, end);
+		}
+		TEST_END;
 	}
 	CATCH_ANY {
 		ERROR(end);
@@ -1029,6 +1485,10 @@ static int bls(void) {
 	bn_free(d);
 	g1_free(s);
 	g2_free(q);
+	for (int i = 0; i < 4; i++) {
+		g1_free(ss[i]);
+		g2_free(qs[i]);
+	}
 	return code;
 }
 
@@ -34,36 +34,125 @@
 #include "relic.h"
 #include "relic_test.h"
 
+#if ALLOC == STATIC && MULTI == PTHREAD
+
+#include <pthread.h>
+#include <sched.h>
+
+/**
+ * Number of threads sharing the pool in the stress test.
+ */
+#define THREADS		4
+
+/**
+ * Number of digit vectors held at once by each thread, enough for the threads
+ * together to need more than the first slab.
+ */
+#define HELD		(POOL_SIZE / 2)
+
+static void *holder(void *ptr) {
+	int *code = (int *)ptr, i, j, k, n;
+	dig_t *a[HELD], mark = (dig_t)(uintptr_t)ptr;
+
+	core_init();
+	*code = STS_OK;
+	for (i = 0; i < 16 && *code == STS_OK; i++) {
+		for (n = 0; n < HELD; n++) {
+			a[n] = pool_get(DV_DIGS);
+			if (a[n] == NULL) {
+				*code = STS_ERR;
+				break;
+			}
+			for (k = 0; k < DV_DIGS; k++) {
+				a[n][k] = mark ^ n ^ k;
+			}
+		}
+		sched_yield();
+		/* An element handed to two threads at once breaks the pattern. */
+		for (j = 0; j < n; j++) {
+			for (k = 0; k < DV_DIGS; k++) {
+				if (a[j][k] != (mark ^ j ^ k)) {
+					*code = STS_ERR;
+				}
+			}
+		}
+		/* Interleave the restored elements with those of other threads. */
+		for (j = 1; j < n; j += 2) {
+			pool_put(a[j]);
+		}
+		sched_yield();
+		for (j = 0; j < n; j += 2) {
+			pool_put(a[j]);
+		}
+	}
+	core_clean();
+	return NULL;
+}
+
+#endif
+
 static int memory(void) {
 	err_t e;
 	int code = STS_ERR;
 
 #if ALLOC == STATIC
-	dv_t a[POOL_SIZE + 1];
+	dv_t a[POOL_SIZE + 1], b;
 
-	for (int i = 0; i < POOL_SIZE; i++) {
+	for (int i = 0; i <= POOL_SIZE; i++) {
 		dv_null(a[i]);
 	}
-	dv_null(a[POOL_SIZE]);
+	dv_null(b);
 
 	TRY {
-		TEST_BEGIN("all memory can be allocated") {
-			for (int j = 0; j < POOL_SIZE; j++) {
+		TEST_ONCE("memory beyond the first slab can be allocated") {
+			for (int j = 0; j <= POOL_SIZE; j++) {
 				dv_new(a[j]);
 			}
-			dv_new(a[POOL_SIZE]);
+			for (int j = 0; j <= POOL_SIZE; j++) {
+				dv_free(a[j]);
+			}
 		}
+		TEST_END;
+
+		TEST_BEGIN("released memory is reused") {
+			dv_new(a[0]);
+			b = a[0];
+			dv_free(a[0]);
+			dv_new(a[0]);
+			TEST_ASSERT(a[0] == b, end);
+			dv_free(a[0]);
+		}
+		TEST_END;
+
+#if MULTI == PTHREAD
+		TEST_ONCE("memory is shared safely among threads") {
+			pthread_t thread[THREADS];
+			int result[THREADS], ok = 1;
+			for (int j = 0; j < THREADS; j++) {
+				result[j] = STS_ERR;
+				if (pthread_create(&thread[j], NULL, holder, &result[j])) {
+					ok = 0;
+				}
+			}
+			for (int j = 0; j < THREADS; j++) {
+				if (pthread_join(thread[j], NULL) || result[j] != STS_OK) {
+					ok = 0;
+				}
+			}
+			TEST_ASSERT(ok == 1, end);
+		}
+		TEST_END;
+#endif
 	} CATCH(e) {
 		switch (e) {
 			case ERR_NO_MEMORY:
-				for (int j = 0; j < POOL_SIZE; j++) {
-					dv_free(a[j]);
-				}
-				dv_free(a[POOL_SIZE]);
+				util_print("FATAL ERROR!\n");
+				ERROR(end);
 				break;
 		}
-		code = STS_OK;
 	}
+	code = STS_OK;
+  end:
 #else
 	dv_t a;
 
@@ -718,8 +718,8 @@ static int fixed(void) {
 
 static int simultaneous(void) {
 	int code = STS_ERR;
-	bn_t n, k, l;
-	ep_t p, q, r;
+	bn_t n, k, l, u[5];
+	ep_t p, q, r, t[5];
 
 	bn_null(n);
 	bn_null(k);
@@ -727,6 +727,10 @@ static int simultaneous(void) {
 	ep_null(p);
 	ep_null(q);
 	ep_null(r);
+	for (int i = 0; i < 5; i++) {
+		bn_null(u[i]);
+		ep_null(t[i]);
+	}
 
 	TRY {
 		bn_new(n);
@@ -735,6 +739,10 @@ static int simultaneous(void) {
 		ep_new(p);
 		ep_new(q);
 		ep_new(r);
+		for (int i = 0; i < 5; i++) {
+			bn_new(u[i]);
+			ep_new(t[i]);
+		}
 
 		ep_curve_get_gen(p);
 		ep_curve_get_ord(n);
@@ -800,6 +808,22 @@ static int simultaneous(void) {
 			ep_mul_sim(q, p, k, q, l);
 			TEST_ASSERT(ep_cmp(q, r) == CMP_EQ, end);
 		} TEST_END;
+
+		TEST_BEGIN("multiple simultaneous point multiplication is correct") {
+			ep_set_infty(q);
+			for (int i = 0; i < 5; i++) {
+				bn_rand_mod(u[i], n);
+				ep_rand(t[i]);
+				ep_mul(p, t[i], u[i]);
+				ep_add(q, q, p);
+			}
+			ep_norm(q, q);
+			ep_mul_sim_lot(r, t, u, 5);
+			TEST_ASSERT(ep_cmp(q, r) == CMP_EQ, end);
+			ep_mul_sim_lot(r, t, u, 1);
+			ep_mul(p, t[0], u[0]);
+			TEST_ASSERT(ep_cmp(p, r) == CMP_EQ, end);
+		} TEST_END;
 	}
 	CATCH_ANY {
 		util_print("FATAL ERROR!\n");
@@ -813,6 +837,10 @@ static int simultaneous(void) {
 	ep_free(p);
 	ep_free(q);
 	ep_free(r);
+	for (int i = 0; i < 5; i++) {
+		bn_free(u[i]);
+		ep_free(t[i]);
+	}
 	return code;
 }
 
@@ -850,16 +878,23 @@ static int compression(void) {
 
 static int hashing(void) {
 	int code = STS_ERR;
-	ep_t a;
+	ep_t a, t[9];
 	bn_t n;
-	uint8_t msg[5];
+	uint8_t msg[5], buf[9][100], *m[9];
+	int i, l[9];
 
 	ep_null(a);
 	bn_null(n);
+	for (i = 0; i < 9; i++) {
+		ep_null(t[i]);
+	}
 
 	TRY {
 		ep_new(a);
 		bn_new(n);
+		for (i = 0; i < 9; i++) {
+			ep_new(t[i]);
+		}
 
 		ep_curve_get_ord(n);
 
@@ -870,6 +905,20 @@ static int hashing(void) {
 			TEST_ASSERT(ep_is_infty(a) == 1, end);
 		}
 		TEST_END;
+
+		TEST_BEGIN("batch point hashing is consistent") {
+			for (int j = 0; j < 9; j++) {
+				l[j] = (11 * j) % sizeof(buf[j]);
+				m[j] = buf[j];
+				rand_bytes(buf[j], sizeof(buf[j]));
+			}
+			ep_map_lot(t, m, l, 9);
+			for (int j = 0; j < 9; j++) {
+				ep_map(a, m[j], l[j]);
+				TEST_ASSERT(ep_cmp(a, t[j]) == CMP_EQ, end);
+			}
+		}
+		TEST_END;
 	}
 	CATCH_ANY {
 		ERROR(end);
@@ -878,6 +927,9 @@ static int hashing(void) {
   end:
 	ep_free(a);
 	bn_free(n);
+	for (i = 0; i < 9; i++) {
+		ep_free(t[i]);
+	}
 	return code;
 }
 
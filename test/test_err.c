@@ -37,6 +37,7 @@
 
 static void dummy(void);
 static void dummy2(void);
+static void dummy3(void);
 
 int j;
 
@@ -55,10 +56,24 @@ static void dummy2(void) {
 	}
 }
 
+static void dummy3(void) {
+	TRY {
+		dummy();
+	}
+	CATCH_ANY {
+		THROW(ERR_CAUGHT);
+	}
+}
+
 int main(void) {
 	err_t e;
 	char *msg = NULL;
 	int code = STS_ERR;
+	bn_t a, b, c;
+
+	bn_null(a);
+	bn_null(b);
+	bn_null(c);
 
 	if (core_init() != STS_OK) {
 		core_clean();
@@ -78,6 +93,41 @@ int main(void) {
 
 	j = 0;
 
+	TEST_ONCE("nested try-catch propagates errors") {
+		code = STS_ERR;
+		TRY {
+			dummy3();
+		}
+		CATCH_ANY {
+			code = STS_OK;
+		}
+		TEST_ASSERT(code == STS_OK, fail);
+		code = STS_ERR;
+	} TEST_END;
+
+	j = 0;
+
+	TEST_ONCE("invalid inputs are rejected before they are used") {
+		bn_new(a);
+		bn_new(b);
+		bn_new(c);
+		bn_set_dig(a, 1);
+		bn_zero(b);
+		e = ERR_CAUGHT;
+		TRY {
+			/* Dividing by zero would not terminate. */
+			bn_div(c, a, b);
+		}
+		CATCH(e) {
+			code = STS_OK;
+		}
+		TEST_ASSERT(code == STS_OK && e == ERR_NO_VALID, fail);
+		code = STS_ERR;
+		bn_free(a);
+		bn_free(b);
+		bn_free(c);
+	} TEST_END;
+
 	TEST_ONCE("try-catch is correct and error message is printed");
 	TRY {
 		dummy();
@@ -101,4 +151,7 @@ int main(void) {
 	else {
 		return 1;
 	}
+  fail:
+	core_clean();
+	return 1;
 }
@@ -64,6 +64,25 @@ char *tests[3] = {
 
 long int count[3] = { 1, 1, 10000 };
 
+#if ARCH == X64
+
+/*
+ * Instruction set masks that select each compression backend in turn.
+ */
+int backends[2] = { ARCH_ALL, 0 };
+
+#define BACKENDS	2
+
+#else
+
+int backends[1] = { 0 };
+
+#define BACKENDS	1
+#define arch_limit(M)	(void)(M)
+#define ARCH_ALL		0
+
+#endif
+
 #if MD_MAP == SHONE || !defined(STRIP)
 
 uint8_t result1[3][20] = {
@@ -77,17 +96,41 @@ uint8_t result1[3][20] = {
 
 static int sha1(void) {
 	int code = STS_ERR;
-	int i, j;
+	int b, i, j, k, len;
 	uint8_t message[MSG_SIZE], digest[20];
+	md_shone_t ctx;
 
 	TEST_ONCE("sha1 hash function is correct") {
-		for (i = 0; i < TEST_MAX; i++) {
-			message[0] = '\0';
-			for (j = 0; j < count[i]; j++) {
-				strcat((char *)message, tests[i]);
+		for (b = 0; b < BACKENDS; b++) {
+			arch_limit(backends[b]);
+			for (i = 0; i < TEST_MAX; i++) {
+				message[0] = '\0';
+				for (j = 0; j < count[i]; j++) {
+					strcat((char *)message, tests[i]);
+				}
+				md_map_shone(digest, message, strlen((char *)message));
+				TEST_ASSERT(memcmp(digest, result1[i], 20) == 0, end);
+			}
+		}
+	}
+	TEST_END;
+
+	TEST_ONCE("sha1 incremental hashing is consistent") {
+		for (b = 0; b < BACKENDS; b++) {
+			arch_limit(backends[b]);
+			for (i = 0; i < TEST_MAX; i++) {
+				message[0] = '\0';
+				for (j = 0; j < count[i]; j++) {
+					strcat((char *)message, tests[i]);
+				}
+				len = strlen((char *)message);
+				md_shone_init(&ctx);
+				for (j = 0, k = 1; j < len; j += k, k = k % 67 + 1) {
+					md_shone_update(&ctx, message + j, MIN(k, len - j));
+				}
+				md_shone_final(&ctx, digest);
+				TEST_ASSERT(memcmp(digest, result1[i], 20) == 0, end);
 			}
-			md_map_shone(digest, message, strlen((char *)message));
-			TEST_ASSERT(memcmp(digest, result1[i], 20) == 0, end);
 		}
 	}
 	TEST_END;
@@ -95,6 +138,7 @@ static int sha1(void) {
 	code = STS_OK;
 
   end:
+	arch_limit(ARCH_ALL);
 	return code;
 }
 
@@ -116,17 +160,41 @@ uint8_t result224[3][28] = {
 
 static int sha224(void) {
 	int code = STS_ERR;
-	int i, j;
+	int b, i, j, k, len;
 	uint8_t message[MSG_SIZE], digest[28];
+	md_sh224_t ctx;
 
 	TEST_ONCE("sha224 hash function is correct") {
-		for (i = 0; i < TEST_MAX; i++) {
-			message[0] = '\0';
-			for (j = 0; j < count[i]; j++) {
-				strcat((char *)message, tests[i]);
+		for (b = 0; b < BACKENDS; b++) {
+			arch_limit(backends[b]);
+			for (i = 0; i < TEST_MAX; i++) {
+				message[0] = '\0';
+				for (j = 0; j < count[i]; j++) {
+					strcat((char *)message, tests[i]);
+				}
+				md_map_sh224(digest, message, strlen((char *)message));
+				TEST_ASSERT(memcmp(digest, result224[i], 28) == 0, end);
+			}
+		}
+	}
+	TEST_END;
+
+	TEST_ONCE("sha224 incremental hashing is consistent") {
+		for (b = 0; b < BACKENDS; b++) {
+			arch_limit(backends[b]);
+			for (i = 0; i < TEST_MAX; i++) {
+				message[0] = '\0';
+				for (j = 0; j < count[i]; j++) {
+					strcat((char *)message, tests[i]);
+				}
+				len = strlen((char *)message);
+				md_sh224_init(&ctx);
+				for (j = 0, k = 1; j < len; j += k, k = k % 67 + 1) {
+					md_sh224_update(&ctx, message + j, MIN(k, len - j));
+				}
+				md_sh224_final(&ctx, digest);
+				TEST_ASSERT(memcmp(digest, result224[i], 28) == 0, end);
 			}
-			md_map_sh224(digest, message, strlen((char *)message));
-			TEST_ASSERT(memcmp(digest, result224[i], 28) == 0, end);
 		}
 	}
 	TEST_END;
@@ -134,6 +202,7 @@ static int sha224(void) {
 	code = STS_OK;
 
   end:
+	arch_limit(ARCH_ALL);
 	return code;
 }
 
@@ -155,17 +224,61 @@ uint8_t result256[3][32] = {
 
 static int sha256(void) {
 	int code = STS_ERR;
-	int i, j;
+	int b, i, j, k, len;
 	uint8_t message[MSG_SIZE], digest[32];
+	md_sh256_t ctx;
+	uint8_t buf[19][300], out[19][32], *m[19], *h[19];
+	int l[19];
 
 	TEST_ONCE("sha256 hash function is correct") {
-		for (i = 0; i < TEST_MAX; i++) {
-			message[0] = '\0';
-			for (j = 0; j < count[i]; j++) {
-				strcat((char *)message, tests[i]);
+		for (b = 0; b < BACKENDS; b++) {
+			arch_limit(backends[b]);
+			for (i = 0; i < TEST_MAX; i++) {
+				message[0] = '\0';
+				for (j = 0; j < count[i]; j++) {
+					strcat((char *)message, tests[i]);
+				}
+				md_map_sh256(digest, message, strlen((char *)message));
+				TEST_ASSERT(memcmp(digest, result256[i], 32) == 0, end);
+			}
+		}
+	}
+	TEST_END;
+
+	TEST_ONCE("sha256 incremental hashing is consistent") {
+		for (b = 0; b < BACKENDS; b++) {
+			arch_limit(backends[b]);
+			for (i = 0; i < TEST_MAX; i++) {
+				message[0] = '\0';
+				for (j = 0; j < count[i]; j++) {
+					strcat((char *)message, tests[i]);
+				}
+				len = strlen((char *)message);
+				md_sh256_init(&ctx);
+				for (j = 0, k = 1; j < len; j += k, k = k % 67 + 1) {
+					md_sh256_update(&ctx, message + j, MIN(k, len - j));
+				}
+				md_sh256_final(&ctx, digest);
+				TEST_ASSERT(memcmp(digest, result256[i], 32) == 0, end);
+			}
+		}
+	}
+	TEST_END;
+
+	TEST_BEGIN("sha256 multi-buffer hashing is consistent") {
+		for (b = 0; b < BACKENDS; b++) {
+			arch_limit(backends[b]);
+			for (j = 0; j < 19; j++) {
+				l[j] = (37 * j) % sizeof(buf[j]);
+				m[j] = buf[j];
+				h[j] = out[j];
+				rand_bytes(buf[j], sizeof(buf[j]));
+			}
+			md_map_sh256_x8(h, m, l, 19);
+			for (j = 0; j < 19; j++) {
+				md_map_sh256(digest, m[j], l[j]);
+				TEST_ASSERT(memcmp(digest, out[j], 32) == 0, end);
 			}
-			md_map_sh256(digest, message, strlen((char *)message));
-			TEST_ASSERT(memcmp(digest, result256[i], 32) == 0, end);
 		}
 	}
 	TEST_END;
@@ -173,6 +286,7 @@ static int sha256(void) {
 	code = STS_OK;
 
   end:
+	arch_limit(ARCH_ALL);
 	return code;
 }
 
@@ -208,8 +322,9 @@ uint8_t result384[4][48] = {
 
 static int sha384(void) {
 	int code = STS_ERR;
-	int i, j;
+	int i, j, k, len;
 	uint8_t message[MSG_SIZE], digest[48];
+	md_sh384_t ctx;
 
 	TEST_ONCE("sha384 hash function is correct") {
 		for (i = 0; i < TEST_MAX; i++) {
@@ -223,6 +338,23 @@ static int sha384(void) {
 	}
 	TEST_END;
 
+	TEST_ONCE("sha384 incremental hashing is consistent") {
+		for (i = 0; i < TEST_MAX; i++) {
+			message[0] = '\0';
+			for (j = 0; j < count2[i]; j++) {
+				strcat((char *)message, tests2[i]);
+			}
+			len = strlen((char *)message);
+			md_sh384_init(&ctx);
+			for (j = 0, k = 1; j < len; j += k, k = k % 67 + 1) {
+				md_sh384_update(&ctx, message + j, MIN(k, len - j));
+			}
+			md_sh384_final(&ctx, digest);
+			TEST_ASSERT(memcmp(digest, result384[i], 48) == 0, end);
+		}
+	}
+	TEST_END;
+
 	code = STS_OK;
 
   end:
@@ -259,8 +391,11 @@ uint8_t result512[4][64] = {
 
 static int sha512(void) {
 	int code = STS_ERR;
-	int i, j;
+	int b, i, j, k, len;
 	uint8_t message[MSG_SIZE], digest[64];
+	md_sh512_t ctx;
+	uint8_t buf[19][300], out[19][64], *m[19], *h[19];
+	int l[19];
 
 	TEST_ONCE("sha512 hash function is correct") {
 		for (i = 0; i < TEST_MAX; i++) {
@@ -274,6 +409,362 @@ static int sha512(void) {
 	}
 	TEST_END;
 
+	TEST_ONCE("sha512 incremental hashing is consistent") {
+		for (i = 0; i < TEST_MAX; i++) {
+			message[0] = '\0';
+			for (j = 0; j < count2[i]; j++) {
+				strcat((char *)message, tests2[i]);
+			}
+			len = strlen((char *)message);
+			md_sh512_init(&ctx);
+			for (j = 0, k = 1; j < len; j += k, k = k % 67 + 1) {
+				md_sh512_update(&ctx, message + j, MIN(k, len - j));
+			}
+			md_sh512_final(&ctx, digest);
+			TEST_ASSERT(memcmp(digest, result512[i], 64) == 0, end);
+		}
+	}
+	TEST_END;
+
+	TEST_BEGIN("sha512 multi-buffer hashing is consistent") {
+		for (b = 0; b < BACKENDS; b++) {
+			arch_limit(backends[b]);
+			for (j = 0; j < 19; j++) {
+				l[j] = (37 * j) % sizeof(buf[j]);
+				m[j] = buf[j];
+				h[j] = out[j];
+				rand_bytes(buf[j], sizeof(buf[j]));
+			}
+			md_map_sh512_x4(h, m, l, 19);
+			for (j = 0; j < 19; j++) {
+				md_map_sh512(digest, m[j], l[j]);
+				TEST_ASSERT(memcmp(digest, out[j], 64) == 0, end);
+			}
+		}
+	}
+	TEST_END;
+
+	code = STS_OK;
+
+  end:
+	arch_limit(ARCH_ALL);
+	return code;
+}
+
+#endif
+
+#if MD_MAP == SH3_256 || MD_MAP == SH3_512 || !defined(STRIP)
+
+uint8_t result3_256[3][32] = {
+	{0x3A, 0x98, 0x5D, 0xA7, 0x4F, 0xE2, 0x25, 0xB2, 0x04, 0x5C, 0x17, 0x2D,
+				0x6B, 0xD3, 0x90, 0xBD, 0x85, 0x5F, 0x08, 0x6E, 0x3E, 0x9D,
+				0x52, 0x5B, 0x46, 0xBF, 0xE2, 0x45, 0x11, 0x43, 0x15, 0x32},
+	{0x41, 0xC0, 0xDB, 0xA2, 0xA9, 0xD6, 0x24, 0x08, 0x49, 0x10, 0x03, 0x76,
+				0xA8, 0x23, 0x5E, 0x2C, 0x82, 0xE1, 0xB9, 0x99, 0x8A, 0x99,
+				0x9E, 0x21, 0xDB, 0x32, 0xDD, 0x97, 0x49, 0x6D, 0x33, 0x76},
+	{0x5C, 0x88, 0x75, 0xAE, 0x47, 0x4A, 0x36, 0x34, 0xBA, 0x4F, 0xD5, 0x5E,
+				0xC8, 0x5B, 0xFF, 0xD6, 0x61, 0xF3, 0x2A, 0xCA, 0x75, 0xC6,
+				0xD6, 0x99, 0xD0, 0xCD, 0xCB, 0x6C, 0x11, 0x58, 0x91, 0xC1},
+};
+
+uint8_t result3_512[3][64] = {
+	{0xB7, 0x51, 0x85, 0x0B, 0x1A, 0x57, 0x16, 0x8A, 0x56, 0x93, 0xCD, 0x92,
+				0x4B, 0x6B, 0x09, 0x6E, 0x08, 0xF6, 0x21, 0x82, 0x74, 0x44,
+				0xF7, 0x0D, 0x88, 0x4F, 0x5D, 0x02, 0x40, 0xD2, 0x71, 0x2E,
+				0x10, 0xE1, 0x16, 0xE9, 0x19, 0x2A, 0xF3, 0xC9, 0x1A, 0x7E,
+				0xC5, 0x76, 0x47, 0xE3, 0x93, 0x40, 0x57, 0x34, 0x0B, 0x4C,
+				0xF4, 0x08, 0xD5, 0xA5, 0x65, 0x92, 0xF8, 0x27, 0x4E, 0xEC,
+				0x53, 0xF0},
+	{0x04, 0xA3, 0x71, 0xE8, 0x4E, 0xCF, 0xB5, 0xB8, 0xB7, 0x7C, 0xB4, 0x86,
+				0x10, 0xFC, 0xA8, 0x18, 0x2D, 0xD4, 0x57, 0xCE, 0x6F, 0x32,
+				0x6A, 0x0F, 0xD3, 0xD7, 0xEC, 0x2F, 0x1E, 0x91, 0x63, 0x6D,
+				0xEE, 0x69, 0x1F, 0xBE, 0x0C, 0x98, 0x53, 0x02, 0xBA, 0x1B,
+				0x0D, 0x8D, 0xC7, 0x8C, 0x08, 0x63, 0x46, 0xB5, 0x33, 0xB4,
+				0x9C, 0x03, 0x0D, 0x99, 0xA2, 0x7D, 0xAF, 0x11, 0x39, 0xD6,
+				0xE7, 0x5E},
+	{0x3C, 0x3A, 0x87, 0x6D, 0xA1, 0x40, 0x34, 0xAB, 0x60, 0x62, 0x7C, 0x07,
+				0x7B, 0xB9, 0x8F, 0x7E, 0x12, 0x0A, 0x2A, 0x53, 0x70, 0x21,
+				0x2D, 0xFF, 0xB3, 0x38, 0x5A, 0x18, 0xD4, 0xF3, 0x88, 0x59,
+				0xED, 0x31, 0x1D, 0x0A, 0x9D, 0x51, 0x41, 0xCE, 0x9C, 0xC5,
+				0xC6, 0x6E, 0xE6, 0x89, 0xB2, 0x66, 0xA8, 0xAA, 0x18, 0xAC,
+				0xE8, 0x28, 0x2A, 0x0E, 0x0D, 0xB5, 0x96, 0xC9, 0x0B, 0x0A,
+				0x7B, 0x87},
+};
+
+static int sha3(void) {
+	int code = STS_ERR;
+	int i, j, k, len;
+	uint8_t message[MSG_SIZE], digest[64];
+	md_sh3_t ctx;
+
+#if MD_MAP == SH3_256 || !defined(STRIP)
+	TEST_ONCE("sha3-256 hash function is correct") {
+		for (i = 0; i < TEST_MAX; i++) {
+			message[0] = '\0';
+			for (j = 0; j < count[i]; j++) {
+				strcat((char *)message, tests[i]);
+			}
+			md_map_sh3_256(digest, message, strlen((char *)message));
+			TEST_ASSERT(memcmp(digest, result3_256[i], 32) == 0, end);
+		}
+	}
+	TEST_END;
+
+	TEST_ONCE("sha3-256 incremental hashing is consistent") {
+		for (i = 0; i < TEST_MAX; i++) {
+			message[0] = '\0';
+			for (j = 0; j < count[i]; j++) {
+				strcat((char *)message, tests[i]);
+			}
+			len = strlen((char *)message);
+			md_sh3_256_init(&ctx);
+			for (j = 0, k = 1; j < len; j += k, k = k % 67 + 1) {
+				md_sh3_256_update(&ctx, message + j, MIN(k, len - j));
+			}
+			md_sh3_256_final(&ctx, digest);
+			TEST_ASSERT(memcmp(digest, result3_256[i], 32) == 0, end);
+		}
+	}
+	TEST_END;
+#endif
+
+#if MD_MAP == SH3_512 || !defined(STRIP)
+	TEST_ONCE("sha3-512 hash function is correct") {
+		for (i = 0; i < TEST_MAX; i++) {
+			message[0] = '\0';
+			for (j = 0; j < count[i]; j++) {
+				strcat((char *)message, tests[i]);
+			}
+			md_map_sh3_512(digest, message, strlen((char *)message));
+			TEST_ASSERT(memcmp(digest, result3_512[i], 64) == 0, end);
+		}
+	}
+	TEST_END;
+
+	TEST_ONCE("sha3-512 incremental hashing is consistent") {
+		for (i = 0; i < TEST_MAX; i++) {
+			message[0] = '\0';
+			for (j = 0; j < count[i]; j++) {
+				strcat((char *)message, tests[i]);
+			}
+			len = strlen((char *)message);
+			md_sh3_512_init(&ctx);
+			for (j = 0, k = 1; j < len; j += k, k = k % 67 + 1) {
+				md_sh3_512_update(&ctx, message + j, MIN(k, len - j));
+			}
+			md_sh3_512_final(&ctx, digest);
+			TEST_ASSERT(memcmp(digest, result3_512[i], 64) == 0, end);
+		}
+	}
+	TEST_END;
+#endif
+
+	code = STS_OK;
+
+  end:
+	return code;
+}
+
+#endif
+
+uint8_t result_shk128[3][40] = {
+	{0x58, 0x81, 0x09, 0x2D, 0xD8, 0x18, 0xBF, 0x5C, 0xF8, 0xA3, 0xDD, 0xB7,
+				0x93, 0xFB, 0xCB, 0xA7, 0x40, 0x97, 0xD5, 0xC5, 0x26, 0xA6,
+				0xD3, 0x5F, 0x97, 0xB8, 0x33, 0x51, 0x94, 0x0F, 0x2C, 0xC8,
+				0x44, 0xC5, 0x0A, 0xF3, 0x2A, 0xCD, 0x3F, 0x2C},
+	{0x1A, 0x96, 0x18, 0x2B, 0x50, 0xFB, 0x8C, 0x7E, 0x74, 0xE0, 0xA7, 0x07,
+				0x78, 0x8F, 0x55, 0xE9, 0x82, 0x09, 0xB8, 0xD9, 0x1F, 0xAD,
+				0xE8, 0xF3, 0x2F, 0x8D, 0xD5, 0xCF, 0xF7, 0xBF, 0x21, 0xF5,
+				0x4E, 0xE5, 0xF1, 0x95, 0x50, 0x82, 0x5A, 0x6E},
+	{0x9D, 0x22, 0x2C, 0x79, 0xC4, 0xFF, 0x9D, 0x09, 0x2C, 0xF6, 0xCA, 0x86,
+				0x14, 0x3A, 0xA4, 0x11, 0xE3, 0x69, 0x97, 0x38, 0x08, 0xEF,
+				0x97, 0x09, 0x32, 0x55, 0x82, 0x6C, 0x55, 0x72, 0xEF, 0x58,
+				0x42, 0x4C, 0x4B, 0x5C, 0x28, 0x47, 0x5F, 0xFD},
+};
+
+uint8_t result_shk256[3][80] = {
+	{0x48, 0x33, 0x66, 0x60, 0x13, 0x60, 0xA8, 0x77, 0x1C, 0x68, 0x63, 0x08,
+				0x0C, 0xC4, 0x11, 0x4D, 0x8D, 0xB4, 0x45, 0x30, 0xF8, 0xF1,
+				0xE1, 0xEE, 0x4F, 0x94, 0xEA, 0x37, 0xE7, 0x8B, 0x57, 0x39,
+				0xD5, 0xA1, 0x5B, 0xEF, 0x18, 0x6A, 0x53, 0x86, 0xC7, 0x57,
+				0x44, 0xC0, 0x52, 0x7E, 0x1F, 0xAA, 0x9F, 0x87, 0x26, 0xE4,
+				0x62, 0xA1, 0x2A, 0x4F, 0xEB, 0x06, 0xBD, 0x88, 0x01, 0xE7,
+				0x51, 0xE4, 0x13, 0x85, 0x14, 0x12, 0x04, 0xF3, 0x29, 0x97,
+				0x9F, 0xD3, 0x04, 0x7A, 0x13, 0xC5, 0x65, 0x77},
+	{0x4D, 0x8C, 0x2D, 0xD2, 0x43, 0x5A, 0x01, 0x28, 0xEE, 0xFB, 0xB8, 0xC3,
+				0x6F, 0x6F, 0x87, 0x13, 0x3A, 0x79, 0x11, 0xE1, 0x8D, 0x97,
+				0x9E, 0xE1, 0xAE, 0x6B, 0xE5, 0xD4, 0xFD, 0x2E, 0x33, 0x29,
+				0x40, 0xD8, 0x68, 0x8A, 0x4E, 0x6A, 0x59, 0xAA, 0x80, 0x60,
+				0xF1, 0xF9, 0xBC, 0x99, 0x6C, 0x05, 0xAC, 0xA3, 0xC6, 0x96,
+				0xA8, 0xB6, 0x62, 0x79, 0xDC, 0x67, 0x2C, 0x74, 0x0B, 0xB2,
+				0x24, 0xEC, 0x37, 0xA9, 0x2B, 0x65, 0xDB, 0x05, 0x39, 0xC0,
+				0x20, 0x34, 0x55, 0xF5, 0x1D, 0x97, 0xCC, 0xE4},
+	{0x35, 0x78, 0xA7, 0xA4, 0xCA, 0x91, 0x37, 0x56, 0x9C, 0xDF, 0x76, 0xED,
+				0x61, 0x7D, 0x31, 0xBB, 0x99, 0x4F, 0xCA, 0x9C, 0x1B, 0xBF,
+				0x8B, 0x18, 0x40, 0x13, 0xDE, 0x82, 0x34, 0xDF, 0xD1, 0x3A,
+				0x3F, 0xD1, 0x24, 0xD4, 0xDF, 0x76, 0xC0, 0xA5, 0x39, 0xEE,
+				0x7D, 0xD2, 0xF6, 0xE1, 0xEC, 0x34, 0x61, 0x24, 0xC8, 0x15,
+				0xD9, 0x41, 0x0E, 0x14, 0x5E, 0xB5, 0x61, 0xBC, 0xD9, 0x7B,
+				0x18, 0xAB, 0x6C, 0xE8, 0xD5, 0x55, 0x3E, 0x0E, 0xAB, 0x3D,
+				0x1F, 0x7D, 0xFB, 0x8F, 0x9D, 0xEE, 0xFE, 0x16},
+};
+
+static int shake(void) {
+	int code = STS_ERR;
+	int i, j;
+	uint8_t message[MSG_SIZE], out[80], ref[80];
+
+	TEST_ONCE("shake128 extendable-output function is correct") {
+		for (i = 0; i < TEST_MAX; i++) {
+			message[0] = '\0';
+			for (j = 0; j < count[i]; j++) {
+				strcat((char *)message, tests[i]);
+			}
+			md_xof_shk128(out, 40, message, strlen((char *)message));
+			TEST_ASSERT(memcmp(out, result_shk128[i], 40) == 0, end);
+		}
+	}
+	TEST_END;
+
+	TEST_ONCE("shake256 extendable-output function is correct") {
+		for (i = 0; i < TEST_MAX; i++) {
+			message[0] = '\0';
+			for (j = 0; j < count[i]; j++) {
+				strcat((char *)message, tests[i]);
+			}
+			md_xof_shk256(out, 80, message, strlen((char *)message));
+			TEST_ASSERT(memcmp(out, result_shk256[i], 80) == 0, end);
+		}
+	}
+	TEST_END;
+
+	TEST_BEGIN("shake outputs of different lengths are consistent") {
+		rand_bytes(message, 100);
+		j = 1 + message[0] % 80;
+		md_xof_shk128(ref, 80, message, 100);
+		md_xof_shk128(out, j, message, 100);
+		TEST_ASSERT(memcmp(out, ref, j) == 0, end);
+		md_xof_shk256(ref, 80, message, 100);
+		md_xof_shk256(out, j, message, 100);
+		TEST_ASSERT(memcmp(out, ref, j) == 0, end);
+	}
+	TEST_END;
+
+	code = STS_OK;
+
+  end:
+	return code;
+}
+
+#if MD_MAP == B2S_256 || MD_MAP == B2B_512 || !defined(STRIP)
+
+uint8_t result_b2s[3][32] = {
+	{0x50, 0x8C, 0x5E, 0x8C, 0x32, 0x7C, 0x14, 0xE2, 0xE1, 0xA7, 0x2B, 0xA3,
+				0x4E, 0xEB, 0x45, 0x2F, 0x37, 0x45, 0x8B, 0x20, 0x9E, 0xD6,
+				0x3A, 0x29, 0x4D, 0x99, 0x9B, 0x4C, 0x86, 0x67, 0x59, 0x82},
+	{0x6F, 0x4D, 0xF5, 0x11, 0x6A, 0x6F, 0x33, 0x2E, 0xDA, 0xB1, 0xD9, 0xE1,
+				0x0E, 0xE8, 0x7D, 0xF6, 0x55, 0x7B, 0xEA, 0xB6, 0x25, 0x9D,
+				0x76, 0x63, 0xF3, 0xBC, 0xD5, 0x72, 0x2C, 0x13, 0xF1, 0x89},
+	{0xBE, 0xC0, 0xC0, 0xE6, 0xCD, 0xE5, 0xB6, 0x7A, 0xCB, 0x73, 0xB8, 0x1F,
+				0x79, 0xA6, 0x7A, 0x40, 0x79, 0xAE, 0x1C, 0x60, 0xDA, 0xC9,
+				0xD2, 0x66, 0x1A, 0xF1, 0x8E, 0x9F, 0x8B, 0x50, 0xDF, 0xA5},
+};
+
+uint8_t result_b2b[3][64] = {
+	{0xBA, 0x80, 0xA5, 0x3F, 0x98, 0x1C, 0x4D, 0x0D, 0x6A, 0x27, 0x97, 0xB6,
+				0x9F, 0x12, 0xF6, 0xE9, 0x4C, 0x21, 0x2F, 0x14, 0x68, 0x5A,
+				0xC4, 0xB7, 0x4B, 0x12, 0xBB, 0x6F, 0xDB, 0xFF, 0xA2, 0xD1,
+				0x7D, 0x87, 0xC5, 0x39, 0x2A, 0xAB, 0x79, 0x2D, 0xC2, 0x52,
+				0xD5, 0xDE, 0x45, 0x33, 0xCC, 0x95, 0x18, 0xD3, 0x8A, 0xA8,
+				0xDB, 0xF1, 0x92, 0x5A, 0xB9, 0x23, 0x86, 0xED, 0xD4, 0x00,
+				0x99, 0x23},
+	{0x72, 0x85, 0xFF, 0x3E, 0x8B, 0xD7, 0x68, 0xD6, 0x9B, 0xE6, 0x2B, 0x3B,
+				0xF1, 0x87, 0x65, 0xA3, 0x25, 0x91, 0x7F, 0xA9, 0x74, 0x4A,
+				0xC2, 0xF5, 0x82, 0xA2, 0x08, 0x50, 0xBC, 0x2B, 0x11, 0x41,
+				0xED, 0x1B, 0x3E, 0x45, 0x28, 0x59, 0x5A, 0xCC, 0x90, 0x77,
+				0x2B, 0xDF, 0x2D, 0x37, 0xDC, 0x8A, 0x47, 0x13, 0x0B, 0x44,
+				0xF3, 0x3A, 0x02, 0xE8, 0x73, 0x0E, 0x5A, 0xD8, 0xE1, 0x66,
+				0xE8, 0x88},
+	{0x98, 0xFB, 0x3E, 0xFB, 0x72, 0x06, 0xFD, 0x19, 0xEB, 0xF6, 0x9B, 0x6F,
+				0x31, 0x2C, 0xF7, 0xB6, 0x4E, 0x3B, 0x94, 0xDB, 0xE1, 0xA1,
+				0x71, 0x07, 0x91, 0x39, 0x75, 0xA7, 0x93, 0xF1, 0x77, 0xE1,
+				0xD0, 0x77, 0x60, 0x9D, 0x7F, 0xBA, 0x36, 0x3C, 0xBB, 0xA0,
+				0x0D, 0x05, 0xF7, 0xAA, 0x4E, 0x4F, 0xA8, 0x71, 0x5D, 0x64,
+				0x28, 0x10, 0x4C, 0x0A, 0x75, 0x64, 0x3B, 0x0F, 0xF3, 0xFD,
+				0x3E, 0xAF},
+};
+
+static int blake2(void) {
+	int code = STS_ERR;
+	int i, j, k, len;
+	uint8_t message[MSG_SIZE], digest[64];
+
+#if MD_MAP == B2S_256 || !defined(STRIP)
+	md_b2s_256_t ctx_s;
+
+	TEST_ONCE("blake2s-256 hash function is correct") {
+		for (i = 0; i < TEST_MAX; i++) {
+			message[0] = '\0';
+			for (j = 0; j < count[i]; j++) {
+				strcat((char *)message, tests[i]);
+			}
+			md_map_b2s_256(digest, message, strlen((char *)message));
+			TEST_ASSERT(memcmp(digest, result_b2s[i], 32) == 0, end);
+		}
+	}
+	TEST_END;
+
+	TEST_ONCE("blake2s-256 incremental hashing is consistent") {
+		for (i = 0; i < TEST_MAX; i++) {
+			message[0] = '\0';
+			for (j = 0; j < count[i]; j++) {
+				strcat((char *)message, tests[i]);
+			}
+			len = strlen((char *)message);
+			md_b2s_256_init(&ctx_s);
+			for (j = 0, k = 1; j < len; j += k, k = k % 67 + 1) {
+				md_b2s_256_update(&ctx_s, message + j, MIN(k, len - j));
+			}
+			md_b2s_256_final(&ctx_s, digest);
+			TEST_ASSERT(memcmp(digest, result_b2s[i], 32) == 0, end);
+		}
+	}
+	TEST_END;
+#endif
+
+#if MD_MAP == B2B_512 || !defined(STRIP)
+	md_b2b_512_t ctx_b;
+
+	TEST_ONCE("blake2b-512 hash function is correct") {
+		for (i = 0; i < TEST_MAX; i++) {
+			message[0] = '\0';
+			for (j = 0; j < count[i]; j++) {
+				strcat((char *)message, tests[i]);
+			}
+			md_map_b2b_512(digest, message, strlen((char *)message));
+			TEST_ASSERT(memcmp(digest, result_b2b[i], 64) == 0, end);
+		}
+	}
+	TEST_END;
+
+	TEST_ONCE("blake2b-512 incremental hashing is consistent") {
+		for (i = 0; i < TEST_MAX; i++) {
+			message[0] = '\0';
+			for (j = 0; j < count[i]; j++) {
+				strcat((char *)message, tests[i]);
+			}
+			len = strlen((char *)message);
+			md_b2b_512_init(&ctx_b);
+			for (j = 0, k = 1; j < len; j += k, k = k % 67 + 1) {
+				md_b2b_512_update(&ctx_b, message + j, MIN(k, len - j));
+			}
+			md_b2b_512_final(&ctx_b, digest);
+			TEST_ASSERT(memcmp(digest, result_b2b[i], 64) == 0, end);
+		}
+	}
+	TEST_END;
+#endif
+
 	code = STS_OK;
 
   end:
@@ -350,6 +841,94 @@ static int mgf(void) {
 #endif
 }
 
+static int hkdf(void) {
+	int code = STS_ERR;
+	uint8_t ikm[22], salt[13], info[10], prk[MD_LEN], okm[42], out[42];
+
+	memset(ikm, 0x0B, sizeof(ikm));
+	for (int j = 0; j < sizeof(salt); j++) {
+		salt[j] = j;
+	}
+	for (int j = 0; j < sizeof(info); j++) {
+		info[j] = 0xF0 + j;
+	}
+
+#if MD_MAP == SH256
+	uint8_t prk1[] = {
+		0x07, 0x77, 0x09, 0x36, 0x2C, 0x2E, 0x32, 0xDF, 0x0D, 0xDC, 0x3F, 0x0D,
+		0xC4, 0x7B, 0xBA, 0x63, 0x90, 0xB6, 0xC7, 0x3B, 0xB5, 0x0F, 0x9C, 0x31,
+		0x22, 0xEC, 0x84, 0x4A, 0xD7, 0xC2, 0xB3, 0xE5
+	};
+	uint8_t okm1[] = {
+		0x3C, 0xB2, 0x5F, 0x25, 0xFA, 0xAC, 0xD5, 0x7A, 0x90, 0x43, 0x4F, 0x64,
+		0xD0, 0x36, 0x2F, 0x2A, 0x2D, 0x2D, 0x0A, 0x90, 0xCF, 0x1A, 0x5A, 0x4C,
+		0x5D, 0xB0, 0x2D, 0x56, 0xEC, 0xC4, 0xC5, 0xBF, 0x34, 0x00, 0x72, 0x08,
+		0xD5, 0xB8, 0x87, 0x18, 0x58, 0x65
+	};
+	uint8_t prk2[] = {
+		0x19, 0xEF, 0x24, 0xA3, 0x2C, 0x71, 0x7B, 0x16, 0x7F, 0x33, 0xA9, 0x1D,
+		0x6F, 0x64, 0x8B, 0xDF, 0x96, 0x59, 0x67, 0x76, 0xAF, 0xDB, 0x63, 0x77,
+		0xAC, 0x43, 0x4C, 0x1C, 0x29, 0x3C, 0xCB, 0x04
+	};
+	uint8_t okm2[] = {
+		0x8D, 0xA4, 0xE7, 0x75, 0xA5, 0x63, 0xC1, 0x8F, 0x71, 0x5F, 0x80, 0x2A,
+		0x06, 0x3C, 0x5A, 0x31, 0xB8, 0xA1, 0x1F, 0x5C, 0x5E, 0xE1, 0x87, 0x9E,
+		0xC3, 0x45, 0x4E, 0x5F, 0x3C, 0x73, 0x8D, 0x2D, 0x9D, 0x20, 0x13, 0x95,
+		0xFA, 0xA4, 0xB6, 0x1A, 0x96, 0xC8
+	};
+
+	TEST_ONCE("hkdf (sha256) key derivation function is correct") {
+		md_hkdf_ext(prk, salt, sizeof(salt), ikm, sizeof(ikm));
+		TEST_ASSERT(memcmp(prk, prk1, MD_LEN) == 0, end);
+		md_hkdf_exp(okm, sizeof(okm), prk, MD_LEN, info, sizeof(info));
+		TEST_ASSERT(memcmp(okm, okm1, sizeof(okm)) == 0, end);
+		md_hkdf_ext(prk, NULL, 0, ikm, sizeof(ikm));
+		TEST_ASSERT(memcmp(prk, prk2, MD_LEN) == 0, end);
+		md_hkdf_exp(okm, sizeof(okm), prk, MD_LEN, NULL, 0);
+		TEST_ASSERT(memcmp(okm, okm2, sizeof(okm)) == 0, end);
+	}
+	TEST_END;
+#endif
+
+#if MD_MAP == SHONE
+	uint8_t prk1[] = {
+		0x9B, 0x6C, 0x18, 0xC4, 0x32, 0xA7, 0xBF, 0x8F, 0x0E, 0x71, 0xC8, 0xEB,
+		0x88, 0xF4, 0xB3, 0x0B, 0xAA, 0x2B, 0xA2, 0x43
+	};
+	uint8_t okm1[] = {
+		0x08, 0x5A, 0x01, 0xEA, 0x1B, 0x10, 0xF3, 0x69, 0x33, 0x06, 0x8B, 0x56,
+		0xEF, 0xA5, 0xAD, 0x81, 0xA4, 0xF1, 0x4B, 0x82, 0x2F, 0x5B, 0x09, 0x15,
+		0x68, 0xA9, 0xCD, 0xD4, 0xF1, 0x55, 0xFD, 0xA2, 0xC2, 0x2E, 0x42, 0x24,
+		0x78, 0xD3, 0x05, 0xF3, 0xF8, 0x96
+	};
+
+	TEST_ONCE("hkdf (sha1) key derivation function is correct") {
+		md_hkdf_ext(prk, salt, sizeof(salt), ikm, 11);
+		TEST_ASSERT(memcmp(prk, prk1, MD_LEN) == 0, end);
+		md_hkdf_exp(okm, sizeof(okm), prk, MD_LEN, info, sizeof(info));
+		TEST_ASSERT(memcmp(okm, okm1, sizeof(okm)) == 0, end);
+	}
+	TEST_END;
+#endif
+
+	TEST_BEGIN("hkdf key derivation function is consistent") {
+		rand_bytes(ikm, sizeof(ikm));
+		md_hkdf_ext(prk, salt, sizeof(salt), ikm, sizeof(ikm));
+		md_hkdf_exp(okm, sizeof(okm), prk, MD_LEN, info, sizeof(info));
+		md_hkdf(out, sizeof(out), ikm, sizeof(ikm), salt, sizeof(salt), info,
+				sizeof(info));
+		TEST_ASSERT(memcmp(okm, out, sizeof(out)) == 0, end);
+		md_hkdf_exp(out, 17, prk, MD_LEN, info, sizeof(info));
+		TEST_ASSERT(memcmp(okm, out, 17) == 0, end);
+	}
+	TEST_END;
+
+	code = STS_OK;
+
+  end:
+	return code;
+}
+
 static int hmac(void) {
 	int code = STS_ERR;
 	uint8_t mac[MD_LEN];
@@ -457,6 +1036,26 @@ static int hmac(void) {
 	TEST_END;	
 #endif
 
+	TEST_BEGIN("hmac with precomputed key is consistent") {
+		uint8_t k[2 * MD_BLOCK], m[3][100], t[MD_LEN];
+		int kl;
+		md_hmac_t ctx;
+
+		rand_bytes(k, sizeof(k));
+		rand_bytes(m[0], sizeof(m));
+		/* Exercise both short keys and keys longer than a block. */
+		kl = (k[0] & 1 ? MD_BLOCK + 1 : MD_LEN);
+		md_hmac_init(&ctx, k, kl);
+		for (int j = 0; j < 3; j++) {
+			md_hmac(mac, m[j], sizeof(m[j]), k, kl);
+			md_hmac_update(&ctx, m[j], 10);
+			md_hmac_update(&ctx, m[j] + 10, sizeof(m[j]) - 10);
+			md_hmac_final(&ctx, t);
+			TEST_ASSERT(memcmp(mac, t, MD_LEN) == 0, end);
+		}
+	}
+	TEST_END;
+
 	code = STS_OK;
 
   end:
@@ -506,6 +1105,25 @@ int main(void) {
 	}
 #endif
 
+#if MD_MAP == SH3_256 || MD_MAP == SH3_512 || !defined(STRIP)
+	if (sha3() != STS_OK) {
+		core_clean();
+		return 1;
+	}
+#endif
+
+	if (shake() != STS_OK) {
+		core_clean();
+		return 1;
+	}
+
+#if MD_MAP == B2S_256 || MD_MAP == B2B_512 || !defined(STRIP)
+	if (blake2() != STS_OK) {
+		core_clean();
+		return 1;
+	}
+#endif
+
 	if (kdf() != STS_OK) {
 		core_clean();
 		return 1;
@@ -516,6 +1134,11 @@ int main(void) {
 		return 1;
 	}
 
+	if (hkdf() != STS_OK) {
+		core_clean();
+		return 1;
+	}
+
 	if (hmac() != STS_OK) {
 		core_clean();
 		return 1;
@@ -616,8 +616,8 @@ static int doubling12(void) {
 static int pairing12(void) {
 	int code = STS_ERR;
 	bn_t k, n;
-	ep_t p;
-	ep2_t q, r;
+	ep_t p, ps[3];
+	ep2_t q, r, qs[3];
 	fp12_t e1, e2;
 
 	bn_null(k);
@@ -627,6 +627,10 @@ static int pairing12(void) {
 	ep2_null(r);
 	fp12_null(e1);
 	fp12_null(e2);
+	for (int i = 0; i < 3; i++) {
+		ep_null(ps[i]);
+		ep2_null(qs[i]);
+	}
 
 	TRY {
 		bn_new(n);
@@ -636,6 +640,10 @@ static int pairing12(void) {
 		ep2_new(r);
 		fp12_new(e1);
 		fp12_new(e2);
+		for (int i = 0; i < 3; i++) {
+			ep_new(ps[i]);
+			ep2_new(qs[i]);
+		}
 
 		ep_curve_get_ord(n);
 
@@ -666,6 +674,24 @@ static int pairing12(void) {
 			TEST_ASSERT(fp12_cmp(e1, e2) == CMP_EQ, end);
 		} TEST_END;
 
+		TEST_BEGIN("product of pairings is correct") {
+			fp12_set_dig(e1, 1);
+			for (int i = 0; i < 3; i++) {
+				ep_rand(ps[i]);
+				ep2_rand(qs[i]);
+				pp_map_k12(e2, ps[i], qs[i]);
+				fp12_mul(e1, e1, e2);
+			}
+			pp_map_sim_k12(e2, ps, qs, 3);
+			TEST_ASSERT(fp12_cmp(e1, e2) == CMP_EQ, end);
+			ep_set_infty(ps[1]);
+			pp_map_k12(e1, ps[0], qs[0]);
+			pp_map_k12(e2, ps[2], qs[2]);
+			fp12_mul(e1, e1, e2);
+			pp_map_sim_k12(e2, ps, qs, 3);
+			TEST_ASSERT(fp12_cmp(e1, e2) == CMP_EQ, end);
+		} TEST_END;
+
 #if PP_MAP == TATEP || !defined(STRIP)
 		TEST_BEGIN("tate pairing is not degenerate") {
 			ep_rand(p);
@@ -693,6 +719,18 @@ static int pairing12(void) {
 			pp_map_tatep_k12(e2, p, q);
 			TEST_ASSERT(fp12_cmp(e1, e2) == CMP_EQ, end);
 		} TEST_END;
+
+		TEST_BEGIN("tate product of pairings is correct") {
+			fp12_set_dig(e1, 1);
+			for (int i = 0; i < 3; i++) {
+				ep_rand(ps[i]);
+				ep2_rand(qs[i]);
+				pp_map_tatep_k12(e2, ps[i], qs[i]);
+				fp12_mul(e1, e1, e2);
+			}
+			pp_map_sim_tatep_k12(e2, ps, qs, 3);
+			TEST_ASSERT(fp12_cmp(e1, e2) == CMP_EQ, end);
+		} TEST_END;
 #endif
 
 #if PP_MAP == WEIL || !defined(STRIP)
@@ -722,6 +760,18 @@ static int pairing12(void) {
 			pp_map_weilp_k12(e2, p, q);
 			TEST_ASSERT(fp12_cmp(e1, e2) == CMP_EQ, end);
 		} TEST_END;
+
+		TEST_BEGIN("weil product of pairings is correct") {
+			fp12_set_dig(e1, 1);
+			for (int i = 0; i < 3; i++) {
+				ep_rand(ps[i]);
+				ep2_rand(qs[i]);
+				pp_map_weilp_k12(e2, ps[i], qs[i]);
+				fp12_mul(e1, e1, e2);
+			}
+			pp_map_sim_weilp_k12(e2, ps, qs, 3);
+			TEST_ASSERT(fp12_cmp(e1, e2) == CMP_EQ, end);
+		} TEST_END;
 #endif
 
 #if PP_MAP == OATEP || !defined(STRIP)
@@ -751,6 +801,18 @@ static int pairing12(void) {
 			pp_map_oatep_k12(e2, p, q);
 			TEST_ASSERT(fp12_cmp(e1, e2) == CMP_EQ, end);
 		} TEST_END;
+
+		TEST_BEGIN("optimal ate product of pairings is correct") {
+			fp12_set_dig(e1, 1);
+			for (int i = 0; i < 3; i++) {
+				ep_rand(ps[i]);
+				ep2_rand(qs[i]);
+				pp_map_oatep_k12(e2, ps[i], qs[i]);
+				fp12_mul(e1, e1, e2);
+			}
+			pp_map_sim_oatep_k12(e2, ps, qs, 3);
+			TEST_ASSERT(fp12_cmp(e1, e2) == CMP_EQ, end);
+		} TEST_END;
 #endif
 	}
 	CATCH_ANY {
@@ -766,6 +828,10 @@ static int pairing12(void) {
 	ep2_free(r);
 	fp12_free(e1);
 	fp12_free(e2);
+	for (int i = 0; i < 3; i++) {
+		ep_free(ps[i]);
+		ep2_free(qs[i]);
+	}
 	return code;
 }
 
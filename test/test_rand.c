@@ -261,6 +261,8 @@ uint8_t result2[] = {
 
 #endif
 
+#ifdef FUNCTION
+
 static int test(void) {
 	int i, len = 2 * MD_LEN, size = (RAND_SIZE - 1) / 2, code = STS_ERR;
 	uint8_t out[len], seed2[size], seed3[size];
@@ -302,6 +304,182 @@ static int test(void) {
 	return code;
 }
 
+#else
+
+static int test(void) {
+	int i, len = 2 * MD_LEN, size = (RAND_SIZE - 1) / 2, code = STS_ERR;
+	uint8_t out1[len], out2[len], seed[size];
+
+	for (i = 0; i < size; i++) {
+		seed[i] = i;
+	}
+
+	TEST_ONCE("hash-dbrg random generator is consistent") {
+		rand_clean();
+		rand_seed(seed, size);
+		rand_bytes(out1, len);
+		rand_clean();
+		rand_seed(seed, size);
+		rand_bytes(out2, len);
+		TEST_ASSERT(memcmp(out1, out2, len) == 0, end);
+		rand_bytes(out2, len);
+		TEST_ASSERT(memcmp(out1, out2, len) != 0, end);
+		rand_clean();
+		rand_seed(seed, size);
+		seed[0] ^= 1;
+		rand_seed(seed, size);
+		rand_bytes(out2, len);
+		TEST_ASSERT(memcmp(out1, out2, len) != 0, end);
+	}
+	TEST_END;
+
+	code = STS_OK;
+
+  end:
+	return code;
+}
+
+#endif
+
+#elif RAND == HMAC || RAND == CTR
+
+/*
+ * Test vectors generated with the OpenSSL 3.0 DRBGs, seeded with entropy
+ * 00...3F, nonce 40...4F and an empty personalization string, then reseeded
+ * with entropy 80...BF.
+ */
+
+#if RAND == CTR
+
+#define NAME "ctr-drbg"
+#define FUNCTION "aes-256"
+
+uint8_t result1[] = {
+	0xE1, 0x0C, 0xD8, 0x3B, 0x8D, 0xC3, 0xF1, 0x57, 0xE7, 0x75,
+	0x68, 0xD5, 0x79, 0x2B, 0xAF, 0xD9, 0xE9, 0x8D, 0x03, 0x84,
+	0x12, 0x3D, 0x44, 0x93, 0x15, 0xCD, 0xA6, 0x9A, 0xE6, 0xD4,
+	0xA7, 0x82, 0x5C, 0xEB, 0xD9, 0x7E, 0x7C, 0x6A, 0x35, 0x1A,
+	0x40, 0x5B, 0x1C, 0xBF, 0x8B, 0x1B, 0xEA, 0xBC, 0xC6, 0x03,
+	0x32, 0x3C, 0x0C, 0x28, 0x08, 0x51, 0xEF, 0x04, 0x52, 0x65,
+	0xC6, 0x71, 0x90, 0xF9, 0xC1, 0x76, 0x75, 0x6C, 0x13, 0xF5,
+	0x68, 0x5D, 0xD1, 0xF3, 0xF8, 0x0C, 0x6B, 0xCA, 0x0F, 0x38
+};
+
+uint8_t result2[] = {
+	0x90, 0xF5, 0x77, 0x77, 0x65, 0xF6, 0xD2, 0x18, 0xE9, 0x82,
+	0xAF, 0x22, 0x3D, 0x66, 0x9A, 0x85, 0xFB, 0x8F, 0x6D, 0xCB,
+	0xDD, 0x23, 0xF4, 0x33, 0x45, 0xDA, 0x6F, 0x0D, 0x56, 0x0B,
+	0xE7, 0x82, 0xE3, 0x2F, 0xAF, 0x5B, 0x0F, 0x39, 0xB6, 0x7F
+};
+
+#elif MD_MAP == SH256
+
+#define NAME "hmac-drbg"
+#define FUNCTION "sha256"
+
+uint8_t result1[] = {
+	0xBE, 0xA9, 0x27, 0x59, 0x4F, 0x15, 0x5F, 0xC1, 0x5E, 0x39,
+	0xBB, 0xC9, 0xD8, 0xA3, 0x39, 0x83, 0xE3, 0x1B, 0x7A, 0x4E,
+	0xE4, 0x23, 0x9D, 0x5C, 0xED, 0x39, 0x58, 0xCF, 0xC5, 0xBA,
+	0x93, 0x13, 0x4D, 0x7D, 0x14, 0x46, 0x68, 0x17, 0x57, 0xFC,
+	0x46, 0x44, 0x39, 0x0B, 0x17, 0xE8, 0x72, 0x4E, 0x16, 0x92,
+	0x84, 0xA4, 0x06, 0x24, 0x36, 0xBD, 0x7B, 0xD9, 0x33, 0xEF,
+	0x90, 0x1B, 0x51, 0x2C, 0x4F, 0xBA, 0x6D, 0x62, 0xAE, 0x7F,
+	0x8F, 0x23, 0x71, 0x4C, 0x9A, 0x93, 0x71, 0x0A, 0x36, 0xB1
+};
+
+uint8_t result2[] = {
+	0x81, 0xF8, 0xC9, 0xCB, 0xF9, 0x9B, 0x64, 0xE1, 0x25, 0x8C,
+	0xA7, 0x02, 0xA6, 0xF6, 0xDC, 0x61, 0x57, 0x2B, 0xC5, 0x1D,
+	0x85, 0x4B, 0x29, 0x57, 0x3B, 0xBE, 0x34, 0xA6, 0xFA, 0x3D,
+	0x93, 0xC2, 0x7A, 0x68, 0x22, 0xD6, 0xC2, 0x42, 0x80, 0xF7
+};
+
+#elif MD_MAP == SH512
+
+#define NAME "hmac-drbg"
+#define FUNCTION "sha512"
+
+uint8_t result1[] = {
+	0xCD, 0xCC, 0x4D, 0x22, 0xDC, 0x0A, 0x10, 0xBF, 0x5F, 0xB4,
+	0x03, 0x8F, 0x28, 0xE5, 0xD0, 0x85, 0x3B, 0x94, 0x9E, 0x13,
+	0x72, 0x39, 0xCA, 0x43, 0x70, 0xF4, 0x7A, 0xCC, 0x5B, 0xE6,
+	0x15, 0xCB, 0xC1, 0x90, 0xA7, 0xF4, 0x59, 0x11, 0x70, 0x2B,
+	0x9A, 0x3D, 0x2E, 0x84, 0xA5, 0x89, 0xF6, 0xB2, 0x31, 0x4E,
+	0x2A, 0x9A, 0x86, 0x55, 0xE0, 0xE2, 0xA7, 0x81, 0x94, 0xB9,
+	0xE6, 0xE6, 0xDA, 0xBE, 0x88, 0x81, 0xE7, 0x8E, 0x7F, 0x8F,
+	0xFB, 0x73, 0xD1, 0xBE, 0x06, 0x94, 0x0C, 0xF0, 0x88, 0xC8
+};
+
+uint8_t result2[] = {
+	0x7A, 0x5E, 0xC8, 0xBA, 0x84, 0xA0, 0xC3, 0xB3, 0x5E, 0x83,
+	0x95, 0x19, 0x76, 0xFC, 0xCB, 0xE6, 0x5D, 0x0A, 0x76, 0x5E,
+	0x95, 0x97, 0x85, 0x28, 0xDE, 0x79, 0x28, 0xB1, 0x4E, 0x43,
+	0x9F, 0x2E, 0x59, 0xE9, 0xBE, 0x72, 0xEE, 0x14, 0x25, 0x9E
+};
+
+#else
+
+#define NAME "hmac-drbg"
+
+#endif
+
+static int test(void) {
+	uint8_t seed[80], out[80], *buf1 = NULL, *buf2 = NULL;
+	int len = (1 << 16) + 100, code = STS_ERR;
+
+	for (int j = 0; j < sizeof(seed); j++) {
+		seed[j] = j;
+	}
+
+#ifdef FUNCTION
+	TEST_ONCE(NAME " (" FUNCTION ") random generator is correct") {
+		rand_clean();
+		rand_seed(seed, sizeof(seed));
+		rand_bytes(out, 40);
+		TEST_ASSERT(memcmp(out, result1, 40) == 0, end);
+		rand_bytes(out, 40);
+		TEST_ASSERT(memcmp(out, result1 + 40, 40) == 0, end);
+	}
+	TEST_END;
+
+	TEST_ONCE(NAME " (" FUNCTION ") reseeding is correct") {
+		for (int j = 0; j < 64; j++) {
+			seed[j] = 0x80 + j;
+		}
+		rand_seed(seed, 64);
+		rand_bytes(out, 40);
+		TEST_ASSERT(memcmp(out, result2, 40) == 0, end);
+	}
+	TEST_END;
+#endif
+
+	buf1 = malloc(2 * len);
+	buf2 = buf1 + len;
+
+	TEST_ONCE(NAME " large requests are consistent") {
+		TEST_ASSERT(buf1 != NULL, end);
+		/* Requests above the limit are split into maximal requests. */
+		rand_clean();
+		rand_seed(seed, sizeof(seed));
+		rand_bytes(buf1, len);
+		rand_clean();
+		rand_seed(seed, sizeof(seed));
+		rand_bytes(buf2, 1 << 16);
+		rand_bytes(buf2 + (1 << 16), len - (1 << 16));
+		TEST_ASSERT(memcmp(buf1, buf2, len) == 0, end);
+		rand_bytes(buf2, len);
+		TEST_ASSERT(memcmp(buf1, buf2, len) != 0, end);
+	}
+	TEST_END;
+
+	code = STS_OK;
+
+  end:
+	free(buf1);
+	return code;
+}
+
 #elif RAND == FIPS
 
 /*
@@ -453,6 +631,109 @@ static int test(void) {
 	return STS_OK;
 }
 
+#elif RAND == CHACHA
+
+static int test(void) {
+	uint8_t seed[SEED_SIZE], key[BC_CHACHA_KEY], iv[BC_CHACHA_IV] = { 0 };
+	uint8_t out[100], exp[100];
+	int code = STS_ERR;
+
+	TEST_ONCE("chacha20 generator is consistent") {
+		memset(seed, 0x5A, sizeof(seed));
+		rand_clean();
+		rand_seed(seed, sizeof(seed));
+		rand_bytes(out, sizeof(out));
+		/* Reproduce the output with the underlying primitives. */
+		md_kdf2(key, sizeof(key), seed, sizeof(seed));
+		memset(exp, 0, sizeof(exp));
+		bc_chacha20(exp, exp, sizeof(exp), key, iv, 1);
+		TEST_ASSERT(memcmp(out, exp, sizeof(out)) == 0, end);
+		/* The second output must use the erased key. */
+		memset(out, 0, sizeof(out));
+		bc_chacha20(key, out, sizeof(key), key, iv, 0);
+		bc_chacha20(exp, out, sizeof(exp), key, iv, 1);
+		rand_bytes(out, sizeof(out));
+		TEST_ASSERT(memcmp(out, exp, sizeof(out)) == 0, end);
+	}
+	TEST_END;
+
+	code = STS_OK;
+
+  end:
+	return code;
+}
+
+#endif
+
+#if RAND != UDEV && RAND != RDRND && RAND != CALL
+
+static int buffer(void) {
+	uint8_t seed[SEED_SIZE], out[RAND_BUF + 32], exp[RAND_BUF + 32];
+	int len, l, code = STS_ERR;
+
+	memset(seed, 0xA5, sizeof(seed));
+
+	TEST_ONCE("small requests are consistent") {
+		rand_clean();
+		rand_seed(seed, sizeof(seed));
+#if RAND_BUF >= 32
+		/* Buffer refills must match a single request of the buffer size. */
+		rand_bytes(exp, RAND_BUF);
+		rand_clean();
+		rand_seed(seed, sizeof(seed));
+		for (len = 0; len < RAND_BUF; len += l) {
+			l = MIN(1 + len % 7, RAND_BUF - len);
+			rand_bytes_small(out + len, l);
+		}
+		TEST_ASSERT(memcmp(out, exp, RAND_BUF) == 0, end);
+		/* The next small request triggers a refill. */
+		rand_bytes(exp, 32);
+		rand_clean();
+		rand_seed(seed, sizeof(seed));
+		rand_bytes(out, RAND_BUF);
+		rand_bytes_small(out, 16);
+		TEST_ASSERT(memcmp(out, exp, 16) == 0, end);
+#else
+		rand_bytes(exp, 32);
+		rand_clean();
+		rand_seed(seed, sizeof(seed));
+		rand_bytes_small(out, 32);
+		TEST_ASSERT(memcmp(out, exp, 32) == 0, end);
+#endif
+	}
+	TEST_END;
+
+	TEST_ONCE("seeding discards buffered bytes") {
+		rand_clean();
+		rand_seed(seed, sizeof(seed));
+		rand_bytes(exp, MAX(RAND_BUF, 1));
+		rand_seed(seed, sizeof(seed));
+		rand_bytes(exp, 16);
+		rand_clean();
+		rand_seed(seed, sizeof(seed));
+		rand_bytes_small(out, 16);
+		rand_seed(seed, sizeof(seed));
+		rand_bytes_small(out, 16);
+		TEST_ASSERT(memcmp(out, exp, 16) == 0, end);
+	}
+	TEST_END;
+
+#if RAND_BUF >= 32
+	TEST_ONCE("consumed bytes are erased") {
+		rand_bytes_small(out, 16);
+		memset(exp, 0, 32);
+		TEST_ASSERT(memcmp(core_get()->rand_buf, exp, 32) == 0, end);
+		TEST_ASSERT(core_get()->rand_len == RAND_BUF - 32, end);
+	}
+	TEST_END;
+#endif
+
+	code = STS_OK;
+
+  end:
+	return code;
+}
+
 #endif
 
 int main(void) {
@@ -468,6 +749,13 @@ int main(void) {
 		return 1;
 	}
 
+#if RAND != UDEV && RAND != RDRND && RAND != CALL
+	if (buffer() != STS_OK) {
+		core_clean();
+		return 1;
+	}
+#endif
+
 	util_banner("All tests have passed.\n", 0);
 
 	core_clean();